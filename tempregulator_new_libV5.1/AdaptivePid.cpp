@@ -0,0 +1,260 @@
+#include "AdaptivePid.h"                                                        // Объявление класса
+//
+#include <math.h>                                                               // exp, log, fabs
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+constexpr double kSampleS = AdaptivePid::kSampleMs / 1000.0;                    // Окно, с
+constexpr double kYScale = 100.0;                                               // Нормировка температуры: параметры МНК порядка 1
+constexpr double kUScale = 255.0;                                               // Нормировка мощности
+constexpr double kP0 = 1.0;                                                     // Начальная ковариация
+constexpr double kTauMin = 20.0, kTauMax = 20000.0;                             // Физические пределы τ, с
+constexpr double kGainMin = 0.05, kGainMax = 20.0;                              // Пределы K, °C на единицу выхода
+//
+bool physical(double a, double b) {                                             // Параметры дают осмысленную печь
+  if (!(a > exp(-kSampleS / kTauMin) && a < exp(-kSampleS / kTauMax))) return false;
+  const double k = b * kYScale / kUScale / (1.0 - a);
+  return k > kGainMin && k < kGainMax;
+}                                                                               // Завершение physical
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void AdaptivePid::start(uint32_t now_ms, double kp, double ki, double kd, const StepIdentifier::Model* prior,
+                        Q16 ambient) {                                          // Запуск
+  base_[0] = kp_ = kp;
+  base_[1] = ki_ = ki;
+  base_[2] = kd_ = kd;
+  has_prior_ = prior && prior->valid && prior->tau_s > 0.0 && prior->gain > 0.0;
+  const double tau = has_prior_ ? prior->tau_s : 600.0;                         // Без модели — средняя печь
+  const double k = has_prior_ ? prior->gain : 2.0;
+  dead_s_ = has_prior_ ? prior->dead_s : kDefaultDeadS;
+  if (has_prior_) {
+    prior_ = *prior;
+    prior_imc_ = StepIdentifier::gains(prior_, StepIdentifier::kImcPid);
+  }
+  const double d = dead_s_ / kSampleS + 0.5;                                    // Окна усреднения запаздывают на половину
+  delay_ = d < kMaxDelay - 1 ? static_cast<uint8_t>(d) : kMaxDelay - 1;
+  const double a = exp(-kSampleS / tau);
+  th_[0] = a;                                                                   // Начальная модель
+  th_[1] = k * (1.0 - a) * kUScale / kYScale;
+  p_[0] = p_[2] = kP0;
+  p_[1] = 0.0;
+  ambient_raw_ = ambient.raw();
+  for (uint8_t& u : u_ring_) u = 0;
+  u_head_ = 0;
+  win_t0_ = now_ms;
+  win_pv_ = 0;
+  win_u_ = 0;
+  win_n_ = 0;
+  samples_ = 0;
+  updates_ = 0;
+  retunes_ = 0;
+  primed_ = false;
+  running_ = true;
+}                                                                               // Завершение start
+//
+void AdaptivePid::stop() {                                                      // Остановка
+  running_ = false;                                                             // Коэффициенты остаются для сохранения в профиль
+}                                                                               // Завершение stop
+//
+bool AdaptivePid::tick(uint32_t now_ms, Q16 pv, int u) {                        // Шаг задачи регулятора
+  if (!running_) return false;
+  const int32_t v = pv.raw();
+  if (!win_n_) win_lo_ = win_hi_ = v;                                           // Размах окна — для зоны нечувствительности
+  if (v < win_lo_) win_lo_ = v;
+  if (v > win_hi_) win_hi_ = v;
+  win_pv_ += v;
+  win_u_ += static_cast<uint32_t>(u < 0 ? 0 : (u > 255 ? 255 : u));
+  ++win_n_;
+  if (now_ms - win_t0_ < kSampleMs) return false;
+  const double y = static_cast<double>(win_pv_ / win_n_ - ambient_raw_) / 65536.0 / kYScale;
+  const uint8_t uw = static_cast<uint8_t>((win_u_ + win_n_ / 2) / win_n_);      // Средняя мощность окна
+  const double trend = fabs(y - y_prev_) * kYScale;                             // Рампа за окно (по средним) — не шум
+  const double spread = (win_hi_ - win_lo_) / 65536.0 - trend;                  // Размах шума, °C
+  const double dead_c = spread * kDeadZoneSpread > kDeadZoneC ? spread * kDeadZoneSpread : kDeadZoneC;
+  win_t0_ = now_ms;
+  win_pv_ = 0;
+  win_u_ = 0;
+  win_n_ = 0;
+  const double ud = u_ring_[(u_head_ + kMaxDelay - 1 - delay_) % kMaxDelay] / kUScale;  // u[k−1−d]
+  if (!primed_) {
+    y_avg_ = y;
+    u_avg_ = ud;
+  }
+  const bool excited = fabs(y_prev_ - y_avg_) * kYScale > dead_c * kExciteDeadZones ||  // Рампа или возмущение
+                       fabs(ud - u_avg_) > kExcitePower;                        // Мощность сдвинулась
+  if (primed_ && excited) update(y, ud, dead_c);
+  y_avg_ += (y - y_avg_) / kRetuneSamples;
+  u_avg_ += (ud - u_avg_) / kRetuneSamples;
+  primed_ = true;
+  y_prev_ = y;
+  u_ring_[u_head_] = uw;
+  u_head_ = (u_head_ + 1) % kMaxDelay;
+  if (++samples_ < kWarmupSamples || samples_ % kRetuneSamples != 0) return false;
+  const bool enough = updates_ >= kMinUpdates;                                  // Было возбуждение — модели можно верить
+  updates_ = 0;
+  if (!enough) return false;
+  retune();
+  return true;
+}                                                                               // Завершение tick
+//
+void AdaptivePid::update(double y, double u, double dead_c) {                  // Шаг ограниченного МНК
+  const double e = y - (th_[0] * y_prev_ + th_[1] * u);                         // Ошибка предсказания до обновления
+  if (fabs(e) * kYScale < dead_c) return;                                       // Шум — не повод менять модель
+  double* p = p_;
+  const double pf1 = p[0] * y_prev_ + p[1] * u;                                 // P·φ
+  const double pf2 = p[1] * y_prev_ + p[2] * u;
+  const double den = kForget + y_prev_ * pf1 + u * pf2;
+  const double g1 = pf1 / den;                                                  // Коэффициент усиления МНК
+  const double g2 = pf2 / den;
+  const double a = th_[0] + g1 * e, b = th_[1] + g2 * e;
+  if (physical(a, b)) {                                                         // Проекция: нефизичный шаг отбрасывается
+    th_[0] = a;
+    th_[1] = b;
+  }
+  p[0] = (p[0] - g1 * pf1) / kForget;                                           // P = (P − g·(P·φ)ᵀ)/λ
+  p[1] = (p[1] - g1 * pf2) / kForget;
+  p[2] = (p[2] - g2 * pf2) / kForget;
+  const double tr = p[0] + p[2];
+  if (tr > kTraceMax) {                                                         // Без возбуждения P растёт как λ^−k — ограничиваем
+    for (double& v : p_) v *= kTraceMax / tr;
+  }
+  if (updates_ < 255) ++updates_;
+}                                                                               // Завершение update
+//
+StepIdentifier::Model AdaptivePid::model() const {                              // Модель в единицах печи
+  StepIdentifier::Model m{0.0, 0.0, dead_s_, false};
+  const double a = th_[0];
+  if (!physical(a, th_[1])) return m;
+  m.tau_s = -kSampleS / log(a);
+  m.gain = th_[1] * kYScale / kUScale / (1.0 - a);
+  m.valid = true;
+  return m;
+}                                                                               // Завершение model
+//
+void AdaptivePid::retune() {                                                    // Шаг коэффициентов к цели
+  StepIdentifier::Model m = model();
+  if (!m.valid) return;
+  if (has_prior_) {                                                             // Загрузка меняет теплоёмкость: τ при той же K
+    const double c = (m.tau_s / m.gain) / (prior_.tau_s / prior_.gain);
+    m = prior_;
+    m.tau_s *= c;
+  }
+  const StepIdentifier::Gains t = StepIdentifier::gains(m, StepIdentifier::kImcPid);
+  if (!t.valid) return;
+  const double imc[3] = {t.kp, t.ki, t.kd};
+  const double prior[3] = {prior_imc_.kp, prior_imc_.ki, prior_imc_.kd};
+  double* cur[3] = {&kp_, &ki_, &kd_};
+  for (uint8_t i = 0; i < 3; ++i) {
+    if (base_[i] <= 0.0) continue;                                              // Выключенную составляющую не включаем
+    double target = has_prior_ && prior[i] > 0.0 ? base_[i] * imc[i] / prior[i] : imc[i];
+    if (target > base_[i] * kMaxRatio) target = base_[i] * kMaxRatio;
+    if (target < base_[i] / kMaxRatio) target = base_[i] / kMaxRatio;
+    const double lim = base_[i] * kMaxStep;                                     // Скорость смены
+    const double step = kStep * (target - *cur[i]);
+    *cur[i] += step > lim ? lim : (step < -lim ? -lim : step);
+  }
+  ++retunes_;
+}                                                                               // Завершение retune
+//
+void AdaptivePid::gains(Q16& kp, Q24& ki, Q16& kd) const {                      // Коэффициенты для PID
+  kp = Q16::fromDouble(kp_);
+  ki = Q24::fromDouble(ki_);
+  kd = Q16::fromDouble(kd_);
+}                                                                               // Завершение gains
+//
+#ifdef TR_AUTOTUNE_SIM
+#include <stdio.h>                                                              // printf: и на устройстве, и на хосте
+#include "PIDController.h"                                                      // Замкнутый контур с регулятором прошивки
+#include "PlatformClock.h"                                                      // Такты на устройстве, нс на хосте
+//
+namespace {                                                                     // Модель печи для отладочной сборки
+//
+struct SimPlant {                                                               // Первый порядок с запаздыванием и шумом термопары
+  static constexpr uint32_t kDtMs = 100;                                        // Шаг регулятора
+  static constexpr uint32_t kMaxDelay = 1200;                                   // Наибольшее запаздывание, шагов
+  double   gain;                                                                // °C на единицу выхода
+  double   tau_s;                                                               // Постоянная времени, с
+  uint32_t delay;                                                               // Запаздывание, шагов
+  double   noise;                                                               // Размах шума, °C
+  double   temp = 25.0;                                                         // Температура печи
+  uint8_t  line[kMaxDelay] = {};                                                // Выход по пути к печи
+  uint32_t n = 0;                                                               // Номер шага
+  uint32_t seed = 12345;                                                        // Генератор шума
+//
+  Q16 step(uint8_t u) {                                                         // Шаг модели: выход → измерение
+    uint8_t late = u;
+    if (delay) {
+      late = line[n % delay];
+      line[n % delay] = u;
+    }
+    ++n;
+    temp += (gain * late - (temp - 25.0)) / tau_s * (kDtMs / 1000.0);
+    seed = seed * 1664525u + 1013904223u;
+    return Q16::fromDouble(temp + noise * ((seed >> 16) % 1001 / 1000.0 - 0.5));
+  }
+};                                                                              // Конец структуры SimPlant
+//
+// Профиль: нагрев 3 °C/мин до 300 °C, выдержка 60 мин. Коэффициенты — IMC по
+// модели профиля (prior), печь — с другой загрузкой (gain, tau_s, dead_s).
+void simulate(const StepIdentifier::Model& prior, double gain, double tau_s, double dead_s, bool adapt) {
+  constexpr uint32_t kRampMs = 92UL * 60 * 1000, kHoldMs = 60UL * 60 * 1000;
+  const StepIdentifier::Gains g0 = StepIdentifier::gains(prior, StepIdentifier::kImcPid);
+  SimPlant p{gain, tau_s, static_cast<uint32_t>(dead_s * 1000 / SimPlant::kDtMs), 0.5};
+  PIDController pid;
+  pid.setCoeffs(g0.kp, g0.ki, g0.kd);
+  pid.setFixedDt(SimPlant::kDtMs);
+  AdaptivePid ad;
+  if (adapt) ad.start(0, g0.kp, g0.ki, g0.kd, &prior, Q16(25));
+  Q16 pv = p.step(0);
+  double pv_f = pv.toDouble();                                                  // PID — по сглаженному, как за фильтром Калмана
+  double iae_ramp = 0.0, iae_hold = 0.0, over = 0.0;
+  uint32_t cost_max = 0, cost_sum = 0, cost_n = 0;
+  for (uint32_t now = 0; now < kRampMs + kHoldMs; now += SimPlant::kDtMs) {
+    const double sp = now < kRampMs ? 25.0 + 275.0 * now / kRampMs : 300.0;
+    pid.setSetpoint(sp);
+    pv_f += (pv.toDouble() - pv_f) * 0.05;                                      // Постоянная 2 с
+    const int u = pid.compute(Q16::fromDouble(pv_f));
+    if (adapt) {
+      const uint32_t c0 = platformCycles();
+      const bool changed = ad.tick(now, pv, u);                                 // Оценка — по сырому измерению
+      const uint32_t c = platformCycles() - c0;
+      cost_sum += c;
+      ++cost_n;
+      if (c > cost_max) cost_max = c;
+      if (changed) {
+        Q16 kp, kd;
+        Q24 ki;
+        ad.gains(kp, ki, kd);
+        pid.setGains(kp, ki, kd);
+      }
+    }
+    pv = p.step(static_cast<uint8_t>(u));
+    const double e = fabs(p.temp - sp) * SimPlant::kDtMs / 1000.0;
+    if (now < kRampMs) iae_ramp += e;
+    else iae_hold += e;
+    if (now >= kRampMs && p.temp - 300.0 > over) over = p.temp - 300.0;
+  }
+  printf("[ADAPT] K %.1f tau %.0f s theta %.0f s, %s: IAE ramp %.0f hold %.0f C*s, overshoot %.2f C",
+         gain, tau_s, dead_s, adapt ? "adaptive" : "fixed", iae_ramp, iae_hold, over);
+  if (adapt) {
+    const StepIdentifier::Model m = ad.model();
+    printf(", %u retunes, Kp %.3f->%.3f Ki %.5f->%.5f Kd %.2f->%.2f, model K %.2f tau %.0f s, tick avg %lu max %lu %s",
+           static_cast<unsigned>(ad.retunes()), g0.kp, ad.kp(), g0.ki, ad.ki(), g0.kd, ad.kd(), m.gain, m.tau_s,
+           static_cast<unsigned long>(cost_sum / cost_n), static_cast<unsigned long>(cost_max), kPlatformCycleUnit);
+  }
+  printf("\n");
+}                                                                               // Завершение simulate
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runAdaptiveSimulation() {                                                  // Профиль подобран на пустой печи 2 °C/ед., τ = 600 с, θ = 30 с
+  const StepIdentifier::Model prior{2.0, 600.0, 30.0, true};
+  simulate(prior, 2.0, 600.0, 30.0, false);                                     // Та же загрузка
+  simulate(prior, 2.0, 600.0, 30.0, true);                                      // Адаптация не должна мешать
+  simulate(prior, 1.6, 1500.0, 45.0, false);                                    // Тяжёлая загрузка
+  simulate(prior, 1.6, 1500.0, 45.0, true);
+  simulate(prior, 2.5, 300.0, 20.0, false);                                     // Лёгкая загрузка
+  simulate(prior, 2.5, 300.0, 20.0, true);
+}                                                                               // Завершение runAdaptiveSimulation
+#endif                                                                          // TR_AUTOTUNE_SIM
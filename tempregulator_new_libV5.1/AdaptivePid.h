@@ -0,0 +1,113 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Измерение и коэффициенты в Q16, как у PID
+#include "StepIdentifier.h"                                                     // Модель печи и правила IMC
+//
+// Адаптивная подстройка PID в работе. Масса загрузки меняет постоянную времени
+// и усиление печи от прогона к прогону, и коэффициенты профиля подходят только
+// к той загрузке, на которой их подбирали. Рядом с PID идёт оценка модели
+// y[k] = a·y[k−1] + b·u[k−1−d] по окнам kSampleMs (температура и мощность
+// усредняются, y отсчитывается от температуры цеха — холодного спая) рекурсивным
+// МНК с забыванием. Свободного члена нет намеренно: на линейном нагреве с ним
+// три параметра неразличимы, а без него наклон и смещение отклика задают и K, и τ.
+//
+// Ограничения МНК, чтобы на выдержке без возбуждения оценка не уплывала:
+//  - возбуждение: окно учитывается, только если y[k−1] ушла от скользящего
+//    среднего за минуту больше чем на kExciteDeadZones зон нечувствительности
+//    или u[k−1−d] — больше чем на kExcitePower полной мощности. На выдержке
+//    y и u стоят, регрессор вырожден (y ≈ K·u), и шум, возвращённый PID в
+//    мощность, иначе смещал бы τ вдоль невозбуждённого направления;
+//  - зона нечувствительности: окно с ошибкой предсказания меньше kDeadZoneC
+//    или kDeadZoneSpread от размаха измерений в окне (без наклона рампы) не
+//    обновляет модель — шум термопары не «обучает» её, какой бы он ни был;
+//  - след ковариации не больше начального (kTraceMax): без возбуждения
+//    забывание не раздувает усиление МНК в невозбуждённом направлении;
+//  - проекция: шаг, после которого τ или K выходят за физические пределы,
+//    отбрасывается.
+//
+// Раз в kRetuneSamples окон (после kWarmupSamples и не меньше kMinUpdates
+// обновлений за период) модель пересчитывается в коэффициенты:
+//  - есть модель профиля (ступенька, StepIdentifier) — от оценки берётся только
+//    τ/K, теплоёмкость на единицу мощности: её и меняет загрузка. Сами K и τ
+//    модель без свободного члена на печи с потерями излучением оценивает по
+//    секущей от цеха, а не по касательной, как ступенька, и их отношение к
+//    модели профиля ошибочно даже без смены загрузки. Модель профиля с τ,
+//    умноженной на отношение τ/K, пересчитывается по IMC, и исходные
+//    коэффициенты умножаются на отношение новых IMC-коэффициентов к исходным;
+//  - модели нет — цель берётся прямо по IMC.
+// Цель ограничена диапазоном [исходный / kMaxRatio, исходный · kMaxRatio]
+// (нулевой исходный коэффициент остаётся нулём), а текущие коэффициенты
+// делают к ней шаг kStep, но не больше kMaxStep исходного за подстройку —
+// от края до края диапазона не быстрее получаса. Смена плавная, скачок
+// выхода снимает setGains().
+//
+// tick() вызывается в задаче регулятора: на каждом шаге — два сложения и два
+// сравнения в целых; на границе окна — шаг МНК 2×2 в double (раз в 2 с), раз
+// в минуту — пересчёт коэффициентов. Кучи нет: задержка выхода — кольцо на
+// kMaxDelay окон.
+class AdaptivePid {                                                             // Адаптивная подстройка коэффициентов
+public:                                                                         // Публичный интерфейс
+  static constexpr uint32_t kSampleMs = 2000;                                   // Окно усреднения и шаг МНК
+  static constexpr uint8_t  kMaxDelay = 64;                                     // Наибольшее запаздывание, окон
+  static constexpr uint16_t kWarmupSamples = 150;                               // Окон до первой подстройки (5 мин)
+  static constexpr uint8_t  kRetuneSamples = 30;                                // Окон между подстройками (1 мин)
+  static constexpr uint8_t  kMinUpdates = 10;                                   // Обновлений модели за период для подстройки
+  static constexpr double   kForget = 0.9995;                                   // Забывание: память ~2000 окон (67 мин)
+  static constexpr double   kTraceMax = 2.0;                                    // Наибольший след ковариации (= начальный)
+  static constexpr double   kDeadZoneC = 0.01;                                  // Зона нечувствительности, °C
+  static constexpr double   kDeadZoneSpread = 0.125;                            // Она же от размаха шума в окне: ~2 ошибки среднего
+  static constexpr double   kExciteDeadZones = 4.0;                             // Уход y от среднего для обновления, зон
+  static constexpr double   kExcitePower = 0.03;                                // Уход u от среднего для обновления, доля полной
+  static constexpr double   kMaxRatio = 1.5;                                    // Наибольшее отклонение от исходных коэффициентов
+  static constexpr double   kStep = 0.2;                                        // Доля пути к цели за подстройку,
+  static constexpr double   kMaxStep = 0.03;                                    // но не больше этой доли исходного
+  static constexpr double   kDefaultDeadS = 20.0;                               // Запаздывание без модели профиля, с
+//
+  void start(uint32_t now_ms, double kp, double ki, double kd,                  // Исходные коэффициенты,
+             const StepIdentifier::Model* prior, Q16 ambient);                  // модель профиля и температура цеха
+  void stop();                                                                  // Остановка; коэффициенты сохраняются
+  bool tick(uint32_t now_ms, Q16 pv, int u);                                    // Шаг: true — коэффициенты изменились
+//
+  bool     running() const { return running_; }                                 // Подстройка идёт
+  uint16_t retunes() const { return retunes_; }                                 // Подстроек с запуска
+  double   kp() const { return kp_; }                                           // Текущие коэффициенты
+  double   ki() const { return ki_; }
+  double   kd() const { return kd_; }
+  void     gains(Q16& kp, Q24& ki, Q16& kd) const;                              // То же в типах PID
+  StepIdentifier::Model model() const;                                          // Текущая оценка модели печи
+//
+private:                                                                        // Внутреннее состояние
+  void update(double y, double u, double dead_c);                               // Шаг МНК по окну с зоной dead_c, °C
+  void retune();                                                                // Пересчёт коэффициентов по модели
+//
+  bool     running_ = false;                                                    // Подстройка идёт
+  bool     primed_ = false;                                                     // Есть предыдущее окно
+  bool     has_prior_ = false;                                                  // Есть модель профиля
+  StepIdentifier::Model prior_{};                                               // Модель профиля
+  StepIdentifier::Gains prior_imc_{};                                           // IMC-коэффициенты модели профиля
+  double   base_[3] = {};                                                       // Исходные Kp, Ki, Kd
+  double   kp_ = 0.0, ki_ = 0.0, kd_ = 0.0;                                     // Текущие коэффициенты
+  double   th_[2] = {};                                                         // a, b (нормированные y/100, u/255)
+  double   p_[3] = {};                                                          // Ковариация: p11 p12 p22
+  int32_t  ambient_raw_ = 0;                                                    // Температура цеха, Q16
+  double   y_prev_ = 0.0;                                                       // Предыдущее окно, нормированное
+  double   y_avg_ = 0.0, u_avg_ = 0.0;                                          // Скользящие средние y и u[k−1−d] за ~kRetuneSamples окон
+  double   dead_s_ = kDefaultDeadS;                                             // Запаздывание, с
+  uint8_t  delay_ = 0;                                                          // Запаздывание, окон
+  uint8_t  u_ring_[kMaxDelay] = {};                                             // Мощность прошлых окон
+  uint8_t  u_head_ = 0;                                                         // Следующая запись в кольце
+  uint32_t win_t0_ = 0;                                                         // Начало текущего окна
+  int64_t  win_pv_ = 0;                                                         // Сумма измерений окна, Q16
+  uint32_t win_u_ = 0;                                                          // Сумма мощности окна
+  uint16_t win_n_ = 0;                                                          // Шагов в окне
+  int32_t  win_lo_ = 0, win_hi_ = 0;                                            // Наименьшее и наибольшее в окне, Q16
+  uint32_t samples_ = 0;                                                        // Окон с запуска
+  uint8_t  updates_ = 0;                                                        // Обновлений модели за период
+  uint16_t retunes_ = 0;                                                        // Подстроек с запуска
+};                                                                              // Конец определения класса AdaptivePid
+//
+#ifdef TR_AUTOTUNE_SIM                                                          // Отладочная сборка: моделирование на печи первого порядка
+void runAdaptiveSimulation();                                                   // Постоянные и адаптивные коэффициенты, стоимость tick()
+#endif                                                                          // TR_AUTOTUNE_SIM
@@ -0,0 +1,282 @@
+#include "AdcSampler.h"                                                         // Объявление класса фоновой выборки
+//
+#ifdef ARDUINO                                                                  // На целевой платформе используем аппаратный АЦП и esp_timer
+#include <Arduino.h>                                                            // analogRead
+#include "esp_timer.h"                                                          // Периодический таймер ESP-IDF
+#endif                                                                          // ARDUINO
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+constexpr uint32_t kValidFlag = 0x80000000UL;                                   // Бит «снимок валиден»
+static_assert(AdcSampler::kMainsSamples <= 32, "outlier mask is 32-bit");       // Маска выбросов периода в одном слове
+//
+#ifdef ARDUINO
+uint16_t arduinoRead(uint8_t pin) {                                             // Источник по умолчанию — встроенный АЦП
+  return static_cast<uint16_t>(analogRead(pin));                                // Одно чтение без задержек
+}                                                                               // Завершение arduinoRead
+#endif                                                                          // ARDUINO
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int8_t AdcSampler::addChannel(uint8_t pin) {                                    // Регистрация дополнительного канала
+  if (timer_ || count_ >= kMaxChannels) {                                       // После запуска или сверх лимита нельзя
+    return -1;                                                                  // Сообщаем об ошибке
+  }                                                                             // Конец проверки
+  ch_[count_].pin = pin;                                                        // Запоминаем вход
+  return static_cast<int8_t>(count_++);                                         // Номер нового канала
+}                                                                               // Завершение addChannel
+//
+bool AdcSampler::begin(uint8_t pin, uint32_t period_us) {                       // Запуск фоновой выборки
+  ch_[0].pin = pin;                                                             // Основной вход
+#ifdef ARDUINO
+  if (!read_) {                                                                 // Если источник не подменён
+    read_ = arduinoRead;                                                        // Используем analogRead
+  }                                                                             // Конец выбора источника
+#endif                                                                          // ARDUINO
+  if (!read_) {                                                                 // Без источника работать нечем
+    return false;                                                               // Сообщаем об ошибке
+  }                                                                             // Конец проверки
+  for (size_t i = 0; i < kWindow * count_; ++i) {                               // Один раз заполняем окна синхронно,
+    sampleOnce();                                                               // чтобы первое чтение сразу было валидным
+  }                                                                             // Конец первичного заполнения
+  median_period_us_ = period_us;                                                // Период режима медианы
+  return restartTimer(mode_ == Mode::Median ? median_period_us_ : period_us_);  // Запускаем таймер текущего режима
+}                                                                               // Завершение begin
+//
+bool AdcSampler::restartTimer(uint32_t period_us) {                             // (Пере)запуск периодического таймера
+  period_us_ = period_us;                                                       // Запоминаем период канала
+#ifdef ARDUINO
+  const uint32_t tick_us = period_us / count_;                                  // Тик опрашивает один канал
+  esp_timer_handle_t h = static_cast<esp_timer_handle_t>(timer_);               // Существующий таймер (если есть)
+  if (!h) {                                                                     // Таймер ещё не создан
+    const esp_timer_create_args_t args = { .callback = &AdcSampler::timerCallback,
+                                           .arg = this,
+                                           .dispatch_method = ESP_TIMER_TASK,
+                                           .name = "adc_sampler" };             // Параметры таймера выборки
+    if (esp_timer_create(&args, &h) != ESP_OK) {                                // Создаём таймер
+      return false;                                                             // Без таймера остаёмся на синхронном окне
+    }                                                                           // Конец проверки создания
+    timer_ = h;                                                                 // Сохраняем дескриптор
+  } else {                                                                      // Таймер уже работает
+    esp_timer_stop(h);                                                          // Останавливаем перед сменой периода
+  }                                                                             // Конец проверки существования
+  if (esp_timer_start_periodic(h, tick_us) != ESP_OK) {                         // Запускаем периодический вызов
+    return false;                                                               // Сообщаем об ошибке
+  }                                                                             // Конец проверки запуска
+#endif                                                                          // ARDUINO
+  return true;                                                                  // Таймер запущен
+}                                                                               // Завершение restartTimer
+//
+void AdcSampler::end() {                                                        // Остановка фоновой выборки
+#ifdef ARDUINO
+  if (timer_) {                                                                 // Если таймер был создан
+    esp_timer_handle_t h = static_cast<esp_timer_handle_t>(timer_);             // Восстанавливаем тип дескриптора
+    esp_timer_stop(h);                                                          // Останавливаем
+    esp_timer_delete(h);                                                        // Удаляем
+  }                                                                             // Конец проверки таймера
+#endif                                                                          // ARDUINO
+  timer_ = nullptr;                                                             // Таймера больше нет
+}                                                                               // Завершение end
+//
+void AdcSampler::setReadFunction(ReadFn fn) {                                   // Подмена источника отсчётов
+  read_ = fn;                                                                   // Следующие отсчёты берутся из fn
+}                                                                               // Завершение setReadFunction
+//
+void AdcSampler::setMode(Mode mode, uint8_t mains_hz, bool ssr_sync) {          // Выбор режима выборки
+  if (mains_hz != 50 && mains_hz != 60) {                                       // Поддерживаются только стандартные сети
+    mains_hz = 50;                                                              // По умолчанию 50 Гц
+  }                                                                             // Конец проверки частоты
+  const uint32_t period = (mode == Mode::MainsIntegrate)                        // Период канала для режима
+      ? (1000000UL / mains_hz + kMainsSamples / 2) / kMainsSamples              // kMainsSamples отсчётов ровно на период сети
+      : median_period_us_;                                                      // Прежний период для медианы
+  mode_ = mode;                                                                 // Запоминаем режим
+  ssr_sync_ = ssr_sync;                                                         // И синхронизацию с SSR
+  for (uint8_t i = 0; i < count_; ++i) {                                        // Для каждого канала
+    resetMains(ch_[i]);                                                         // Интегрирование начинаем с чистого периода
+    ch_[i].mains_have_ref = false;                                              // Опору для выбросов получаем заново
+  }                                                                             // Конец цикла по каналам
+  if (timer_ || period_us_ != 0) {                                              // Выборка уже запущена
+    restartTimer(period);                                                       // Применяем новый период
+  } else {                                                                      // Ещё до begin()
+    period_us_ = period;                                                        // Период применится при запуске
+  }                                                                             // Конец проверки запуска
+}                                                                               // Завершение setMode
+//
+void AdcSampler::setMedianPeriod(uint32_t period_us) {                          // Смена частоты выборки на ходу
+  median_period_us_ = period_us;                                                // Запоминаем для режима Median
+  if (mode_ != Mode::Median || period_us == period_us_) {                       // В MainsIntegrate период задан сетью
+    return;                                                                     // Применится при возврате в Median
+  }                                                                             // Конец проверки
+  if (timer_ || period_us_ != 0) {                                              // Выборка уже запущена
+    restartTimer(period_us);                                                    // Окно медианы не сбрасываем: отсчёты остаются валидны
+  }                                                                             // Конец проверки запуска
+}                                                                               // Завершение setMedianPeriod
+//
+void AdcSampler::notifySsrEdge() {                                              // Фронт SSR из таймера SsrOutput
+  if (!ssr_sync_) {                                                             // Только при включённой синхронизации
+    return;                                                                     // Ничего не делаем
+  }                                                                             // Конец проверки
+  for (uint8_t i = 0; i < count_; ++i) {                                        // Наводка от фронта задевает все каналы
+    ch_[i].ssr_edge = true;                                                     // Обработается в задаче таймера
+  }                                                                             // Конец цикла по каналам
+}                                                                               // Завершение notifySsrEdge
+//
+void AdcSampler::timerCallback(void* arg) {                                     // Вызывается esp_timer в своей задаче
+  static_cast<AdcSampler*>(arg)->sampleOnce();                                  // Один отсчёт за тик
+}                                                                               // Завершение timerCallback
+//
+void AdcSampler::sampleOnce() {                                                 // Снять и обработать один отсчёт
+  if (!read_) {                                                                 // Нет источника
+    return;                                                                     // Ничего не делаем
+  }                                                                             // Конец проверки
+  const uint8_t ch = next_;                                                     // Канал этого тика
+  ++ticks_;                                                                     // Учитываем тик
+  pushSample(ch, read_(ch_[ch].pin));                                           // Читаем и добавляем в окно
+  next_ = (ch + 1 >= count_) ? 0 : ch + 1;                                      // Следующий канал по кругу
+  if (next_ == 0) {                                                             // Круг завершён
+    publishFrame();                                                             // Публикуем кадр всех каналов
+  }                                                                             // Конец проверки круга
+}                                                                               // Завершение sampleOnce
+//
+void AdcSampler::pushSample(uint8_t ch, uint16_t raw) {                         // Добавление отсчёта в окно канала
+  if (ch >= count_) {                                                           // Нет такого канала
+    return;                                                                     // Игнорируем
+  }                                                                             // Конец проверки
+  Channel& c = ch_[ch];                                                         // Состояние канала
+  c.samples = c.samples + 1;                                                    // Учитываем отсчёт
+  c.rail = raw >= kRailRaw;                                                     // Обрыв виден по первому же отсчёту, до медианы
+  if (mode_ == Mode::MainsIntegrate) {                                          // Режим интегрирования по периоду сети
+    pushMains(c, raw);                                                          // Отдельный путь за O(1)
+    return;                                                                     // Медиану не трогаем
+  }                                                                             // Конец проверки режима
+  c.filter.push(raw);                                                           // Инкрементное обновление медианы, без кучи
+  publish(c);                                                                   // Обновляем опубликованный результат
+}                                                                               // Завершение pushSample
+//
+void AdcSampler::resetMains(Channel& c) {                                       // Новый период интегрирования
+  c.mains_head = 0;                                                             // Пишем с начала
+  c.mains_count = 0;                                                            // Период пуст
+  c.mains_sum = 0;                                                              // Сумма пуста
+  c.mains_outlier_bits = 0;                                                     // Выбросов нет
+  c.mains_outliers = 0;                                                         // Счётчик выбросов пуст
+}                                                                               // Завершение resetMains
+//
+void AdcSampler::pushMains(Channel& c, uint16_t raw) {                          // Скользящее интегрирование по периоду сети
+  if (c.ssr_edge) {                                                             // Был фронт SSR — переходный процесс в окне
+    c.ssr_edge = false;                                                         // Флаг обработан
+    resetMains(c);                                                              // Начинаем период после фронта
+  }                                                                             // Конец обработки фронта
+  const int diff = (int)raw - (int)c.mains_ref;                                 // Отклонение от среднего прошлого периода
+  const bool outlier = c.mains_have_ref && (diff > kMainsOutlierThreshold || -diff > kMainsOutlierThreshold);  // Выброс?
+  const uint16_t v = outlier ? c.mains_ref : raw;                               // Выброс заменяем опорным значением
+  const uint32_t bit = 1UL << c.mains_head;                                     // Бит текущей позиции
+  if (c.mains_count == kMainsSamples) {                                         // Период полон — вытесняем старый отсчёт
+    c.mains_sum -= c.mains_ring[c.mains_head];                                  // Убираем из суммы
+    if (c.mains_outlier_bits & bit) {                                           // Он был выбросом
+      --c.mains_outliers;                                                       // Уменьшаем счётчик
+    }                                                                           // Конец проверки
+  } else {                                                                      // Период ещё набирается
+    ++c.mains_count;                                                            // Увеличиваем размер
+  }                                                                             // Конец проверки заполнения
+  c.mains_ring[c.mains_head] = v;                                               // Запоминаем отсчёт
+  c.mains_sum += v;                                                             // Добавляем в сумму
+  if (outlier) {                                                                // Новый выброс
+    c.mains_outlier_bits |= bit;                                                // Отмечаем в маске
+    ++c.mains_outliers;                                                         // Учитываем
+  } else {                                                                      // Обычный отсчёт
+    c.mains_outlier_bits &= ~bit;                                               // Снимаем отметку
+  }                                                                             // Конец учёта выбросов
+  c.mains_head = (c.mains_head + 1 == kMainsSamples) ? 0 : c.mains_head + 1;    // Сдвигаем позицию записи
+  if (c.mains_count < kMainsSamples) {                                          // После сброса период ещё не набран
+    return;                                                                     // Оставляем прошлое опубликованное значение
+  }                                                                             // Конец проверки
+  const uint16_t mean = static_cast<uint16_t>(c.mains_sum / kMainsSamples);     // Среднее за ровно один период сети
+  c.mains_ref = mean;                                                           // Новая опора для выбросов
+  c.mains_have_ref = true;                                                      // Опора получена
+  if (c.mains_head == 0) {                                                      // Закончился очередной период
+    completeWindow(c, c.mains_outliers);                                        // Учитываем окно
+  }                                                                             // Конец проверки
+  publish(c, mean, c.mains_outliers);                                           // Публикуем
+}                                                                               // Завершение pushMains
+//
+void AdcSampler::publish(Channel& c) {                                          // Медиана + среднее по невыбросам
+  uint8_t outliers = 0;                                                         // Количество выбросов в окне
+  const uint16_t value = c.filter.filtered(outliers);                           // Среднее отсчётов в допуске от медианы
+  if (c.filter.wrapped()) {                                                     // Окно прошло полный круг
+    completeWindow(c, outliers);                                                // Ещё одно полностью новое окно
+  }                                                                             // Конец проверки круга
+  publish(c, value, outliers);                                                  // Публикуем
+}                                                                               // Завершение publish
+//
+void AdcSampler::publish(Channel& c, uint16_t value, uint8_t outliers) {        // Упаковка и публикация снимка
+  c.published = kValidFlag | (static_cast<uint32_t>(outliers) << 16) | value;   // Атомарная запись одного 32-битного слова
+}                                                                               // Завершение publish
+//
+void AdcSampler::completeWindow(Channel& c, uint8_t outliers) {                 // Завершено очередное окно канала
+  c.windows = c.windows + 1;                                                    // Счётчик окон
+  c.outlier_total = c.outlier_total + outliers;                                 // Накопленные выбросы
+  if (outliers > c.max_outliers) {                                              // Новый максимум
+    c.max_outliers = outliers;                                                  // Запоминаем
+  }                                                                             // Конец проверки
+}                                                                               // Завершение completeWindow
+//
+void AdcSampler::publishFrame() {                                               // Кадр после полного круга опроса
+  const uint32_t seq = frame_seq_ + 1;                                          // Номер нового кадра
+  Frame& f = frames_[seq & 1];                                                  // Пишем в неактивную половину буфера
+  f.seq = seq;                                                                  // Номер
+#ifdef ARDUINO
+  f.t_us = static_cast<uint32_t>(esp_timer_get_time());                         // Монотонное время, мкс
+#else
+  f.t_us = ticks_ * (period_us_ / count_);                                      // На хосте время считаем по тикам
+#endif                                                                          // ARDUINO
+  f.count = count_;                                                             // Число каналов
+  for (uint8_t i = 0; i < count_; ++i) {                                        // Снимки каналов
+    const uint32_t snap = ch_[i].published;                                     // Одно атомарное чтение
+    f.adc[i] = static_cast<uint16_t>(snap & 0xFFFF);                            // Значение АЦП
+    f.outliers[i] = static_cast<uint8_t>((snap >> 16) & 0xFF);                  // Выбросы
+  }                                                                             // Конец цикла по каналам
+  frame_seq_ = seq;                                                             // Публикуем номер — кадр готов
+}                                                                               // Завершение publishFrame
+//
+bool AdcSampler::readFrame(Frame& out) const {                                  // Чтение последнего кадра
+  for (int attempt = 0; attempt < 4; ++attempt) {                               // Повторяем, если писатель обогнал
+    const uint32_t seq = frame_seq_;                                            // Номер актуального кадра
+    if (seq == 0) {                                                             // Кадров ещё не было
+      return false;                                                             // Нечего читать
+    }                                                                           // Конец проверки
+    out = frames_[seq & 1];                                                     // Копируем кадр
+    if (frame_seq_ - seq < 2 && out.seq == seq) {                               // Половину не успели переписать
+      return true;                                                              // Кадр целостный
+    }                                                                           // Конец проверки
+  }                                                                             // Конец попыток
+  return false;                                                                 // Не удалось прочитать целостный кадр
+}                                                                               // Завершение readFrame
+//
+bool AdcSampler::ready(uint8_t ch) const {                                      // Есть ли валидный снимок
+  return ch < count_ && (ch_[ch].published & kValidFlag) != 0;                  // Проверяем флаг
+}                                                                               // Завершение ready
+//
+uint16_t AdcSampler::latest(uint8_t ch, uint8_t& out_outliers) const {          // Чтение последнего снимка за O(1)
+  const uint32_t snap = ch < count_ ? ch_[ch].published : 0;                    // Одно атомарное чтение
+  out_outliers = static_cast<uint8_t>((snap >> 16) & 0xFF);                     // Выбросы в последнем окне
+  return static_cast<uint16_t>(snap & 0xFFFF);                                  // Отфильтрованное значение АЦП
+}                                                                               // Завершение latest
+//
+uint32_t AdcSampler::windowCount(uint8_t ch) const {                            // Число полных окон канала
+  return ch < count_ ? ch_[ch].windows : 0;                                     // Для несуществующего канала — ноль
+}                                                                               // Завершение windowCount
+//
+uint32_t AdcSampler::sampleCount(uint8_t ch) const {                            // Число отсчётов канала
+  return ch < count_ ? ch_[ch].samples : 0;                                     // Для несуществующего канала — ноль
+}                                                                               // Завершение sampleCount
+//
+AdcSampler::ChannelStats AdcSampler::stats(uint8_t ch) const {                  // Снимок статистики канала
+  ChannelStats s;                                                               // Результат
+  if (ch < count_) {                                                            // Канал существует
+    s.windows = ch_[ch].windows;                                                // Окна
+    s.samples = ch_[ch].samples;                                                // Отсчёты
+    s.outlier_total = ch_[ch].outlier_total;                                    // Выбросы
+    s.max_outliers = ch_[ch].max_outliers;                                      // Максимум в окне
+  }                                                                             // Конец проверки
+  return s;                                                                     // Готово
+}                                                                               // Завершение stats
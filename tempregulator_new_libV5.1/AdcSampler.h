@@ -0,0 +1,126 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "MedianFilter.h"                                                       // Скользящая медиана без кучи
+//
+// Фоновый сборщик отсчётов АЦП термопары. Периодический таймер кладёт по одному
+// отсчёту в скользящий медианный фильтр и сразу публикует отфильтрованное значение,
+// поэтому управляющий цикл получает последнюю температуру за O(1) без delay().
+// На хосте таймер не запускается: отсчёты подаются через setReadFunction()
+// + sampleOnce() или напрямую через pushSample().
+//
+// Режим MainsIntegrate усредняет ровно kMainsSamples отсчётов на один период
+// сети (50/60 Гц): сетевая наводка и её гармоники интегрируются в ноль. При
+// включённой синхронизации с SSR окно, в которое попал фронт реле, отбрасывается
+// и интегрирование начинается заново после фронта.
+//
+// Каналы опрашиваются по кругу, по одному отсчёту за тик таймера; период тика
+// делится на число каналов, так что частота выборки каждого канала не зависит
+// от их количества. После каждого полного круга публикуется кадр — значения
+// всех каналов с общей меткой времени. Управляющий цикл только читает готовые
+// снимки, поэтому добавление каналов не удлиняет его период.
+class AdcSampler {                                                              // Класс фоновой выборки АЦП
+public:                                                                         // Публичный интерфейс
+  using ReadFn = uint16_t (*)(uint8_t pin);                                     // Источник сырого отсчёта (analogRead или заглушка)
+//
+  enum class Mode : uint8_t {                                                   // Способ получения значения
+    Median = 0,                                                                 // Скользящая медиана + среднее невыбросов
+    MainsIntegrate = 1,                                                         // Интегрирование по целому периоду сети
+  };                                                                            // Конец перечисления Mode
+//
+  static constexpr size_t   kWindow         = 21;                               // Размер окна фильтра (как прежний пакет из 21 чтения)
+  static constexpr uint16_t kOutlierThreshold = 50;                             // Допустимое отклонение от медианы, единиц АЦП
+  static constexpr size_t   kMainsSamples   = 20;                               // Отсчётов на период сети в режиме MainsIntegrate
+  static constexpr uint16_t kMainsOutlierThreshold = 400;                       // Отклонение от среднего прошлого периода, выше которого отсчёт — выброс
+  static constexpr size_t   kMaxChannels    = 3;                                // Нагрузка, стенка камеры, защитный датчик
+  static constexpr uint16_t kRailRaw       = 4080;                              // 12-битный АЦП у верхней границы: обрыв (усилитель ушёл в насыщение)
+//
+  struct Frame {                                                                // Снимок всех каналов за один круг опроса
+    uint32_t seq = 0;                                                           // Номер кадра
+    uint32_t t_us = 0;                                                          // Время завершения круга, мкс
+    uint8_t  count = 0;                                                         // Число каналов в кадре
+    uint16_t adc[kMaxChannels] = {};                                            // Отфильтрованные значения АЦП
+    uint8_t  outliers[kMaxChannels] = {};                                       // Выбросы в текущем окне канала
+  };                                                                            // Конец структуры Frame
+//
+  struct ChannelStats {                                                         // Накопленная статистика выбросов канала
+    uint32_t windows = 0;                                                       // Число полностью обновлённых окон
+    uint32_t samples = 0;                                                       // Число отсчётов
+    uint32_t outlier_total = 0;                                                 // Сумма выбросов по завершённым окнам
+    uint8_t  max_outliers = 0;                                                  // Наибольшее число выбросов в одном окне
+  };                                                                            // Конец структуры ChannelStats
+//
+  int8_t addChannel(uint8_t pin);                                               // Добавить канал до begin(); возвращает его номер или -1
+  bool begin(uint8_t pin, uint32_t period_us);                                  // Канал 0 на pin; заполнить окна и запустить таймер
+  void end();                                                                   // Остановить таймер
+  void setReadFunction(ReadFn fn);                                              // Подменить источник отсчётов (хост/отладка)
+  void setMode(Mode mode, uint8_t mains_hz, bool ssr_sync);                     // Выбрать режим; период таймера пересчитывается
+  void setMedianPeriod(uint32_t period_us);                                     // Период канала в режиме Median (адаптивная частота)
+  Mode mode() const { return mode_; }                                           // Текущий режим
+  uint32_t periodUs() const { return period_us_; }                              // Период выборки одного канала, мкс
+  void notifySsrEdge();                                                         // Сообщить о переключении SSR (для синхронизации окна)
+//
+  void sampleOnce();                                                            // Снять один отсчёт очередного канала и обработать его
+  void pushSample(uint16_t raw) { pushSample(0, raw); }                         // Добавить готовый отсчёт канала 0
+  void pushSample(uint8_t ch, uint16_t raw);                                    // Добавить готовый отсчёт канала ch
+//
+  bool     ready() const { return ready(0); }                                   // Окно канала 0 заполнено хотя бы один раз
+  bool     ready(uint8_t ch) const;                                             // То же для канала ch
+  uint16_t latest(uint8_t& out_outliers) const { return latest(0, out_outliers); }  // Последнее значение канала 0, O(1)
+  uint16_t latest(uint8_t ch, uint8_t& out_outliers) const;                     // Последнее значение канала ch, O(1)
+  uint32_t windowCount(uint8_t ch = 0) const;                                   // Число полностью обновлённых окон канала (медиана: kWindow отсчётов, сеть: период)
+  uint32_t sampleCount(uint8_t ch = 0) const;                                   // Число обработанных отсчётов канала
+  ChannelStats stats(uint8_t ch) const;                                         // Статистика выбросов канала
+  bool     openCircuit(uint8_t ch = 0) const { return ch < count_ && ch_[ch].rail; } // Последний сырой отсчёт у верхней границы
+  uint8_t  channelCount() const { return count_; }                              // Число каналов
+  uint8_t  channelPin(uint8_t ch) const { return ch < count_ ? ch_[ch].pin : 0; }  // Вход канала
+//
+  bool     readFrame(Frame& out) const;                                         // Последний кадр; false — кадров ещё не было
+  uint32_t frameCount() const { return frame_seq_; }                            // Число опубликованных кадров
+//
+private:                                                                        // Внутреннее состояние
+  struct Channel {                                                              // Состояние одного канала
+    uint8_t  pin = 0;                                                           // Аналоговый вход
+    SlidingMedianFilter<kWindow, kOutlierThreshold> filter;                     // Окно отсчётов с инкрементной медианой
+    volatile bool ssr_edge = false;                                             // Фронт SSR произошёл, окно нужно начать заново
+    uint16_t mains_ring[kMainsSamples]{};                                       // Отсчёты текущего периода сети
+    uint32_t mains_outlier_bits = 0;                                            // Битовая маска выбросов в mains_ring
+    uint32_t mains_sum = 0;                                                     // Сумма отсчётов в mains_ring
+    uint8_t  mains_head = 0;                                                    // Позиция записи в mains_ring
+    uint8_t  mains_count = 0;                                                   // Число отсчётов с начала периода (до kMainsSamples)
+    uint8_t  mains_outliers = 0;                                                // Число выбросов в mains_ring
+    uint16_t mains_ref = 0;                                                     // Среднее прошлого периода — опора для выбросов
+    bool     mains_have_ref = false;                                            // Опора уже получена
+    volatile uint32_t published = 0;                                            // Упакованный снимок: [31] valid | [23:16] выбросы | [15:0] АЦП
+    volatile uint32_t windows = 0;                                              // Счётчик полных окон
+    volatile uint32_t samples = 0;                                              // Счётчик отсчётов
+    volatile uint32_t outlier_total = 0;                                        // Сумма выбросов по завершённым окнам
+    volatile uint8_t  max_outliers = 0;                                         // Максимум выбросов в окне
+    volatile bool     rail = false;                                             // Последний сырой отсчёт >= kRailRaw
+  };                                                                            // Конец структуры Channel
+//
+  static void timerCallback(void* arg);                                         // Колбэк периодического таймера
+  void publish(Channel& c);                                                     // Опубликовать снимок медианного окна
+  void publish(Channel& c, uint16_t value, uint8_t outliers);                   // Опубликовать готовое значение
+  void completeWindow(Channel& c, uint8_t outliers);                            // Учёт завершённого окна в статистике
+  void pushMains(Channel& c, uint16_t raw);                                     // Шаг интегратора по периоду сети
+  static void resetMains(Channel& c);                                           // Начать период интегрирования заново
+  void publishFrame();                                                          // Опубликовать кадр после полного круга
+  bool restartTimer(uint32_t period_us);                                        // Перезапустить таймер с новым периодом канала
+//
+  Channel  ch_[kMaxChannels];                                                   // Каналы; 0 — основная термопара
+  uint8_t  count_ = 1;                                                          // Число каналов (канал 0 есть всегда)
+  uint8_t  next_ = 0;                                                           // Канал следующего тика
+  Mode     mode_ = Mode::Median;                                                // Текущий режим
+  uint32_t period_us_ = 0;                                                      // Период выборки одного канала
+  uint32_t median_period_us_ = 0;                                               // Период для режима Median (из begin)
+  bool     ssr_sync_ = false;                                                   // Отбрасывать окна с фронтом SSR
+  ReadFn   read_ = nullptr;                                                     // Текущий источник отсчётов
+  void*    timer_ = nullptr;                                                    // Дескриптор esp_timer (nullptr на хосте)
+  uint32_t ticks_ = 0;                                                          // Число тиков (время на хосте)
+//
+  Frame    frames_[2];                                                          // Двойной буфер кадров
+  volatile uint32_t frame_seq_ = 0;                                             // Номер последнего кадра; frames_[seq & 1] — актуальный
+};                                                                              // Конец определения класса AdcSampler
@@ -0,0 +1,49 @@
+#include "AutotuneSession.h"                                                    // Объявление класса
+//
+void AutotuneSession::start(uint32_t now_ms, Q16 target, Q16 hyst, Q16 pv) {    // Запуск выбранным способом
+  rule_ = 0;
+  started_ = true;
+  t0_ = now_ms;
+  if (method_ == kStep) step_.start(now_ms, target, kStepPower);
+  else relay_.start(now_ms, target, hyst, pv);
+}                                                                               // Завершение start
+//
+void AutotuneSession::stop() {                                                  // Остановка без результата
+  relay_.stop();
+  step_.stop();
+}                                                                               // Завершение stop
+//
+uint8_t AutotuneSession::tick(uint32_t now_ms, Q16 pv) {                        // Мощность на выход
+  if (relay_.running()) return relay_.tick(now_ms, pv) ? 255 : 0;
+  if (step_.running()) return step_.tick(now_ms, pv);
+  return 0;
+}                                                                               // Завершение tick
+//
+AutotuneSession::Outcome AutotuneSession::poll(uint32_t now_ms) const {         // Исход для задачи UI
+  if (!started_) return Outcome::Idle;
+  const bool by_step = method_ == kStep;
+  const bool converged = by_step ? step_.converged() : relay_.converged();
+  const bool running = by_step ? step_.running() : relay_.running();
+  if (!running && !converged) {                                                 // Ступенька упёрлась в предел или нагрев снят аварией
+    return by_step && step_.limitReached() ? Outcome::LimitReached : Outcome::Stopped;
+  }
+  if (converged) return Outcome::Converged;
+  if (now_ms - t0_ > kTimeoutMs) return Outcome::TimedOut;
+  return Outcome::Running;
+}                                                                               // Завершение poll
+//
+void AutotuneSession::selectRule(int delta) {                                   // Перебор правил по кругу
+  const int n = method_ == kStep ? static_cast<int>(StepIdentifier::kTuningCount)
+                                 : static_cast<int>(RelayAutotune::kRuleCount);
+  rule_ = static_cast<uint8_t>((rule_ + delta % n + n) % n);
+}                                                                               // Завершение selectRule
+//
+RelayAutotune::Gains AutotuneSession::gains() const {                           // Коэффициенты выбранного правила
+  if (method_ == kStep) return StepIdentifier::gains(step_.model(), static_cast<StepIdentifier::Tuning>(rule_));
+  return relay_.gains(static_cast<RelayAutotune::Rule>(rule_));
+}                                                                               // Завершение gains
+//
+const char* AutotuneSession::ruleName() const {                                 // Название для экрана
+  return method_ == kStep ? StepIdentifier::tuningName(static_cast<StepIdentifier::Tuning>(rule_))
+                          : RelayAutotune::ruleName(static_cast<RelayAutotune::Rule>(rule_));
+}                                                                               // Завершение ruleName
@@ -0,0 +1,61 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+#include "RelayAutotune.h"                                                      // Релейные автоколебания
+#include "StepIdentifier.h"                                                     // Ступенька мощности
+//
+// Сеанс автонастройки PID без интерфейса: выбранный способ (реле или
+// ступенька мощности), время запуска, исход и правило пересчёта в
+// коэффициенты. tick() вызывается в задаче регулятора и выдаёт мощность;
+// poll() и gains() — в задаче UI под ControlScheduler::Lock. TempRegulator
+// по исходу строит экраны, а сам сеанс собирается и проверяется на ПК.
+class AutotuneSession {                                                         // Сеанс автонастройки
+public:                                                                         // Публичный интерфейс
+  enum Method : uint8_t {                                                       // Способ автонастройки
+    kRelay = 0,                                                                 // Релейные автоколебания вокруг цели
+    kStep,                                                                      // Ступенька мощности и модель первого порядка
+  };                                                                            // Конец перечисления Method
+//
+  enum class Outcome : uint8_t {                                                // Исход для задачи UI
+    Idle,                                                                       // Не запускался
+    Running,                                                                    // Идёт
+    Converged,                                                                  // Результат готов: выбор правила
+    LimitReached,                                                               // Ступенька дошла до предела раньше модели
+    Stopped,                                                                    // Прервано (авария, стоп)
+    TimedOut,                                                                   // Не сошлось за kTimeoutMs
+  };                                                                            // Конец перечисления Outcome
+//
+  static constexpr uint32_t kTimeoutMs = 60UL * 60 * 1000;                      // Разогрев и не меньше двух согласованных периодов
+  static constexpr uint8_t  kStepPower = 128;                                   // Ступенька 50 %: печь успевает показать τ до цели
+  static constexpr float    kMinTargetC = 40.0f;                                // Допустимая цель, °C
+  static constexpr float    kMaxTargetC = 500.0f;
+//
+  void    setMethod(Method m) { method_ = m; }                                  // Способ следующего запуска
+  void    toggleMethod() { method_ = method_ == kStep ? kRelay : kStep; }       // Переключить способ
+  void    start(uint32_t now_ms, Q16 target, Q16 hyst, Q16 pv);                 // Запуск выбранным способом
+  void    stop();                                                               // Остановка без результата
+  uint8_t tick(uint32_t now_ms, Q16 pv);                                        // Шаг задачи регулятора: мощность 0..255
+//
+  bool    active() const { return relay_.running() || step_.running(); }        // Выход ведёт автонастройка
+  Outcome poll(uint32_t now_ms) const;                                          // Исход для задачи UI
+  void    selectRule(int delta);                                                // Следующее или предыдущее правило
+  RelayAutotune::Gains gains() const;                                           // Коэффициенты выбранного правила
+  const char* ruleName() const;                                                 // Название выбранного правила
+  static bool targetValid(float c) { return c >= kMinTargetC && c <= kMaxTargetC; }  // Цель в допустимых пределах
+//
+  Method   method() const { return method_; }                                   // Способ
+  uint8_t  rule() const { return rule_; }                                       // Номер правила выбранного способа
+  uint32_t startedMs() const { return t0_; }                                    // Время запуска
+  const RelayAutotune&  relay() const { return relay_; }                        // Состояние реле (для экрана)
+  const StepIdentifier& step() const { return step_; }                          // Модель ступеньки (для экрана)
+//
+private:                                                                        // Внутреннее состояние
+  Method         method_ = kRelay;                                              // Способ
+  uint8_t        rule_ = 0;                                                     // Правило на экране результата
+  bool           started_ = false;                                              // Был запуск
+  uint32_t       t0_ = 0;                                                       // Время запуска
+  RelayAutotune  relay_;                                                        // Реле, кольцо переключений и критерий сходимости
+  StepIdentifier step_;                                                         // Ступенька мощности и банк моделей МНК
+};                                                                              // Конец определения класса AutotuneSession
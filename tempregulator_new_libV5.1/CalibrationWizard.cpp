@@ -0,0 +1,98 @@
+#include "CalibrationWizard.h"                                                  // Объявление класса
+//
+void CalibrationWizard::start(uint32_t now_ms) {                                // Первый шаг
+  step_ = Step::InputAmbient;
+  error_ = Error::None;
+  t0_ = now_ms;
+  stable_ = false;
+  holding_ = false;
+}                                                                               // Завершение start
+//
+void CalibrationWizard::confirmAmbient(uint32_t now_ms, float ambient_c) {      // Температура введена
+  if (step_ != Step::InputAmbient) return;
+  ambient_c_ = ambient_c;
+  step_ = Step::MeasureAmbient;
+  t0_ = now_ms;
+}                                                                               // Завершение confirmAmbient
+//
+void CalibrationWizard::back(uint32_t now_ms) {                                 // Вернуться к вводу температуры
+  if (step_ != Step::WaitStable) return;
+  step_ = Step::InputAmbient;
+  t0_ = now_ms;                                                                 // Тайм-аут шага — заново
+  stable_ = false;
+  holding_ = false;
+}                                                                               // Завершение back
+//
+bool CalibrationWizard::confirmBoiling(uint32_t now_ms) {                       // Снять вторую точку
+  if (step_ != Step::WaitStable || !stable_) return false;
+  step_ = Step::MeasureBoiling;
+  t0_ = now_ms;
+  return true;
+}                                                                               // Завершение confirmBoiling
+//
+CalibrationWizard::Event CalibrationWizard::fail(Error e) {                     // Переход в Error
+  step_ = Step::Error;
+  error_ = e;
+  return Event::Failed;
+}                                                                               // Завершение fail
+//
+CalibrationWizard::Event CalibrationWizard::tick(uint32_t now_ms, const Reading& r, tc::Type type) {  // Шаг мастера
+  switch (step_) {
+    case Step::InputAmbient:
+      return now_ms - t0_ > kStepTimeoutMs ? fail(Error::AmbientTimeout) : Event::None;
+//
+    case Step::MeasureAmbient:
+      if (r.outliers > kMaxOutliers) return fail(Error::SensorFault);
+      adc1_ = r.adc;
+      cj1_ = r.cj_sensor ? r.cj_c : ambient_c_;                                 // Без датчика холодный спай = окружающая среда
+      stable_ = false;
+      holding_ = false;
+      last_adc_ = r.adc;
+      t0_ = now_ms;
+      step_ = Step::WaitStable;
+      return Event::AmbientMeasured;
+//
+    case Step::WaitStable: {
+      if (r.outliers > kMaxOutliers) return fail(Error::SensorFault);
+      const bool was = stable_;
+      const int d = static_cast<int>(r.adc) - static_cast<int>(last_adc_);
+      if (d <= kStableDelta && d >= -static_cast<int>(kStableDelta)) {
+        if (!holding_) {
+          holding_ = true;
+          stable_t0_ = now_ms;
+        }
+        if (now_ms - stable_t0_ >= kStableHoldMs) stable_ = true;
+      } else {
+        stable_ = false;
+        holding_ = false;
+      }
+      last_adc_ = r.adc;
+      if (now_ms - t0_ > kStepTimeoutMs) return fail(Error::BoilingTimeout);
+      return stable_ != was ? Event::StableChanged : Event::None;
+    }
+//
+    case Step::MeasureBoiling: {
+      if (r.outliers > kMaxOutliers) return fail(Error::SensorFault);
+      const uint16_t adc2 = r.adc;
+      const float cj2 = r.cj_sensor ? r.cj_c : ambient_c_;
+      last_adc_ = adc2;
+      if (adc2 <= adc1_ || adc2 - adc1_ < kMinAdcDiff) return fail(Error::SmallSpan);
+      result_ = tc::calibrateTwoPoint(type, adc1_, ambient_c_, cj1_, adc2, kBoilingC, cj2);
+      step_ = Step::Done;
+      return Event::Finished;
+    }
+//
+    default:
+      return Event::None;
+  }
+}                                                                               // Завершение tick
+//
+const char* CalibrationWizard::errorText(Error e) {                             // Сообщение для экрана
+  switch (e) {
+    case Error::AmbientTimeout: return "Тайм-аут шага 1";
+    case Error::BoilingTimeout: return "Тайм-аут шага 2";
+    case Error::SensorFault:    return "Неисправность термопары";
+    case Error::SmallSpan:      return "Недостаточная разница АЦП";
+    default:                    return "";
+  }
+}                                                                               // Завершение errorText
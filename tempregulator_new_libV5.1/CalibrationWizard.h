@@ -0,0 +1,87 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "ThermocoupleTables.h"                                                 // tc::Type, calibrateTwoPoint
+//
+// Мастер калибровки термопары по двум точкам без интерфейса: окружающая
+// среда (температуру вводит пользователь) и кипящая вода. TempRegulator
+// строит экраны по шагам мастера и передаёт в tick() отфильтрованный отсчёт
+// АЦП с числом выбросов окна и температурой холодного спая; сам мастер не
+// обращается ни к LVGL, ни к таймерам, поэтому проверяется на ПК.
+//
+// Вторая точка снимается только после того, как отсчёт kStableHoldMs не
+// уходит дальше kStableDelta; на каждый шаг — kStepTimeoutMs. Больше
+// kMaxOutliers выбросов в окне — неисправность датчика, разница АЦП между
+// точками меньше kMinAdcDiff — калибровка бессмысленна.
+class CalibrationWizard {                                                       // Двухточечная калибровка термопары
+public:                                                                         // Публичный интерфейс
+  static constexpr uint8_t  kMaxOutliers = 5;                                   // Выбросов в окне АЦП, выше — неисправность
+  static constexpr uint16_t kMinAdcDiff = 120;                                  // Наименьшая разница АЦП между точками
+  static constexpr uint16_t kStableDelta = 8;                                   // Допуск «отсчёт стоит», единиц АЦП
+  static constexpr uint32_t kStableHoldMs = 2000;                               // Сколько отсчёт должен стоять
+  static constexpr uint32_t kStepTimeoutMs = 60000;                             // Предел одного шага
+  static constexpr float    kBoilingC = 100.0f;                                 // Вторая точка — кипение воды
+//
+  enum class Step : uint8_t {                                                   // Шаг мастера
+    Idle,                                                                       // Не запущен
+    InputAmbient,                                                               // Ввод температуры окружающей среды
+    MeasureAmbient,                                                             // Замер первой точки (один tick)
+    WaitStable,                                                                 // Термопара в кипятке: ждём устойчивости
+    MeasureBoiling,                                                             // Замер второй точки (один tick)
+    Done,                                                                       // Коэффициенты посчитаны
+    Error,                                                                      // Ошибка: см. error()
+  };                                                                            // Конец перечисления Step
+//
+  enum class Error : uint8_t {                                                  // Причина ошибки
+    None,                                                                       // Ошибки нет
+    AmbientTimeout,                                                             // Тайм-аут первого шага
+    BoilingTimeout,                                                             // Тайм-аут второго шага
+    SensorFault,                                                                // Слишком много выбросов
+    SmallSpan,                                                                  // Мала разница АЦП между точками
+  };                                                                            // Конец перечисления Error
+//
+  enum class Event : uint8_t {                                                  // Что изменил tick()
+    None,                                                                       // Ничего
+    AmbientMeasured,                                                            // Первая точка снята — экран второго шага
+    StableChanged,                                                              // Изменилась устойчивость отсчёта
+    Finished,                                                                   // Готово: result()
+    Failed,                                                                     // Ошибка: error()
+  };                                                                            // Конец перечисления Event
+//
+  struct Reading {                                                              // Входные данные шага
+    uint16_t adc;                                                               // Отфильтрованный отсчёт АЦП
+    uint8_t  outliers;                                                          // Выбросов в окне фильтра
+    float    cj_c;                                                              // Температура холодного спая, °C
+    bool     cj_sensor;                                                         // Есть датчик холодного спая
+  };                                                                            // Конец структуры Reading
+//
+  void  start(uint32_t now_ms);                                                 // Первый шаг
+  void  confirmAmbient(uint32_t now_ms, float ambient_c);                       // «Далее» на первом шаге
+  void  back(uint32_t now_ms);                                                  // «Назад» со второго шага
+  bool  confirmBoiling(uint32_t now_ms);                                        // «ОК» на втором шаге (false — не устоялось)
+  Event tick(uint32_t now_ms, const Reading& r, tc::Type type);                 // Шаг мастера
+//
+  Step     step() const { return step_; }                                       // Текущий шаг
+  Error    error() const { return error_; }                                     // Причина ошибки
+  bool     stable() const { return stable_; }                                   // Отсчёт устоялся
+  uint16_t lastAdc() const { return last_adc_; }                                // Последний отсчёт
+  float    ambientC() const { return ambient_c_; }                              // Температура первой точки
+  const tc::Calibration& result() const { return result_; }                     // Коэффициенты (после Finished)
+  static const char* errorText(Error e);                                        // Сообщение для экрана
+//
+private:                                                                        // Внутреннее состояние
+  Event fail(Error e);                                                          // Переход в Error
+//
+  Step     step_ = Step::Idle;                                                  // Текущий шаг
+  Error    error_ = Error::None;                                                // Причина ошибки
+  uint32_t t0_ = 0;                                                             // Начало шага
+  uint32_t stable_t0_ = 0;                                                      // Начало устойчивого интервала
+  bool     holding_ = false;                                                    // Интервал начат
+  bool     stable_ = false;                                                     // Отсчёт устоялся
+  uint16_t last_adc_ = 0;                                                       // Прошлый отсчёт
+  float    ambient_c_ = 25.0f;                                                  // Первая точка, °C
+  uint16_t adc1_ = 0;                                                           // АЦП в первой точке
+  float    cj1_ = 25.0f;                                                        // Холодный спай в первой точке
+  tc::Calibration result_{};                                                    // Итог
+};                                                                              // Конец определения класса CalibrationWizard
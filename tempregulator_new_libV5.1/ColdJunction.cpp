@@ -0,0 +1,40 @@
+#include "ColdJunction.h"                                                       // Объявление класса
+//
+#ifdef ARDUINO
+#include <Arduino.h>                                                            // analogReadMilliVolts, pinMode
+#endif                                                                          // ARDUINO
+#include "HardwareConfig.h"                                                     // Параметры датчика холодного спая
+//
+void ColdJunction::begin(int8_t pin) {                                          // Настройка входа
+  pin_ = pin;                                                                   // Запоминаем вход
+  ok_ = false;                                                                  // Показаний ещё нет
+  primed_ = false;                                                              // Фильтр пуст
+#ifdef ARDUINO
+  if (pin_ >= 0) {                                                              // Датчик подключён
+    pinMode(pin_, INPUT);                                                       // Аналоговый вход
+    last_ms_ = millis() - kPeriodMs;                                            // Чтобы первый опрос прошёл сразу
+    update(millis());                                                           // Первое показание
+  }                                                                             // Конец проверки датчика
+#else
+  pin_ = -1;                                                                    // На хосте АЦП нет — фиксированное значение
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение begin
+//
+void ColdJunction::update(uint32_t now_ms) {                                    // Опрос датчика
+  if (pin_ < 0 || now_ms - last_ms_ < kPeriodMs) {                              // Нет датчика или рано
+    return;                                                                     // Ничего не делаем
+  }                                                                             // Конец проверки
+  last_ms_ = now_ms;                                                            // Запоминаем время опроса
+#ifdef ARDUINO
+  const int32_t mv = static_cast<int32_t>(analogReadMilliVolts(pin_));          // Калиброванное напряжение, мВ
+#else
+  const int32_t mv = 0;                                                         // Сюда не доходит: pin_ < 0
+#endif                                                                          // ARDUINO
+  const Q16 t = Q16::fromRatio(mv - CJC_SENSOR_MV_AT_0C, CJC_SENSOR_MV_PER_C);  // Пересчёт в °C
+  ok_ = (t >= Q16(kMinValidC) && t <= Q16(kMaxValidC));                         // Правдоподобность
+  if (!ok_) {                                                                   // Отказ датчика
+    return;                                                                     // Остаёмся на фиксированном значении
+  }                                                                             // Конец проверки
+  filtered_ = primed_ ? filtered_ + (t - filtered_) * Q16::fromRatio(1, 8) : t; // Экспоненциальное сглаживание 1/8
+  primed_ = true;                                                               // Фильтр инициализирован
+}                                                                               // Завершение update
@@ -0,0 +1,32 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+//
+// Температура холодного спая для компенсации термопары. Если аналоговый датчик
+// подключён (CJC_SENSOR_PIN >= 0), он опрашивается раз в kPeriodMs и сглаживается;
+// иначе используется фиксированное значение — температура окружающей среды,
+// введённая при калибровке. Неправдоподобные показания датчика отбрасываются.
+class ColdJunction {                                                            // Источник температуры холодного спая
+public:                                                                         // Публичный интерфейс
+  static constexpr uint32_t kPeriodMs = 1000;                                   // Период опроса датчика, мс
+  static constexpr int      kMinValidC = -20;                                   // Ниже — обрыв или замыкание датчика
+  static constexpr int      kMaxValidC = 85;                                    // Выше — обрыв или замыкание датчика
+//
+  void begin(int8_t pin);                                                       // Настроить вход (pin < 0 — без датчика)
+  void setFixed(Q16 t) { fixed_ = t; }                                          // Значение без датчика или при его отказе
+  void update(uint32_t now_ms);                                                 // Опрос датчика из управляющего цикла
+//
+  bool hasSensor() const { return pin_ >= 0; }                                  // Датчик подключён
+  bool sensorOk() const { return ok_; }                                         // Последнее показание правдоподобно
+  Q16  temperature() const { return (hasSensor() && ok_) ? filtered_ : fixed_; }  // Текущая температура холодного спая
+//
+private:                                                                        // Внутреннее состояние
+  int8_t   pin_ = -1;                                                           // Аналоговый вход датчика
+  bool     ok_ = false;                                                         // Показание валидно
+  bool     primed_ = false;                                                     // Фильтр инициализирован
+  uint32_t last_ms_ = 0;                                                        // Время последнего опроса
+  Q16      fixed_ = Q16(25);                                                    // Фиксированное значение, °C
+  Q16      filtered_;                                                           // Сглаженное показание датчика, °C
+};                                                                              // Конец определения класса ColdJunction
@@ -0,0 +1,177 @@
+#include "ControlBenchmark.h"                                                   // Объявление runControlBenchmark
+//
+#ifdef TR_PID_BENCHMARK                                                         // Весь файл — только в отладочной сборке
+#include <stdio.h>                                                              // printf: и на устройстве, и на хосте
+#include <stdlib.h>                                                             // abs
+//
+#include <algorithm>                                                            // nth_element (прежний фильтр АЦП)
+#include <vector>                                                               // Прежний фильтр АЦП
+//
+#include "AdaptivePid.h"                                                        // Адаптивная подстройка
+#include "AdcSampler.h"                                                         // Фоновая выборка АЦП
+#include "GainSchedule.h"                                                       // Таблица коэффициентов
+#include "MedianFilter.h"                                                       // Скользящая медиана АЦП
+#include "OvershootShaper.h"                                                    // Формирователь уставки
+#include "PIDController.h"                                                      // PID в Q16
+#include "PlatformClock.h"                                                      // platformCycles(), единица замера
+#include "ProfileRunner.h"                                                      // Задатчик профиля
+#include "TemperatureEstimator.h"                                               // Оценщик температуры
+#include "ThermocoupleTables.h"                                                 // ЭДС -> °C
+//
+namespace {                                                                     // Внутренние помощники замера
+//
+constexpr int      kIterations = 2000;                                          // Вызовов в серии
+constexpr uint32_t kStepMs = 100;                                               // Шаг задачи регулятора, мс
+//
+template <typename F>
+uint32_t cyclesPerCall(F&& f) {                                                 // Средняя стоимость вызова f(i)
+  const uint32_t c0 = platformCycles();                                         // Счётчик до серии
+  for (int i = 0; i < kIterations; ++i) f(i);                                   // Серия вызовов
+  const uint32_t c1 = platformCycles();                                         // Счётчик после серии
+  return (c1 - c0) / kIterations;                                               // На один вызов
+}                                                                               // Завершение cyclesPerCall
+//
+void report(const char* name, uint32_t cost) {                                  // Строка отчёта
+  printf("[BENCH] %-22s %6lu %s\n", name, static_cast<unsigned long>(cost), kPlatformCycleUnit);
+}                                                                               // Завершение report
+//
+Q16 pvAt(int i) { return Q16::fromRatio(150, 1) + Q16::fromRaw((i & 255) << 12); }  // Измерение 150..166 °C
+//
+uint16_t adcAt(int i) {                                                         // Отсчёт АЦП: шум ±16 и выброс на каждом 37-м
+  const uint32_t h = uint32_t(i) * 2654435761u;                                 // Хэш номера вместо генератора
+  return static_cast<uint16_t>(2000 + (h >> 27) + (i % 37 == 0 ? 900 : 0));
+}                                                                               // Завершение adcAt
+//
+int g_adc_i = 0;                                                                // Номер отсчёта для источника AdcSampler
+//
+uint16_t adcSource(uint8_t) { return adcAt(g_adc_i++); }                        // analogRead для замера
+//
+constexpr size_t   kAdcWindow = AdcSampler::kWindow;                            // Окно AdcSampler
+constexpr uint16_t kAdcThreshold = AdcSampler::kOutlierThreshold;                // Допуск AdcSampler
+//
+uint16_t vectorMedianFilter(const uint16_t* win, uint8_t& outliers) {           // Прежний readAdcFiltered(): копия и nth_element
+  std::vector<uint16_t> v(win, win + kAdcWindow);
+  auto sv = v;
+  std::nth_element(sv.begin(), sv.begin() + sv.size() / 2, sv.end());
+  const uint16_t med = sv[sv.size() / 2];
+  uint32_t acc = 0;
+  uint16_t n = 0;
+  outliers = 0;
+  for (uint16_t s : v) {
+    if (abs(int(s) - int(med)) <= kAdcThreshold) { acc += s; ++n; } else { ++outliers; }
+  }
+  return n ? static_cast<uint16_t>(acc / n) : med;
+}                                                                               // Завершение vectorMedianFilter
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runControlBenchmark() {                                                    // Стоимость звеньев и всего шага
+  volatile int32_t sink = 0;                                                    // Не даём компилятору выбросить расчёт
+//
+  const tc::EmfQ e0 = tc::emf(tc::Type::K, Q16::fromRatio(150, 1));             // ЭДС около рабочей точки
+  const uint32_t c_tc = cyclesPerCall([&](int i) {
+    sink = sink + tc::temperature(tc::Type::K, e0 + tc::EmfQ::fromRatio(i & 511, 1)).raw();
+  });
+  report("tc::temperature", c_tc);
+//
+  TemperatureEstimator est;                                                     // Оценщик с моделью нагрева
+  est.configure(TemperatureEstimator::kDefaultProcessNoise,
+                TemperatureEstimator::kDefaultMeasureNoise, 0.05);
+  const uint32_t c_est = cyclesPerCall([&](int i) {
+    est.update(uint32_t(i) * kStepMs, pvAt(i), 128);
+    sink = sink + est.temperature().raw();
+  });
+  report("TemperatureEstimator", c_est);
+//
+  ProfileRunner prof;                                                           // Рампа и выдержка, как у типичного профиля
+  prof.addSegment(20.0f, 600.0f, 600.0f, 5.0f);
+  prof.addSegment(600.0f, 600.0f, 60.0f, 5.0f);
+  prof.start(0);
+  const uint32_t c_prof = cyclesPerCall([&](int i) {
+    prof.tick(uint32_t(i) * kStepMs, pvAt(i));
+    sink = sink + prof.setpoint().raw();
+  });
+  report("ProfileRunner::tick", c_prof);
+//
+  GainSchedule sched;                                                           // Три точки, как в config.ini
+  const GainSchedule::Point pts[] = {{100.0f, 4.0f, 0.05f, 20.0f},
+                                      {300.0f, 3.0f, 0.03f, 30.0f},
+                                      {500.0f, 2.0f, 0.02f, 40.0f}};
+  sched.compile(pts, 3);
+  const uint32_t c_gs = cyclesPerCall([&](int i) {
+    Q16 kp, kd;
+    Q24 ki;
+    sched.eval(Q16::fromRatio(50 + (i & 511), 1), kp, ki, kd);
+    sink = sink + kp.raw() + ki.raw() + kd.raw();
+  });
+  report("GainSchedule::eval", c_gs);
+//
+  const StepIdentifier::Model model{1.2, 600.0, 40.0, true};                    // Типичная печь: τ 10 мин, θ 40 с
+  OvershootShaper shaper;
+  shaper.configure(model);
+  shaper.start(0);
+  const uint32_t c_os = cyclesPerCall([&](int i) {
+    shaper.tick(uint32_t(i) * kStepMs, 128, pvAt(i));
+    sink = sink + shaper.shape(Q16::fromRatio(160, 1), Q16::fromRatio(160, 1), pvAt(i)).raw();
+  });
+  report("OvershootShaper", c_os);
+//
+  AdaptivePid adapt;
+  adapt.start(0, 2.0, 0.02, 30.0, &model, Q16::fromRatio(20, 1));
+  const uint32_t c_ad = cyclesPerCall([&](int i) {
+    sink = sink + adapt.tick(uint32_t(i) * kStepMs, pvAt(i), 128 + (i & 63));
+  });
+  report("AdaptivePid::tick", c_ad);
+//
+  PIDController pid;
+  pid.setCoeffs(2.0, 5.0, 1.0);                                                 // Коэффициенты по умолчанию прошивки
+  pid.setSetpoint(160.0);
+  pid.setFixedDt(kStepMs);                                                      // Как в прошивке: шаг задан заранее
+  const uint32_t c_pid = cyclesPerCall([&](int i) {
+    sink = sink + pid.compute(pvAt(i));
+  });
+  report("PIDController::compute", c_pid);
+//
+  const uint32_t total = c_tc + c_est + c_prof + c_gs + c_os + c_ad + c_pid;    // Шаг задачи со всеми звеньями
+  report("total", total);
+  (void)sink;
+}                                                                               // Завершение runControlBenchmark
+//
+void runFilterBenchmark() {                                                     // Фильтр АЦП: скользящая медиана против прежнего
+  volatile int32_t sink = 0;                                                    // Не даём компилятору выбросить расчёт
+  SlidingMedianFilter<kAdcWindow, kAdcThreshold> filter;
+  for (size_t i = 0; i < kAdcWindow; ++i) filter.push(adcAt(int(i)));           // Окно заполнено, как в работе
+  const uint32_t c_push = cyclesPerCall([&](int i) {
+    filter.push(adcAt(i));
+    sink = sink + filter.median();
+  });
+  report("SlidingMedian::push", c_push);
+  const uint32_t c_filt = cyclesPerCall([&](int i) {
+    uint8_t o = 0;
+    filter.push(adcAt(i));
+    sink = sink + filter.filtered(o) + o;
+  });
+  report("push + filtered", c_filt);
+//
+  uint16_t win[kAdcWindow + 64];                                                // Скользящее окно для прежнего фильтра
+  for (size_t i = 0; i < sizeof(win) / sizeof(win[0]); ++i) win[i] = adcAt(int(i));
+  const uint32_t c_vec = cyclesPerCall([&](int i) {
+    uint8_t o = 0;
+    sink = sink + vectorMedianFilter(win + (i & 63), o) + o;
+  });
+  report("vector + nth_element", c_vec);
+//
+  AdcSampler sampler;                                                           // Тик таймера и чтение задачей регулятора
+  sampler.setReadFunction(adcSource);
+  sampler.begin(0, 2000);
+  const uint32_t c_tick = cyclesPerCall([&](int) { sampler.sampleOnce(); });
+  report("AdcSampler::sampleOnce", c_tick);
+  const uint32_t c_latest = cyclesPerCall([&](int) {
+    uint8_t o = 0;
+    sink = sink + sampler.latest(o) + o;
+  });
+  report("AdcSampler::latest", c_latest);
+  sampler.end();
+  (void)sink;
+}                                                                               // Завершение runFilterBenchmark
+#endif                                                                          // TR_PID_BENCHMARK
@@ -0,0 +1,13 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+// Замер стоимости горячего пути задачи регулятора по звеньям: перевод отсчёта
+// АЦП в температуру, оценщик, задатчик профиля, таблица коэффициентов,
+// формирователь уставки, адаптивная подстройка и PID. Каждое звено вызывается
+// серией с меняющимся входом и временем, идущим шагом регулятора, поэтому
+// редкие шаги моделей (окна 1–2 с) входят в среднее в своей доле. На
+// устройстве результат — такты CPU, на ПК — наносекунды (PlatformClock.h).
+//
+#ifdef TR_PID_BENCHMARK                                                         // Отладочная сборка: стоимость звеньев регулятора
+void runControlBenchmark();                                                     // Печатает стоимость вызова каждого звена и всего шага
+void runFilterBenchmark();                                                      // Фильтр АЦП на окне: SlidingMedianFilter и прежние vector + nth_element
+#endif                                                                          // TR_PID_BENCHMARK
@@ -0,0 +1,120 @@
+#include "ControlScheduler.h"                                                   // Объявление класса
+//
+#ifdef ARDUINO
+#include <Arduino.h>                                                            // micros
+#include <freertos/FreeRTOS.h>                                                  // Типы FreeRTOS
+#include <freertos/semphr.h>                                                    // Рекурсивный мьютекс
+#include <freertos/task.h>                                                      // Задача и vTaskDelayUntil
+#endif                                                                          // ARDUINO
+//
+#ifdef ARDUINO
+static constexpr uint32_t kTaskStack = 4096;                                    // Стек задачи регулятора, байт
+static constexpr UBaseType_t kTaskPriority = 10;                                // Выше loopTask (1), ниже esp_timer и Wi-Fi
+#endif                                                                          // ARDUINO
+//
+void* ControlScheduler::mutex_ = nullptr;                                       // Создаётся в begin()
+//
+ControlScheduler::Lock::Lock() {                                                // Захват
+#ifdef ARDUINO
+  if (mutex_) xSemaphoreTakeRecursive(static_cast<SemaphoreHandle_t>(mutex_), portMAX_DELAY);
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение конструктора
+//
+ControlScheduler::Lock::~Lock() {                                               // Освобождение
+#ifdef ARDUINO
+  if (mutex_) xSemaphoreGiveRecursive(static_cast<SemaphoreHandle_t>(mutex_));
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение деструктора
+//
+ControlScheduler::ControlScheduler() {                                          // Конструктор
+#ifdef ARDUINO
+  clock_ = []() -> uint32_t { return micros(); };                               // На устройстве — системное время
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение конструктора
+//
+uint32_t ControlScheduler::clampPeriod(uint32_t period_ms) {                    // Приведение периода
+  if (period_ms < kMinPeriodMs) period_ms = kMinPeriodMs;                       // Не чаще минимума
+  if (period_ms > kMaxPeriodMs) period_ms = kMaxPeriodMs;                       // Не реже максимума
+  return (period_ms + kPeriodStepMs / 2) / kPeriodStepMs * kPeriodStepMs;       // К ближайшему кратному шагу (границы кратны)
+}                                                                               // Завершение clampPeriod
+//
+uint8_t ControlScheduler::binFor(uint32_t us) {                                 // Номер корзины
+  uint8_t b = 0;                                                                // Начинаем с первой
+  while (b < kBins - 1 && us > kBinEdgesUs[b]) ++b;                             // Ищем первую границу не меньше значения
+  return b;                                                                     // Последняя корзина — всё, что больше
+}                                                                               // Завершение binFor
+//
+bool ControlScheduler::begin(StepFn fn, void* arg, uint32_t period_ms) {        // Запуск
+  fn_ = fn;                                                                     // Запоминаем шаг
+  arg_ = arg;
+  period_ms_ = clampPeriod(period_ms);                                          // Допустимый период
+  resetStats();                                                                 // Статистика с нуля
+#ifdef ARDUINO
+  if (!mutex_) mutex_ = xSemaphoreCreateRecursiveMutex();                       // Мьютекс общего состояния
+  if (!mutex_) return false;                                                    // Нет памяти
+  if (!task_) {                                                                 // Задача ещё не создана
+    TaskHandle_t h = nullptr;                                                   // Дескриптор новой задачи
+    if (xTaskCreate(&ControlScheduler::taskMain, "control", kTaskStack, this, kTaskPriority, &h) != pdPASS) {
+      return false;                                                             // Задачу создать не удалось
+    }                                                                           // Конец проверки создания
+    task_ = h;                                                                  // Запоминаем
+  }                                                                             // Конец проверки
+#endif                                                                          // ARDUINO
+  return true;                                                                  // Готово
+}                                                                               // Завершение begin
+//
+void ControlScheduler::setPeriod(uint32_t period_ms) {                          // Новый период
+  Lock lock;                                                                    // Не посреди шага
+  period_ms_ = clampPeriod(period_ms);                                          // Допустимый период
+  primed_ = false;                                                              // Первый интервал нового периода не считаем
+  stats_.period_ms = period_ms_;                                                // Для снимка
+}                                                                               // Завершение setPeriod
+//
+void ControlScheduler::resetStats() {                                           // Обнуление статистики
+  Lock lock;                                                                    // Согласованный сброс
+  stats_ = Stats{};                                                             // Всё с нуля
+  stats_.period_ms = period_ms_;                                                // Кроме периода
+  primed_ = false;                                                              // Джиттер — со следующего интервала
+}                                                                               // Завершение resetStats
+//
+ControlScheduler::Stats ControlScheduler::stats() const {                       // Снимок
+  Lock lock;                                                                    // Без разрыва между полями
+  return stats_;                                                                // Копия
+}                                                                               // Завершение stats
+//
+void ControlScheduler::tick() {                                                 // Один шаг
+  if (!fn_) return;                                                             // Не запущен
+  Lock lock;                                                                    // UI не меняет состояние посреди шага
+  const uint32_t t0 = now();                                                    // Фактическое начало шага
+  const uint32_t period_us = period_ms_ * 1000;                                 // Период, мкс
+  uint32_t jitter_us = 0;                                                       // Отклонение интервала от периода
+  if (primed_) {                                                                // Есть предыдущий шаг
+    const uint32_t interval = t0 - last_us_;                                    // Фактический интервал
+    jitter_us = interval > period_us ? interval - period_us : period_us - interval;
+    ++stats_.jitter[binFor(jitter_us)];                                         // В гистограмму
+    if (jitter_us > stats_.max_jitter_us) stats_.max_jitter_us = jitter_us;     // Новый максимум
+  }                                                                             // Конец проверки
+  last_us_ = t0;                                                                // Опора следующего интервала
+  fn_(arg_);                                                                    // Шаг контура
+  const uint32_t exec_us = now() - t0;                                          // Время шага
+  ++stats_.exec[binFor(exec_us)];                                               // В гистограмму
+  if (exec_us > stats_.max_exec_us) stats_.max_exec_us = exec_us;               // Новый максимум
+  if (exec_us >= period_us || (primed_ && jitter_us >= period_us / 2)) {        // Шаг не уложился или сильно опоздал
+    ++stats_.overruns;                                                          // Учитываем перегрузку
+  }                                                                             // Конец проверки
+  ++stats_.steps;                                                               // Учитываем шаг
+  primed_ = true;                                                               // Интервал со следующего шага
+}                                                                               // Завершение tick
+//
+void ControlScheduler::taskMain(void* arg) {                                    // Тело задачи
+#ifdef ARDUINO
+  auto* self = static_cast<ControlScheduler*>(arg);                             // Владелец задачи
+  TickType_t wake = xTaskGetTickCount();                                        // Опорный момент
+  for (;;) {                                                                    // Задача не завершается
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(self->period_ms_));                    // Строго от опорного момента, без накопления сдвига
+    self->tick();                                                               // Шаг
+  }                                                                             // Конец цикла
+#else
+  (void)arg;                                                                    // На хосте tick() вызывается вручную
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение taskMain
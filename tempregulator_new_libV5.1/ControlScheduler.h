@@ -0,0 +1,75 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+// Планировщик контура регулирования: цепочка «сбор → оценка → PID → SSR»
+// выполняется с фиксированным периодом в отдельной задаче FreeRTOS с
+// приоритетом выше loopTask, поэтому отрисовка LVGL и трафик WebSocket больше
+// не сдвигают шаг регулятора. Задача просыпается по vTaskDelayUntil раз в
+// период; модуляцию выхода внутри окна SSR ведёт SsrOutput по своему таймеру.
+//
+// Период — от kMinPeriodMs до kMaxPeriodMs с шагом kPeriodStepMs: окно SSR
+// и шаг PID тогда содержат целое число полупериодов сети 50 Гц, а
+// vTaskDelayUntil — целое число тиков при любой частоте тика FreeRTOS до 100 Гц.
+//
+// Для каждого шага ведутся гистограммы джиттера (|интервал − период|)
+// и времени выполнения. Общее с UI состояние регулятора защищается Lock —
+// рекурсивным мьютексом с наследованием приоритета; на хосте и до begin() это
+// пустая операция, а tick() можно вызывать вручную.
+class ControlScheduler {                                                        // Планировщик фиксированного шага
+public:                                                                         // Публичный интерфейс
+  using StepFn = void (*)(void* arg);                                           // Шаг контура
+  using ClockFn = uint32_t (*)();                                               // Источник времени, мкс
+//
+  static constexpr uint32_t kMinPeriodMs = 20;                                  // Наименьший период регулятора, мс
+  static constexpr uint32_t kMaxPeriodMs = 1000;                                // Наибольший период регулятора, мс
+  static constexpr uint32_t kDefaultPeriodMs = 100;                             // Период по умолчанию, мс
+  static constexpr uint32_t kPeriodStepMs = 10;                                 // Период кратен полупериоду сети 50 Гц и тику FreeRTOS
+  static constexpr uint8_t  kBins = 8;                                          // Число корзин гистограмм
+  static constexpr uint32_t kBinEdgesUs[kBins - 1] = {50, 100, 250, 500, 1000, 2000, 5000};  // Верхние границы корзин, мкс
+//
+  struct Stats {                                                                // Снимок статистики
+    uint32_t period_ms = 0;                                                     // Текущий период, мс
+    uint32_t steps = 0;                                                         // Выполнено шагов
+    uint32_t overruns = 0;                                                      // Шагов дольше периода или с пропуском
+    uint32_t max_jitter_us = 0;                                                 // Наибольший джиттер, мкс
+    uint32_t max_exec_us = 0;                                                   // Наибольшее время шага, мкс
+    uint32_t jitter[kBins] = {};                                                // Гистограмма джиттера
+    uint32_t exec[kBins] = {};                                                  // Гистограмма времени шага
+  };                                                                            // Конец структуры Stats
+//
+  class Lock {                                                                  // Захват состояния регулятора на время области видимости
+  public:                                                                       // Публичный интерфейс
+    Lock();                                                                     // Захват (ждёт завершения шага)
+    ~Lock();                                                                    // Освобождение
+    Lock(const Lock&) = delete;                                                 // Копировать нельзя
+    Lock& operator=(const Lock&) = delete;                                      // Присваивать нельзя
+  };                                                                            // Конец определения класса Lock
+//
+  ControlScheduler();                                                           // Конструктор
+  bool begin(StepFn fn, void* arg, uint32_t period_ms);                         // Запуск задачи регулятора
+  void setPeriod(uint32_t period_ms);                                           // Новый период
+  uint32_t periodMs() const { return period_ms_; }                              // Текущий период, мс
+  void resetStats();                                                            // Обнулить статистику
+  Stats stats() const;                                                          // Снимок статистики
+  void setClock(ClockFn fn) { clock_ = fn; }                                    // Подменить источник времени (хост)
+//
+  void tick();                                                                  // Один шаг (тело задачи; на хосте — вручную)
+  static uint32_t clampPeriod(uint32_t period_ms);                              // В пределы и к кратному kPeriodStepMs
+  static uint8_t  binFor(uint32_t us);                                          // Номер корзины для значения
+//
+private:                                                                        // Внутреннее состояние
+  static void taskMain(void* arg);                                              // Тело задачи FreeRTOS
+  uint32_t now() const { return clock_ ? clock_() : 0; }                        // Время, мкс
+//
+  static void* mutex_;                                                          // Рекурсивный мьютекс (nullptr до begin и на хосте)
+//
+  StepFn   fn_ = nullptr;                                                       // Шаг контура
+  void*    arg_ = nullptr;                                                      // Аргумент шага
+  ClockFn  clock_ = nullptr;                                                    // Источник времени
+  void*    task_ = nullptr;                                                     // Дескриптор задачи (nullptr на хосте)
+  uint32_t period_ms_ = kDefaultPeriodMs;                                       // Период, мс
+  uint32_t last_us_ = 0;                                                        // Начало последнего шага
+  bool     primed_ = false;                                                     // Есть предыдущий шаг для джиттера
+  Stats    stats_;                                                              // Статистика
+};                                                                              // Конец определения класса ControlScheduler
@@ -2,6 +2,9 @@
 //
 #include <Arduino.h>                                                               // Подключаем базовые определения Arduino (SPI, задержки и т.п.)
 //
+#include "EventTrace.h"                                                           // Трассировка заливки и чтения тача
+#include "SpiBusArbiter.h"                                                         // Арбитраж общей шины с SPI-усилителем термопары
+//
 LGFX::LGFX() {                                                                     // Конструктор класса LGFX отвечает за настройку шины, панели и тачскрина
   {                                                                                // Первый блок конфигурирует SPI-шину, по которой работает экран
     auto c = _bus.config();                                                        // Получаем текущую конфигурацию шины LGFX Bus
@@ -62,14 +65,23 @@ static void display_flush_cb(lv_display_t* disp,
                              uint8_t* px_map) {                                    // Указатель на массив пикселей в формате RGB565
   uint32_t w = static_cast<uint32_t>(area->x2 - area->x1 + 1);                     // Вычисляем ширину области обновления
   uint32_t h = static_cast<uint32_t>(area->y2 - area->y1 + 1);                     // Вычисляем высоту области
-  tft.pushImage(area->x1, area->y1, w, h,                                          // Передаём пиксели в драйвер дисплея, начиная с верхнего левого угла области
-                reinterpret_cast<const lgfx::rgb565_t*>(px_map));                  // Приводим указатель к типу, ожидаемому библиотекой LovyanGFX
+  TR_TRACE_SCOPE(kFlush, w * h);                                                  // Участок заливки до lv_display_flush_ready (≤ 320×40 пикселей)
+  {                                                                                // Шина занята заливкой только на время передачи
+    SpiBusLock lock(SpiBusArbiter::Client::Display);                               // Датчик не начнёт обмен посреди заливки
+    tft.pushImage(area->x1, area->y1, w, h,                                        // Передаём пиксели в драйвер дисплея, начиная с верхнего левого угла области
+                  reinterpret_cast<const lgfx::rgb565_t*>(px_map));                // Приводим указатель к типу, ожидаемому библиотекой LovyanGFX
+  }                                                                                // Шина освобождена
   lv_display_flush_ready(disp);                                                    // Сообщаем LVGL, что обновление завершено
 }                                                                                  // Завершение функции колбэка
 //
 static void touchpad_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {           // Колбэк чтения тачскрина для LVGL
+  TR_TRACE_SCOPE(kTouch, 0);                                                      // Участок чтения тача
   uint16_t rx, ry;                                                                 // Переменные для сырых значений тачскрина по X и Y
-  bool pressed = tft.getTouchRaw(&rx, &ry);                                        // Получаем состояние тача и сырые координаты
+  bool pressed = false;                                                            // Состояние тача
+  {                                                                                // Захватываем шину на время чтения тача
+    SpiBusLock lock(SpiBusArbiter::Client::Touch);                                 // Датчик подождёт следующего промежутка
+    pressed = tft.getTouchRaw(&rx, &ry);                                           // Получаем состояние тача и сырые координаты
+  }                                                                                // Шина освобождена
   if (g_touch_swap_axes) {                                                         // Если в настройках нужно поменять оси местами
     uint16_t tmp = rx;                                                             // Сохраняем временно значение X
     rx = ry;                                                                       // Переставляем X <- Y
@@ -2,6 +2,7 @@
 //
 #include <Arduino.h>                                                               // Используем Arduino API для pinMode и attachInterrupt
 #include "HardwareConfig.h"                                                       // Пины энкодера определены в конфигурации железа
+#include "EventTrace.h"                                                           // Трассировка щелчков и нажатий из прерываний
 #include "esp_timer.h"                                                            // Нужен для высокоточного таймера при антидребезге кнопки
 #include "driver/gpio.h"                                                          // Низкоуровневый доступ к GPIO для чтения уровней в обработчиках прерываний
 //
@@ -30,6 +31,7 @@ void IRAM_ATTR onEncoderTick() {
     accum++;                                                                       // Накопление подшагов вперёд
     if (accum >= 4) {                                                              // Полный щелчок (4 перехода квадратичного энкодера)
       encoder_diff++;                                                              // Увеличиваем счётчик шага
+      TR_TRACE_COUNTER(kEncoder, encoder_diff);                                    // Положение энкодера в трассу
       accum = 0;                                                                   // Сбрасываем накопитель
     }
   } else if ((last == 0b00 && s == 0b10) || (last == 0b10 && s == 0b11) ||         // Иначе проверяем переходы при шаге назад
@@ -40,6 +42,7 @@ void IRAM_ATTR onEncoderTick() {
     accum--;                                                                       // Накопление подшагов назад
     if (accum <= -4) {                                                             // Достигли полного шага в обратную сторону
       encoder_diff--;                                                              // Уменьшаем счётчик шага
+      TR_TRACE_COUNTER(kEncoder, encoder_diff);                                    // Положение энкодера в трассу
       accum = 0;                                                                   // Обнуляем накопитель
     }
   }                                                                                // Конец определения направления
@@ -54,6 +57,7 @@ void IRAM_ATTR onEncoderButton() {
     uint32_t now = static_cast<uint32_t>(esp_timer_get_time());                    // Текущее время в микросекундах
     if (now - last_press_us > DEBOUNCE_US) {                                       // Проверяем, что прошло больше времени, чем длительность дребезга
       encoderButtonPressed = true;                                                 // Фиксируем факт нажатия для основного цикла
+      TR_TRACE_INSTANT(kEncoderButton, 1);                                         // Подтверждённое нажатие в трассу
       last_press_us = now;                                                         // Обновляем отметку времени последнего нажатия
     }
   }
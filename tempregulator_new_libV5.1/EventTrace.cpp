@@ -0,0 +1,164 @@
+#include "EventTrace.h"                                                         // Объявление класса
+//
+#if TR_EVENT_TRACE
+#include <atomic>                                                               // Индекс кольца и остановка записи
+#include <string.h>                                                             // strlen, memcpy
+//
+#include "PlatformClock.h"                                                      // platformMicros()
+//
+#ifdef ARDUINO
+#include <Arduino.h>                                                            // IRAM_ATTR, Print
+#include <memory>                                                               // unique_ptr для снимка
+#include <new>                                                                  // nothrow
+#define TR_TRACE_IRAM IRAM_ATTR                                                 // Запись вызывается из прерываний
+#else
+#define TR_TRACE_IRAM
+#endif                                                                          // ARDUINO
+//
+namespace {                                                                     // Локальные для модуля сущности
+struct Record {                                                                 // Запись кольца
+  std::atomic<uint32_t> seq;                                                    // Номер записи + 1, 0 — пишется
+  uint32_t ts_us;                                                               // Метка времени
+  uint8_t  id;                                                                  // EventTrace::Id
+  uint8_t  kind;                                                                // EventTrace::Kind
+  int16_t  arg;                                                                 // Аргумент
+};                                                                              // Конец структуры Record
+//
+constexpr size_t kHeaderSize = 24;                                              // Заголовок снимка без имён
+//
+Record g_ring[EventTrace::kCapacity];                                           // Кольцо (в .bss)
+std::atomic<uint32_t> g_head{0};                                                // Записано всего (следующая позиция)
+std::atomic<uint32_t> g_dropped{0};                                             // Потеряно, пока шло копирование
+std::atomic<bool> g_frozen{false};                                              // Снимок: запись остановлена
+//
+const char* const kNames[EventTrace::kCount] = {                                // Имена в порядке Id
+  "display_flush", "touch_read", "encoder", "encoder_button", "storage_save",
+  "profile_load", "ws_event", "ws_send", "control"
+};                                                                              // Конец массива kNames
+//
+uint8_t* put16(uint8_t* p, uint16_t v) {                                        // Little-endian независимо от платформы
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  return p + 2;
+}                                                                               // Завершение put16
+//
+uint8_t* put32(uint8_t* p, uint32_t v) {                                        // Little-endian независимо от платформы
+  p = put16(p, static_cast<uint16_t>(v));
+  return put16(p, static_cast<uint16_t>(v >> 16));
+}                                                                               // Завершение put32
+//
+uint32_t get32(const uint8_t* p) {                                              // Обратно к put32
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}                                                                               // Завершение get32
+//
+void sortByTime(uint8_t* recs, uint32_t n, uint32_t now_us) {                   // Вставками по возрасту, старые первыми
+  constexpr size_t kSize = EventTrace::kRecordSize;
+  uint8_t tmp[kSize];
+  for (uint32_t i = 1; i < n; ++i) {                                            // Почти упорядочено: сдвиги редкие
+    uint8_t* cur = recs + i * kSize;
+    const uint32_t age = now_us - get32(cur);                                   // Разность не боится переполнения micros()
+    uint32_t j = i;
+    while (j > 0 && now_us - get32(recs + (j - 1) * kSize) < age) --j;
+    if (j == i) continue;
+    memcpy(tmp, cur, kSize);
+    memmove(recs + (j + 1) * kSize, recs + j * kSize, (i - j) * kSize);
+    memcpy(recs + j * kSize, tmp, kSize);
+  }
+}                                                                               // Завершение sortByTime
+//
+size_t namesSize() {                                                            // Имена с завершающими NUL
+  size_t n = 0;
+  for (const char* s : kNames) n += strlen(s) + 1;
+  return n;
+}                                                                               // Завершение namesSize
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void TR_TRACE_IRAM EventTrace::record(Id id, Kind kind, int16_t arg) {          // Добавить запись
+  if (g_frozen.load(std::memory_order_relaxed)) {                               // Идёт копирование: не портим снимок
+    g_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const uint32_t n = g_head.fetch_add(1, std::memory_order_relaxed);
+  Record& r = g_ring[n & (kCapacity - 1)];
+  r.seq.store(0, std::memory_order_relaxed);                                    // Снимок пропустит недописанную запись
+  std::atomic_thread_fence(std::memory_order_release);
+  r.ts_us = platformMicros();
+  r.id = id;
+  r.kind = kind;
+  r.arg = arg;
+  r.seq.store(n + 1, std::memory_order_release);                                // Запись готова
+}                                                                               // Завершение record
+//
+size_t EventTrace::snapshotSize() {                                             // Наибольший размер снимка
+  return kHeaderSize + namesSize() + static_cast<size_t>(kCapacity) * kRecordSize;
+}                                                                               // Завершение snapshotSize
+//
+size_t EventTrace::snapshot(uint8_t* out, size_t cap) {                         // Снимок кольца
+  if (cap < snapshotSize()) return 0;
+  g_frozen.store(true, std::memory_order_seq_cst);
+  const uint32_t head = g_head.load(std::memory_order_seq_cst);
+  const uint32_t avail = head < kCapacity ? head : kCapacity;
+  uint8_t* p = out;
+  memcpy(p, "TRC1", 4);
+  p += 4;
+  p = put16(p, kRecordSize);
+  p = put16(p, kCount);
+  p = put32(p, head);
+  uint8_t* const tail = p;                                                      // Потеряно, записей, время — после копирования
+  p += 12;
+  for (const char* s : kNames) {
+    const size_t n = strlen(s) + 1;
+    memcpy(p, s, n);
+    p += n;
+  }
+  uint8_t* const recs = p;
+  uint32_t skipped = 0;
+  for (uint32_t i = head - avail; i != head; ++i) {                             // В порядке занятия мест
+    const Record& r = g_ring[i & (kCapacity - 1)];
+    const uint32_t seq = r.seq.load(std::memory_order_acquire);
+    const uint32_t ts = r.ts_us;
+    const uint8_t id = r.id;
+    const uint8_t kind = r.kind;
+    const int16_t arg = r.arg;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq != i + 1 || r.seq.load(std::memory_order_relaxed) != seq) {         // Запись ещё пишется (задача прервана)
+      ++skipped;
+      continue;
+    }
+    p = put32(p, ts);
+    *p++ = id;
+    *p++ = kind;
+    p = put16(p, static_cast<uint16_t>(arg));
+  }
+  const uint32_t count = static_cast<uint32_t>(p - recs) / kRecordSize;
+  const uint32_t now_us = platformMicros();                                     // Не раньше последней метки
+  sortByTime(recs, count, now_us);                                              // Прерывание могло занять место позже, а метку взять раньше
+  put32(put32(put32(tail, g_dropped.load(std::memory_order_relaxed) + skipped), count), now_us);
+  g_frozen.store(false, std::memory_order_seq_cst);
+  return static_cast<size_t>(p - out);
+}                                                                               // Завершение snapshot
+//
+const char* EventTrace::name(Id id) {                                           // Имя события
+  return id < kCount ? kNames[id] : "?";
+}                                                                               // Завершение name
+//
+#ifdef ARDUINO
+void EventTrace::printHex(Print& out) {                                         // Снимок в последовательный порт
+  const size_t cap = snapshotSize();
+  std::unique_ptr<uint8_t[]> buf(new (std::nothrow) uint8_t[cap]);
+  if (!buf) {
+    out.println("[TRACE] нет памяти для снимка");
+    return;
+  }
+  const size_t n = snapshot(buf.get(), cap);
+  out.printf("[TRACE] begin %u\n", static_cast<unsigned>(n));
+  char line[2 * 32 + 1];
+  for (size_t i = 0; i < n; i += 32) {                                          // По 32 байта в строке
+    size_t k = 0;
+    for (size_t j = i; j < n && j < i + 32; ++j) k += snprintf(line + k, sizeof(line) - k, "%02x", buf[j]);
+    out.println(line);
+  }
+  out.println("[TRACE] end");
+}                                                                               // Завершение printHex
+#endif                                                                          // ARDUINO
+#endif                                                                          // TR_EVENT_TRACE
@@ -0,0 +1,89 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+// Трассировка событий для разбора подвисаний (заливка экрана во время записи
+// во флеш, веб-трафик рядом с шагом регулятора). Начало и конец участков,
+// мгновенные события и значения счётчиков пишутся 8-байтными записями с
+// меткой времени в микросекундах в кольцо в RAM на kCapacity записей: самые
+// старые затираются. Место в кольце занимается атомарным fetch_add, поэтому
+// писать можно из любой задачи и из прерывания (record() лежит в IRAM), без
+// блокировок и без кучи. Номер записи в кольце ставится последним: пока он
+// не совпал с местом, запись считается недописанной.
+//
+// snapshot() останавливает запись на время копирования (события в эти
+// микросекунды и недописанные записи считаются потерянными) и выдаёт
+// самоописывающий двоичный снимок: заголовок, имена событий, записи по
+// возрастанию метки времени. Время снимка берётся после копирования, поэтому
+// ни одна метка не позже него. Прибор отдаёт
+// его по HTTP (/trace.bin) и в последовательный порт шестнадцатеричными
+// строками по команде «t»; tools/trace_to_chrome.py переводит снимок в JSON
+// для chrome://tracing и Perfetto.
+//
+// Формат (little-endian): "TRC1", u16 размер записи, u16 число имён,
+// u32 записано всего, u32 потеряно, u32 записей в снимке, u32 время снимка
+// в мкс; имена через NUL; записи {u32 мкс, u8 событие, u8 вид, i16 аргумент}.
+//
+// Сборка с -DTR_EVENT_TRACE=0 убирает трассировку: макросы ниже пустые.
+#ifndef TR_EVENT_TRACE
+#define TR_EVENT_TRACE 1                                                        // Трассировка включена по умолчанию
+#endif                                                                          // TR_EVENT_TRACE
+//
+#if TR_EVENT_TRACE
+#ifdef ARDUINO
+class Print;                                                                    // Поток вывода Arduino
+#endif                                                                          // ARDUINO
+//
+class EventTrace {                                                              // Кольцо событий трассировки
+public:                                                                         // Публичный интерфейс
+  enum Id : uint8_t {                                                           // Источники событий
+    kFlush,                                                                     // display_flush_cb, аргумент — пикселей
+    kTouch,                                                                     // touchpad_read_cb, аргумент — касание
+    kEncoder,                                                                   // Счётчик щелчков энкодера из прерывания
+    kEncoderButton,                                                             // Нажатие кнопки энкодера из прерывания
+    kStorageSave,                                                               // Storage::save — запись конфигурации
+    kProfileLoad,                                                               // TemperatureProfile::loadFromNVS
+    kWsEvent,                                                                   // Обработчик WebSocket, аргумент — WStype_t
+    kWsSend,                                                                    // Рассылка телеметрии, аргумент — байт
+    kControl,                                                                   // Шаг задачи регулятора
+    kCount                                                                      // Число источников
+  };                                                                            // Конец перечисления Id
+//
+  enum Kind : uint8_t {                                                         // Вид записи (буква фазы Chrome trace)
+    kBegin = 'B',                                                               // Начало участка
+    kEnd = 'E',                                                                 // Конец участка
+    kInstant = 'i',                                                             // Мгновенное событие
+    kCounter = 'C'                                                              // Значение счётчика
+  };                                                                            // Конец перечисления Kind
+//
+  static constexpr uint16_t kCapacity = 1024;                                   // Записей в кольце (степень двойки, 12 КБ)
+  static constexpr uint16_t kRecordSize = 8;                                    // Байт на запись в снимке
+//
+  static void record(Id id, Kind kind, int16_t arg);                            // Добавить запись (из любой задачи и ISR)
+  static size_t snapshotSize();                                                 // Наибольший размер снимка, байт
+  static size_t snapshot(uint8_t* out, size_t cap);                             // Снимок кольца (0 — буфер мал)
+  static const char* name(Id id);                                               // Имя события
+#ifdef ARDUINO
+  static void printHex(Print& out);                                             // Снимок шестнадцатеричными строками
+#endif                                                                          // ARDUINO
+//
+  class Scope {                                                                 // Участок на время области видимости
+  public:                                                                       // Публичный интерфейс
+    Scope(Id id, int16_t arg) : id_(id) { record(id, kBegin, arg); }            // Начало участка
+    ~Scope() { record(id_, kEnd, 0); }                                          // Конец участка
+    Scope(const Scope&) = delete;                                               // Копировать нельзя
+    Scope& operator=(const Scope&) = delete;                                    // Присваивать нельзя
+  private:                                                                      // Внутреннее состояние
+    Id id_;                                                                     // Источник
+  };                                                                            // Конец определения класса Scope
+};                                                                              // Конец определения класса EventTrace
+//
+#define TR_TRACE_SCOPE(id, arg) EventTrace::Scope tr_trace_scope_(EventTrace::id, static_cast<int16_t>(arg))
+#define TR_TRACE_INSTANT(id, arg) EventTrace::record(EventTrace::id, EventTrace::kInstant, static_cast<int16_t>(arg))
+#define TR_TRACE_COUNTER(id, value) EventTrace::record(EventTrace::id, EventTrace::kCounter, static_cast<int16_t>(value))
+#else
+#define TR_TRACE_SCOPE(id, arg)
+#define TR_TRACE_INSTANT(id, arg)
+#define TR_TRACE_COUNTER(id, value)
+#endif                                                                          // TR_EVENT_TRACE
@@ -0,0 +1,104 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+namespace fixed_detail {                                                        // Внутренние помощники
+constexpr int32_t sat32(int64_t v) {                                            // Насыщение до диапазона int32_t
+  return v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : static_cast<int32_t>(v));
+}                                                                               // Конец sat32
+}  // namespace fixed_detail                                                    // Завершение fixed_detail
+//
+// Знаковое число с фиксированной точкой: int32_t с FracBits дробными битами.
+// ESP32-C6 не имеет FPU, поэтому float/double эмулируются программно; арифметика
+// этого типа компилируется в целочисленные инструкции. Умножение и деление идут
+// через 64-битный промежуточный результат с насыщением вместо переполнения.
+template <int FracBits>                                                         // Количество дробных бит
+class Fixed {                                                                   // Тип Q(31-FracBits).FracBits
+  static_assert(FracBits > 0 && FracBits < 31, "invalid fraction width");       // Должны остаться целые биты
+//
+public:                                                                         // Публичный интерфейс
+  static constexpr int     kFracBits = FracBits;                                // Число дробных бит
+  static constexpr int32_t kOne = int32_t(1) << FracBits;                       // Представление единицы
+//
+  constexpr Fixed() : raw_(0) {}                                                // Ноль по умолчанию
+  constexpr explicit Fixed(int v) : raw_(sat(int64_t(v) * kOne)) {}             // Из целого (без плавающей точки)
+//
+  static constexpr Fixed fromRaw(int32_t r) { Fixed f; f.raw_ = r; return f; }  // Из сырого представления
+  static constexpr Fixed fromDouble(double v) {                                 // Из double (для констант и настроек, не для горячего пути)
+    return fromRaw(sat(static_cast<int64_t>(v * kOne + (v >= 0 ? 0.5 : -0.5)))); // Округляем к ближайшему
+  }                                                                             // Конец fromDouble
+  static constexpr Fixed fromRatio(int32_t num, int32_t den) {                  // num/den без плавающей точки
+    return fromRaw(sat((int64_t(num) * kOne) / den));                           // Деление в 64 битах
+  }                                                                             // Конец fromRatio
+  static constexpr Fixed max() { return fromRaw(INT32_MAX); }                   // Наибольшее значение
+  static constexpr Fixed min() { return fromRaw(INT32_MIN); }                   // Наименьшее значение
+//
+  constexpr int32_t raw() const { return raw_; }                                // Сырое значение
+  constexpr int32_t toInt() const { return raw_ >> FracBits; }                  // Целая часть (округление вниз)
+  constexpr int32_t roundToInt() const {                                        // Ближайшее целое
+    return static_cast<int32_t>((int64_t(raw_) + (kOne >> 1)) >> FracBits);     // Добавляем половину и отбрасываем дробь
+  }                                                                             // Конец roundToInt
+  constexpr double toDouble() const { return double(raw_) / kOne; }             // В double (для отображения)
+  constexpr float  toFloat() const { return float(raw_) / kOne; }               // В float (для отображения)
+//
+  friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw(sat(int64_t(a.raw_) + b.raw_)); }  // Сложение с насыщением
+  friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw(sat(int64_t(a.raw_) - b.raw_)); }  // Вычитание с насыщением
+  friend constexpr Fixed operator-(Fixed a) { return fromRaw(sat(-int64_t(a.raw_))); }                    // Смена знака
+  friend constexpr Fixed operator*(Fixed a, Fixed b) {                          // Умножение с насыщением
+    return fromRaw(sat((int64_t(a.raw_) * b.raw_) >> FracBits));                // 64-битное произведение и сдвиг
+  }                                                                             // Конец operator*
+  friend constexpr Fixed operator/(Fixed a, Fixed b) {                          // Деление с насыщением
+    if (b.raw_ == 0) return a.raw_ >= 0 ? max() : min();                        // Деление на ноль — к пределу
+    return fromRaw(sat((int64_t(a.raw_) * kOne) / b.raw_));                     // Делимое расширяем до 64 бит
+  }                                                                             // Конец operator/
+  Fixed& operator+=(Fixed b) { return *this = *this + b; }                      // Составное сложение
+  Fixed& operator-=(Fixed b) { return *this = *this - b; }                      // Составное вычитание
+  Fixed& operator*=(Fixed b) { return *this = *this * b; }                      // Составное умножение
+  Fixed& operator/=(Fixed b) { return *this = *this / b; }                      // Составное деление
+//
+  friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw_ == b.raw_; }  // Сравнения по сырому значению
+  friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw_ != b.raw_; }
+  friend constexpr bool operator<(Fixed a, Fixed b)  { return a.raw_ <  b.raw_; }
+  friend constexpr bool operator>(Fixed a, Fixed b)  { return a.raw_ >  b.raw_; }
+  friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw_ <= b.raw_; }
+  friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw_ >= b.raw_; }
+//
+private:                                                                        // Внутреннее представление
+  static constexpr int32_t sat(int64_t v) { return fixed_detail::sat32(v); }    // Насыщение до диапазона int32_t
+  int32_t raw_;                                                                 // Сырое значение
+};                                                                              // Конец шаблона Fixed
+//
+template <int To, int From>                                                     // Формат результата и формат множителя
+constexpr Fixed<To> mulInt(Fixed<From> a, int32_t n) {                          // a*n с переводом в другой формат (например Q24*АЦП -> Q16)
+  const int64_t p = int64_t(a.raw()) * n;                                       // Точное 64-битное произведение
+  if constexpr (From >= To) {                                                   // Результат грубее множителя
+    return Fixed<To>::fromRaw(fixed_detail::sat32(p >> (From - To)));           // Отбрасываем лишние дробные биты
+  } else {                                                                      // Результат точнее множителя
+    return Fixed<To>::fromRaw(fixed_detail::sat32(p * (int64_t(1) << (To - From))));  // Дописываем дробные биты
+  }                                                                             // Конец выбора направления
+}                                                                               // Конец mulInt
+//
+using Q16 = Fixed<16>;                                                          // Q15.16: ±32767 с шагом 1.5e-5 — температура, мощность, коэффициенты
+using Q24 = Fixed<24>;                                                          // Q7.24: ±127 с шагом 6e-8 — малые коэффициенты (наклон калибровки)
+//
+// Единый способ преобразования для шаблонного кода, работающего и с double,
+// и с Fixed: в горячем пути используются только fromInt/fromRatio.
+template <typename T>                                                           // Общий случай — встроенные типы с плавающей точкой
+struct NumericTraits {                                                          // Преобразования для float/double
+  using Fine = T;                                                               // Тип малых коэффициентов (Ki)
+  static constexpr T fromDouble(double v) { return static_cast<T>(v); }         // Из double
+  static constexpr T fromInt(int32_t v) { return static_cast<T>(v); }           // Из целого
+  static constexpr T fromRatio(int32_t n, int32_t d) { return static_cast<T>(n) / static_cast<T>(d); }  // Из дроби
+  static constexpr double toDouble(T v) { return static_cast<double>(v); }      // В double
+  static constexpr int32_t toInt(T v) { return static_cast<int32_t>(v); }       // Усечение к целому
+};                                                                              // Конец NumericTraits<T>
+//
+template <int F>                                                                // Специализация для фиксированной точки
+struct NumericTraits<Fixed<F>> {                                                // Преобразования для Fixed<F>
+  using Fine = Fixed<(F + 8 < 30 ? F + 8 : 30)>;                                // Ki печи ~1e-4: Q16 теряет проценты, Q24 — нет
+  static constexpr Fixed<F> fromDouble(double v) { return Fixed<F>::fromDouble(v); }
+  static constexpr Fixed<F> fromInt(int32_t v) { return Fixed<F>(static_cast<int>(v)); }
+  static constexpr Fixed<F> fromRatio(int32_t n, int32_t d) { return Fixed<F>::fromRatio(n, d); }
+  static constexpr double toDouble(Fixed<F> v) { return v.toDouble(); }
+  static constexpr int32_t toInt(Fixed<F> v) { return v.toInt(); }
+};                                                                              // Конец NumericTraits<Fixed<F>>
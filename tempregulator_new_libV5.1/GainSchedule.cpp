@@ -0,0 +1,44 @@
+#include "GainSchedule.h"                                                       // Объявление класса
+//
+void GainSchedule::compile(const Point* points, uint8_t n) {                    // Сборка таблицы
+  count_ = 0;                                                                   // Начинаем с пустой
+  if (n > kMaxPoints) n = kMaxPoints;
+  for (uint8_t i = 0; i < n; ++i) {                                             // Вставка по возрастанию температуры
+    const Point& p = points[i];
+    if (!(p.temp_c > 0.0f)) continue;                                           // Точка выключена
+    Node node{};
+    node.t_raw = Q16::fromDouble(p.temp_c).raw();
+    node.kp_raw = Q16::fromDouble(p.kp > 0.0f ? p.kp : 0.0f).raw();             // Отрицательные коэффициенты не имеют смысла
+    node.ki_raw = Q24::fromDouble(p.ki > 0.0f ? p.ki : 0.0f).raw();
+    node.kd_raw = Q16::fromDouble(p.kd > 0.0f ? p.kd : 0.0f).raw();
+    uint8_t j = count_;
+    while (j > 0 && node_[j - 1].t_raw > node.t_raw) --j;                       // Место по возрастанию температуры
+    if (j > 0 && node_[j - 1].t_raw == node.t_raw) continue;                    // Та же температура — остаётся первая
+    for (uint8_t k = count_; k > j; --k) node_[k] = node_[k - 1];               // Сдвигаем более горячие точки
+    node_[j] = node;
+    ++count_;
+  }
+  for (uint8_t i = 0; i < count_; ++i) {                                        // Деления — один раз, здесь
+    node_[i].inv_span = i + 1 < count_
+        ? (int64_t(1) << 48) / (int64_t(node_[i + 1].t_raw) - node_[i].t_raw)
+        : 0;
+  }
+}                                                                               // Завершение compile
+//
+void GainSchedule::eval(Q16 pv, Q16& kp, Q24& ki, Q16& kd) const {              // Интерполяция
+  const int32_t t = pv.raw();
+  uint8_t i = 0;
+  while (i + 1 < count_ && t >= node_[i + 1].t_raw) ++i;                        // Интервал, в котором лежит pv
+  const Node& a = node_[i];
+  if (i + 1 >= count_ || t <= a.t_raw) {                                        // За крайней точкой — её набор
+    kp = Q16::fromRaw(a.kp_raw);
+    ki = Q24::fromRaw(a.ki_raw);
+    kd = Q16::fromRaw(a.kd_raw);
+    return;
+  }
+  const Node& b = node_[i + 1];
+  const int64_t w = (int64_t(t - a.t_raw) * a.inv_span) >> 32;                  // Доля интервала, Q16 (0..1)
+  kp = Q16::fromRaw(static_cast<int32_t>(a.kp_raw + ((int64_t(b.kp_raw) - a.kp_raw) * w >> 16)));
+  ki = Q24::fromRaw(static_cast<int32_t>(a.ki_raw + ((int64_t(b.ki_raw) - a.ki_raw) * w >> 16)));
+  kd = Q16::fromRaw(static_cast<int32_t>(a.kd_raw + ((int64_t(b.kd_raw) - a.kd_raw) * w >> 16)));
+}                                                                               // Завершение eval
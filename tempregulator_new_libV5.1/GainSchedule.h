@@ -0,0 +1,45 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Kp, Kd в Q16, Ki в Q24 — как у PID
+//
+// Таблица коэффициентов PID по температуре (gain scheduling). Теплопотери и
+// усиление печи сильно меняются между 40 и 500 °C, поэтому один набор Kp/Ki/Kd
+// либо раскачивает выдержки при низкой температуре, либо затягивает рампы при
+// высокой. Точка таблицы — набор коэффициентов для своей температуры; между
+// точками коэффициенты интерполируются линейно, за крайними точками держатся
+// крайние наборы. Точка с температурой ≤ 0 не используется.
+//
+// compile() сортирует точки и заранее считает величину, обратную ширине
+// интервала (Q16 × 2^32), поэтому eval() в задаче регулятора — поиск интервала
+// по 3–4 точкам, умножения и сдвиги, без float и деления. Безударность смены
+// коэффициентов обеспечивает PIDControllerT::setGains().
+class GainSchedule {                                                            // Коэффициенты PID по температуре
+public:                                                                         // Публичный интерфейс
+  static constexpr uint8_t kMaxPoints = 4;                                      // Точек в таблице
+//
+  struct Point {                                                                // Точка таблицы в том виде, как её хранят и редактируют
+    float temp_c;                                                               // Температура точки, °C (≤ 0 — точка не используется)
+    float kp;                                                                   // Коэффициенты PID для этой температуры
+    float ki;
+    float kd;
+  };                                                                            // Конец структуры Point
+//
+  void compile(const Point* points, uint8_t n);                                 // Пересобрать таблицу (не более kMaxPoints точек)
+  bool active() const { return count_ > 0; }                                    // Есть хотя бы одна точка
+  uint8_t count() const { return count_; }                                      // Число используемых точек
+  void eval(Q16 pv, Q16& kp, Q24& ki, Q16& kd) const;                           // Коэффициенты для измерения pv (только при active())
+//
+private:                                                                        // Внутреннее состояние
+  struct Node {                                                                 // Скомпилированная точка
+    int32_t t_raw;                                                              // Температура, Q16
+    int32_t kp_raw;                                                             // Коэффициенты, Q16
+    int32_t ki_raw;                                                             // Q24: Ki печи ~1e-4
+    int32_t kd_raw;
+    int64_t inv_span;                                                           // 2^48 / (t следующей − t), 0 у последней
+  };                                                                            // Конец структуры Node
+//
+  Node    node_[kMaxPoints] = {};                                               // Точки по возрастанию температуры
+  uint8_t count_ = 0;                                                           // Число точек
+};                                                                              // Конец определения класса GainSchedule
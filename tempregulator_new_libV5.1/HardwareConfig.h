@@ -10,16 +10,23 @@
 #define PIN_TFT_RST 5                                  // Пин аппаратного сброса TFT
 //
 #define PIN_TOUCH_CS  21                               // Пин выбора чипа тачскрина XPT2046
+#define PIN_TC_SPI_CS 22                               // Пин выбора SPI-усилителя термопары (MAX31855/MAX31856), если tc_source != 0
 //
 #define ENCODER_A_PIN   11                             // Линия A энкодера
 #define ENCODER_B_PIN   3                              // Линия B энкодера
 #define ENCODER_BTN_PIN 8                              // Кнопка энкодера
 //
 #define THERMOCOUPLE_PIN 1                             // Аналоговый вход усилителя термопары
+#define TC_WALL_PIN      -1                            // Термопара стенки камеры (например GPIO0); -1 — нет
+#define TC_SAFETY_PIN    -1                            // Защитная термопара; -1 — нет
 #define SSR_CONTROL_PIN  19                            // Управление твердотельным реле нагревателя
 #define SSR_FEEDBACK_PIN 20                            // Вход обратной связи SSR (если используется)
 #define BUZZER_PIN       18                            // Пин пьезоизлучателя
 //
+#define CJC_SENSOR_PIN      -1                         // Аналоговый датчик холодного спая (TMP36 и т.п.); -1 — нет, используется температура калибровки
+#define CJC_SENSOR_MV_AT_0C 500                        // Выход датчика холодного спая при 0 °C, мВ
+#define CJC_SENSOR_MV_PER_C 10                         // Крутизна датчика холодного спая, мВ/°C
+//
 #define LED_R_PIN 15                                   // Красный канал RGB-светодиода
 #define LED_G_PIN 16                                   // Зелёный канал RGB-светодиода
 #define LED_B_PIN 17                                   // Синий канал RGB-светодиода
@@ -0,0 +1,96 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+#include <string.h>                                                             // memmove
+//
+#include <type_traits>                                                          // is_trivially_copyable
+//
+// Скользящий медианный фильтр с отбраковкой выбросов фиксированной ёмкости.
+// Хранит окно в порядке поступления и отдельно отсортированную копию, которую
+// обновляет инкрементно: позиции вытесняемого и нового отсчёта находятся
+// двоичным поиском, а элементы между ними сдвигаются на одну позицию одним
+// memmove. Память выделяется только внутри объекта, куча не используется.
+template <size_t N, uint32_t Threshold, typename T = uint16_t>                  // N — размер окна, Threshold — допуск от медианы
+class SlidingMedianFilter {                                                     // Шаблон фильтра
+  static_assert(N > 0, "window must not be empty");                             // Пустое окно не имеет смысла
+  static_assert(N < 256, "outlier counter is 8-bit");                           // Счётчик выбросов помещается в uint8_t
+  static_assert(std::is_trivially_copyable<T>::value, "sorted_ is moved with memmove");  // Блочный сдвиг
+//
+public:                                                                         // Публичный интерфейс
+  static constexpr size_t   kWindow    = N;                                     // Размер окна
+  static constexpr uint32_t kThreshold = Threshold;                             // Допуск от медианы
+//
+  void reset() { head_ = 0; count_ = 0; }                                       // Очистить окно
+//
+  void push(T sample) {                                                         // Добавить отсчёт: два двоичных поиска и один memmove
+    if (count_ == N) {                                                          // Окно заполнено — вытесняем самый старый
+      replaceSorted(ring_[head_], sample);                                      // Старый и новый — за один сдвиг
+    } else {                                                                    // Иначе окно ещё растёт
+      insertSorted(sample);                                                     // Вставка в отсортированную копию
+      ++count_;                                                                 // Увеличиваем размер
+    }                                                                           // Конец проверки заполнения
+    ring_[head_] = sample;                                                      // Кладём новый отсчёт в кольцо
+    head_ = (head_ + 1 == N) ? 0 : head_ + 1;                                   // Сдвигаем позицию записи
+  }                                                                             // Конец push
+//
+  size_t size() const { return count_; }                                        // Текущее число отсчётов
+  bool   full() const { return count_ == N; }                                   // Окно заполнено
+  bool   wrapped() const { return count_ == N && head_ == 0; }                  // Последний push завершил полный круг окна
+  T      median() const { return count_ ? sorted_[count_ / 2] : T(); }          // Медиана окна за O(1)
+//
+  T filtered(uint8_t& out_outliers) const {                                     // Среднее по отсчётам в пределах допуска от медианы
+    if (count_ == 0) {                                                          // Пустое окно
+      out_outliers = 0;                                                         // Выбросов нет
+      return T();                                                               // Возвращаем ноль
+    }                                                                           // Конец проверки
+    const T med = median();                                                     // Медиана окна
+    const T lo  = (med > static_cast<T>(Threshold)) ? static_cast<T>(med - Threshold) : T();  // Нижняя граница допуска
+    const uint32_t hi = static_cast<uint32_t>(med) + Threshold;                 // Верхняя граница допуска
+    const size_t first = lowerBound(lo);                                        // Первый невыброс (окно отсортировано)
+    size_t last = first;                                                        // Граница за последним невыбросом
+    uint32_t acc = 0;                                                           // Сумма невыбросов
+    while (last < count_ && static_cast<uint32_t>(sorted_[last]) <= hi) {       // Невыбросы лежат подряд
+      acc += sorted_[last];                                                     // Накопление суммы
+      ++last;                                                                   // Следующий отсчёт
+    }                                                                           // Конец накопления
+    const size_t n = last - first;                                              // Число невыбросов (медиана всегда среди них)
+    out_outliers = static_cast<uint8_t>(count_ - n);                            // Остальное — выбросы
+    return static_cast<T>(acc / n);                                             // Среднее невыбросов
+  }                                                                             // Конец filtered
+//
+private:                                                                        // Внутренние помощники
+  size_t lowerBound(T v, size_t n) const {                                      // Первый индекс sorted_[0..n) со значением >= v
+    size_t lo = 0, hi = n;                                                      // Полуинтервал поиска
+    while (lo < hi) {                                                           // Двоичный поиск
+      const size_t mid = (lo + hi) / 2;                                         // Середина
+      if (sorted_[mid] < v) lo = mid + 1; else hi = mid;                        // Сужаем интервал
+    }                                                                           // Конец поиска
+    return lo;                                                                  // Найденная позиция
+  }                                                                             // Конец lowerBound
+  size_t lowerBound(T v) const { return lowerBound(v, count_); }                // По всему окну
+//
+  void insertSorted(T v) {                                                      // Вставка в sorted_[0..count_) (count_ ещё без v)
+    const size_t i = lowerBound(v);                                             // Место нового значения
+    memmove(&sorted_[i + 1], &sorted_[i], (count_ - i) * sizeof(T));            // Хвост вправо одним блоком
+    sorted_[i] = v;                                                             // Ставим значение на место
+  }                                                                             // Конец insertSorted
+//
+  void replaceSorted(T old, T v) {                                              // Заменить old на v, сохранив порядок
+    const size_t i = lowerBound(old);                                           // Позиция вытесняемого значения
+    if (v > old) {                                                              // Новое правее: сдвиг (i, k) влево
+      const size_t k = lowerBound(v);                                           // Первый элемент >= v
+      memmove(&sorted_[i], &sorted_[i + 1], (k - i - 1) * sizeof(T));
+      sorted_[k - 1] = v;
+    } else {                                                                    // Новое левее или равно: сдвиг [k, i) вправо
+      const size_t k = lowerBound(v, i);                                        // Первый элемент >= v левее old
+      memmove(&sorted_[k + 1], &sorted_[k], (i - k) * sizeof(T));
+      sorted_[k] = v;
+    }                                                                           // Конец выбора направления
+  }                                                                             // Конец replaceSorted
+//
+  T      ring_[N]{};                                                            // Отсчёты в порядке поступления
+  T      sorted_[N]{};                                                          // Те же отсчёты по возрастанию
+  size_t head_  = 0;                                                            // Позиция следующей записи в ring_
+  size_t count_ = 0;                                                            // Число валидных отсчётов
+};                                                                              // Конец шаблона SlidingMedianFilter
@@ -0,0 +1,264 @@
+#include "OvershootShaper.h"                                                    // Объявление класса
+//
+#include <math.h>                                                               // expf
+#include <limits.h>                                                             // INT32_MIN
+//
+bool OvershootShaper::configure(const StepIdentifier::Model& m) {               // Модель печи
+  ready_ = m.valid && m.gain > 0.0 && m.tau_s > 0.0 && m.dead_s >= 0.0;
+  running_ = false;
+  if (!ready_) return false;
+  model_ = m;
+  a_ = expf(-(kSampleMs / 1000.0f) / static_cast<float>(m.tau_s));              // Точная дискретизация первого порядка
+  b_ = static_cast<float>(m.gain) * (1.0f - a_);
+  const double d = m.dead_s * 1000.0 / kSampleMs + 0.5;
+  delay_ = d < kMaxDelay - 1 ? static_cast<uint8_t>(d) : kMaxDelay - 1;
+  release_raw_ = Q16::fromDouble(kReleaseC).raw();
+  band_raw_ = Q16::fromDouble(kBandC).raw();
+  preset_band_raw_ = Q16::fromDouble(kPresetBandC).raw();
+  release_ms_ = static_cast<uint32_t>(m.dead_s * 1000.0 * kReleaseDead);
+  tau_per_k_ = static_cast<float>(m.tau_s / m.gain);
+  return true;
+}                                                                               // Завершение configure
+//
+void OvershootShaper::start(uint32_t now_ms) {                                  // Пуск нагрева
+  x_ = 0.0f;                                                                    // Модель в покое: считаем приращения от пуска
+  for (float& v : ring_) v = 0.0f;
+  head_ = 0;
+  lead_raw_ = 0;
+  for (uint8_t& v : power_) v = 0;
+  late_sum_ = 0;
+  power_head_ = 0;
+  pv_head_ = 0;
+  windows_ = 0;
+  hold_valid_ = false;
+  preset_ = false;
+  win_t0_ = now_ms;
+  win_u_ = 0;
+  win_n_ = 0;
+  target_raw_ = INT32_MIN;                                                      // Первая цель взведёт формирование
+  armed_ = false;
+  engaged_ = false;
+  shaping_ = false;
+  running_ = ready_;
+}                                                                               // Завершение start
+//
+void OvershootShaper::stop() {                                                  // Остановка
+  running_ = false;
+  shaping_ = false;
+  preset_ = false;
+}                                                                               // Завершение stop
+//
+void OvershootShaper::tick(uint32_t now_ms, int u, Q16 pv) {                    // Шаг задачи регулятора
+  if (!running_) return;
+  win_u_ += static_cast<uint32_t>(u < 0 ? 0 : (u > 255 ? 255 : u));
+  ++win_n_;
+  if (now_ms - win_t0_ < kSampleMs) return;
+  const float uw = static_cast<float>(win_u_) / win_n_;                         // Средняя мощность окна
+  win_t0_ = now_ms;
+  win_u_ = 0;
+  win_n_ = 0;
+  x_ = a_ * x_ + b_ * uw;                                                       // Выход модели без запаздывания
+  ring_[head_] = x_;
+  const float late = ring_[(head_ + kMaxDelay - delay_) % kMaxDelay];           // Тот же выход θ назад — то, что видит термопара
+  head_ = (head_ + 1) % kMaxDelay;
+  lead_raw_ = static_cast<int32_t>((x_ - late) * 65536.0f);
+//
+  constexpr uint16_t kLen = kMaxDelay + kHoldWindows;                           // История мощности: θ и окно оценки
+  power_[power_head_] = static_cast<uint8_t>(uw + 0.5f);
+  late_sum_ += power_[(power_head_ + kLen - delay_) % kLen];                    // Окно дошло до камеры
+  if (windows_ >= kHoldWindows) late_sum_ -= power_[(power_head_ + kLen - delay_ - kHoldWindows) % kLen];
+  power_head_ = (power_head_ + 1) % kLen;
+  pv_[pv_head_] = pv.raw();
+  pv_head_ = (pv_head_ + 1) % (kHoldWindows + 1);
+  if (windows_ < kLen) ++windows_;
+  hold_valid_ = windows_ > delay_ + kHoldWindows;                               // Оба окна уже в истории
+  if (!hold_valid_) return;
+  const int32_t old = pv_[pv_head_];                                            // Измерение kHoldWindows окон назад
+  const float slope = (pv.raw() - old) / 65536.0f / (kHoldWindows * (kSampleMs / 1000.0f));  // °C/с за окно
+  hold_u_ = static_cast<float>(late_sum_) / kHoldWindows - tau_per_k_ * slope;  // Мощность удержания при hold_pv_
+  hold_pv_ = (pv.raw() + old) / 131072.0f;
+}                                                                               // Завершение tick
+//
+Q16 OvershootShaper::shape(Q16 sp, Q16 target, Q16 pv) {                        // Уставка для PID
+  shaping_ = false;
+  if (!running_) return sp;
+  if (target.raw() != target_raw_) {                                            // Новая цель — формирование снова нужно
+    target_raw_ = target.raw();
+    armed_ = true;
+    engaged_ = false;
+    preset_ = false;
+    preset_used_ = false;
+  }
+  if (!armed_) return sp;
+  const int32_t lead = lead_raw_ > 0 ? lead_raw_ : 0;                           // Спад после снятия мощности не в счёт
+  const int32_t excess = pv.raw() + lead - target_raw_;                         // Предсказанный выход за цель
+  if (excess > 0) engaged_ = true;
+  if (!preset_used_ && hold_valid_ && excess > -preset_band_raw_) {             // Подход к цели: запоминаем мощность удержания
+    const float u = hold_u_ + (target_raw_ / 65536.0f - hold_pv_) / static_cast<float>(model_.gain);
+    preset_raw_ = static_cast<int32_t>((u < 0.0f ? 0.0f : (u > 255.0f ? 255.0f : u)) * 65536.0f);
+    preset_ = true;
+    preset_used_ = true;                                                        // Один раз на цель
+    preset_t0_ = win_t0_;
+  }
+  if (preset_ && (pv.raw() >= target_raw_ - band_raw_ || win_t0_ - preset_t0_ >= kPresetMs)) {
+    preset_ = false;                                                            // Цель достигнута или оценка устарела: интеграл свободен
+  }
+  if (sp.raw() < target_raw_ || !engaged_) {
+    hold_t0_ = win_t0_;                                                         // Рампа или печь ещё не подошла: часы выдержки стоят
+  } else if (win_t0_ - hold_t0_ >= release_ms_) {
+    armed_ = false;                                                             // Модель дольше печи помнит тепло «в пути»
+    preset_ = false;
+    return sp;
+  }
+  if (sp.raw() >= target_raw_ && lead < release_raw_ && pv.raw() >= target_raw_ - band_raw_) {
+    armed_ = false;                                                             // Печь вышла на цель, дальше — обычный PID
+    preset_ = false;
+    return sp;
+  }
+  if (excess <= 0) return sp;                                                   // Садка отстаёт — рампа как есть
+  shaping_ = true;
+  return Q16::fromRaw(sp.raw() - kLeadGain * excess);
+}                                                                               // Завершение shape
+//
+#ifdef TR_AUTOTUNE_SIM
+#include <stdio.h>                                                              // printf: и на устройстве, и на хосте
+#include "PIDController.h"                                                      // Замкнутый контур с регулятором прошивки
+#include "ProfileRunner.h"                                                      // Уставка по профилю, как в работе
+#include "PlatformClock.h"                                                      // Такты на устройстве, нс на хосте
+//
+namespace {                                                                     // Модель печи для отладочной сборки
+//
+// Нагреватель и камера — два инерционных звена: тепло, накопленное в
+// нагревателе, продолжает греть камеру после снятия мощности. Модель первого
+// порядка, по которой работает формирователь, снимается с этой же печи
+// ступенькой мощности (StepIdentifier), как на устройстве.
+struct SimPlant {                                                               // Два звена, запаздывание и шум термопары
+  static constexpr uint32_t kDtMs = 100;                                        // Шаг регулятора
+  static constexpr uint32_t kMaxDelay = 600;                                    // Наибольшее запаздывание, шагов
+  double   gain;                                                                // °C на единицу выхода
+  double   tau_heater_s;                                                        // Постоянная нагревателя, с
+  double   tau_s;                                                               // Постоянная камеры, с
+  uint32_t delay;                                                               // Запаздывание, шагов
+  double   heater = 25.0;                                                       // Температура нагревателя
+  double   temp = 25.0;                                                         // Температура камеры
+  uint8_t  line[kMaxDelay] = {};                                                // Выход по пути к печи
+  uint32_t n = 0;                                                               // Номер шага
+  uint32_t seed = 12345;                                                        // Генератор шума
+//
+  Q16 step(uint8_t u) {                                                         // Шаг модели: выход → измерение
+    uint8_t late = u;
+    if (delay) {
+      late = line[n % delay];
+      line[n % delay] = u;
+    }
+    ++n;
+    const double dt = kDtMs / 1000.0;
+    heater += (gain * late - (heater - 25.0)) / tau_heater_s * dt;
+    temp += (heater - temp) / tau_s * dt;
+    seed = seed * 1664525u + 1013904223u;
+    return Q16::fromDouble(temp + 0.3 * ((seed >> 16) % 1001 / 1000.0 - 0.5));
+  }
+};                                                                              // Конец структуры SimPlant
+//
+SimPlant makePlant(double gain, double tau_heater_s, double tau_s, double dead_s) {
+  SimPlant p{};
+  p.gain = gain;
+  p.tau_heater_s = tau_heater_s;
+  p.tau_s = tau_s;
+  p.delay = static_cast<uint32_t>(dead_s * 1000 / SimPlant::kDtMs);
+  return p;
+}                                                                               // Завершение makePlant
+//
+StepIdentifier::Model identify(double gain, double tau_heater_s, double tau_s, double dead_s) {  // Ступенька 40 %
+  SimPlant p = makePlant(gain, tau_heater_s, tau_s, dead_s);
+  StepIdentifier id;
+  id.start(0, Q16(450), 100);
+  Q16 pv = p.step(0);
+  for (uint32_t now = 0; id.running() && now < 6UL * 3600 * 1000; now += SimPlant::kDtMs) {
+    pv = p.step(id.tick(now, pv));
+  }
+  return id.model();
+}                                                                               // Завершение identify
+//
+// Профиль: 25 → 300 °C за 55 мин (5 °C/мин), выдержка 60 мин, 300 → 450 °C за
+// 50 мин (3 °C/мин), выдержка 60 мин. Коэффициенты — IMC по снятой модели,
+// умноженные на kp_mul и ki_mul (быстрая настройка под слежение за рампой).
+void simulate(const StepIdentifier::Model& m, const SimPlant& plant, double kp_mul, double ki_mul, bool shaped) {
+  const StepIdentifier::Gains g = StepIdentifier::gains(m, StepIdentifier::kImcPid);
+  SimPlant p = plant;
+  ProfileRunner runner;
+  runner.addSegment(25.0f, 300.0f, 55.0f);
+  runner.addSegment(300.0f, 300.0f, 60.0f);
+  runner.addSegment(300.0f, 450.0f, 50.0f);
+  runner.addSegment(450.0f, 450.0f, 60.0f);
+  PIDController pid;
+  pid.setCoeffs(g.kp * kp_mul, g.ki * ki_mul, g.kd);
+  pid.setFixedDt(SimPlant::kDtMs);
+  OvershootShaper shaper;
+  shaper.configure(m);
+  runner.start(0);
+  shaper.start(0);
+  Q16 pv = p.step(0);
+  double pv_f = pv.toDouble();                                                  // PID — по сглаженному, как за фильтром Калмана
+  double over[2] = {}, iae[2] = {}, settle[2] = {};
+  uint32_t cost_max = 0, cost_sum = 0, cost_n = 0;
+  int u = 0;
+  for (uint32_t now = 0; runner.tick(now, Q16::fromDouble(pv_f)); now += SimPlant::kDtMs) {
+    pv_f += (pv.toDouble() - pv_f) * 0.05;                                      // Постоянная 2 с
+    const Q16 pvq = Q16::fromDouble(pv_f);
+    const uint8_t i = runner.segment();
+    Q16 sp = runner.setpoint();
+    if (shaped) {
+      const uint32_t c0 = platformCycles();
+      shaper.tick(now, u, pvq);
+      if (runner.isHold(i) || (runner.isRampUp(i) && runner.isHold(i + 1))) {   // Нагрев перед выдержкой и сама выдержка
+        sp = shaper.shape(sp, runner.segmentEnd(i), pvq);
+        if (shaper.presetting()) pid.presetIntegral(shaper.integralPreset());
+      }
+      const uint32_t c = platformCycles() - c0;
+      cost_sum += c;
+      ++cost_n;
+      if (c > cost_max) cost_max = c;
+    }
+    pid.setSetpointValue(sp);
+    u = pid.compute(pvq);
+    pv = p.step(static_cast<uint8_t>(u));
+    if (runner.isHold(i)) {                                                     // Качество выдержек
+      const uint8_t h = i / 2;
+      const double target = runner.segmentEnd(i).toDouble();
+      const double e = p.temp - target;
+      if (e > over[h]) over[h] = e;
+      iae[h] += fabs(e) * SimPlant::kDtMs / 1000.0;
+      if (fabs(e) > 1.0) settle[h] = runner.segmentElapsedMs() / 60000.0;       // Последний выход из ±1 °C
+    }
+  }
+  printf("[SHAPE] heater %.0f s, chamber %.0f s, theta %.0f s, Kp x%.0f Ki x%.0f, %s: overshoot %.2f / %.2f C, "
+         "hold IAE %.0f / %.0f C*s, within 1 C after %.1f / %.1f min",
+         p.tau_heater_s, p.tau_s, p.delay * SimPlant::kDtMs / 1000.0, kp_mul, ki_mul, shaped ? "shaped" : "plain ",
+         over[0], over[1], iae[0], iae[1], settle[0], settle[1]);
+  if (shaped) {
+    printf(", tick avg %lu max %lu %s", static_cast<unsigned long>(cost_sum / cost_n),
+           static_cast<unsigned long>(cost_max), kPlatformCycleUnit);
+  }
+  printf("\n");
+}                                                                               // Завершение simulate
+//
+void run(double gain, double tau_heater_s, double tau_s, double dead_s) {       // Снять модель и сравнить
+  const StepIdentifier::Model m = identify(gain, tau_heater_s, tau_s, dead_s);
+  printf("[SHAPE] model K %.2f tau %.0f s theta %.0f s%s\n", m.gain, m.tau_s, m.dead_s, m.valid ? "" : " (invalid)");
+  if (!m.valid) return;
+  const SimPlant p = makePlant(gain, tau_heater_s, tau_s, dead_s);
+  simulate(m, p, 1.0, 1.0, false);                                              // IMC: перерегулирования нет, мешать нельзя
+  simulate(m, p, 1.0, 1.0, true);
+  simulate(m, p, 2.0, 4.0, false);                                              // Быстрая настройка: интеграл уносит за цель
+  simulate(m, p, 2.0, 4.0, true);
+}                                                                               // Завершение run
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runShaperSimulation() {                                                    // Печи с разной долей тепла в нагревателе
+  run(2.0, 60.0, 600.0, 15.0);                                                  // Лёгкий нагреватель
+  run(2.0, 180.0, 600.0, 15.0);                                                 // Массивный нагреватель
+  run(2.0, 300.0, 1200.0, 30.0);                                                // Тяжёлая печь
+}                                                                               // Завершение runShaperSimulation
+#endif                                                                          // TR_AUTOTUNE_SIM
@@ -0,0 +1,111 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Уставка и измерение в Q16, как у PID
+#include "StepIdentifier.h"                                                     // Модель печи первого порядка с запаздыванием
+//
+// Упреждающее формирование уставки на переходе «нагрев → выдержка». На рампе
+// интеграл PID и тепло, уже отданное нагревателем, но ещё не дошедшее до
+// термопары, уносят камеру за уставку выдержки. Рядом с PID идёт модель печи
+// K·e^(−θs)/(τs + 1) (по ступеньке мощности — StepIdentifier — или заданная
+// вручную), которую питает фактическая мощность. Её выход без запаздывания
+// опережает измерение на θ, и разница выходов «сейчас» и «θ назад» — рост,
+// который придёт, даже если мощность снять прямо сейчас (как у предиктора
+// Смита). Температура, на которую печь выйдет, — pv + lead().
+//
+// shape() сравнивает предсказание с целью — конечной уставкой рампы, за
+// которой идёт выдержка, или уставкой самой выдержки. Пока садка отстаёт
+// (pv + lead() ≤ цели), уставка не меняется, поэтому настроенному без запаса
+// PID формирователь не мешает. Когда предсказание переходит за цель, уставка
+// опускается на kLeadGain таких градусов, и PID снимает мощность ещё на рампе.
+// На выдержке формирование снимается, когда lead() < kReleaseC, а измерение
+// вошло в kBandC от цели, или через kReleaseDead·θ (модель первого порядка
+// дольше реальной печи считает тепло «в пути»). Новая цель — следующая
+// выдержка или другая уставка — снова включает формирование.
+//
+// Опущенной уставки мало, когда за цель уносит сам PID: на рампе интеграл
+// набирает мощность разгона (теплоёмкость × скорость роста), а на выдержке
+// её нужно сбросить, и медленный интеграл IMC-настройки делает это часами.
+// Поэтому по истории окон оценивается мощность удержания цели: из баланса
+// C·dT/dt = P·u(t − θ) − потери(T) следует u_уд = ū(t − θ) − (τ/K)·dT/dt
+// (среднее за kHoldWindows), плюс (цель − pv)/K до самой цели. Отношение τ/K
+// — теплоёмкость на единицу мощности — от температуры линеаризации не
+// зависит. Когда предсказание подходит к цели на kPresetBandC, оценка
+// запоминается, и до подхода к цели интеграл PID держится на ней (presetting()
+// и integralPreset() — для WorkLoop): выход на цели сразу равен мощности
+// удержания, а не мощности рампы. Держится в обе стороны: интеграл выше
+// оценки уносит печь за цель, ниже — оставляет её часами подползать снизу.
+//
+// tick() вызывается в задаче регулятора на каждом шаге: на шаге — сложение в
+// целых, на границе окна kSampleMs — шаг модели и оценка мощности удержания в
+// float (раз в секунду). shape() — сравнение и вычитание в Q16. Кучи нет:
+// запаздывание и история — кольца.
+class OvershootShaper {                                                         // Формирователь уставки по модели печи
+public:                                                                         // Публичный интерфейс
+  static constexpr uint32_t kSampleMs = 1000;                                   // Шаг модели
+  static constexpr uint8_t  kMaxDelay = 240;                                    // Наибольшее запаздывание, окон (4 мин)
+  static constexpr int32_t  kLeadGain = 2;                                      // Уставка опускается на столько предсказанных °C выхода за цель
+  static constexpr float    kReleaseC = 0.2f;                                   // Остаточный рост, при котором формирование снимается,
+  static constexpr float    kBandC = 1.0f;                                      // если измерение уже в этой полосе от цели
+  static constexpr uint8_t  kReleaseDead = 3;                                   // Иначе — через столько θ выдержки
+  static constexpr uint8_t  kHoldWindows = 120;                                 // Окно оценки мощности удержания, окон (2 мин)
+  static constexpr float    kPresetBandC = 5.0f;                                // Интеграл = оценка — когда pv + lead() ближе к цели,
+  static constexpr uint32_t kPresetMs = 600000;                                 // пока pv не в kBandC от цели, но не дольше
+//
+  bool configure(const StepIdentifier::Model& m);                               // Модель печи (false — непригодна)
+  void start(uint32_t now_ms);                                                  // Пуск нагрева: модель в покое
+  void stop();                                                                  // Остановка
+  void tick(uint32_t now_ms, int u, Q16 pv);                                    // Шаг модели по выданной мощности и измерению
+  Q16  shape(Q16 sp, Q16 target, Q16 pv);                                       // Уставка для PID (не выше sp)
+//
+  bool ready() const { return ready_; }                                         // Модель задана
+  bool running() const { return running_; }                                     // Модель идёт
+  bool shaping() const { return shaping_; }                                     // Последний shape() опустил уставку
+  bool presetting() const { return preset_; }                                   // Интеграл PID держится на integralPreset()
+  Q16  lead() const { return Q16::fromRaw(lead_raw_); }                         // Рост, который ещё придёт, °C
+  Q16  integralPreset() const { return Q16::fromRaw(preset_raw_); }             // Мощность удержания цели, 0..255
+  const StepIdentifier::Model& model() const { return model_; }                 // Текущая модель
+//
+private:                                                                        // Внутреннее состояние
+  StepIdentifier::Model model_{};                                               // Модель печи
+  bool     ready_ = false;                                                      // Модель пригодна
+  bool     running_ = false;                                                    // Модель идёт
+  bool     armed_ = false;                                                      // Формирование для текущей цели не снято
+  bool     engaged_ = false;                                                    // Предсказание хоть раз переходило за цель
+  bool     shaping_ = false;                                                    // Уставка опущена
+  float    a_ = 0.0f;                                                           // e^(−Ts/τ)
+  float    b_ = 0.0f;                                                           // K·(1 − a)
+  float    x_ = 0.0f;                                                           // Выход модели без запаздывания, °C от начала
+  float    ring_[kMaxDelay] = {};                                               // Выход модели прошлых окон
+  uint8_t  power_[kMaxDelay + kHoldWindows] = {};                               // Средняя мощность прошлых окон
+  int32_t  pv_[kHoldWindows + 1] = {};                                          // Измерение на границах окон, Q16
+  uint32_t late_sum_ = 0;                                                       // Сумма мощности за kHoldWindows окон θ назад
+  uint16_t power_head_ = 0;                                                     // Следующая запись мощности
+  uint8_t  pv_head_ = 0;                                                        // Следующая запись измерения
+  uint16_t windows_ = 0;                                                        // Окон с пуска (до заполнения истории)
+  float    tau_per_k_ = 0.0f;                                                   // τ/K: единиц мощности на °C/с
+  float    hold_u_ = 0.0f;                                                      // Мощность удержания при hold_pv_
+  float    hold_pv_ = 0.0f;                                                     // Середина окна оценки, °C
+  bool     hold_valid_ = false;                                                 // История заполнена, оценка есть
+  bool     preset_ = false;                                                     // Интеграл держится на оценке
+  bool     preset_used_ = false;                                                // Оценка для текущей цели уже назначалась
+  int32_t  preset_raw_ = 0;                                                     // Мощность удержания цели, Q16
+  uint32_t preset_t0_ = 0;                                                      // Начало удержания интеграла (окно модели)
+  uint8_t  delay_ = 0;                                                          // Запаздывание, окон
+  uint8_t  head_ = 0;                                                           // Следующая запись в кольце
+  int32_t  lead_raw_ = 0;                                                       // x(t) − x(t − θ), Q16
+  int32_t  release_raw_ = 0;                                                    // kReleaseC в Q16
+  int32_t  band_raw_ = 0;                                                       // kBandC в Q16
+  int32_t  preset_band_raw_ = 0;                                                // kPresetBandC в Q16
+  uint32_t release_ms_ = 0;                                                     // kReleaseDead·θ, мс
+  int32_t  target_raw_ = 0;                                                     // Цель, для которой взведено формирование
+  uint32_t hold_t0_ = 0;                                                        // Начало выдержки (окно модели)
+  uint32_t win_t0_ = 0;                                                         // Начало текущего окна
+  uint32_t win_u_ = 0;                                                          // Сумма мощности окна
+  uint16_t win_n_ = 0;                                                          // Шагов в окне
+};                                                                              // Конец определения класса OvershootShaper
+//
+#ifdef TR_AUTOTUNE_SIM                                                          // Отладочная сборка: моделирование на печи второго порядка
+void runShaperSimulation();                                                     // Перерегулирование с формированием уставки и без
+#endif                                                                          // TR_AUTOTUNE_SIM
@@ -1,32 +1,166 @@
-#include "PIDController.h"                                            // Заголовок с определением класса PIDController
+#include "PIDController.h"                                            // Заголовок с определением шаблона PIDControllerT
 //
-#include <Arduino.h>                                                   // Используем функции millis() и constrain()
+#include "PlatformClock.h"                                             // millis() на устройстве, steady_clock на хосте
 //
-void PIDController::setCoeffs(double p, double i, double d) {          // Устанавливаем коэффициенты PID-регулятора
+template <typename T>
+void PIDControllerT<T>::setCoeffs(double p, double i, double d) {      // Устанавливаем коэффициенты PID-регулятора
+  setGains(NumericTraits<T>::fromDouble(p),                            // Переводим в тип расчёта
+           NumericTraits<ki_type>::fromDouble(i),
+           NumericTraits<T>::fromDouble(d));
+}                                                                      // Завершение метода setCoeffs
+//
+template <typename T>
+void PIDControllerT<T>::setGains(T p, ki_type i, T d) {                // Коэффициенты в типе расчёта
+  if (p == kp && i == ki && d == kd) return;                           // Ничего не изменилось — множители те же
+  if (primed) {                                                        // Регулятор уже работает
+    integral.add((kp - p) * last_e);                                   // Компенсируем скачок P, чтобы выход не дёрнулся
+  }                                                                    // Конец проверки
   kp = p;                                                              // Пропорциональный коэффициент
   ki = i;                                                              // Интегральный коэффициент
   kd = d;                                                              // Дифференциальный коэффициент
-}                                                                      // Завершение метода setCoeffs
+  if (fixed_dt_ms) fixed = factorsFor(fixed_dt_ms);                    // Пересчитываем множители шага
+}                                                                      // Завершение метода setGains
 //
-void PIDController::setSetpoint(double s) {                            // Устанавливаем требуемую температуру (уставку)
-  set = s;                                                             // Запоминаем новое значение уставки
-  integral = 0.0;                                                      // Сбрасываем накопленную интегральную составляющую
-  prev = 0.0;                                                          // Обнуляем предыдущую ошибку
-  last_ms = millis();                                                  // Запоминаем время установки для корректного расчёта dt
+template <typename T>
+void PIDControllerT<T>::setSetpoint(double s) {                        // Устанавливаем требуемую температуру (уставку)
+  set = NumericTraits<T>::fromDouble(s);                               // Интеграл не трогаем: D по измерению, броска нет
 }                                                                      // Завершение метода setSetpoint
 //
-int PIDController::compute(double pv) {                                // Рассчитываем управляющее воздействие по текущему значению процесса
-  uint32_t now = millis();                                             // Получаем текущее время в миллисекундах
-  double dt_ms = static_cast<double>(now - last_ms);                   // Вычисляем прошедший интервал времени
-  if (dt_ms <= 0.0) {                                                  // Защита на случай нулевого/отрицательного интервала
+template <typename T>
+void PIDControllerT<T>::setOutputLimits(int lo, int hi) {              // Диапазон выхода
+  out_lo = NumericTraits<T>::fromInt(lo);                              // Нижняя граница
+  out_hi = NumericTraits<T>::fromInt(hi);                              // Верхняя граница
+}                                                                      // Завершение метода setOutputLimits
+//
+template <typename T>
+void PIDControllerT<T>::setDerivativeFilter(double tf_s) {             // Постоянная фильтра D
+  tf = NumericTraits<T>::fromDouble(tf_s > 0.0 ? tf_s : 0.0);          // Отрицательная не имеет смысла
+  if (fixed_dt_ms) fixed = factorsFor(fixed_dt_ms);                    // Пересчитываем множители шага
+}                                                                      // Завершение метода setDerivativeFilter
+//
+template <typename T>
+void PIDControllerT<T>::setFixedDt(uint32_t dt_ms) {                   // Фиксированный шаг
+  fixed_dt_ms = dt_ms;                                                 // Запоминаем
+  if (fixed_dt_ms) fixed = factorsFor(fixed_dt_ms);                    // Множители один раз
+}                                                                      // Завершение метода setFixedDt
+//
+template <typename T>
+void PIDControllerT<T>::reset() {                                      // Начать с чистого состояния
+  integral.set(T());                                                   // Интеграл пуст
+  d_term = T();                                                        // Фильтр D пуст
+  p_term = T();                                                        // P пока нет
+  last_e = T();                                                        // Ошибки пока нет
+  primed = false;                                                      // Предыдущего измерения нет
+  last_ms = platformMillis();                                          // Отсчёт интервала
+}                                                                      // Завершение метода reset
+//
+template <typename T>
+void PIDControllerT<T>::initialize(T pv, int output) {                 // Безударный переход в автоматический режим
+  reset();                                                             // Фильтр и история заново
+  last_e = set - pv;                                                   // Текущая ошибка
+  const T out = NumericTraits<T>::fromInt(output);                     // Выход, который был в ручном режиме
+  const T i0 = out - kp * last_e;                                      // Интеграл продолжит этот выход
+  integral.set(i0 > out_hi ? out_hi : (i0 < out_lo ? out_lo : i0));    // В пределах выхода
+  prev_pv = pv;                                                        // Производная начнётся с нуля
+  primed = true;                                                       // История есть
+}                                                                      // Завершение метода initialize
+//
+template <typename T>
+void PIDControllerT<T>::presetIntegral(T v) {                          // Интеграл задан извне
+  integral.set(v);                                                     // И избыток рампы, и недобор снимаются сразу
+}                                                                      // Завершение метода presetIntegral
+//
+template <typename T>
+typename PIDControllerT<T>::StepFactors PIDControllerT<T>::factorsFor(uint32_t dt_ms) const {  // Множители шага
+  StepFactors f;                                                       // Результат
+  const T dt_s = NumericTraits<T>::fromRatio(static_cast<int32_t>(dt_ms), 1000);  // Интервал в секундах
+  f.ki_dt = pid_detail::Integral<T>::rate(ki, dt_ms);                  // Приращение интеграла на единицу ошибки
+  f.kd_dt = kd / dt_s;                                                 // Производная на единицу изменения измерения
+  f.alpha = dt_s / (tf + dt_s);                                        // Фильтр первого порядка: 1 при tf = 0
+  f.kaw_dt = Rate();                                                   // Без I обратный расчёт не нужен
+  if (ki > ki_type() && kp > T()) {                                    // Постоянная слежения Ti = Kp/Ki
+    f.kaw_dt = pid_detail::Integral<T>::perGain(f.ki_dt, kp);          // dt/Ti, больше единицы — перекомпенсация
+  }                                                                    // Конец проверки
+  return f;                                                            // Готово
+}                                                                      // Завершение метода factorsFor
+//
+template <typename T>
+int PIDControllerT<T>::compute(T pv) {                                 // Рассчитываем управляющее воздействие по текущему значению процесса
+  uint32_t now = platformMillis();                                     // Получаем текущее время в миллисекундах
+  if (fixed_dt_ms) {                                                   // Вызывается планировщиком с постоянным периодом
+    last_ms = now;                                                     // Время для переключения обратно
+    return step(pv, fixed);                                            // Множители уже посчитаны
+  }                                                                    // Конец фиксированного шага
+  uint32_t dt_ms = now - last_ms;                                      // Вычисляем прошедший интервал времени
+  if (dt_ms == 0) {                                                    // Защита на случай нулевого интервала
     return 0;                                                          // Возвращаем нейтральное значение
   }                                                                    // Конец проверки dt
-  double e = set - pv;                                                 // Ошибка регулирования: разница между уставкой и текущим значением
-  integral += e * (dt_ms / 1000.0);                                    // Накопление интегральной составляющей (используем секунды)
-  double der = (e - prev) / (dt_ms / 1000.0);                          // Дифференциальная составляющая: скорость изменения ошибки
-  prev = e;                                                            // Сохраняем текущую ошибку для следующего шага
   last_ms = now;                                                       // Обновляем отметку времени последнего расчёта
-  double out = kp * e + ki * integral + kd * der;                      // Рассчитываем итоговое управляющее воздействие
-  return constrain(static_cast<int>(out), 0, 255);                     // Ограничиваем результат диапазоном ШИМ 0-255 и возвращаем его
+  return compute(pv, dt_ms);                                           // Общий расчёт с известным интервалом
 }                                                                      // Завершение метода compute
-
+//
+template <typename T>
+int PIDControllerT<T>::compute(T pv, uint32_t dt_ms) {                 // Расчёт с явно заданным интервалом
+  if (dt_ms == 0) {                                                    // Нулевой интервал не даёт производной
+    return 0;                                                          // Возвращаем нейтральное значение
+  }                                                                    // Конец проверки dt
+  if (dt_ms == fixed_dt_ms) {                                          // Совпадает с фиксированным шагом
+    return step(pv, fixed);                                            // Без делений
+  }                                                                    // Конец проверки
+  return step(pv, factorsFor(dt_ms));                                  // Множители под этот интервал
+}                                                                      // Завершение метода compute
+//
+template <typename T>
+int PIDControllerT<T>::step(T pv, const StepFactors& f) {              // Один шаг (только умножения и сложения)
+  if (!primed) {                                                       // Первое измерение
+    prev_pv = pv;                                                      // Производная начнётся с нуля
+    primed = true;                                                     // История есть
+  }                                                                    // Конец проверки
+  const T e = set - pv;                                                // Ошибка регулирования
+  p_term = kp * e;                                                     // Пропорциональная составляющая
+  const T raw_d = f.kd_dt * (prev_pv - pv);                            // D по измерению: смена уставки не даёт броска
+  d_term += (raw_d - d_term) * f.alpha;                                // Фильтр первого порядка
+  prev_pv = pv;                                                        // Для следующего шага
+  last_e = e;                                                          // Для безударной смены Kp
+  const T unsat = p_term + integral.value() + d_term;                  // Выход до ограничения
+  const bool wind_up = (unsat >= out_hi && e > T()) || (unsat <= out_lo && e < T());  // Интегрирование углубит насыщение
+  if (!wind_up) {                                                      // Условное интегрирование
+    integral.add(f.ki_dt, e);                                          // Накопление в единицах выхода
+  }                                                                    // Конец проверки
+  const T out = p_term + integral.value() + d_term;                    // Выход с новым интегралом
+  const T sat = out > out_hi ? out_hi : (out < out_lo ? out_lo : out); // Ограничение
+  integral.add(f.kaw_dt, sat - out);                                   // Обратный расчёт: интеграл отходит от насыщения
+  return NumericTraits<T>::toInt(sat);                                 // Ограниченный выход в целых единицах
+}                                                                      // Завершение метода step
+//
+template class PIDControllerT<double>;                                 // Эталонная реализация на double
+template class PIDControllerT<Q16>;                                    // Целочисленная реализация для прошивки
+//
+#ifdef TR_PID_BENCHMARK
+#include <stdio.h>                                                     // printf: и на устройстве, и на хосте
+//
+template <typename T>
+static uint32_t benchCyclesPerCompute() {                              // Среднее число тактов CPU (нс на хосте) на вызов compute()
+  constexpr int kIterations = 2000;                                    // Количество вызовов в замере
+  PIDControllerT<T> pid;                                               // Отдельный экземпляр под замер
+  pid.setCoeffs(2.0, 5.0, 1.0);                                        // Коэффициенты по умолчанию прошивки
+  pid.setSetpoint(210.0);                                              // Типичная уставка
+  pid.setFixedDt(100);                                                 // Коэффициенты шага — один раз, вне замера
+  volatile int sink = 0;                                               // Не даём компилятору выбросить расчёт
+  const uint32_t c0 = platformCycles();                                // Счётчик тактов до замера
+  for (int i = 0; i < kIterations; ++i) {                              // Серия вызовов с меняющимся значением процесса
+    sink = sink + pid.compute(NumericTraits<T>::fromInt(150 + (i & 63)));
+  }                                                                    // Конец серии
+  const uint32_t c1 = platformCycles();                                // Счётчик тактов после замера
+  (void)sink;
+  return (c1 - c0) / kIterations;                                      // Такты на вызов
+}                                                                      // Завершение benchCyclesPerCompute
+//
+void runPidBenchmark() {                                               // Сравнение double и Q16 (на целевом CPU и на хосте)
+  const uint32_t cyc_double = benchCyclesPerCompute<double>();         // Программная эмуляция double
+  const uint32_t cyc_fixed  = benchCyclesPerCompute<Q16>();            // Целочисленный Q15.16
+  printf("[PID] compute(): double %lu %s, Q16 %lu %s\n",
+         static_cast<unsigned long>(cyc_double), kPlatformCycleUnit,
+         static_cast<unsigned long>(cyc_fixed), kPlatformCycleUnit);   // Печатаем результат
+}                                                                      // Завершение runPidBenchmark
+#endif                                                                 // TR_PID_BENCHMARK
@@ -1,18 +1,137 @@
 #pragma once                                 // Предотвращаем повторное включение заголовка
 //
-class PIDController {                         // Класс, реализующий PID-регулятор
+#include <stdint.h>                          // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                      // Числа с фиксированной точкой для FPU-less ESP32-C6
+//
+// PID в форме для управления печью:
+//  - D по измерению (а не по ошибке): смена уставки не даёт броска производной;
+//  - D-составляющая сглажена фильтром первого порядка с постоянной tf;
+//  - интегральная часть хранится в единицах выхода, поэтому смена уставки и
+//    коэффициентов её не сбрасывает и не вызывает скачка (bumpless);
+//  - антинасыщение: условное интегрирование (в насыщении интеграл не растёт в
+//    сторону насыщения) и обратный расчёт с постоянной слежения Ti = Kp/Ki;
+//  - режим фиксированного шага: множители ki·dt, kd/dt и т.д. считаются один
+//    раз в setFixedDt(), горячий путь — только умножения и сложения;
+//  - Ki задаётся в типе ki_type (для Q16 — Q24), а интеграл копится в
+//    pid_detail::Integral: у медленной печи ki·dt ≈ 4e-5 на шаг 100 мс, и в
+//    Q16 такой шаг интеграла терял до трети величины и округлялся вниз.
+namespace pid_detail {                       // Накопитель интеграла
+template <typename T>                        // double: точности хватает как есть
+struct Integral {                            // Интеграл в единицах выхода
+  using Rate = T;                            // Множитель ki·dt и dt/Ti
+  static Rate rate(typename NumericTraits<T>::Fine ki, uint32_t dt_ms) {  // ki·dt
+    return ki * NumericTraits<T>::fromRatio(static_cast<int32_t>(dt_ms), 1000);
+  }                                          // Конец rate
+  static Rate perGain(Rate r, T kp) {        // r/kp не больше единицы (dt/Ti)
+    const T q = r / kp;
+    return q > NumericTraits<T>::fromInt(1) ? NumericTraits<T>::fromInt(1) : q;
+  }                                          // Конец perGain
+  void add(Rate r, T e) { acc += r * e; }    // acc += r·e
+  void add(T v) { acc += v; }                // acc += v
+  void set(T v) { acc = v; }                 // acc = v
+  T value() const { return acc; }            // Текущее значение
+  T acc = T();                               // Накопленное значение
+};                                           // Конец шаблона Integral
+//
+template <int F>                             // Fixed<F>: 64 бита, 16 лишних дробных бит
+struct Integral<Fixed<F>> {                  // Интеграл в единицах выхода
+  using Rate = int64_t;                      // Множитель ki·dt и dt/Ti, Q32
+  static constexpr int kRateBits = 32;       // Дробных бит множителя
+  static constexpr int kExtraBits = 16;      // Дробных бит накопителя сверх F
+  static int64_t roundShift(int64_t v, int n) {  // v/2^n к ближайшему, половина — от нуля
+    const int64_t half = int64_t(1) << (n - 1);
+    return v >= 0 ? (v + half) >> n : -((-v + half) >> n);
+  }                                          // Конец roundShift
+  static Rate rate(typename NumericTraits<Fixed<F>>::Fine ki, uint32_t dt_ms) {  // ki·dt, Q32, с округлением
+    constexpr int kFine = NumericTraits<Fixed<F>>::Fine::kFracBits;
+    const int64_t p = int64_t(ki.raw()) * dt_ms * (int64_t(1) << (kRateBits - kFine));
+    return p >= 0 ? (p + 500) / 1000 : (p - 500) / 1000;
+  }                                          // Конец rate
+  static Rate perGain(Rate r, Fixed<F> kp) { // r/kp, Q32, не больше единицы
+    if (r >= (int64_t(kp.raw()) << (kRateBits - F))) return int64_t(1) << kRateBits;
+    return (r << F) / kp.raw();
+  }                                          // Конец perGain
+  void add(Rate r, Fixed<F> e) {             // acc += r·e: точное произведение, одно округление
+    int64_t er = e.raw();
+    if (r != 0) {                            // Произведение должно уместиться в 64 бита
+      const int64_t lim = INT64_MAX / (r < 0 ? -r : r);
+      er = er > lim ? lim : (er < -lim ? -lim : er);
+    }
+    put(acc + roundShift(r * er, kRateBits - kExtraBits));
+  }                                          // Конец add
+  void add(Fixed<F> v) { put(acc + (int64_t(v.raw()) << kExtraBits)); }   // acc += v
+  void set(Fixed<F> v) { acc = int64_t(v.raw()) << kExtraBits; }          // acc = v
+  Fixed<F> value() const {                   // Значение в формате выхода
+    return Fixed<F>::fromRaw(fixed_detail::sat32(roundShift(acc, kExtraBits)));
+  }                                          // Конец value
+  void put(int64_t v) {                      // Насыщение до диапазона Fixed<F>
+    constexpr int64_t hi = int64_t(INT32_MAX) << kExtraBits;
+    constexpr int64_t lo = int64_t(INT32_MIN) * (int64_t(1) << kExtraBits);
+    acc = v > hi ? hi : (v < lo ? lo : v);
+  }                                          // Конец put
+  int64_t acc = 0;                           // Накопленное значение, Q(F+16)
+};                                           // Конец специализации Integral<Fixed<F>>
+}  // namespace pid_detail                   // Завершение pid_detail
+//
+template <typename T>                        // T — числовой тип расчёта (double или Fixed<N>)
+class PIDControllerT {                       // Класс, реализующий PID-регулятор
 public:                                      // Публичные методы
-  void setCoeffs(double p, double i, double d);  // Задание коэффициентов PID
-  void setSetpoint(double s);                    // Установка желаемого значения процесса
-  int  compute(double pv);                       // Расчёт управляющего воздействия по текущему значению
+  using value_type = T;                      // Тип, в котором ведутся вычисления
+  using ki_type = typename NumericTraits<T>::Fine;  // Тип Ki (для Q16 — Q24)
+//
+  void setCoeffs(double p, double i, double d);  // Задание коэффициентов PID (без скачка выхода)
+  void setGains(T p, ki_type i, T d);            // То же в типе расчёта, без double (таблица по температуре)
+  void setSetpoint(double s);                    // Установка уставки (интеграл сохраняется)
+  void setSetpointValue(T s) { set = s; }        // То же в типе расчёта, без double (задатчик профиля)
+  void setOutputLimits(int lo, int hi);          // Диапазон выхода (по умолчанию 0..255)
+  void setDerivativeFilter(double tf_s);         // Постоянная фильтра D, с (0 — без фильтра)
+  void setFixedDt(uint32_t dt_ms);               // Фиксированный шаг (0 — шаг по millis())
+  void reset();                                  // Сбросить интеграл, фильтр D и историю измерения
+  void initialize(T pv, int output);             // Безударный переход из ручного режима: выход = output
+  void presetIntegral(T v);                      // Интеграл = v (выход на выдержку по модели)
+  int  compute(T pv);                            // Расчёт управляющего воздействия (шаг фиксированный или по millis())
+  int  compute(T pv, uint32_t dt_ms);            // То же с явно заданным интервалом
+//
+  T proportionalTerm() const { return p_term; }  // Составляющие последнего расчёта (для диагностики)
+  T integralTerm() const { return integral.value(); }
+  T derivativeTerm() const { return d_term; }
+  T proportionalGain() const { return kp; }    // Действующие коэффициенты
+  ki_type integralGain() const { return ki; }
+  T derivativeGain() const { return kd; }
 //
 private:                                     // Приватные данные, хранящие состояние регулятора
-  double kp = 1.0;                           // Пропорциональная составляющая по умолчанию
-  double ki = 0.0;                           // Интегральная составляющая по умолчанию
-  double kd = 0.0;                           // Дифференциальная составляющая по умолчанию
-  double set = 0.0;                          // Текущая уставка
-  double integral = 0.0;                     // Накопленная интегральная ошибка
-  double prev = 0.0;                         // Ошибка предыдущего шага
-  unsigned long last_ms = 0;                 // Время последнего вычисления
-};                                           // Конец определения класса PIDController
-
+  using Rate = typename pid_detail::Integral<T>::Rate;  // Множитель интеграла
+  struct StepFactors {                       // Множители, зависящие от шага
+    Rate ki_dt;                              // ki·dt
+    T kd_dt;                                 // kd/dt
+    T alpha;                                 // dt/(tf + dt) — вес фильтра D
+    Rate kaw_dt;                             // dt/Ti — вес обратного расчёта
+  };                                         // Конец структуры StepFactors
+  StepFactors factorsFor(uint32_t dt_ms) const;  // Множители для шага dt_ms
+  int  step(T pv, const StepFactors& f);     // Один шаг регулятора
+//
+  T kp = NumericTraits<T>::fromInt(1);       // Пропорциональный коэффициент
+  ki_type ki = ki_type();                    // Интегральный коэффициент
+  T kd = T();                                // Дифференциальный коэффициент
+  T tf = NumericTraits<T>::fromInt(1);       // Постоянная фильтра D, с
+  T set = T();                               // Текущая уставка
+  T out_lo = T();                            // Нижняя граница выхода
+  T out_hi = NumericTraits<T>::fromInt(255); // Верхняя граница выхода
+  pid_detail::Integral<T> integral;          // Интегральная составляющая в единицах выхода
+  T d_term = T();                            // Отфильтрованная D-составляющая
+  T p_term = T();                            // P-составляющая последнего шага
+  T prev_pv = T();                           // Измерение предыдущего шага
+  T last_e = T();                            // Ошибка предыдущего шага (безударная смена Kp)
+  bool primed = false;                       // Есть предыдущее измерение
+  uint32_t last_ms = 0;                      // Время последнего вычисления
+  uint32_t fixed_dt_ms = 0;                  // Фиксированный шаг, мс (0 — нет)
+  StepFactors fixed;                         // Множители фиксированного шага
+};                                           // Конец определения шаблона PIDControllerT
+//
+using PIDController = PIDControllerT<Q16>;   // Регулятор прошивки: целочисленный Q15.16
+using PIDControllerDouble = PIDControllerT<double>;  // Эталонная реализация на double (для сравнения)
+//
+#ifdef TR_PID_BENCHMARK                      // Отладочная сборка: сравнение стоимости compute() на устройстве
+void runPidBenchmark();                      // Печатает в Serial такты CPU на вызов для double и Q16
+#endif                                       // TR_PID_BENCHMARK
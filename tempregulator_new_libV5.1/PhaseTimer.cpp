@@ -0,0 +1,74 @@
+#include "PhaseTimer.h"                                                         // Объявление класса
+//
+#if TR_PHASE_TIMING
+namespace {                                                                     // Локальные для модуля сущности
+struct PhaseStats {                                                             // Накопленная статистика фазы
+  uint32_t count;                                                               // Замеров
+  uint64_t sum;                                                                 // Сумма, такты
+  uint32_t min;                                                                 // Минимум, такты
+  uint32_t max;                                                                 // Максимум, такты
+  uint16_t bins[PhaseTimer::kBins];                                             // Гистограмма
+};                                                                              // Конец структуры PhaseStats
+//
+PhaseStats g_stats[PhaseTimer::kCount];                                         // Статистика всех фаз (в .bss)
+//
+const char* const kNames[PhaseTimer::kCount] = {                                // Имена в порядке Phase
+  "lvgl", "events", "screen", "telemetry", "socket",
+  "broadcast", "loop", "acquire", "control", "ssr"
+};                                                                              // Конец массива kNames
+//
+uint8_t binOf(uint32_t v) {                                                     // Корзина: 0..3 — точно, дальше по 4 на октаву
+  if (v < 4) return static_cast<uint8_t>(v);
+  const uint8_t msb = static_cast<uint8_t>(31 - __builtin_clz(v));
+  return static_cast<uint8_t>(4 * (msb - 1) + ((v >> (msb - 2)) & 3));
+}                                                                               // Завершение binOf
+//
+uint32_t binLow(uint8_t b) {                                                    // Нижняя граница корзины
+  if (b < 4) return b;
+  const uint8_t msb = static_cast<uint8_t>(b / 4 + 1);
+  return static_cast<uint32_t>(4 + b % 4) << (msb - 2);
+}                                                                               // Завершение binLow
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void PhaseTimer::record(Phase p, uint32_t cycles) {                             // Добавить замер
+  PhaseStats& s = g_stats[p];
+  if (s.count == 0 || cycles < s.min) s.min = cycles;
+  if (cycles > s.max) s.max = cycles;
+  ++s.count;
+  s.sum += cycles;
+  uint16_t& bin = s.bins[binOf(cycles)];
+  if (bin == UINT16_MAX) {                                                      // Переполнение: старые замеры весят вдвое меньше
+    for (uint16_t& b : s.bins) b >>= 1;
+  }
+  ++bin;
+}                                                                               // Завершение record
+//
+PhaseTimer::Summary PhaseTimer::summary(Phase p) {                              // Сводка по фазе
+  const PhaseStats& s = g_stats[p];
+  Summary out{s.count, 0.0f, 0.0f, 0.0f, 0.0f};
+  if (s.count == 0) return out;
+  const float per_us = static_cast<float>(platformCyclesPerUs());
+  out.min_us = s.min / per_us;
+  out.max_us = s.max / per_us;
+  out.avg_us = static_cast<float>(static_cast<double>(s.sum) / s.count) / per_us;
+  uint32_t total = 0;
+  for (uint16_t b : s.bins) total += b;
+  const uint32_t rank = total - total / 100;                                    // Замер, ниже которого 99 %
+  uint32_t seen = 0;
+  uint32_t p99 = s.max;
+  for (uint8_t b = 0; b < kBins; ++b) {
+    seen += s.bins[b];
+    if (seen >= rank && seen > 0) {
+      const uint32_t high = b + 1 < kBins ? binLow(b + 1) - 1 : UINT32_MAX;     // Верхняя граница корзины
+      if (high < p99) p99 = high;
+      break;
+    }
+  }
+  out.p99_us = p99 / per_us;
+  return out;
+}                                                                               // Завершение summary
+//
+const char* PhaseTimer::name(Phase p) {                                         // Короткое имя
+  return p < kCount ? kNames[p] : "?";
+}                                                                               // Завершение name
+#endif                                                                          // TR_PHASE_TIMING
@@ -0,0 +1,87 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "PlatformClock.h"                                                      // Счётчик тактов
+//
+// Замер времени по фазам цикла UI и шага регулятора на работающем приборе.
+// Длительность фазы — разность platformCycles(); на каждую фазу — число
+// замеров, сумма, минимум, максимум и гистограмма в статической памяти:
+// логарифмические корзины по четыре на октаву (ошибка границы < 19 %), по
+// ним — 99-й перцентиль. Корзины 16-битные: когда одна переполняется, все
+// делятся пополам, и гистограмма плавно «забывает» старые замеры. Запись —
+// сложения и __builtin_clz, без делений и без кучи.
+//
+// У каждой фазы один писатель (задача UI или задача регулятора), поэтому
+// блокировок нет; summary() из задачи UI может увидеть фазу регулятора
+// рассогласованной на один замер, что для статистики несущественно.
+//
+// Сборка с -DTR_PHASE_TIMING=0 убирает замеры целиком: макросы ниже
+// становятся пустыми, а вывод в окне «Инфо» и в WebSocket не собирается.
+#ifndef TR_PHASE_TIMING
+#define TR_PHASE_TIMING 1                                                       // Замер фаз включён по умолчанию
+#endif                                                                          // TR_PHASE_TIMING
+//
+#if TR_PHASE_TIMING
+class PhaseTimer {                                                              // Статистика длительности фаз
+public:                                                                         // Публичный интерфейс
+  enum Phase : uint8_t {                                                        // Замеряемые фазы
+    kLvgl,                                                                      // lv_timer_handler()
+    kEvents,                                                                    // Тревоги и конечный автомат режимов
+    kScreen,                                                                    // Подписи экрана, шаги калибровки и автонастройки
+    kTelemetry,                                                                 // WebInterface::updateTelemetry()
+    kSocket,                                                                    // Обслуживание WebSocket
+    kBroadcast,                                                                 // Рассылка телеметрии
+    kLoop,                                                                      // Весь проход loop()
+    kAcquire,                                                                   // Опрос холодного спая, термопар и кадра АЦП
+    kControl,                                                                   // Оценщик, задатчик профиля, PID
+    kSsr,                                                                       // Выдача мощности на SSR
+    kCount                                                                      // Число фаз
+  };                                                                            // Конец перечисления Phase
+//
+  static constexpr uint8_t kBins = 124;                                         // Корзин на фазу (до 2^32 тактов)
+//
+  struct Summary {                                                              // Сводка по фазе, мкс
+    uint32_t count;                                                             // Замеров
+    float    min_us;                                                            // Минимум
+    float    avg_us;                                                            // Среднее
+    float    max_us;                                                            // Максимум
+    float    p99_us;                                                            // 99-й перцентиль (верхняя граница корзины)
+  };                                                                            // Конец структуры Summary
+//
+  static void record(Phase p, uint32_t cycles);                                 // Добавить замер
+  static Summary summary(Phase p);                                              // Сводка по фазе
+  static const char* name(Phase p);                                             // Короткое имя для вывода
+//
+  class Lap {                                                                   // Последовательные фазы одной функции
+  public:                                                                       // Публичный интерфейс
+    Lap() : t_(platformCycles()) {}                                             // Начало первой фазы
+    void next(Phase p) {                                                        // Закрыть фазу и начать следующую
+      const uint32_t now = platformCycles();
+      record(p, now - t_);
+      t_ = now;
+    }                                                                           // Завершение next
+  private:                                                                      // Внутреннее состояние
+    uint32_t t_;                                                                // Начало текущей фазы
+  };                                                                            // Конец определения класса Lap
+//
+  class Scope {                                                                 // Фаза на время области видимости
+  public:                                                                       // Публичный интерфейс
+    explicit Scope(Phase p) : p_(p), t_(platformCycles()) {}                    // Начало фазы
+    ~Scope() { record(p_, platformCycles() - t_); }                             // Конец фазы
+    Scope(const Scope&) = delete;                                               // Копировать нельзя
+    Scope& operator=(const Scope&) = delete;                                    // Присваивать нельзя
+  private:                                                                      // Внутреннее состояние
+    Phase    p_;                                                                // Фаза
+    uint32_t t_;                                                                // Начало
+  };                                                                            // Конец определения класса Scope
+};                                                                              // Конец определения класса PhaseTimer
+//
+#define TR_PHASE_LAP(lap) PhaseTimer::Lap lap                                   // Начать цепочку фаз
+#define TR_PHASE_NEXT(lap, phase) (lap).next(PhaseTimer::phase)                 // Закрыть фазу цепочки
+#define TR_PHASE_SCOPE(phase) PhaseTimer::Scope tr_phase_scope_(PhaseTimer::phase)  // Фаза до конца блока
+#else
+#define TR_PHASE_LAP(lap)
+#define TR_PHASE_NEXT(lap, phase)
+#define TR_PHASE_SCOPE(phase)
+#endif                                                                          // TR_PHASE_TIMING
@@ -0,0 +1,376 @@
+#include "PlantSimulator.h"                                                     // Объявление модели и прогона
+//
+#ifdef TR_AUTOTUNE_SIM                                                          // Весь файл — только в отладочной сборке
+#include <math.h>                                                               // exp, fabs
+#include <stdio.h>                                                              // printf, snprintf: и на устройстве, и на хосте
+#include <string.h>                                                             // strlen
+//
+#include "AdaptivePid.h"                                                        // Звенья рабочего режима
+#include "AdcSampler.h"                                                         // Медиана отсчётов, как на плате
+#include "GainSchedule.h"
+#include "OvershootShaper.h"
+#include "PIDController.h"
+#include "PlatformClock.h"                                                      // Время прогона на ПК
+#include "SsrFeedback.h"                                                        // Ток нагревателя против команды, как на плате
+#include "SsrOutput.h"                                                          // Модуляция выхода, как на плате
+#include "TemperatureEstimator.h"                                               // Оценщик температуры
+#include "WorkLoop.h"                                                           // Шаг рабочего режима
+//
+void PlantSimulator::reset(const Params& p) {                                   // Печь остыла до цеха
+  p_ = p;
+  t_ = s_ = p.ambient_c;
+  lag_ = p.tc_tau_s > 0.0 ? 1.0 - exp(-(kDtMs / 1000.0) / p.tc_tau_s) : 1.0;
+  energy_j_ = 0.0;
+  const double d = p.dead_s * 1000.0 / kDtMs;
+  delay_ = d <= 0.0 ? 0 : (d >= kMaxDelay ? kMaxDelay : static_cast<uint16_t>(d + 0.5));
+  for (uint16_t i = 0; i < kMaxDelay; ++i) line_[i] = 0.0f;
+  head_ = 0;
+  steps_ = 0;
+  seed_ = p.seed ? p.seed : 1;
+}                                                                               // Завершение reset
+//
+void PlantSimulator::step(double duty) {                                        // Шаг теплового баланса
+  const bool fault = faulted();
+  if (fault && p_.fault == Fault::StuckOn) duty = 1.0;                          // Команда уже ничего не решает
+  if (fault && p_.fault == Fault::NoCurrent) duty = 0.0;
+  ++steps_;
+  double late = duty;                                                           // Мощность, дошедшая до камеры
+  if (delay_) {
+    late = line_[head_];
+    line_[head_] = static_cast<float>(duty);
+    head_ = (head_ + 1) % delay_;
+  }
+  constexpr double dt = kDtMs / 1000.0;
+  const double tk = t_ + 273.15, ak = p_.ambient_c + 273.15;                    // Абсолютные температуры для излучения
+  const double loss = p_.loss_w * (t_ - p_.ambient_c) + p_.rad_w * (tk * tk * tk * tk - ak * ak * ak * ak);
+  t_ += (p_.heater_w * late - loss) / p_.capacity_j * dt;
+  s_ += ((fault && p_.fault == Fault::ProbeOut ? p_.ambient_c : t_) - s_) * lag_;  // Инерция термопары
+  energy_j_ += p_.heater_w * duty * dt;
+}                                                                               // Завершение step
+//
+double PlantSimulator::uniform() {                                              // Линейный конгруэнтный генератор
+  seed_ = seed_ * 1664525u + 1013904223u;
+  return (seed_ >> 8) / 16777216.0;
+}                                                                               // Завершение uniform
+//
+bool PlantSimulator::current(bool commanded) const {                            // Ток по команде и неисправности
+  if (faulted() && p_.fault == Fault::StuckOn) return true;
+  if (faulted() && p_.fault == Fault::NoCurrent) return false;
+  return commanded;
+}                                                                               // Завершение current
+//
+double PlantSimulator::sample() {                                               // Отсчёт: спай, шум, выброс
+  if (faulted() && p_.fault == Fault::OpenCircuit) return 1.0e4;                // Разомкнутый вход подтянут к верхней границе
+  const double g = (uniform() + uniform() + uniform() + uniform() - 2.0) * 1.7320508;  // Почти нормальный, СКО 1
+  double v = s_ + p_.noise_c * g;
+  if (uniform() < p_.outlier_rate) v += uniform() < 0.5 ? -p_.outlier_c : p_.outlier_c;  // Наводка или дребезг контакта
+  return v;
+}                                                                               // Завершение sample
+//
+StepIdentifier::Model PlantSimulator::linearModel(double temp_c) const {        // Касательная к балансу в temp_c
+  const double tk = temp_c + 273.15;
+  const double g = p_.loss_w + 4.0 * p_.rad_w * tk * tk * tk;                   // d(потери)/dT, Вт/°C
+  return StepIdentifier::Model{p_.heater_w / 255.0 / g, p_.capacity_j / g,
+                               p_.dead_s + p_.tc_tau_s, true};                  // Инерция термопары — как добавка к запаздыванию
+}                                                                               // Завершение linearModel
+//
+void LoopScenario::addSegment(float start_c, float end_c, float minutes, float band_c) {  // Строка профиля
+  if (count < ProfileRunner::kMaxSegments) segments[count++] = Segment{start_c, end_c, minutes, band_c};
+}                                                                               // Завершение addSegment
+//
+LoopScenario LoopScenario::standard() {                                         // Обжиг: две рампы и две выдержки, 8 ч
+  LoopScenario sc;
+  sc.shaper = true;                                                             // Модель печи есть — формирователь работает
+  sc.feedback = true;
+  sc.addSegment(20.0f, 600.0f, 120.0f);
+  sc.addSegment(600.0f, 600.0f, 120.0f, 5.0f);
+  sc.addSegment(600.0f, 850.0f, 90.0f);
+  sc.addSegment(850.0f, 850.0f, 150.0f, 5.0f);
+  return sc;
+}                                                                               // Завершение standard
+//
+namespace {                                                                     // Помощники прогона
+//
+constexpr double   kAdcSlopeC = 0.25;                                           // Калибровка канала: °C на единицу АЦП
+constexpr uint32_t kAdcPeriodUs = 2000;                                         // Период выборки, как ADC_SAMPLE_PERIOD_US
+constexpr uint32_t kExtraMs = 4UL * 3600 * 1000;                                // Запас на паузы выдержек сверх длительности профиля
+//
+uint16_t toRaw(double temp_c) {                                                 // °C → отсчёт 12-битного АЦП
+  const double raw = temp_c / kAdcSlopeC + 0.5;
+  return raw <= 0.0 ? 0 : (raw >= 4095.0 ? 4095 : static_cast<uint16_t>(raw));
+}                                                                               // Завершение toRaw
+//
+bool raise(LoopReport& r, SafetyMonitor::Alarm a, uint32_t now) {               // Как TempRegulator::requestAlarm()
+  if (a == SafetyMonitor::Alarm::None || r.alarm != SafetyMonitor::Alarm::None) return false;  // Показывается первая
+  r.alarm = a;
+  r.alarm_s = now / 1000.0;
+  return SafetyMonitor::stopsHeat(a);                                           // Нагрев снят — прогон окончен
+}                                                                               // Завершение raise
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runClosedLoop(const LoopScenario& sc, LoopReport& r) {                     // Прогон профиля по модели
+  r = LoopReport{};
+  static PlantSimulator plant;                                                  // Кольцо запаздывания — не на стеке
+  plant.reset(sc.plant);
+//
+  ProfileRunner profile;
+  for (uint8_t i = 0; i < sc.count; ++i) {
+    const LoopScenario::Segment& s = sc.segments[i];
+    profile.addSegment(s.start_c, s.end_c, s.minutes, s.band_c);
+  }
+  profile.setMaxWaitMs(static_cast<uint32_t>(sc.max_wait_min * 60000.0));      // Как rWait_GS в TempRegulator
+  double model_c = sc.model_c;                                                  // Точка линеаризации — первая выдержка
+  for (uint8_t i = 0; model_c <= 0.0 && i < sc.count; ++i) {
+    if (sc.segments[i].start_c == sc.segments[i].end_c) model_c = sc.segments[i].end_c;
+  }
+  const StepIdentifier::Model model = plant.linearModel(model_c > 0.0 ? model_c : 500.0);
+  const StepIdentifier::Gains g = sc.kp > 0.0 ? StepIdentifier::Gains{sc.kp, sc.ki, sc.kd, true}
+                                               : StepIdentifier::gains(model, StepIdentifier::kImcPid);
+  r.kp = g.kp; r.ki = g.ki; r.kd = g.kd;
+//
+  PIDController pid;                                                            // Звенья — как у TempRegulator
+  GainSchedule schedule;
+  OvershootShaper shaper;
+  AdaptivePid adaptive;
+  TemperatureEstimator est;
+  WorkLoop loop{pid, schedule, profile, shaper, adaptive};
+  AdcSampler adc;
+  SsrOutput ssr;
+  SsrFeedback feedback;
+  SafetyMonitor safety;
+  ssr.begin(0, static_cast<SsrOutput::Mode>(sc.ssr_mode), 50);
+  if (sc.feedback) feedback.begin(0, false, &ssr);                              // На ПК без таймера: отсчёты — из цикла слотов
+  for (size_t i = 0; i < AdcSampler::kWindow; ++i) adc.pushSample(toRaw(plant.sample()));
+  const Q16 offset_q = Q16();                                                   // Канал без смещения
+  const Q24 slope_q = Q24::fromDouble(kAdcSlopeC);
+  est.configure(TemperatureEstimator::kDefaultProcessNoise, TemperatureEstimator::kDefaultMeasureNoise,
+                TemperatureEstimator::kDefaultPowerGain);
+  pid.setFixedDt(PlantSimulator::kDtMs);
+  pid.setCoeffs(g.kp, g.ki, g.kd);
+//
+  pid.reset();                                                                  // Пуск — как TempRegulator::startHeat()
+  profile.start(0);
+  pid.setSetpointValue(profile.setpoint());
+  if (sc.adapt) adaptive.start(0, g.kp, g.ki, g.kd, &model, Q16::fromDouble(sc.plant.ambient_c));
+  if (sc.shaper && shaper.configure(model)) shaper.start(0);
+//
+  const uint32_t wall0 = platformMillis();
+  const uint32_t limit = profile.totalMs() + kExtraMs;
+  int power = 0;                                                                // Мощность прошлого шага
+  uint32_t slot_us = 0;                                                         // Время, ещё не отданное слотам SSR
+  uint32_t fb_us = 0;                                                           // Время, ещё не отданное отсчётам обратной связи
+  int8_t hold = -1;                                                             // Выдержка, которую сейчас учитываем
+  uint8_t hold_seg = 0;                                                         // Её ступень
+  uint32_t hold_t0 = 0, hold_out = 0;                                           // Начало и последний выход из полосы
+  double worst_settle = 0.0;
+  uint32_t now = 0;
+  for (;; now += PlantSimulator::kDtMs) {
+    for (uint32_t us = 0; us < PlantSimulator::kDtMs * 1000; us += kAdcPeriodUs) adc.pushSample(toRaw(plant.sample()));
+    uint8_t outliers = 0;
+    const Q16 measured = offset_q + mulInt<16>(slope_q, adc.latest(outliers));  // Как readTemperatureQ() в линейном режиме
+    if (raise(r, safety.adcReading(adc.openCircuit(), adc.windowCount(), outliers), now)) break;
+    if (raise(r, safety.ssrFeedback(feedback, true), now)) break;
+    est.update(now, measured, feedback.deliveredPower(power));                  // Мощность прошлого шага — по фактическому току
+    const Q16 pv = est.temperature();
+//
+    int out = 0;
+    const WorkLoop::Result res = loop.step({now, pv, Q16(), power, true, true, false}, out);
+    if (res != WorkLoop::Result::Power) {
+      r.finished = res == WorkLoop::Result::Finished;
+      r.timed_out = !r.finished;
+      if (res == WorkLoop::Result::TimedOut) r.timeout_s = now / 1000.0;       // «Не вошла в допуск выдержки»
+      break;
+    }
+    if (now >= limit) {                                                         // Выдержки так и не дождались допуска
+      r.timed_out = true;
+      break;
+    }
+    power = out;
+    loop.adapt(now, measured, feedback.deliveredPower(power));
+    if (raise(r, safety.rise(now, est.primed() && r.alarm == SafetyMonitor::Alarm::None, pv, est.rate(), power,
+                             profile.setpoint().toFloat()), now)) break;
+//
+    ssr.setPower(static_cast<uint8_t>(power < 0 ? 0 : (power > 255 ? 255 : power)));
+    const uint32_t on0 = ssr.onSlots(), n0 = ssr.totalSlots();
+    for (slot_us += PlantSimulator::kDtMs * 1000; slot_us >= ssr.slotUs(); slot_us -= ssr.slotUs()) {
+      ssr.tick();
+      if (!sc.feedback) continue;
+      for (fb_us += ssr.slotUs(); fb_us >= SsrFeedback::kSampleUs; fb_us -= SsrFeedback::kSampleUs) {
+        feedback.sample(ssr.level(), plant.current(ssr.level()));               // Опрос входа раз в kSampleUs
+      }
+    }
+    const uint32_t n = ssr.totalSlots() - n0;
+    plant.step(n ? double(ssr.onSlots() - on0) / n : 0.0);
+//
+    const double t = plant.chamber();
+    const double sp = profile.setpoint().toDouble();
+    r.iae += fabs(sp - t) * (PlantSimulator::kDtMs / 1000.0);
+    const uint8_t seg = profile.segment();
+    if (hold >= 0 && seg != hold_seg) {                                         // Выдержка кончилась
+      LoopReport::Hold& h = r.holds[hold];
+      h.settle_s = fabs(t - h.sp) <= LoopReport::kSettleC ? (hold_out - hold_t0) / 1000.0 : -1.0;
+      hold = -1;
+    }
+    if (hold < 0 && profile.isHold(seg) && r.hold_count < ProfileRunner::kMaxSegments) {
+      hold = static_cast<int8_t>(r.hold_count++);
+      hold_seg = seg;
+      hold_t0 = hold_out = now;
+      r.holds[hold] = LoopReport::Hold{profile.segmentEnd(seg).toDouble(), 0.0, 0.0};
+    }
+    if (hold >= 0) {
+      LoopReport::Hold& h = r.holds[hold];
+      if (t - h.sp > h.overshoot_c) h.overshoot_c = t - h.sp;
+      if (fabs(t - h.sp) > LoopReport::kSettleC) hold_out = now + PlantSimulator::kDtMs;
+    }
+  }
+  if (hold >= 0) {                                                              // Профиль кончился на выдержке
+    LoopReport::Hold& h = r.holds[hold];
+    h.settle_s = fabs(plant.chamber() - h.sp) <= LoopReport::kSettleC ? (hold_out - hold_t0) / 1000.0 : -1.0;
+  }
+  for (uint8_t i = 0; i < r.hold_count; ++i) {
+    const LoopReport::Hold& h = r.holds[i];
+    if (h.overshoot_c > r.overshoot_c) r.overshoot_c = h.overshoot_c;
+    if (worst_settle >= 0.0) worst_settle = h.settle_s < 0.0 ? -1.0 : (h.settle_s > worst_settle ? h.settle_s : worst_settle);
+  }
+  r.settle_s = worst_settle;
+  r.sim_s = now / 1000.0;
+  r.wall_ms = platformMillis() - wall0;
+  r.ssr_switches = ssr.edgeCount();
+  r.duty = ssr.totalSlots() ? double(ssr.onSlots()) / ssr.totalSlots() : 0.0;
+  r.energy_kwh = plant.energyKwh();
+  r.retunes = adaptive.retunes();
+}                                                                               // Завершение runClosedLoop
+//
+void printLoopReport(const char* name, const LoopReport& r, const char* failed) {  // Одна строка JSON на прогон
+  printf("{\"name\":\"%s\",\"result\":\"%s\",\"sim_s\":%.0f,\"wall_ms\":%lu,"
+         "\"overshoot_c\":%.2f,\"iae\":%.0f,\"settle_s\":%.0f,\"alarm\":\"%s\",\"alarm_s\":%.1f,\"timeout_s\":%.0f,"
+         "\"ssr_switches\":%lu,\"duty\":%.3f,\"energy_kwh\":%.2f,\"kp\":%.4g,\"ki\":%.4g,\"kd\":%.4g,"
+         "\"retunes\":%u,\"holds\":[",
+         name, r.finished ? "finished" : (r.timed_out ? "timeout" : "stopped"), r.sim_s,
+         static_cast<unsigned long>(r.wall_ms), r.overshoot_c, r.iae, r.settle_s, SafetyMonitor::text(r.alarm),
+         r.alarm_s, r.timeout_s, static_cast<unsigned long>(r.ssr_switches), r.duty, r.energy_kwh, r.kp, r.ki, r.kd,
+         static_cast<unsigned>(r.retunes));
+  for (uint8_t i = 0; i < r.hold_count; ++i) {
+    printf("%s{\"sp\":%.1f,\"overshoot_c\":%.2f,\"settle_s\":%.0f}", i ? "," : "",
+           r.holds[i].sp, r.holds[i].overshoot_c, r.holds[i].settle_s);
+  }
+  printf("]");
+  if (failed) printf(",\"pass\":%s,\"failed\":\"%s\"", failed[0] ? "false" : "true", failed);
+  printf("}\n");
+}                                                                               // Завершение printLoopReport
+//
+LoopLimits LoopLimits::fault(SafetyMonitor::Alarm a, double detect_s) {         // Прогон с неисправностью
+  LoopLimits lim;
+  lim.alarm = a;
+  lim.detect_s = detect_s;
+  return lim;
+}                                                                               // Завершение fault
+//
+LoopLimits LoopLimits::timeout() {                                              // Прогон с остановкой по допуску
+  LoopLimits lim;
+  lim.band_timeout = true;
+  return lim;
+}                                                                               // Завершение timeout
+//
+namespace {                                                                     // Сверка с пределами
+//
+void addFailure(char* failed, size_t size, const char* what) {                  // Дописать нарушенную проверку
+  const size_t n = strlen(failed);
+  if (n < size) snprintf(failed + n, size - n, "%s%s", n ? " " : "", what);
+}                                                                               // Завершение addFailure
+//
+void addFailure(char* failed, size_t size, const char* what, double limit) {    // То же с пределом
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%s>%g", what, limit);
+  addFailure(failed, size, buf);
+}                                                                               // Завершение addFailure
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+bool checkLoopReport(const LoopScenario& sc, const LoopReport& r, const LoopLimits& lim, char* failed,
+                     size_t size) {                                             // Пределы прогона
+  failed[0] = '\0';
+  if (lim.alarm != SafetyMonitor::Alarm::None) {                                // Неисправность: авария вовремя и не раньше
+    if (r.alarm != lim.alarm) addFailure(failed, size, "alarm");
+    else if (r.alarm_s < sc.plant.fault_s || r.alarm_s - sc.plant.fault_s > lim.detect_s) {
+      addFailure(failed, size, "detect_s", lim.detect_s);
+    }
+    return failed[0] == '\0';
+  }
+  if (lim.band_timeout) {                                                       // Остановка по допуску, а не по аварии или пределу времени
+    if (r.timeout_s < 0.0) addFailure(failed, size, "result");
+    if (r.alarm != SafetyMonitor::Alarm::None) addFailure(failed, size, "alarm");
+    return failed[0] == '\0';
+  }
+  if (!r.finished) addFailure(failed, size, "result");
+  if (r.alarm != SafetyMonitor::Alarm::None) addFailure(failed, size, "alarm");  // Ложная авария на исправной печи
+  if (r.overshoot_c > lim.overshoot_c) addFailure(failed, size, "overshoot_c", lim.overshoot_c);
+  if (lim.iae > 0.0 && r.iae > lim.iae) addFailure(failed, size, "iae", lim.iae);
+  if (r.settle_s < 0.0 || r.settle_s > lim.settle_s) addFailure(failed, size, "settle_s", lim.settle_s);
+  return failed[0] == '\0';
+}                                                                               // Завершение checkLoopReport
+//
+namespace {                                                                     // Набор
+//
+int runCase(const char* name, const LoopScenario& sc, const LoopLimits& lim, LoopReport& r) {  // Прогон и сверка: 1 — нарушение
+  char failed[96];
+  runClosedLoop(sc, r);
+  const bool ok = checkLoopReport(sc, r, lim, failed, sizeof(failed));
+  printLoopReport(name, r, failed);
+  return ok ? 0 : 1;
+}                                                                               // Завершение runCase
+//
+LoopScenario faulty(PlantSimulator::Fault f, double at_s) {                     // Стандартный прогон с неисправностью
+  LoopScenario sc = LoopScenario::standard();
+  sc.plant.fault = f;
+  sc.plant.fault_s = at_s;
+  return sc;
+}                                                                               // Завершение faulty
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int runPlantSimulation() {                                                      // Регрессионный набор на стандартном профиле
+  using Alarm = SafetyMonitor::Alarm;
+  using Fault = PlantSimulator::Fault;
+  int failures = 0;
+  LoopReport r;
+  LoopScenario sc = LoopScenario::standard();                                   // Пределы — итог прогона с запасом около 25 %
+  failures += runCase("imc", sc, LoopLimits{1.0, 6.0e5, 4500.0}, r);
+//
+  const double kp = r.kp, ki = r.ki, kd = r.kd;                                 // Настройка без запаса — с перерегулированием
+  sc.kp = kp * 2.0; sc.ki = ki * 4.0; sc.kd = kd;
+  sc.shaper = false;
+  failures += runCase("fast", sc, LoopLimits{15.0, 2.6e5, 11000.0}, r);
+  sc.shaper = true;
+  failures += runCase("fast+shaper", sc, LoopLimits{1.0, 2.0e5, 750.0}, r);
+//
+  sc = LoopScenario::standard();                                                // Садка вдвое тяжелее, коэффициенты — по пустой печи
+  sc.kp = kp; sc.ki = ki; sc.kd = kd;
+  sc.plant.capacity_j *= 2.0;
+  failures += runCase("heavy", sc, LoopLimits{1.0, 1.4e6, 9000.0}, r);
+  sc.adapt = true;
+  failures += runCase("heavy+adapt", sc, LoopLimits{1.0, 1.4e6, 10500.0}, r);
+//
+  sc = LoopScenario::standard();                                                // Плохой датчик: шум и частые выбросы
+  sc.plant.noise_c = 1.5;
+  sc.plant.outlier_rate = 0.02;
+  failures += runCase("noisy", sc, LoopLimits{1.5, 6.0e5, 4500.0}, r);
+//
+  sc = LoopScenario::standard();                                                // Сигма-дельта: те же кВт·ч, другие переключения
+  sc.ssr_mode = 2;
+  failures += runCase("sigma-delta", sc, LoopLimits{1.0, 6.0e5, 4500.0}, r);
+//
+  sc = LoopScenario::standard();                                                // Садка впятеро тяжелее не догоняет рампу
+  sc.plant.capacity_j *= 5.0;
+  sc.max_wait_min = 15.0;
+  failures += runCase("band-timeout", sc, LoopLimits::timeout(), r);
+//
+  failures += runCase("fault-open", faulty(Fault::OpenCircuit, 3000.0), LoopLimits::fault(Alarm::OpenCircuit, 1.0), r);
+  failures += runCase("fault-stuck-on", faulty(Fault::StuckOn, 9000.0), LoopLimits::fault(Alarm::SsrStuckOn, 10.0), r);
+  failures += runCase("fault-no-current", faulty(Fault::NoCurrent, 3000.0), LoopLimits::fault(Alarm::SsrNoCurrent, 10.0), r);
+  failures += runCase("fault-probe-out", faulty(Fault::ProbeOut, 3000.0), LoopLimits::fault(Alarm::RiseStall, 180.0), r);
+  printf("{\"summary\":\"furnace_sim\",\"failures\":%d}\n", failures);
+  return failures;
+}                                                                               // Завершение runPlantSimulation
+#endif                                                                          // TR_AUTOTUNE_SIM
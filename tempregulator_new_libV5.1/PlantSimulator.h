@@ -0,0 +1,152 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "ProfileRunner.h"                                                      // Число ступеней профиля
+#include "SafetyMonitor.h"                                                      // Аварии, как на плате
+#include "StepIdentifier.h"                                                     // Модель первого порядка с запаздыванием
+//
+// Модель печи для прогонов замкнутого контура на ПК быстрее реального времени.
+// Тепловой баланс камеры: C·dT/dt = P·u(t − θ) − G·(T − Tа) − R·(T⁴ − Tа⁴)
+// (мощность нагревателя по доле включённых слотов SSR, теплоёмкость, потери
+// теплопроводностью и излучением, транспортное запаздывание); термопара —
+// инерционное звено первого порядка, к каждому отсчёту АЦП добавляются шум и
+// редкие выбросы. С момента fault_s вносится неисправность: обрыв
+// термопары, залипший или не включающийся SSR, термопара, выпавшая из печи.
+//
+// runClosedLoop() гоняет по модели тот же код, что задача регулятора в
+// рабочем режиме: отсчёты идут через AdcSampler (медиана с отбраковкой
+// выбросов), температура — через TemperatureEstimator, шаг — WorkLoop
+// (задатчик профиля, таблица коэффициентов, формирователь, PID, подстройка),
+// выход — через SsrOutput, слоты которого и греют модель, а ток нагревателя
+// раз в мс сравнивает с командой SsrFeedback. Аварии поднимает SafetyMonitor,
+// как в TempRegulator: авария, снимающая нагрев, останавливает прогон. Часы
+// виртуальные: время — номер шага, поэтому 8-часовой профиль проходит за
+// секунды. Итог — перерегулирование, IAE, время установления на выдержках,
+// первая авария и число переключений SSR — печатается строкой JSON (JSON
+// Lines). runPlantSimulation() сверяет итоги набора с пределами LoopLimits и
+// возвращает число нарушений — furnace_sim выходит с ненулевым кодом.
+#ifdef TR_AUTOTUNE_SIM                                                          // Отладочная сборка: моделирование на ПК
+class PlantSimulator {                                                          // Тепловая модель печи и термопары
+public:                                                                         // Публичный интерфейс
+  static constexpr uint32_t kDtMs = 100;                                        // Шаг модели = шаг регулятора
+  static constexpr uint16_t kMaxDelay = 3000;                                   // Наибольшее запаздывание, шагов (5 мин)
+//
+  enum class Fault : uint8_t {                                                  // Вносимая неисправность
+    None,                                                                       // Исправная печь
+    OpenCircuit,                                                                // Обрыв термопары: вход у верхней границы АЦП
+    StuckOn,                                                                    // SSR залип: нагреватель включён всегда
+    NoCurrent,                                                                  // SSR не включается или обрыв нагревателя
+    ProbeOut,                                                                   // Термопара выпала из печи: спай остывает к цеху
+  };                                                                            // Конец перечисления Fault
+//
+  struct Params {                                                               // Параметры печи и датчика
+    double   heater_w = 2500.0;                                                 // Мощность нагревателя, Вт
+    double   capacity_j = 15000.0;                                              // Теплоёмкость камеры с садкой, Дж/°C
+    double   loss_w = 1.0;                                                      // Потери теплопроводностью, Вт/°C
+    double   rad_w = 5.67e-10;                                                  // Потери излучением, Вт/K⁴
+    double   ambient_c = 20.0;                                                  // Температура цеха, °C
+    double   dead_s = 20.0;                                                     // Запаздывание нагреватель → камера, с
+    double   tc_tau_s = 8.0;                                                    // Постоянная времени термопары, с
+    double   noise_c = 0.3;                                                     // СКО шума отсчёта, °C
+    double   outlier_rate = 0.002;                                              // Доля отсчётов-выбросов
+    double   outlier_c = 60.0;                                                  // Размах выброса, °C
+    uint32_t seed = 1;                                                          // Зерно генератора шума
+    Fault    fault = Fault::None;                                               // Неисправность
+    double   fault_s = 0.0;                                                     // С этого времени, с
+  };                                                                            // Конец структуры Params
+//
+  void   reset(const Params& p);                                                // Печь остыла до цеха
+  void   step(double duty);                                                     // Шаг kDtMs со средней долей включения 0..1
+  bool   current(bool commanded) const;                                         // Ток нагревателя при команде SSR
+  bool   faulted() const { return p_.fault != Fault::None && steps_ * (kDtMs / 1000.0) >= p_.fault_s; }  // Неисправность внесена
+  double sample();                                                              // Один отсчёт термопары с шумом, °C
+  double chamber() const { return t_; }                                         // Температура камеры, °C
+  double sensor() const { return s_; }                                          // Температура спая без шума, °C
+  double energyKwh() const { return energy_j_ / 3.6e6; }                        // Отдано нагревателем, кВт·ч
+  StepIdentifier::Model linearModel(double temp_c) const;                       // Первый порядок с запаздыванием около temp_c
+//
+private:                                                                        // Внутреннее состояние
+  double uniform();                                                             // Равномерное 0..1
+//
+  Params   p_{};                                                                // Параметры
+  double   t_ = 0.0;                                                            // Температура камеры
+  double   s_ = 0.0;                                                            // Температура спая
+  double   lag_ = 1.0;                                                          // 1 − e^(−dt/τ термопары)
+  double   energy_j_ = 0.0;                                                     // Отданная энергия, Дж
+  float    line_[kMaxDelay] = {};                                               // Мощность на пути к камере
+  uint16_t delay_ = 0;                                                          // Запаздывание, шагов
+  uint16_t head_ = 0;                                                           // Позиция в кольце
+  uint32_t steps_ = 0;                                                          // Шагов с reset()
+  uint32_t seed_ = 1;                                                           // Генератор шума
+};                                                                              // Конец определения класса PlantSimulator
+//
+struct LoopScenario {                                                           // Прогон замкнутого контура
+  struct Segment {                                                              // Строка профиля, как в TemperatureProfile
+    float start_c;                                                              // Начальная уставка, °C
+    float end_c;                                                                // Конечная уставка, °C
+    float minutes;                                                              // Длительность, мин
+    float band_c;                                                               // Допуск гарантированной выдержки (0 — без гарантии)
+  };                                                                            // Конец структуры Segment
+//
+  PlantSimulator::Params plant{};                                               // Печь
+  Segment  segments[ProfileRunner::kMaxSegments] = {};                          // Профиль
+  uint8_t  count = 0;                                                           // Ступеней в профиле
+  double   kp = 0.0, ki = 0.0, kd = 0.0;                                        // Коэффициенты PID (kp ≤ 0 — IMC по модели печи)
+  bool     shaper = false;                                                      // Формирование уставки перед выдержкой
+  bool     feedback = false;                                                    // Обратная связь SSR по току нагревателя
+  bool     adapt = false;                                                       // Подстройка коэффициентов
+  uint8_t  ssr_mode = 0;                                                        // SsrOutput::Mode
+  double   model_c = 0.0;                                                       // Температура линеаризации модели (0 — первая выдержка)
+  double   max_wait_min = 0.0;                                                  // Наибольшее ожидание допуска за ступень, мин (rWait_GS; 0 — без аварии)
+//
+  void addSegment(float start_c, float end_c, float minutes, float band_c = 0.0f);  // Добавить строку профиля
+  static LoopScenario standard();                                               // 8-часовой профиль до 850 °C, IMC и формирователь
+};                                                                              // Конец структуры LoopScenario
+//
+struct LoopReport {                                                             // Итог прогона
+  static constexpr double kSettleC = 1.0;                                       // Полоса установления на выдержке, °C
+//
+  struct Hold {                                                                 // Итог одной выдержки
+    double sp;                                                                  // Уставка, °C
+    double overshoot_c;                                                         // Наибольший выход камеры за уставку, °C
+    double settle_s;                                                            // От начала выдержки до входа в kSettleC навсегда (−1 — не вошла)
+  };                                                                            // Конец структуры Hold
+//
+  bool     finished = false;                                                    // Профиль пройден
+  bool     timed_out = false;                                                   // Профиль остановлен по допуску выдержки или по времени
+  double   timeout_s = -1.0;                                                    // Остановлен по допуску выдержки (WorkLoop::Result::TimedOut), с (−1 — нет)
+  SafetyMonitor::Alarm alarm = SafetyMonitor::Alarm::None;                      // Первая авария (снимающая нагрев останавливает прогон)
+  double   alarm_s = -1.0;                                                      // Её время, с (−1 — аварий не было)
+  double   sim_s = 0.0;                                                         // Модельное время, с
+  uint32_t wall_ms = 0;                                                         // Время прогона на ПК, мс
+  double   overshoot_c = 0.0;                                                   // Наибольшее по выдержкам
+  double   iae = 0.0;                                                           // ∫|уставка профиля − камера| dt, °C·с
+  double   settle_s = 0.0;                                                      // Наибольшее по выдержкам (−1 — хоть одна не вошла)
+  uint32_t ssr_switches = 0;                                                    // Переключений выхода SSR
+  double   duty = 0.0;                                                          // Средняя доля включения
+  double   energy_kwh = 0.0;                                                    // Отдано нагревателем
+  double   kp = 0.0, ki = 0.0, kd = 0.0;                                        // Коэффициенты PID при пуске
+  uint16_t retunes = 0;                                                         // Подстроек коэффициентов
+  Hold     holds[ProfileRunner::kMaxSegments] = {};                             // По выдержкам
+  uint8_t  hold_count = 0;                                                      // Выдержек
+};                                                                              // Конец структуры LoopReport
+//
+struct LoopLimits {                                                             // Пределы регрессионного прогона
+  double overshoot_c = 0.0;                                                     // Наибольшее перерегулирование, °C
+  double iae = 0.0;                                                             // Наибольший IAE, °C·с (0 — не проверяется)
+  double settle_s = 0.0;                                                        // Каждая выдержка входит в полосу не позже, с
+  SafetyMonitor::Alarm alarm = SafetyMonitor::Alarm::None;                      // Ожидаемая авария (None — профиль пройден без аварий)
+  double detect_s = 0.0;                                                        // Авария не позже стольких секунд после неисправности
+  bool   band_timeout = false;                                                  // Ожидается остановка «не вошла в допуск выдержки»
+//
+  static LoopLimits fault(SafetyMonitor::Alarm a, double detect_s);             // Неисправность: только авария и её задержка
+  static LoopLimits timeout();                                                  // Садка не догоняет: остановка по допуску, без аварий
+};                                                                              // Конец структуры LoopLimits
+//
+void runClosedLoop(const LoopScenario& sc, LoopReport& out);                    // Прогон профиля по модели
+void printLoopReport(const char* name, const LoopReport& r, const char* failed = nullptr);  // Строка JSON (failed — нарушенные пределы)
+bool checkLoopReport(const LoopScenario& sc, const LoopReport& r, const LoopLimits& lim, char* failed, size_t size);  // Пределы выдержаны
+int  runPlantSimulation();                                                      // Набор регрессионных прогонов: число нарушений
+#endif                                                                          // TR_AUTOTUNE_SIM
@@ -0,0 +1,54 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#ifdef ARDUINO
+#include <Arduino.h>                                                            // millis(), micros(), ESP.getCycleCount()
+#else
+#include <chrono>                                                               // Часы хоста
+#endif                                                                          // ARDUINO
+//
+// Время для модулей ядра регулятора, которые собираются и на ПК (PID,
+// задатчик профиля, идентификация, отладочные моделирования и замеры). На
+// устройстве — millis() и счётчик тактов CPU, на хосте — steady_clock, а
+// вместо тактов — наносекунды (единица — kPlatformCycleUnit).
+inline uint32_t platformMillis() {                                              // Миллисекунды с запуска
+#ifdef ARDUINO
+  return millis();
+#else
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение platformMillis
+//
+inline uint32_t platformMicros() {                                              // Микросекунды с запуска (переполнение через 71 мин)
+#ifdef ARDUINO
+  return micros();
+#else
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение platformMicros
+//
+inline uint32_t platformCycles() {                                              // Такты на устройстве, нс на хосте
+#ifdef ARDUINO
+  return ESP.getCycleCount();
+#else
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение platformCycles
+//
+inline uint32_t platformCyclesPerUs() {                                         // Единиц platformCycles() в микросекунде
+#ifdef ARDUINO
+  return ESP.getCpuFreqMHz();
+#else
+  return 1000;
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение platformCyclesPerUs
+//
+#ifdef ARDUINO
+constexpr const char* kPlatformCycleUnit = "cyc";                               // Единица platformCycles()
+#else
+constexpr const char* kPlatformCycleUnit = "ns";
+#endif                                                                          // ARDUINO
@@ -0,0 +1,93 @@
+#include "ProfileRunner.h"                                                      // Объявление класса
+//
+void ProfileRunner::clear() {                                                   // Пустой профиль
+  count_ = 0;                                                                   // Ступеней нет
+  total_ms_ = 0;
+  stop();                                                                       // И выполнять нечего
+  finished_ = false;
+  timed_out_ = false;
+  setpoint_ = Q16();
+}                                                                               // Завершение clear
+//
+bool ProfileRunner::addSegment(float start_c, float end_c, float minutes, float band_c) {  // Компиляция ступени
+  if (count_ >= kMaxSegments || !(minutes > 0.0f)) return false;                // Нет места или пустая строка
+  const float ms = minutes * 60000.0f;                                          // Длительность, мс
+  const uint32_t dur = ms >= static_cast<float>(kMaxSegmentMs) ? kMaxSegmentMs
+                     : (ms < 1.0f ? 1 : static_cast<uint32_t>(ms));             // В допустимых пределах
+  Segment& s = seg_[count_];                                                    // Новая ступень
+  s.start_raw = Q16::fromDouble(start_c).raw();                                 // Начальная уставка
+  const int64_t delta = int64_t(Q16::fromDouble(end_c).raw()) - s.start_raw;    // Изменение за ступень
+  s.slope = delta * 65536 / dur;                                                // Деление один раз, здесь
+  s.dur_ms = dur;
+  s.band_in = band_c > 0.0f ? Q16::fromDouble(band_c).raw() : 0;                // Полоса гарантированной выдержки
+  s.band_out = s.band_in + s.band_in / 8;                                       // Гистерезис выхода
+  if (count_ == 0) setpoint_ = Q16::fromRaw(s.start_raw);                       // До запуска — начало профиля
+  total_ms_ += dur;                                                             // Общая длительность
+  ++count_;
+  return true;                                                                  // Ступень добавлена
+}                                                                               // Завершение addSegment
+//
+bool ProfileRunner::start(uint32_t now_ms) {                                    // Запуск
+  finished_ = false;                                                            // Новый проход
+  timed_out_ = false;
+  if (!count_) return false;                                                    // Нечего выполнять
+  index_ = 0;                                                                   // С первой ступени
+  start_ms_ = now_ms;
+  last_ms_ = now_ms;
+  elapsed_ms_ = 0;
+  wait_ms_ = 0;
+  paused_ = false;
+  setpoint_ = Q16::fromRaw(seg_[0].start_raw);                                  // Уставка начала
+  running_ = true;
+  return true;                                                                  // Запущен
+}                                                                               // Завершение start
+//
+void ProfileRunner::stop() {                                                    // Остановка
+  running_ = false;                                                             // Уставка остаётся последней
+  paused_ = false;
+  index_ = 0;
+}                                                                               // Завершение stop
+//
+Q16 ProfileRunner::segmentEnd(uint8_t i) const {                                // Конечная уставка ступени
+  if (i >= count_) return setpoint_;                                            // Ступени нет — текущая уставка
+  const Segment& s = seg_[i];
+  return Q16::fromRaw(static_cast<int32_t>(s.start_raw + ((s.slope * s.dur_ms) >> 16)));
+}                                                                               // Завершение segmentEnd
+//
+bool ProfileRunner::tick(uint32_t now_ms, Q16 pv) {                             // Шаг задатчика
+  if (!running_) return false;                                                  // Не выполняется
+  const uint32_t dt = now_ms - last_ms_;                                        // С предыдущего тика
+  last_ms_ = now_ms;
+  const Segment& cur = seg_[index_];
+  if (cur.band_in) {                                                            // Гарантированная выдержка
+    int32_t e = pv.raw() - setpoint_.raw();                                     // Отклонение от уставки
+    if (e < 0) e = -e;
+    paused_ = e > (paused_ ? cur.band_in : cur.band_out);                       // Вход по band, выход по band + band/8
+  }                                                                             // Конец проверки полосы
+  if (paused_) {                                                                // Часы ступени стоят
+    wait_ms_ += dt;
+    if (max_wait_ms_ && wait_ms_ >= max_wait_ms_) {                             // Садка так и не догнала уставку
+      running_ = false;
+      paused_ = false;
+      timed_out_ = true;
+      return false;                                                             // Профиль остановлен
+    }                                                                           // Конец проверки ожидания
+    return true;                                                                // Уставка на месте
+  }                                                                             // Конец паузы
+  elapsed_ms_ += dt;                                                            // Время ступени
+  while (elapsed_ms_ >= seg_[index_].dur_ms) {                                  // Ступень пройдена (обычно не более одной за тик)
+    const Segment& done = seg_[index_];
+    if (index_ + 1 >= count_) {                                                 // Последняя
+      setpoint_ = Q16::fromRaw(static_cast<int32_t>(done.start_raw + ((done.slope * done.dur_ms) >> 16)));  // Конечная уставка
+      running_ = false;
+      finished_ = true;
+      return false;                                                             // Профиль завершён
+    }                                                                           // Конец проверки
+    elapsed_ms_ -= done.dur_ms;                                                 // Остаток — в следующую
+    wait_ms_ = 0;
+    ++index_;
+  }                                                                             // Конец перехода
+  const Segment& s = seg_[index_];                                              // Текущая ступень
+  setpoint_ = Q16::fromRaw(static_cast<int32_t>(s.start_raw + ((s.slope * elapsed_ms_) >> 16)));  // Линейная уставка
+  return true;                                                                  // Выполняется
+}                                                                               // Завершение tick
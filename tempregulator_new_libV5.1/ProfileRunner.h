@@ -0,0 +1,72 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Уставка в Q16, как у PID
+//
+// Исполнитель температурного профиля: ступени выполняются по порядку, уставка
+// каждой линейно идёт от начальной температуры к конечной за время ступени
+// (равные температуры — выдержка). Строки профиля компилируются заранее в
+// addSegment(): наклон хранится в Q16/мс с 16 дополнительными дробными битами,
+// поэтому tick() в задаче регулятора — одно умножение и сдвиг, без float,
+// деления и выделения памяти. Время — millis(); остаток времени ступени
+// переносится в следующую, поэтому задержки шага не копятся. После последней
+// ступени running() сбрасывается, а finished() остаётся до следующего start().
+//
+// Гарантированная выдержка: у ступени с допуском band часы ступени идут только
+// пока измерение отличается от уставки не больше чем на band (выход из полосы —
+// при band + band/8, чтобы пауза не дребезжала на границе). На паузе уставка
+// стоит на месте: рампа ждёт отстающую садку, выдержка отсчитывается по
+// реальному прогреву. Если пауза в одной ступени в сумме превысила
+// setMaxWaitMs(), профиль останавливается с признаком timedOut().
+class ProfileRunner {                                                           // Задатчик уставки по профилю
+public:                                                                         // Публичный интерфейс
+  static constexpr uint8_t  kMaxSegments = 10;                                  // Ступеней в профиле (TemperatureProfile::MAX_ROWS)
+  static constexpr uint32_t kMaxSegmentMs = 24UL * 24 * 3600 * 1000;            // Наибольшая длительность ступени, мс (24 сут)
+//
+  void clear();                                                                 // Удалить все ступени и остановиться
+  bool addSegment(float start_c, float end_c, float minutes, float band_c = 0.0f);  // Добавить ступень (band_c ≤ 0 — без гарантии)
+  void setMaxWaitMs(uint32_t ms) { max_wait_ms_ = ms; }                         // Наибольшая пауза в ступени, мс (0 — без ограничения)
+  bool start(uint32_t now_ms);                                                  // Запуск с первой ступени (false — ступеней нет)
+  void stop();                                                                  // Остановка без признака завершения
+  bool tick(uint32_t now_ms, Q16 pv);                                           // Шаг: пауза, переход ступеней и уставка (false — не выполняется)
+//
+  Q16      setpoint() const { return setpoint_; }                               // Текущая уставка, °C
+  bool     running() const { return running_; }                                 // Профиль выполняется
+  bool     finished() const { return finished_; }                               // Последняя ступень пройдена
+  bool     paused() const { return paused_; }                                   // Часы ступени стоят: измерение вне допуска
+  bool     timedOut() const { return timed_out_; }                              // Остановлен: пауза дольше setMaxWaitMs()
+  uint8_t  segmentCount() const { return count_; }                              // Число ступеней
+  uint8_t  segment() const { return index_; }                                   // Текущая ступень (с нуля)
+  bool     isHold(uint8_t i) const { return i < count_ && seg_[i].slope == 0; } // Ступень — выдержка
+  bool     isRampUp(uint8_t i) const { return i < count_ && seg_[i].slope > 0; }  // Ступень — нагрев
+  Q16      segmentEnd(uint8_t i) const;                                         // Конечная уставка ступени
+  uint32_t startMs() const { return start_ms_; }                                // Начало профиля, millis()
+  uint32_t segmentElapsedMs() const { return elapsed_ms_; }                     // Пройдено в текущей ступени без пауз, мс
+  uint32_t segmentWaitMs() const { return wait_ms_; }                           // Пауз в текущей ступени, мс
+  uint32_t totalMs() const { return total_ms_; }                                // Длительность профиля, мс
+//
+private:                                                                        // Внутреннее состояние
+  struct Segment {                                                              // Скомпилированная ступень
+    int32_t  start_raw;                                                         // Начальная уставка, Q16
+    int64_t  slope;                                                             // Наклон, Q16/мс × 2^16
+    uint32_t dur_ms;                                                            // Длительность, мс
+    int32_t  band_in;                                                           // Допуск входа в полосу, Q16 (0 — без гарантии)
+    int32_t  band_out;                                                          // Допуск выхода из полосы, Q16
+  };                                                                            // Конец структуры Segment
+//
+  Segment  seg_[kMaxSegments] = {};                                             // Ступени
+  uint8_t  count_ = 0;                                                          // Число ступеней
+  uint8_t  index_ = 0;                                                          // Текущая ступень
+  bool     running_ = false;                                                    // Выполняется
+  bool     finished_ = false;                                                   // Завершён
+  bool     paused_ = false;                                                     // Вне допуска
+  bool     timed_out_ = false;                                                  // Остановлен по ожиданию
+  uint32_t start_ms_ = 0;                                                       // Начало профиля
+  uint32_t last_ms_ = 0;                                                        // Предыдущий тик
+  uint32_t elapsed_ms_ = 0;                                                     // Время текущей ступени без пауз
+  uint32_t wait_ms_ = 0;                                                        // Пауз в текущей ступени
+  uint32_t max_wait_ms_ = 0;                                                    // Предел пауз в ступени (0 — нет)
+  uint32_t total_ms_ = 0;                                                       // Сумма длительностей
+  Q16      setpoint_;                                                           // Текущая уставка
+};                                                                              // Конец определения класса ProfileRunner
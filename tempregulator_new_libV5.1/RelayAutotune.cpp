@@ -0,0 +1,236 @@
+#include "RelayAutotune.h"                                                      // Объявление класса
+//
+#include <math.h>                                                               // sqrt, atan, asin для пересчёта в коэффициенты
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+constexpr double kPi = 3.14159265358979323846;                                  // Число пи
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void RelayAutotune::start(uint32_t now_ms, Q16 setpoint, Q16 hyst, Q16 pv, uint8_t out_hi) {  // Запуск
+  sp_raw_ = setpoint.raw();                                                     // Параметры реле
+  hyst_raw_ = hyst.raw() > 0 ? hyst.raw() : 0;
+  out_hi_ = out_hi;
+  pv0_raw_ = pv.raw();                                                          // Исходная температура — для оценки усиления печи
+  extreme_raw_ = pv.raw();
+  head_ = 0;                                                                    // Кольцо пустое
+  switches_ = 0;
+  samples_ = 0;
+  last_ms_ = now_ms;
+  on_ms_ = 0;
+  period_ms_ = 0;
+  pp_raw_ = 0;
+  duty_pm_ = 0.0f;
+  converged_ = false;
+  on_ = true;                                                                   // Начинаем с нагрева
+  running_ = true;
+}                                                                               // Завершение start
+//
+void RelayAutotune::stop() {                                                    // Остановка
+  running_ = false;                                                             // Результат, если был, сохраняется
+  on_ = false;
+}                                                                               // Завершение stop
+//
+bool RelayAutotune::tick(uint32_t now_ms, Q16 pv) {                             // Шаг реле
+  if (!running_) return false;                                                  // Выход выключен
+  const uint32_t dt = now_ms - last_ms_;                                        // С предыдущего тика
+  last_ms_ = now_ms;
+  if (on_) on_ms_ += dt;                                                        // Время включения для оценки мощности
+  const int32_t t = pv.raw();
+  if (on_ ? t < extreme_raw_ : t > extreme_raw_) extreme_raw_ = t;              // Включено — минимум, выключено — максимум
+  const bool flip = on_ ? t > sp_raw_ + hyst_raw_ : t < sp_raw_ - hyst_raw_;    // Выход за полосу гистерезиса
+  if (!flip) return on_;                                                        // Фаза продолжается
+//
+  ring_[head_] = Event{now_ms, extreme_raw_, on_ms_};                           // Событие переключения
+  head_ = (head_ + 1) % kRing;
+  if (switches_ < 255) ++switches_;
+  on_ = !on_;                                                                   // Новая фаза
+  extreme_raw_ = t;
+  if (switches_ < 4) return on_;                                                // Первый полупериод — разогрев, оценок ещё нет
+//
+  const Event& e0 = back(0);                                                    // Последние три переключения
+  const Event& e1 = back(1);
+  const Event& e2 = back(2);
+  const uint32_t period = e0.t_ms - e2.t_ms;                                    // Два полупериода
+  const int32_t d = e0.extreme_raw - e1.extreme_raw;                            // Максимум и минимум соседних фаз
+  const uint32_t pp = static_cast<uint32_t>(d < 0 ? -d : d);
+  for (uint8_t i = 0; i + 1 < kWindow; ++i) {                                   // Сдвигаем окно оценок
+    period_win_[i] = period_win_[i + 1];
+    pp_win_[i] = pp_win_[i + 1];
+  }
+  period_win_[kWindow - 1] = period;
+  pp_win_[kWindow - 1] = pp;
+  if (samples_ < kWindow) ++samples_;
+  period_ms_ = period;                                                          // Ход настройки для экрана
+  pp_raw_ = pp;
+  duty_pm_ = period ? (e0.on_ms - e2.on_ms) * 1000.0f / period : 0.0f;
+//
+  if (samples_ >= kWindow && pp > 0 && spreadOk(period_win_) && spreadOk(pp_win_)) {  // Колебания установились
+    uint64_t ps = 0, as = 0;
+    for (uint8_t i = 0; i < kWindow; ++i) {                                     // Результат — среднее окна
+      ps += period_win_[i];
+      as += pp_win_[i];
+    }
+    period_ms_ = static_cast<uint32_t>(ps / kWindow);
+    pp_raw_ = static_cast<uint32_t>(as / kWindow);
+    converged_ = true;
+    running_ = false;
+    on_ = false;
+  }
+  return on_;                                                                   // Новое состояние выхода
+}                                                                               // Завершение tick
+//
+bool RelayAutotune::spreadOk(const uint32_t* v) const {                         // Разброс окна не больше kTolPermille от среднего
+  uint32_t lo = v[0], hi = v[0];
+  uint64_t sum = 0;
+  for (uint8_t i = 0; i < kWindow; ++i) {
+    lo = v[i] < lo ? v[i] : lo;
+    hi = v[i] > hi ? v[i] : hi;
+    sum += v[i];
+  }
+  return uint64_t(hi - lo) * 1000 * kWindow <= sum * kTolPermille;              // (max − min)/среднее без деления
+}                                                                               // Завершение spreadOk
+//
+double RelayAutotune::ultimateGain() const {                                    // Предельный коэффициент
+  const double a = pp_raw_ / 65536.0 / 2.0;                                     // Амплитуда, °C
+  const double eps = hyst_raw_ / 65536.0;                                       // Гистерезис реле, °C
+  const double d = out_hi_ / 2.0;                                               // Амплитуда реле в единицах выхода
+  const double a_eff = a > eps ? sqrt(a * a - eps * eps) : a;                   // Поправка на гистерезис
+  return a_eff > 0.0 ? 4.0 * d / (kPi * a_eff) : 0.0;                           // Описывающая функция реле
+}                                                                               // Завершение ultimateGain
+//
+RelayAutotune::Gains RelayAutotune::gains(Rule rule) const {                    // Пересчёт в коэффициенты
+  Gains g{0.0, 0.0, 0.0, false};
+  const double ku = ultimateGain();
+  const double tu = period_ms_ / 1000.0;                                        // Период, с
+  if (!converged_ || ku <= 0.0 || tu <= 0.0) return g;                          // Нет результата
+  double kp = 0.0, ti = 0.0, td = 0.0;                                          // Параллельная форма: Kp, Ti, Td
+  switch (rule) {
+    case kTyreusLuyben:   kp = ku / 2.2; ti = 2.2 * tu; td = tu / 6.3; break;
+    case kNoOvershoot:    kp = 0.2 * ku; ti = 0.5 * tu; td = tu / 3.0; break;
+    case kZieglerNichols: kp = 0.6 * ku; ti = 0.5 * tu; td = tu / 8.0; break;
+    case kSimc: {                                                               // Модель K·e^(−θs)/(τs + 1) по точке колебаний
+      const double u = duty_pm_ / 1000.0 * out_hi_;                             // Средний выход в колебаниях
+      const double rise = (sp_raw_ - pv0_raw_) / 65536.0;                       // Нагрев от исходной температуры
+      if (u <= 0.0 || rise <= 0.0) return g;                                    // Запуск с горячей печи — усиление не оценить
+      const double k = rise / u;                                                // Статическое усиление, °C на единицу выхода
+      const double a = pp_raw_ / 65536.0 / 2.0;
+      const double eps = hyst_raw_ / 65536.0;
+      const double w = 2.0 * kPi / tu;                                          // Частота колебаний
+      const double mag = kPi * a / (4.0 * (out_hi_ / 2.0));                     // |G(jw)| = 1/|N(a)|
+      const double phase = kPi - (a > eps ? asin(eps / a) : 0.0);              // −arg G(jw) с учётом гистерезиса
+      const double r = k / mag;
+      if (r <= 1.0) return g;                                                   // Модель первого порядка не согласуется с измерением
+      const double tau = sqrt(r * r - 1.0) / w;                                 // Постоянная времени
+      const double theta = (phase - atan(tau * w)) / w;                         // Запаздывание
+      if (theta <= 0.0) return g;
+      const double tc = theta;                                                  // Желаемая постоянная замкнутого контура
+      const double kc = (tau + theta / 3.0) / (k * (tc + theta));               // Улучшенный SIMC (последовательная форма)
+      const double t_i = fmin(tau + theta / 3.0, 4.0 * (tc + theta));
+      const double t_d = theta / 3.0;
+      kp = kc * (1.0 + t_d / t_i);                                              // В параллельную форму
+      ti = t_i + t_d;
+      td = t_i * t_d / (t_i + t_d);
+      break;
+    }
+    default: return g;
+  }
+  g.kp = kp;
+  g.ki = ti > 0.0 ? kp / ti : 0.0;
+  g.kd = kp * td;
+  g.valid = true;
+  return g;
+}                                                                               // Завершение gains
+//
+const char* RelayAutotune::ruleName(Rule rule) {                                // Название правила
+  switch (rule) {
+    case kTyreusLuyben:   return "Тайрес-Люйбен";
+    case kSimc:           return "SIMC (модель)";
+    case kNoOvershoot:    return "Без перерегулир.";
+    case kZieglerNichols: return "Зиглер-Николс";
+    default:              return "?";
+  }
+}                                                                               // Завершение ruleName
+//
+#ifdef TR_AUTOTUNE_SIM
+#include <stdio.h>                                                              // printf: и на устройстве, и на хосте
+//
+namespace {                                                                     // Модель печи для отладочной сборки
+//
+struct SimFurnace {                                                             // Первый порядок с запаздыванием и шумом термопары
+  static constexpr uint32_t kDtMs = 100;                                        // Шаг регулятора
+  static constexpr uint32_t kDelay = 300;                                       // Запаздывание 30 с в шагах
+  double   temp = 25.0;                                                         // Температура печи
+  double   noise = 0.0;                                                         // Размах шума термопары, °C
+  uint8_t  line[kDelay] = {};                                                   // Выход по пути к печи
+  uint32_t n = 0;                                                               // Номер шага
+  uint32_t seed = 12345;                                                        // Генератор шума
+//
+  Q16 step(uint8_t u) {                                                         // Шаг модели: выход → измерение
+    const uint8_t late = line[n % kDelay];                                      // Выход 30 с назад
+    line[n % kDelay] = u;
+    ++n;
+    temp += (2.0 * late - (temp - 25.0)) / 600.0 * (kDtMs / 1000.0);           // 2 °C на единицу, τ = 600 с
+    seed = seed * 1664525u + 1013904223u;
+    return Q16::fromDouble(temp + noise * ((seed >> 16) % 1001 / 1000.0 - 0.5));
+  }
+};                                                                              // Конец структуры SimFurnace
+//
+void simulate(double noise) {                                                   // Прежний и новый алгоритм на одной печи
+  constexpr uint32_t kLimitMs = 4UL * 3600 * 1000;                              // Предел моделирования
+  const Q16 sp(200), hyst(2);
+  uint32_t legacy_ms = 0;                                                       // Прежний алгоритм: реле и 6 пересечений уставки
+  double legacy_kp = 0.0;
+  {
+    SimFurnace f;
+    f.noise = noise;
+    Q16 pv = f.step(0);
+    bool on = true, above = false;
+    uint8_t crossings = 0;
+    double vmax = 0.0, vmin = 1e9;
+    for (uint32_t now = 0; now < kLimitMs && crossings < 6; now += SimFurnace::kDtMs) {
+      if (on && pv > sp + hyst) on = false;
+      else if (!on && pv < sp - hyst) on = true;
+      if ((pv > sp) != above) {                                                 // Значение в момент пересечения — как в прежнем коде
+        above = !above;
+        ++crossings;
+        legacy_ms = now;
+        vmax = fmax(vmax, pv.toDouble());
+        vmin = fmin(vmin, pv.toDouble());
+      }
+      pv = f.step(on ? 255 : 0);
+    }
+    const double a = fmax((vmax - vmin) / 2.0, 0.1);
+    legacy_kp = 0.6 * 4.0 / (kPi * a);                                          // Прежняя формула: d = 1, без гистерезиса
+  }
+  uint32_t new_ms = 0;                                                          // Остановка по сходимости
+  RelayAutotune at;
+  {
+    SimFurnace f;
+    f.noise = noise;
+    Q16 pv = f.step(0);
+    at.start(0, sp, hyst, pv);
+    for (uint32_t now = 0; now < kLimitMs && at.running(); now += SimFurnace::kDtMs) {
+      pv = f.step(at.tick(now, pv) ? 255 : 0);
+      new_ms = now;
+    }
+  }
+  printf("[AT] noise %.1f C: 6 crossings %lu s (Kp %.3f); converged=%d %lu s, %u switches, Tu %.1f s, a %.2f C, Ku %.2f\n",
+         noise, static_cast<unsigned long>(legacy_ms / 1000), legacy_kp, at.converged() ? 1 : 0,
+         static_cast<unsigned long>(new_ms / 1000), static_cast<unsigned>(at.switches()),
+         at.periodMs() / 1000.0, at.amplitudeC(), at.ultimateGain());
+  for (uint8_t r = 0; r < RelayAutotune::kRuleCount; ++r) {                     // Коэффициенты по всем правилам
+    const auto rule = static_cast<RelayAutotune::Rule>(r);
+    const RelayAutotune::Gains g = at.gains(rule);
+    printf("[AT]   %s: Kp %.3f Ki %.5f Kd %.2f%s\n", RelayAutotune::ruleName(rule), g.kp, g.ki, g.kd, g.valid ? "" : " (n/a)");
+  }
+}                                                                               // Завершение simulate
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runAutotuneSimulation() {                                                  // Печь 2 °C/ед., τ = 600 с, запаздывание 30 с, уставка 200 °C
+  simulate(0.0);                                                                // Чистое измерение
+  simulate(0.5);                                                                // Шум термопары ±0.25 °C
+}                                                                               // Завершение runAutotuneSimulation
+#endif                                                                          // TR_AUTOTUNE_SIM
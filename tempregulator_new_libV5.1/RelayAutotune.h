@@ -0,0 +1,95 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Измерение в Q16, как у PID
+//
+// Релейная автонастройка PID (метод Острёма–Хэгглунда). Выход переключается
+// между 0 и out_hi с гистерезисом ±hyst вокруг уставки; установившиеся
+// автоколебания дают предельный период Tu и размах, по которым считаются
+// коэффициенты.
+//
+// Полупериод отсчитывается между переключениями реле (у них уже есть
+// гистерезис, поэтому шум у уставки не даёт ложных пересечений). Пока реле
+// выключено, запоминается максимум температуры, пока включено — минимум.
+// Каждое переключение кладёт в кольцо на kRing событий время, экстремум
+// завершившейся фазы и накопленное время включения; кучи нет.
+//
+// С третьего переключения (первый полупериод — разогрев из холодного
+// состояния) каждое событие даёт оценку периода (два полупериода назад) и
+// размаха (два последних экстремума). Настройка заканчивается, как только
+// последние kWindow оценок периода и размаха расходятся не больше чем на
+// kTolPermille от среднего, а не после фиксированного числа пересечений.
+//
+// tick() вызывается в задаче регулятора: только сравнения и сложения в целых.
+// Коэффициенты считаются в gains() после остановки, в задаче UI.
+class RelayAutotune {                                                           // Релейная автонастройка
+public:                                                                         // Публичный интерфейс
+  enum Rule : uint8_t {                                                         // Правила пересчёта в коэффициенты PID
+    kTyreusLuyben = 0,                                                          // Тайрес–Люйбен: мягче ZN, малое перерегулирование
+    kSimc,                                                                      // SIMC по модели первого порядка с запаздыванием
+    kNoOvershoot,                                                               // Вариант ZN «без перерегулирования»
+    kZieglerNichols,                                                            // Классический Зиглер–Николс (заметное перерегулирование)
+    kRuleCount                                                                  // Число правил
+  };                                                                            // Конец перечисления Rule
+//
+  struct Gains {                                                                // Коэффициенты PID в параллельной форме
+    double kp;                                                                  // Пропорциональный
+    double ki;                                                                  // Интегральный, 1/с
+    double kd;                                                                  // Дифференциальный, с
+    bool   valid;                                                               // Правило применимо к измерению
+  };                                                                            // Конец структуры Gains
+//
+  static constexpr uint8_t  kRing = 8;                                          // Событий в кольце
+  static constexpr uint8_t  kWindow = 2;                                        // Согласованных оценок для остановки
+  static constexpr uint16_t kTolPermille = 50;                                  // Допустимый разброс оценок, ‰ от среднего
+//
+  void start(uint32_t now_ms, Q16 setpoint, Q16 hyst, Q16 pv, uint8_t out_hi = 255);  // Запуск: реле включено, pv — исходная температура
+  void stop();                                                                  // Остановка без результата
+  bool tick(uint32_t now_ms, Q16 pv);                                           // Шаг: true — выход включён
+//
+  bool     running() const { return running_; }                                 // Реле работает
+  bool     converged() const { return converged_; }                             // Период и размах установились
+  uint8_t  switches() const { return switches_; }                               // Переключений реле с запуска
+  uint32_t periodMs() const { return period_ms_; }                              // Последняя оценка периода, мс (0 — нет)
+  float    amplitudeC() const { return pp_raw_ * (0.5f / 65536.0f); }           // Последняя оценка амплитуды, °C
+  float    dutyPermille() const { return duty_pm_; }                            // Доля включения за период, ‰
+//
+  double      ultimateGain() const;                                             // Ku с поправкой на гистерезис
+  Gains       gains(Rule rule) const;                                           // Коэффициенты по правилу (после converged())
+  static const char* ruleName(Rule rule);                                       // Название правила для экрана
+//
+private:                                                                        // Внутреннее состояние
+  struct Event {                                                                // Переключение реле
+    uint32_t t_ms;                                                              // Время
+    int32_t  extreme_raw;                                                       // Экстремум завершившейся фазы, Q16
+    uint32_t on_ms;                                                             // Накопленное время включения
+  };                                                                            // Конец структуры Event
+//
+  const Event& back(uint8_t k) const { return ring_[(head_ + kRing - 1 - k) % kRing]; }  // k-е событие с конца
+  bool spreadOk(const uint32_t* v) const;                                       // Оценки окна согласованы
+//
+  Event    ring_[kRing] = {};                                                   // Последние переключения
+  uint8_t  head_ = 0;                                                           // Следующая запись в кольце
+  uint8_t  switches_ = 0;                                                       // Число переключений (до 255)
+  uint32_t period_win_[kWindow] = {};                                           // Последние оценки периода, мс
+  uint32_t pp_win_[kWindow] = {};                                               // Последние оценки размаха, Q16
+  uint8_t  samples_ = 0;                                                        // Оценок в окне
+  bool     running_ = false;                                                    // Реле работает
+  bool     converged_ = false;                                                  // Результат готов
+  bool     on_ = false;                                                         // Состояние выхода
+  uint8_t  out_hi_ = 255;                                                       // Уровень включённого выхода
+  int32_t  sp_raw_ = 0;                                                         // Уставка, Q16
+  int32_t  hyst_raw_ = 0;                                                       // Гистерезис, Q16
+  int32_t  pv0_raw_ = 0;                                                        // Температура при запуске, Q16
+  int32_t  extreme_raw_ = 0;                                                    // Экстремум текущей фазы, Q16
+  uint32_t last_ms_ = 0;                                                        // Предыдущий тик
+  uint32_t on_ms_ = 0;                                                          // Время включения с запуска
+  uint32_t period_ms_ = 0;                                                      // Результат: период
+  uint32_t pp_raw_ = 0;                                                         // Результат: размах, Q16
+  float    duty_pm_ = 0.0f;                                                     // Результат: доля включения, ‰
+};                                                                              // Конец определения класса RelayAutotune
+//
+#ifdef TR_AUTOTUNE_SIM                                                          // Отладочная сборка: моделирование на печи первого порядка
+void runAutotuneSimulation();                                                   // Сравнение с прежней остановкой по 6 пересечениям
+#endif                                                                          // TR_AUTOTUNE_SIM
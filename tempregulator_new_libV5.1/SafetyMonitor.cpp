@@ -0,0 +1,85 @@
+#include "SafetyMonitor.h"                                                      // Объявление класса
+//
+#include "SsrFeedback.h"                                                        // Признаки блоков
+//
+const char* SafetyMonitor::text(Alarm a) {                                      // Сообщение для экрана
+  switch (a) {
+    case Alarm::OpenCircuit:   return "Обрыв термопары";
+    case Alarm::SensorFault:   return "Неисправность термопары";
+    case Alarm::RiseFast:      return "Скачок температуры: проверьте термопару";
+    case Alarm::RiseStall:     return "Нет роста температуры при нагреве";
+    case Alarm::SsrStuckOn:    return "SSR не отключается: ток при выключенном выходе";
+    case Alarm::SsrNoCurrent:  return "Нет тока нагревателя: SSR не включается или обрыв";
+    case Alarm::SsrWeak:       return "Нагреватель потребляет неполную мощность";
+    case Alarm::ProbeOverheat: return "Перегрев: защитный датчик";
+    default:                   return "";
+  }
+}                                                                               // Завершение text
+//
+bool SafetyMonitor::stopsHeat(Alarm a) {                                        // Предупреждения нагрев не снимают
+  return a != Alarm::None && a != Alarm::SensorFault && a != Alarm::SsrWeak;
+}                                                                               // Завершение stopsHeat
+//
+SafetyMonitor::Alarm SafetyMonitor::faultCycle(bool bad) {                      // Счёт плохих циклов подряд
+  if (!bad) {
+    fault_cycles_ = 0;
+    return Alarm::None;
+  }
+  if (fault_cycles_ < 255) ++fault_cycles_;
+  return fault_cycles_ >= kFaultCycles ? Alarm::SensorFault : Alarm::None;
+}                                                                               // Завершение faultCycle
+//
+SafetyMonitor::Alarm SafetyMonitor::spiReading(uint32_t seq, bool open, bool fault) {  // Раз на новое чтение
+  if (seq == spi_seq_seen_) return Alarm::None;
+  spi_seq_seen_ = seq;
+  if (open) return Alarm::OpenCircuit;
+  return faultCycle(fault);
+}                                                                               // Завершение spiReading
+//
+SafetyMonitor::Alarm SafetyMonitor::adcReading(bool open, uint32_t window, uint8_t outliers) {  // Отсчёт АЦП
+  if (open) return Alarm::OpenCircuit;                                          // По сырому отсчёту, не дожидаясь окон
+  if (window == window_seen_) return Alarm::None;                               // Выбросы — раз в полностью новое окно
+  window_seen_ = window;
+  return faultCycle(outliers > kOutlierAlarmCount);
+}                                                                               // Завершение adcReading
+//
+SafetyMonitor::Alarm SafetyMonitor::rise(uint32_t now_ms, bool active, Q16 pv, Q16 rate, int power,
+                                         float target_c) {                      // Аварии по скорости роста
+  if (!active) {                                                                // Нет нагрева, авария уже есть или оценщик не готов
+    restartRise();
+    return Alarm::None;
+  }
+  const uint32_t now = now_ms | 1;                                              // 0 означает «таймер не запущен»
+  if (rate > kRiseFastRate) {
+    if (!fast_t0_) fast_t0_ = now;
+  } else {
+    fast_t0_ = 0;
+  }
+  if (fast_t0_ && now - fast_t0_ >= kRiseFastMs) return Alarm::RiseFast;
+  if (power < kStallPower || pv.toFloat() >= target_c - kStallMarginC) {       // Мощность снята или цель рядом
+    stall_t0_ = 0;
+  } else if (!stall_t0_) {
+    stall_t0_ = now;
+    stall_pv_ = pv;
+  } else if (now - stall_t0_ >= kStallMs) {
+    const Q16 min_rise = Q16::fromRaw(kStallRate.raw() * static_cast<int32_t>(kStallMs / 1000));  // 2.4 °C за окно
+    if (pv - stall_pv_ < min_rise) return Alarm::RiseStall;
+    stall_t0_ = now;                                                            // Рост был: следующее окно
+    stall_pv_ = pv;
+  }
+  return Alarm::None;
+}                                                                               // Завершение rise
+//
+SafetyMonitor::Alarm SafetyMonitor::ssrFeedback(const SsrFeedback& fb, bool heating) {  // Итоги раз в блок
+  if (!fb.enabled() || fb.blockCount() == blocks_seen_) return Alarm::None;
+  blocks_seen_ = fb.blockCount();
+  const uint8_t f = fb.flags();
+  if (f & SsrFeedback::kStuckOn) return Alarm::SsrStuckOn;
+  if (f & SsrFeedback::kNoCurrent) return Alarm::SsrNoCurrent;
+  if (heating && (f & SsrFeedback::kWeak)) return Alarm::SsrWeak;
+  return Alarm::None;
+}                                                                               // Завершение ssrFeedback
+//
+SafetyMonitor::Alarm SafetyMonitor::probe(float temp_c) const {                 // Защитный датчик
+  return temp_c > kProbeMaxC ? Alarm::ProbeOverheat : Alarm::None;
+}                                                                               // Завершение probe
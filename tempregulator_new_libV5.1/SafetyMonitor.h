@@ -0,0 +1,69 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+//
+class SsrFeedback;                                                              // Итоги блоков обратной связи SSR
+//
+// Аварийные проверки датчика и нагревателя без ввода-вывода: обрыв и
+// неисправность термопары (SPI-усилитель или окна АЦП), скачок температуры и
+// нагрев без роста, итоги обратной связи SSR и защитный датчик. Владелец
+// передаёт сюда то, что уже прочитал, и по непустому Alarm поднимает аварию
+// с text() и stopsHeat(). Как и WorkLoop, один и тот же код выполняют
+// TempRegulator на плате и модель печи на ПК (PlantSimulator), поэтому
+// прогоны с внесёнными неисправностями проверяют именно прошивочную логику.
+//
+// Таймеры роста хранят время начала с младшим битом 1: 0 означает «таймер
+// не запущен». Нагрев без роста оценивается по приросту температуры за окно
+// kStallMs, а не по мгновенной скорости: у неподвижного спая оценка
+// скорости шумит вокруг нуля сильнее kStallRate, и любой шаг выше порога
+// сбрасывал бы таймер. Окна АЦП и чтения SPI оцениваются по одному разу —
+// повтор того же номера ничего не меняет.
+class SafetyMonitor {                                                           // Аварии датчика и нагревателя
+public:                                                                         // Публичный интерфейс
+  static constexpr uint8_t  kOutlierAlarmCount = 5;                             // Выбросов в окне АЦП больше — окно плохое
+  static constexpr uint8_t  kFaultCycles = 3;                                   // Плохих окон или чтений подряд — неисправность
+  static constexpr float    kProbeMaxC = 550.0f;                                // Предел защитного датчика, °C
+  static constexpr Q16      kRiseFastRate = Q16(20);                            // Быстрее нагреватель не может: обрыв/замыкание датчика, °C/с
+  static constexpr uint32_t kRiseFastMs = 2000;                                 // Столько держится — авария
+  static constexpr Q16      kStallRate = Q16::fromRatio(1, 50);                 // Почти полная мощность, а рост за окно медленнее: датчик выпал из печи, °C/с
+  static constexpr int      kStallPower = 230;                                  // Мощность «почти полная», 0..255
+  static constexpr float    kStallMarginC = 20.0f;                              // Ниже цели хотя бы на столько
+  static constexpr uint32_t kStallMs = 120000;                                  // Окно оценки прироста
+//
+  enum class Alarm : uint8_t {                                                  // Итог проверки
+    None,                                                                       // Всё в порядке
+    OpenCircuit,                                                                // Обрыв термопары
+    SensorFault,                                                                // Выбросы или ошибки усилителя подряд
+    RiseFast,                                                                   // Рост быстрее возможного
+    RiseStall,                                                                  // Полная мощность без роста
+    SsrStuckOn,                                                                 // Ток при выключенном выходе
+    SsrNoCurrent,                                                               // Нет тока при включённом выходе
+    SsrWeak,                                                                    // Ток ниже обычного
+    ProbeOverheat,                                                              // Защитный датчик выше kProbeMaxC
+  };                                                                            // Конец перечисления Alarm
+//
+  static const char* text(Alarm a);                                             // Сообщение для экрана и веба
+  static bool        stopsHeat(Alarm a);                                        // Авария снимает нагрев
+//
+  void  clearFaults() { fault_cycles_ = 0; }                                    // Авария снята: счёт плохих циклов заново
+  void  restartRise() { fast_t0_ = stall_t0_ = 0; }                             // Оценщик перезапущен: таймеры роста заново
+  void  skipWindows(uint32_t window) { window_seen_ = window; }                 // Окна до window не оценивать (смена режима АЦП)
+  Alarm spiReading(uint32_t seq, bool open, bool fault);                        // Чтение SPI-усилителя номер seq
+  Alarm adcReading(bool open, uint32_t window, uint8_t outliers);               // Отсчёт АЦП: обрыв сразу, выбросы — раз в окно
+  Alarm rise(uint32_t now_ms, bool active, Q16 pv, Q16 rate, int power, float target_c);  // Скорость роста при нагреве
+  Alarm ssrFeedback(const SsrFeedback& fb, bool heating);                       // Итоги нового блока обратной связи
+  Alarm probe(float temp_c) const;                                              // Защитный датчик
+//
+private:                                                                        // Внутреннее состояние
+  Alarm faultCycle(bool bad);                                                   // Плохой или хороший цикл подряд
+//
+  uint32_t spi_seq_seen_ = 0;                                                   // Последнее оценённое чтение SPI
+  uint32_t window_seen_ = 0;                                                    // Последнее оценённое окно АЦП
+  uint32_t blocks_seen_ = 0;                                                    // Последний оценённый блок SSR
+  uint32_t fast_t0_ = 0;                                                        // Начало слишком быстрого роста (0 — нет)
+  uint32_t stall_t0_ = 0;                                                       // Начало окна нагрева на полной мощности (0 — нет)
+  Q16      stall_pv_;                                                           // Температура в начале окна
+  uint8_t  fault_cycles_ = 0;                                                   // Плохих циклов подряд
+};                                                                              // Конец определения класса SafetyMonitor
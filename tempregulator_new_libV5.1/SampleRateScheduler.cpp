@@ -0,0 +1,52 @@
+#include "SampleRateScheduler.h"                                                // Объявление класса
+//
+namespace {                                                                     // Внутренние пороги модуля
+//
+struct Threshold {                                                              // Граница ступени
+  Q16 rate;                                                                     // Модуль скорости роста, °C/с
+  Q16 error;                                                                    // Модуль ошибки регулирования, °C
+};                                                                              // Конец структуры Threshold
+//
+constexpr Threshold kThresholds[SampleRateScheduler::kLevels - 1] = {           // Выше порога — ступень с этим номером
+  { Q16(2),                 Q16(20) },                                          // Разгон: 1000 Гц
+  { Q16::fromRatio(1, 2),   Q16(5) },                                           // Подход к уставке: 500 Гц
+  { Q16::fromRatio(1, 10),  Q16(1) },                                           // Доводка: 200 Гц
+};                                                                              // Иначе выдержка: 50 Гц
+//
+Q16 absQ(Q16 v) { return v < Q16() ? -v : v; }                                  // Модуль
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+uint8_t SampleRateScheduler::wantedLevel(Q16 rate, Q16 error) {                 // Ступень по текущей динамике
+  rate = absQ(rate);                                                            // Знак не важен: остывание тоже быстро
+  error = absQ(error);
+  for (uint8_t i = 0; i < kLevels - 1; ++i) {                                   // От самой частой ступени
+    if (rate > kThresholds[i].rate || error > kThresholds[i].error) {           // Процесс быстрее порога
+      return i;                                                                 // Эта ступень
+    }                                                                           // Конец проверки
+  }                                                                             // Конец перебора
+  return kLevels - 1;                                                           // Выдержка
+}                                                                               // Завершение wantedLevel
+//
+bool SampleRateScheduler::update(uint32_t now_ms, Q16 rate_c_per_s, Q16 error_c) {  // Вызывается на шаге оценщика
+  const uint8_t want = wantedLevel(rate_c_per_s, error_c);                      // Нужная ступень
+  if (want < level_) {                                                          // Процесс ускорился
+    level_ = want;                                                              // Ускоряемся сразу
+    calm_since_ = 0;                                                            // Спокойный участок прерван
+    return true;                                                                // Период изменился
+  }                                                                             // Конец ускорения
+  if (want == level_) {                                                         // Ступень подходит
+    calm_since_ = 0;                                                            // Замедлять нечего
+    return false;                                                               // Без изменений
+  }                                                                             // Конец проверки
+  if (!calm_since_) {                                                           // Начало спокойного участка
+    calm_since_ = now_ms | 1;                                                   // 0 означает «нет участка»
+    return false;                                                               // Ждём выдержку
+  }                                                                             // Конец проверки
+  if (now_ms - calm_since_ < kDwellMs) {                                        // Выдержка не прошла
+    return false;                                                               // Ждём
+  }                                                                             // Конец проверки
+  ++level_;                                                                     // Замедляемся на одну ступень
+  calm_since_ = 0;                                                              // Следующая ступень — после новой выдержки
+  return true;                                                                  // Период изменился
+}                                                                               // Завершение update
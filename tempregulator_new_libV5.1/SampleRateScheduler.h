@@ -0,0 +1,31 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+//
+// Выбор частоты выборки АЦП по динамике процесса. Уровень определяется
+// оценкой скорости роста и ошибкой регулирования: на разгоне и при большой
+// ошибке отсчёты идут чаще (меньше запаздывание медианного окна), на выдержке —
+// реже (меньше занятость CPU и АЦП). Ускорение применяется сразу, замедление —
+// по одной ступени после kDwellMs спокойного процесса, чтобы частота не
+// переключалась на каждом колебании около уставки.
+class SampleRateScheduler {                                                     // Планировщик частоты выборки
+public:                                                                         // Публичный интерфейс
+  static constexpr uint8_t  kLevels = 4;                                        // Число ступеней частоты
+  static constexpr uint8_t  kNominalLevel = 1;                                  // Ступень прежнего фиксированного периода
+  static constexpr uint32_t kDwellMs = 5000;                                    // Выдержка перед замедлением
+  static constexpr uint32_t kPeriodUs[kLevels] = { 1000, 2000, 5000, 20000 };   // Период канала по ступеням, мкс
+//
+  bool update(uint32_t now_ms, Q16 rate_c_per_s, Q16 error_c);                  // Пересчёт ступени; true — период изменился
+  void reset() { level_ = kNominalLevel; calm_since_ = 0; }                     // Вернуться к номинальной частоте
+//
+  uint8_t  level() const { return level_; }                                     // Текущая ступень (0 — самая частая)
+  uint32_t periodUs() const { return kPeriodUs[level_]; }                       // Период выборки канала, мкс
+//
+private:                                                                        // Внутреннее состояние
+  static uint8_t wantedLevel(Q16 rate, Q16 error);                              // Ступень, нужная процессу сейчас
+//
+  uint8_t  level_ = kNominalLevel;                                              // Текущая ступень
+  uint32_t calm_since_ = 0;                                                     // Начало спокойного участка (0 — нет)
+};                                                                              // Конец определения класса SampleRateScheduler
@@ -0,0 +1,70 @@
+#include "SensorHealth.h"                                                       // Объявление класса
+//
+#include <math.h>                                                               // sqrtf, fabsf
+//
+void SensorHealth::restart() {                                                  // Начало нового сеанса измерений
+  n_ = 0; mean_ = 0.0f; m2_ = 0.0f;                                             // Блок Уэлфорда пуст
+  marks_valid_ = false;                                                         // Отметки счётчиков АЦП возьмём заново
+  drift_ = 0.0f;                                                                // Дрейф с нуля
+  cusum_hi_ = 0.0f; cusum_lo_ = 0.0f;                                           // CUSUM с нуля
+  steps_ = 0;                                                                   // Скачков нет
+  holdoff_ = 0;                                                                 // Паузы нет
+  flags_ &= kOpen;                                                              // Обрыв определяется по отсчёту, остальное — заново
+}                                                                               // Завершение restart
+//
+void SensorHealth::setOpen(bool open) {                                         // Обрыв по последнему отсчёту
+  flags_ = open ? (flags_ | kOpen) : (flags_ & ~kOpen);                         // Обновляем бит
+}                                                                               // Завершение setOpen
+//
+float SensorHealth::noiseC() const {                                            // СКО невязки
+  if (blocks_ > 0) return block_sigma_;                                         // Итог последнего блока
+  return n_ > 1 ? sqrtf(m2_ / (n_ - 1)) : 0.0f;                                 // До первого блока — текущая оценка
+}                                                                               // Завершение noiseC
+//
+void SensorHealth::update(Q16 innovation, uint32_t samples_total, uint32_t outliers_total) {  // Шаг оценщика
+  if (!marks_valid_) {                                                          // Первый шаг блока после restart()
+    samples_mark_ = samples_total; outliers_mark_ = outliers_total;             // Отметки счётчиков
+    marks_valid_ = true;
+  }                                                                             // Конец проверки
+  const float e = innovation.toFloat();                                         // Невязка, °C
+  ++n_;                                                                         // Уэлфорд: одно обновление за O(1)
+  const float d = e - mean_;
+  mean_ += d / n_;
+  m2_ += d * (e - mean_);
+  drift_ += (e - drift_) * kDriftAlpha;                                         // Медленное среднее невязки
+  const float ref = base_sigma_ > 0.0f ? base_sigma_ : kNoisyMinC;              // Шкала для CUSUM
+  const float k = (4.0f * ref > 1.0f) ? 4.0f * ref : 1.0f;                      // Допуск: обычный шум не накапливается
+  if (holdoff_) {                                                               // Оценщик ещё догоняет прошлый скачок
+    --holdoff_;                                                                 // Один и тот же скачок не считаем дважды
+  } else {                                                                      // Ищем скачок
+    cusum_hi_ = (cusum_hi_ + e - k > 0.0f) ? cusum_hi_ + e - k : 0.0f;          // Накопление вверх
+    cusum_lo_ = (cusum_lo_ - e - k > 0.0f) ? cusum_lo_ - e - k : 0.0f;          // Накопление вниз
+    if (cusum_hi_ > 4.0f * k || cusum_lo_ > 4.0f * k) {                         // Устойчивый сдвиг показаний
+      ++steps_;                                                                 // Учитываем скачок
+      flags_ |= kStep;                                                          // Признак держится до restart()
+      cusum_hi_ = 0.0f; cusum_lo_ = 0.0f;                                       // Ищем следующий
+      holdoff_ = kStepHoldoff;                                                  // После паузы
+    }                                                                           // Конец проверки скачка
+  }                                                                             // Конец проверки паузы
+  if (fabsf(drift_) > kDriftMaxC) flags_ |= kDrift; else flags_ &= ~kDrift;     // Дрейф от модели
+  if (n_ >= kBlockSteps) {                                                      // Блок набран
+    finishBlock(samples_total, outliers_total);                                 // Итоги блока
+  }                                                                             // Конец проверки
+}                                                                               // Завершение update
+//
+void SensorHealth::finishBlock(uint32_t samples_total, uint32_t outliers_total) {  // Итоги блока
+  block_sigma_ = sqrtf(m2_ / (n_ - 1));                                         // СКО невязки за блок
+  ++blocks_;                                                                    // Учитываем блок
+  const uint32_t samples = samples_total - samples_mark_;                       // Отсчётов АЦП за блок
+  const uint32_t outliers = outliers_total - outliers_mark_;                    // Выбросов за блок
+  outlier_pct_ = samples ? 100.0f * outliers / samples : 0.0f;                  // Доля выбросов
+  samples_mark_ = samples_total; outliers_mark_ = outliers_total;               // Отметки следующего блока
+  const bool noisy = base_sigma_ > 0.0f && block_sigma_ > kNoisyMinC &&
+                     block_sigma_ > kNoisyRatio * base_sigma_;                  // Шум заметно вырос
+  if (!noisy && block_sigma_ > 0.0f && (base_sigma_ == 0.0f || block_sigma_ < base_sigma_)) {
+    base_sigma_ = block_sigma_;                                                 // Наименьший шум — база исправного датчика
+  }                                                                             // Конец обновления базы
+  if (noisy) flags_ |= kNoisy; else flags_ &= ~kNoisy;                          // Признак шума
+  if (outlier_pct_ > kOutlierPct) flags_ |= kOutliers; else flags_ &= ~kOutliers;  // Признак выбросов
+  n_ = 0; mean_ = 0.0f; m2_ = 0.0f;                                             // Следующий блок
+}                                                                               // Завершение finishBlock
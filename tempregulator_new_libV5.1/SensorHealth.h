@@ -0,0 +1,65 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+//
+// Потоковая статистика исправности термопары с памятью O(1). Питается невязкой
+// оценщика (измерение минус прогноз модели) на каждом его шаге и счётчиками
+// выбросов сборщика АЦП:
+//  - шум: дисперсия невязки по Уэлфорду в блоках по kBlockSteps шагов; рост
+//    относительно наименьшего шума исправного датчика выдаёт деградацию;
+//  - доля выбросов медианного окна за блок;
+//  - дрейф: медленное экспоненциальное среднее невязки (смещение от модели);
+//  - скачок: двусторонний CUSUM невязки с порогом от базового шума.
+// Обрыв отмечается извне (AdcSampler::openCircuit, бит SPI) — с первого отсчёта.
+class SensorHealth {                                                            // Статистика исправности датчика
+public:                                                                         // Публичный интерфейс
+  static constexpr uint16_t kBlockSteps = 600;                                  // Шагов оценщика в блоке (1 мин при 100 мс)
+  static constexpr float    kNoisyRatio = 3.0f;                                 // Шум выше базового во столько раз — деградация
+  static constexpr float    kNoisyMinC = 0.5f;                                  // Ниже этого шум не считается проблемой, °C
+  static constexpr float    kOutlierPct = 5.0f;                                 // Доля выбросов, при которой датчик под подозрением, %
+  static constexpr float    kDriftMaxC = 1.0f;                                  // Допустимое смещение от модели, °C
+  static constexpr float    kDriftAlpha = 1.0f / 256;                           // Вес EMA дрейфа (~25 с при 100 мс)
+  static constexpr uint8_t  kStepHoldoff = 50;                                  // Шагов после скачка без нового поиска (оценщик догоняет)
+//
+  enum Flag : uint8_t {                                                         // Признаки неисправности
+    kNoisy = 0x01,                                                              // Шум вырос
+    kOutliers = 0x02,                                                           // Много выбросов
+    kDrift = 0x04,                                                              // Показания уходят от модели
+    kStep = 0x08,                                                               // Был скачок показаний
+    kOpen = 0x10,                                                               // Обрыв
+  };                                                                            // Конец перечисления Flag
+//
+  void restart();                                                               // Новый сеанс: блок, дрейф и CUSUM заново (база сохраняется)
+  void update(Q16 innovation, uint32_t samples_total, uint32_t outliers_total); // Шаг оценщика
+  void setOpen(bool open);                                                      // Состояние обрыва по последнему отсчёту
+//
+  bool     hasData() const { return blocks_ > 0 || n_ > 1; }                    // Есть оценка шума
+  float    noiseC() const;                                                      // СКО невязки (последний блок или текущий), °C
+  float    baselineNoiseC() const { return base_sigma_; }                       // Наименьший шум исправного датчика, °C
+  float    outlierPct() const { return outlier_pct_; }                          // Доля выбросов за последний блок, %
+  float    driftC() const { return drift_; }                                    // Смещение от модели, °C
+  uint16_t stepCount() const { return steps_; }                                 // Число обнаруженных скачков
+  uint8_t  flags() const { return flags_; }                                     // Текущие признаки Flag
+//
+private:                                                                        // Внутреннее состояние
+  void finishBlock(uint32_t samples_total, uint32_t outliers_total);            // Итоги блока
+//
+  uint16_t n_ = 0;                                                              // Шагов в текущем блоке
+  float    mean_ = 0.0f;                                                        // Уэлфорд: среднее невязки
+  float    m2_ = 0.0f;                                                          // Уэлфорд: сумма квадратов отклонений
+  float    block_sigma_ = 0.0f;                                                 // СКО последнего блока, °C
+  float    base_sigma_ = 0.0f;                                                  // Базовый шум (0 — ещё нет)
+  uint32_t blocks_ = 0;                                                         // Завершённых блоков
+  uint32_t samples_mark_ = 0;                                                   // Счётчик отсчётов АЦП в начале блока
+  uint32_t outliers_mark_ = 0;                                                  // Счётчик выбросов в начале блока
+  bool     marks_valid_ = false;                                                // Отметки блока заданы
+  float    outlier_pct_ = 0.0f;                                                 // Доля выбросов, %
+  float    drift_ = 0.0f;                                                       // EMA невязки, °C
+  float    cusum_hi_ = 0.0f;                                                    // CUSUM вверх
+  float    cusum_lo_ = 0.0f;                                                    // CUSUM вниз
+  uint16_t steps_ = 0;                                                          // Скачков с начала сеанса
+  uint8_t  holdoff_ = 0;                                                        // Осталось шагов паузы после скачка
+  uint8_t  flags_ = 0;                                                          // Признаки Flag
+};                                                                              // Конец определения класса SensorHealth
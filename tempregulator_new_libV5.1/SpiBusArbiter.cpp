@@ -0,0 +1,59 @@
+#include "SpiBusArbiter.h"                                                      // Объявление арбитра
+//
+#ifdef ARDUINO
+#include <Arduino.h>                                                            // micros
+#endif                                                                          // ARDUINO
+//
+SpiBusArbiter& SpiBusArbiter::instance() {                                      // Единственный экземпляр
+  static SpiBusArbiter arbiter;                                                 // Создаётся при первом обращении
+  return arbiter;                                                               // Возвращаем ссылку
+}                                                                               // Завершение instance
+//
+SpiBusArbiter::SpiBusArbiter() {                                                // Конструктор
+#ifdef ARDUINO
+  clock_ = []() -> uint32_t { return micros(); };                               // На устройстве — системное время
+#endif                                                                          // ARDUINO
+}                                                                               // Завершение конструктора
+//
+bool SpiBusArbiter::tryAcquire(Client c) {                                      // Захват без ожидания
+  uint8_t expected = static_cast<uint8_t>(Client::None);                        // Ожидаем свободную шину
+  if (!owner_.compare_exchange_strong(expected, static_cast<uint8_t>(c))) {     // Шина занята
+    if (c == Client::Sensor) {                                                  // Датчик откладывает чтение
+      ++stats_.sensor_deferrals;                                                // Учитываем
+    }                                                                           // Конец проверки
+    return false;                                                               // Не захватили
+  }                                                                             // Конец проверки захвата
+  ++stats_.grants[static_cast<uint8_t>(c)];                                     // Учитываем захват
+  if (c == Client::Sensor) {                                                    // Датчик — засекаем удержание
+    sensor_t0_ = now();                                                         // Начало удержания
+  }                                                                             // Конец проверки
+  return true;                                                                  // Шина наша
+}                                                                               // Завершение tryAcquire
+//
+void SpiBusArbiter::acquire(Client c) {                                         // Захват с ожиданием
+  uint8_t expected = static_cast<uint8_t>(Client::None);                        // Ожидаем свободную шину
+  if (owner_.compare_exchange_strong(expected, static_cast<uint8_t>(c))) {      // Быстрый путь — шина свободна
+    ++stats_.grants[static_cast<uint8_t>(c)];                                   // Учитываем захват
+    return;                                                                     // Готово
+  }                                                                             // Конец быстрого пути
+  const uint32_t t0 = now();                                                    // Начало ожидания
+  do {                                                                          // Ждём окончания короткой транзакции датчика
+    expected = static_cast<uint8_t>(Client::None);                              // Снова ожидаем свободную шину
+  } while (!owner_.compare_exchange_weak(expected, static_cast<uint8_t>(c)));   // Пока не захватим
+  const uint32_t waited = now() - t0;                                           // Время ожидания
+  if (waited > stats_.max_wait_us) {                                            // Новый максимум
+    stats_.max_wait_us = waited;                                                // Запоминаем
+  }                                                                             // Конец проверки
+  ++stats_.grants[static_cast<uint8_t>(c)];                                     // Учитываем захват
+}                                                                               // Завершение acquire
+//
+void SpiBusArbiter::release(Client c) {                                         // Освобождение шины
+  if (c == Client::Sensor) {                                                    // Датчик — фиксируем удержание
+    const uint32_t held = now() - sensor_t0_;                                   // Длительность удержания
+    if (held > stats_.max_sensor_hold_us) {                                     // Новый максимум
+      stats_.max_sensor_hold_us = held;                                         // Запоминаем
+    }                                                                           // Конец проверки
+  }                                                                             // Конец проверки участника
+  uint8_t expected = static_cast<uint8_t>(c);                                   // Освобождать может только владелец
+  owner_.compare_exchange_strong(expected, static_cast<uint8_t>(Client::None)); // Шина свободна
+}                                                                               // Завершение release
@@ -0,0 +1,60 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <atomic>                                                               // Атомарный владелец шины
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+// Арбитр общей шины SPI2_HOST: дисплей ILI9341, тач XPT2046 и SPI-усилители
+// термопар. Дисплей и тач захватывают шину на время своей транзакции и при
+// необходимости ждут; датчик только пробует захватить её без ожидания и, если
+// шина занята, откладывает чтение до следующего свободного промежутка. Время
+// удержания шины датчиком ограничено одной короткой транзакцией (~10 мкс), так
+// что отрисовка LVGL не задерживается, а заливка кадра не блокирует датчик:
+// преобразование в микросхеме идёт непрерывно, отложенное чтение лишь сдвигается.
+class SpiBusArbiter {                                                           // Арбитр шины
+public:                                                                         // Публичный интерфейс
+  enum class Client : uint8_t {                                                 // Участники шины
+    None = 0,                                                                   // Шина свободна
+    Display = 1,                                                                // Заливка LVGL (display_flush_cb)
+    Touch = 2,                                                                  // Чтение тача (touchpad_read_cb)
+    Sensor = 3,                                                                 // SPI-усилитель термопары
+  };                                                                            // Конец перечисления Client
+  static constexpr uint8_t kClientCount = 4;                                    // Размер массивов статистики
+//
+  using ClockFn = uint32_t (*)();                                               // Источник времени, мкс
+//
+  struct Stats {                                                                // Статистика арбитража
+    uint32_t grants[kClientCount] = {};                                         // Выданные захваты по участникам
+    uint32_t sensor_deferrals = 0;                                              // Отложенные чтения датчика
+    uint32_t max_wait_us = 0;                                                   // Наибольшее ожидание дисплея/тача
+    uint32_t max_sensor_hold_us = 0;                                            // Наибольшее удержание шины датчиком
+  };                                                                            // Конец структуры Stats
+//
+  static SpiBusArbiter& instance();                                             // Единственный арбитр шины
+//
+  bool tryAcquire(Client c);                                                    // Захват без ожидания (датчик)
+  void acquire(Client c);                                                       // Захват с ожиданием (дисплей, тач)
+  void release(Client c);                                                       // Освобождение шины владельцем
+  Client owner() const { return static_cast<Client>(owner_.load()); }           // Текущий владелец
+  void setClock(ClockFn fn) { clock_ = fn; }                                    // Подменить источник времени (хост)
+  Stats stats() const { return stats_; }                                        // Снимок статистики
+//
+private:                                                                        // Внутреннее состояние
+  SpiBusArbiter();                                                              // Закрытый конструктор
+  uint32_t now() const { return clock_ ? clock_() : 0; }                        // Время, мкс
+//
+  std::atomic<uint8_t> owner_{0};                                               // Владелец шины (Client)
+  ClockFn  clock_ = nullptr;                                                    // Источник времени
+  uint32_t sensor_t0_ = 0;                                                      // Начало удержания шины датчиком
+  Stats    stats_;                                                              // Статистика
+};                                                                              // Конец определения класса SpiBusArbiter
+//
+class SpiBusLock {                                                              // Захват шины на время области видимости
+public:                                                                         // Публичный интерфейс
+  explicit SpiBusLock(SpiBusArbiter::Client c) : c_(c) { SpiBusArbiter::instance().acquire(c_); }
+  ~SpiBusLock() { SpiBusArbiter::instance().release(c_); }                      // Освобождаем при выходе
+  SpiBusLock(const SpiBusLock&) = delete;                                       // Копировать нельзя
+  SpiBusLock& operator=(const SpiBusLock&) = delete;                            // Присваивать нельзя
+//
+private:                                                                        // Внутреннее состояние
+  SpiBusArbiter::Client c_;                                                     // Владелец
+};                                                                              // Конец определения класса SpiBusLock
@@ -0,0 +1,69 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "SpiBusArbiter.h"                                                      // Проверка владельца шины при обмене
+#include "SpiThermocouple.h"                                                    // TransferFn и типы микросхем
+//
+// Имитация MAX31855 / MAX31856 для запуска без железа (в том числе на Linux):
+// подставляется в SpiThermocouple::setTransfer(SpiMockDevice::transfer) и
+// отвечает кадрами с заданной температурой. Каждый обмен проверяет, что шину
+// в этот момент держит датчик, — так проверяется расписание арбитра вместе с
+// имитацией заливки и тача через SpiBusArbiter::acquire()/release().
+class SpiMockDevice {                                                           // Имитатор SPI-усилителя
+public:                                                                         // Публичный интерфейс
+  explicit SpiMockDevice(SpiThermocouple::Chip chip) : chip_(chip) { active() = this; }  // Становится текущим устройством
+  ~SpiMockDevice() { if (active() == this) active() = nullptr; }                // Снимаем регистрацию
+//
+  void set(double hot_c, double cold_c, uint8_t fault = 0) {                    // Значения следующих ответов
+    hot_c_ = hot_c; cold_c_ = cold_c; fault_ = fault;                           // Запоминаем
+  }                                                                             // Конец set
+//
+  uint32_t transfers() const { return transfers_; }                             // Число обменов
+  uint32_t busViolations() const { return violations_; }                        // Обмены без захвата шины датчиком
+  uint8_t  cr0() const { return regs_[0]; }                                     // Записанный CR0 (MAX31856)
+  uint8_t  cr1() const { return regs_[1]; }                                     // Записанный CR1 (MAX31856)
+//
+  static bool transfer(int8_t, uint8_t, uint32_t, uint8_t* buf, size_t len) {   // Совместима с SpiThermocouple::TransferFn
+    SpiMockDevice* d = active();                                                // Текущее устройство
+    return d ? d->exchange(buf, len) : false;                                   // Нет устройства — нет ответа
+  }                                                                             // Конец transfer
+//
+private:                                                                        // Внутреннее состояние
+  static SpiMockDevice*& active() { static SpiMockDevice* p = nullptr; return p; }  // Текущее устройство
+//
+  bool exchange(uint8_t* buf, size_t len) {                                     // Один обмен
+    ++transfers_;                                                               // Учитываем
+    if (SpiBusArbiter::instance().owner() != SpiBusArbiter::Client::Sensor) {   // Шину держит не датчик
+      ++violations_;                                                            // Нарушение расписания
+    }                                                                           // Конец проверки
+    if (chip_ == SpiThermocouple::Chip::MAX31855) {                             // 32-битный кадр
+      const uint32_t hot = static_cast<uint32_t>(static_cast<int32_t>(hot_c_ * 4)) & 0x3FFF;   // 14 бит, 0.25 °C
+      const uint32_t cold = static_cast<uint32_t>(static_cast<int32_t>(cold_c_ * 16)) & 0x0FFF;  // 12 бит, 0.0625 °C
+      const uint32_t f = (hot << 18) | (fault_ ? 0x10000UL : 0) | (cold << 4) | (fault_ & 0x07);
+      for (size_t i = 0; i < len && i < 4; ++i) buf[i] = static_cast<uint8_t>(f >> (24 - 8 * i));
+      return true;                                                              // Готово
+    }                                                                           // Конец MAX31855
+    uint8_t addr = buf[0] & 0x7F;                                               // MAX31856: адрес регистра
+    if (buf[0] & 0x80) {                                                        // Запись
+      for (size_t i = 1; i < len && addr < sizeof(regs_); ++i) regs_[addr++] = buf[i];
+      return true;                                                              // Готово
+    }                                                                           // Конец записи
+    const int32_t cold = static_cast<int32_t>(cold_c_ * 64) << 2;               // CJTH:CJTL
+    const int32_t hot = static_cast<int32_t>(hot_c_ * 128) << 5;                // LTCBH:LTCBM:LTCBL
+    regs_[0x0A] = uint8_t(cold >> 8); regs_[0x0B] = uint8_t(cold);
+    regs_[0x0C] = uint8_t(hot >> 16); regs_[0x0D] = uint8_t(hot >> 8); regs_[0x0E] = uint8_t(hot);
+    regs_[0x0F] = fault_;                                                       // SR
+    for (size_t i = 1; i < len && addr < sizeof(regs_); ++i) buf[i] = regs_[addr++];  // Последовательное чтение
+    return true;                                                                // Готово
+  }                                                                             // Конец exchange
+//
+  SpiThermocouple::Chip chip_;                                                  // Имитируемая микросхема
+  double   hot_c_ = 25.0;                                                       // Температура горячего спая
+  double   cold_c_ = 25.0;                                                      // Температура холодного спая
+  uint8_t  fault_ = 0;                                                          // Биты неисправности (формат микросхемы)
+  uint8_t  regs_[16] = {};                                                      // Регистры MAX31856
+  uint32_t transfers_ = 0;                                                      // Счётчик обменов
+  uint32_t violations_ = 0;                                                     // Счётчик нарушений
+};                                                                              // Конец определения класса SpiMockDevice
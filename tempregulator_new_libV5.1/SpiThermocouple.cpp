@@ -0,0 +1,137 @@
+#include "SpiThermocouple.h"                                                    // Объявление драйвера
+//
+#include "SpiBusArbiter.h"                                                      // Захват общей шины
+//
+#ifdef ARDUINO
+#include "DisplayDriver.h"                                                      // LovyanGFX: тот же SPI-драйвер, что у дисплея и тача
+#endif                                                                          // ARDUINO
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+constexpr uint8_t kRegCr0 = 0x00;                                               // MAX31856: регистр CR0
+constexpr uint8_t kRegCjth = 0x0A;                                              // MAX31856: первый регистр блока результата
+constexpr uint8_t kWrite = 0x80;                                                // MAX31856: бит записи в адресе
+constexpr uint8_t kCr0AutoConvert = 0x80;                                       // CR0: непрерывное преобразование
+constexpr uint8_t kCr0OpenDetect = 0x10;                                        // CR0: детектор обрыва, режим 1
+constexpr uint8_t kCr0Filter50Hz = 0x01;                                        // CR0: режекция 50 Гц (0 — 60 Гц)
+constexpr uint8_t kSrOpen = 0x01;                                               // SR: обрыв
+constexpr uint8_t kSrOvUv = 0x02;                                               // SR: напряжение вне диапазона (замыкание)
+constexpr uint8_t kSrRange = 0xC0;                                              // SR: холодный спай или термопара вне диапазона
+//
+constexpr int32_t kSeebeckNvPerC_K = 41276;                                     // MAX31855K: заложенная крутизна, нВ/°C
+constexpr int32_t kSeebeckNvPerC_J = 57953;                                     // MAX31855J: заложенная крутизна, нВ/°C
+//
+#ifdef ARDUINO
+bool lgfxTransfer(int8_t cs, uint8_t mode, uint32_t freq, uint8_t* buf, size_t len) {  // Обмен через lgfx::spi, как у Touch_XPT2046
+  lgfx::spi::beginTransaction(SPI2_HOST, freq, mode);                           // Настройка частоты и режима
+  lgfx::gpio_lo(cs);                                                            // Выбор микросхемы
+  lgfx::spi::readBytes(SPI2_HOST, buf, len);                                    // Полнодуплексный обмен
+  lgfx::gpio_hi(cs);                                                            // Снятие выбора
+  lgfx::spi::endTransaction(SPI2_HOST);                                         // Конец транзакции
+  return true;                                                                  // Шина не сообщает об ошибках
+}                                                                               // Завершение lgfxTransfer
+#endif                                                                          // ARDUINO
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+bool SpiThermocouple::begin(Chip chip, int8_t cs_pin, tc::Type type, uint8_t mains_hz) {  // Настройка
+  chip_ = chip;                                                                 // Тип микросхемы
+  cs_ = cs_pin;                                                                 // Пин выбора
+  last_ = Reading{};                                                            // Результатов ещё нет
+#ifdef ARDUINO
+  if (!transfer_) {                                                             // Если обмен не подменён
+    transfer_ = lgfxTransfer;                                                   // Используем шину дисплея
+  }                                                                             // Конец выбора обмена
+  if (cs_ >= 0) {                                                               // Пин выбора задан
+    lgfx::pinMode(cs_, lgfx::pin_mode_t::output);                               // Выход
+    lgfx::gpio_hi(cs_);                                                         // Микросхема не выбрана
+  }                                                                             // Конец настройки пина
+#endif                                                                          // ARDUINO
+  if (chip_ == Chip::None || cs_ < 0 || !transfer_) {                           // Нечего настраивать
+    chip_ = Chip::None;                                                         // Драйвер выключен
+    return false;                                                               // Сообщаем вызывающему
+  }                                                                             // Конец проверки
+  if (chip_ == Chip::MAX31856) {                                                // Регистровая микросхема
+    const uint8_t tc_bits = (type == tc::Type::J) ? 0x02 : 0x03;                // CR1: тип J или K, без усреднения
+    uint8_t cfg[3] = { static_cast<uint8_t>(kRegCr0 | kWrite),
+                       static_cast<uint8_t>(kCr0AutoConvert | kCr0OpenDetect | (mains_hz == 60 ? 0 : kCr0Filter50Hz)),
+                       tc_bits };                                               // Запись CR0 и CR1 подряд
+    SpiBusLock lock(SpiBusArbiter::Client::Sensor);                             // Однократная настройка может подождать
+    transfer_(cs_, 1, kSpiFreq, cfg, sizeof(cfg));                              // MAX31856 работает в режиме SPI 1
+  }                                                                             // Конец настройки MAX31856
+  due_ms_ = 0;                                                                  // Первое чтение — сразу
+  return true;                                                                  // Готово
+}                                                                               // Завершение begin
+//
+bool SpiThermocouple::poll(uint32_t now_ms) {                                   // Вызывается из управляющего цикла
+  if (chip_ == Chip::None || (last_.valid && int32_t(now_ms - due_ms_) < 0)) {  // Выключен или результат ещё не готов
+    return false;                                                               // Ничего не делаем
+  }                                                                             // Конец проверки
+  SpiBusArbiter& bus = SpiBusArbiter::instance();                               // Арбитр шины
+  if (!bus.tryAcquire(SpiBusArbiter::Client::Sensor)) {                         // Идёт заливка или чтение тача
+    ++deferrals_;                                                               // Попробуем на следующем цикле
+    return false;                                                               // Не ждём
+  }                                                                             // Конец проверки шины
+  const bool ok = readNow();                                                    // Короткий обмен
+  bus.release(SpiBusArbiter::Client::Sensor);                                   // Сразу освобождаем шину
+  due_ms_ = now_ms + kConversionMs;                                             // Следующий результат
+  return ok;                                                                    // Было ли новое чтение
+}                                                                               // Завершение poll
+//
+bool SpiThermocouple::readNow() {                                               // Обмен с микросхемой
+  Reading r;                                                                    // Новый результат
+  if (chip_ == Chip::MAX31855) {                                                // 32 такта, только чтение
+    uint8_t b[4] = {0, 0, 0, 0};                                                // Приёмный буфер
+    if (!transfer_(cs_, 0, kSpiFreq, b, sizeof(b))) return false;               // Обмен не удался
+    r = decode31855((uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | b[3]);
+  } else {                                                                      // MAX31856: адрес + 6 регистров
+    uint8_t b[7] = {kRegCjth, 0, 0, 0, 0, 0, 0};                                // Чтение с 0x0A
+    if (!transfer_(cs_, 1, kSpiFreq, b, sizeof(b))) return false;               // Обмен не удался
+    r = decode31856(b + 1);                                                     // Разбираем регистры
+  }                                                                             // Конец выбора микросхемы
+  r.seq = last_.seq + 1;                                                        // Номер чтения
+  last_ = r;                                                                    // Публикуем
+  return true;                                                                  // Готово
+}                                                                               // Завершение readNow
+//
+SpiThermocouple::Reading SpiThermocouple::decode31855(uint32_t frame) {         // Кадр MAX31855
+  Reading r;                                                                    // Результат
+  r.valid = true;                                                               // Чтение состоялось
+  const int32_t hot = static_cast<int32_t>(frame) >> 18;                        // 14 бит со знаком, 0.25 °C
+  const int32_t cold = static_cast<int32_t>(frame << 16) >> 20;                 // 12 бит со знаком, 0.0625 °C
+  r.hot = Q16::fromRaw(hot * (Q16::kOne / 4));                                  // В Q16
+  r.cold = Q16::fromRaw(cold * (Q16::kOne / 16));                               // В Q16
+  r.fault = static_cast<uint8_t>(frame & 0x07);                                 // OC / SCG / SCV совпадают с Fault
+  if ((frame & 0x00010000UL) && r.fault == 0) {                                 // Общий бит неисправности без подробностей
+    r.fault = kFaultOther;                                                      // Прочая неисправность
+  }                                                                             // Конец проверки
+  if (frame == 0 || frame == 0xFFFFFFFFUL) {                                    // Микросхема не отвечает (MISO висит)
+    r.fault = kFaultOther;                                                      // Нет связи
+  }                                                                             // Конец проверки
+  return r;                                                                     // Готово
+}                                                                               // Завершение decode31855
+//
+SpiThermocouple::Reading SpiThermocouple::decode31856(const uint8_t* regs) {    // Регистры MAX31856 с 0x0A
+  Reading r;                                                                    // Результат
+  r.valid = true;                                                               // Чтение состоялось
+  const int32_t cold = static_cast<int16_t>((regs[0] << 8) | regs[1]) >> 2;     // 14 бит со знаком, 1/64 °C
+  const int32_t hot = static_cast<int32_t>((uint32_t(regs[2]) << 24) | (uint32_t(regs[3]) << 16) |
+                                           (uint32_t(regs[4]) << 8)) >> 13;     // 19 бит со знаком, 1/128 °C
+  r.hot = Q16::fromRaw(hot * (Q16::kOne / 128));                                // В Q16
+  r.cold = Q16::fromRaw(cold * (Q16::kOne / 64));                               // В Q16
+  const uint8_t sr = regs[5];                                                   // Регистр состояния
+  r.fault = static_cast<uint8_t>(((sr & kSrOpen) ? kFaultOpen : 0) |
+                                 ((sr & kSrOvUv) ? kFaultShortVcc : 0) |
+                                 ((sr & kSrRange) ? kFaultOther : 0));          // Перевод в общие биты
+  return r;                                                                     // Готово
+}                                                                               // Завершение decode31856
+//
+Q16 SpiThermocouple::linearized(tc::Type type) const {                          // Температура с линеаризацией
+  if (chip_ != Chip::MAX31855 || type == tc::Type::Linear) {                    // MAX31856 линеаризует сам
+    return last_.hot;                                                           // Как есть
+  }                                                                             // Конец проверки
+  const int32_t nv = (type == tc::Type::J) ? kSeebeckNvPerC_J : kSeebeckNvPerC_K;  // Крутизна, заложенная в микросхему
+  const int64_t dt = int64_t(last_.hot.raw()) - last_.cold.raw();               // Разность спаев, Q16 °C
+  const tc::EmfQ rel = tc::EmfQ::fromRaw(fixed_detail::sat32(dt * nv / (1000 * (Q16::kOne / tc::EmfQ::kOne))));  // Восстановленная ЭДС, мкВ
+  return tc::temperature(type, rel + tc::emf(type, last_.cold));                // ЭДС от 0 °C -> таблица NIST
+}                                                                               // Завершение linearized
@@ -0,0 +1,66 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+#include "ThermocoupleTables.h"                                                 // Тип термопары
+//
+// Драйвер SPI-усилителей термопар MAX31855 / MAX31856 на общей с дисплеем шине.
+// Микросхема преобразует непрерывно (~100 мс), драйвер лишь забирает результат:
+// poll() из управляющего цикла раз в kConversionMs пробует захватить шину через
+// SpiBusArbiter и, если она занята заливкой или тачем, откладывает чтение до
+// следующего вызова. Обмен идёт через подменяемую функцию TransferFn, поэтому
+// на хосте вместо шины подключается SpiMockDevice.
+class SpiThermocouple {                                                         // Драйвер усилителя термопары
+public:                                                                         // Публичный интерфейс
+  enum class Chip : uint8_t {                                                   // Тип микросхемы
+    None = 0,                                                                   // Не используется (встроенный АЦП)
+    MAX31855 = 1,                                                               // Только чтение 32-битного кадра
+    MAX31856 = 2,                                                               // Регистровый интерфейс, линеаризация в микросхеме
+  };                                                                            // Конец перечисления Chip
+//
+  enum Fault : uint8_t {                                                        // Биты неисправности
+    kFaultOpen = 0x01,                                                          // Обрыв термопары
+    kFaultShortGnd = 0x02,                                                      // Замыкание на землю
+    kFaultShortVcc = 0x04,                                                      // Замыкание на питание
+    kFaultOther = 0x80,                                                         // Прочие (диапазон, холодный спай, нет ответа)
+  };                                                                            // Конец перечисления Fault
+//
+  // Полнодуплексный обмен: buf отправляется и заменяется принятыми байтами.
+  using TransferFn = bool (*)(int8_t cs_pin, uint8_t spi_mode, uint32_t freq, uint8_t* buf, size_t len);
+//
+  static constexpr uint32_t kConversionMs = 100;                                // Период готовности нового результата
+  static constexpr uint32_t kSpiFreq = 4000000;                                 // Частота SPI (обе микросхемы до 5 МГц)
+//
+  struct Reading {                                                              // Результат одного чтения
+    Q16      hot;                                                               // Температура горячего спая, °C
+    Q16      cold;                                                              // Температура холодного спая (внутренний датчик), °C
+    uint8_t  fault = 0;                                                         // Биты Fault (0 — исправно)
+    bool     valid = false;                                                     // Было хотя бы одно чтение
+    uint32_t seq = 0;                                                           // Номер чтения
+  };                                                                            // Конец структуры Reading
+//
+  bool begin(Chip chip, int8_t cs_pin, tc::Type type, uint8_t mains_hz);        // Настройка микросхемы
+  void setTransfer(TransferFn fn) { transfer_ = fn; }                           // Подменить обмен (хост)
+  bool poll(uint32_t now_ms);                                                   // Забрать результат, если пора и шина свободна
+//
+  Chip     chip() const { return chip_; }                                       // Тип микросхемы
+  bool     enabled() const { return chip_ != Chip::None; }                      // Драйвер активен
+  Reading  latest() const { return last_; }                                     // Последний результат
+  Q16      linearized(tc::Type type) const;                                     // Температура с линеаризацией NIST для MAX31855
+  uint32_t deferrals() const { return deferrals_; }                             // Отложенные чтения (шина была занята)
+//
+  static Reading decode31855(uint32_t frame);                                   // Разбор кадра MAX31855
+  static Reading decode31856(const uint8_t* regs);                              // Разбор регистров MAX31856 с 0x0A (6 байт)
+//
+private:                                                                        // Внутреннее состояние
+  bool readNow();                                                               // Обмен с микросхемой (шина уже захвачена)
+//
+  Chip       chip_ = Chip::None;                                                // Тип микросхемы
+  int8_t     cs_ = -1;                                                          // Пин выбора
+  TransferFn transfer_ = nullptr;                                               // Функция обмена
+  uint32_t   due_ms_ = 0;                                                       // Время следующего чтения
+  uint32_t   deferrals_ = 0;                                                    // Счётчик отложенных чтений
+  Reading    last_;                                                             // Последний результат
+};                                                                              // Конец определения класса SpiThermocouple
@@ -0,0 +1,123 @@
+#include "SsrFeedback.h"                                                        // Объявление класса
+//
+#include "SsrOutput.h"                                                          // Команда выхода
+//
+#ifdef ARDUINO                                                                  // На целевой платформе — GPIO и esp_timer
+#include <Arduino.h>                                                            // digitalRead
+#include "esp_timer.h"                                                          // Периодический таймер ESP-IDF
+#endif                                                                          // ARDUINO
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+#ifdef ARDUINO
+bool arduinoRead(uint8_t pin) {                                                 // Чтение по умолчанию — GPIO
+  return digitalRead(pin) == HIGH;                                              // Уровень входа
+}                                                                               // Завершение arduinoRead
+#endif                                                                          // ARDUINO
+//
+constexpr uint16_t kMaxRatio = 4000;                                            // Верхняя граница отношения фактической мощности к заданной, ‰
+//
+uint16_t permille(uint32_t part, uint32_t whole) {                              // Доля в промилле
+  return whole ? static_cast<uint16_t>(part * 1000 / whole) : 0;                // Без деления на ноль
+}                                                                               // Завершение permille
+//
+uint8_t confirm(uint8_t bad, bool cond) {                                       // Счётчик плохих блоков подряд
+  return cond ? (bad < 255 ? bad + 1 : bad) : 0;                                // Сброс на хорошем блоке
+}                                                                               // Завершение confirm
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+bool SsrFeedback::begin(uint8_t pin, bool active_low, const SsrOutput* out) {   // Запуск
+  pin_ = pin;                                                                   // Вход
+  active_low_ = active_low;                                                     // Полярность
+#ifdef ARDUINO
+  if (!read_) {                                                                 // Если чтение не подменено
+    read_ = arduinoRead;                                                        // Читаем GPIO
+  }                                                                             // Конец выбора источника
+  if (!timer_) {                                                                // Таймер ещё не создан
+    esp_timer_handle_t h = nullptr;                                             // Дескриптор нового таймера
+    const esp_timer_create_args_t args = { .callback = &SsrFeedback::timerCallback,
+                                           .arg = this,
+                                           .dispatch_method = ESP_TIMER_TASK,
+                                           .name = "ssr_feedback" };            // Параметры таймера опроса
+    if (esp_timer_create(&args, &h) != ESP_OK) {                                // Создаём таймер
+      return false;                                                             // Без таймера монитор не работает
+    }                                                                           // Конец проверки создания
+    if (esp_timer_start_periodic(h, kSampleUs) != ESP_OK) {                     // Запускаем опрос
+      esp_timer_delete(h);                                                      // Освобождаем
+      return false;                                                             // Сообщаем об ошибке
+    }                                                                           // Конец проверки запуска
+    timer_ = h;                                                                 // Сохраняем дескриптор
+  }                                                                             // Конец проверки существования
+#endif                                                                          // ARDUINO
+  out_ = out;                                                                   // Монитор включён
+  return true;                                                                  // Готово
+}                                                                               // Завершение begin
+//
+void SsrFeedback::end() {                                                       // Остановка
+#ifdef ARDUINO
+  if (timer_) {                                                                 // Если таймер был создан
+    esp_timer_handle_t h = static_cast<esp_timer_handle_t>(timer_);             // Восстанавливаем тип дескриптора
+    esp_timer_stop(h);                                                          // Останавливаем
+    esp_timer_delete(h);                                                        // Удаляем
+  }                                                                             // Конец проверки таймера
+#endif                                                                          // ARDUINO
+  timer_ = nullptr;                                                             // Таймера больше нет
+  out_ = nullptr;                                                               // Монитор выключен
+  flags_ = 0;                                                                   // Признаков нет
+}                                                                               // Завершение end
+//
+void SsrFeedback::timerCallback(void* arg) {                                    // Вызывается esp_timer в своей задаче
+  auto* self = static_cast<SsrFeedback*>(arg);                                  // Владелец таймера
+  if (!self->out_ || !self->read_) return;                                      // Не запущен
+  self->sample(self->out_->level(), self->read_(self->pin_) != self->active_low_);  // Команда и фактический ток
+}                                                                               // Завершение timerCallback
+//
+void SsrFeedback::sample(bool commanded, bool current) {                        // Один отсчёт
+  if (commanded) {                                                              // Выход включён
+    ++on_n_;
+    if (current) ++on_cur_;
+  } else {                                                                      // Выход выключен
+    ++off_n_;
+    if (current) ++off_cur_;
+  }                                                                             // Конец учёта
+  if (++n_ >= kBlockSamples) finishBlock();                                     // Блок набран
+}                                                                               // Завершение sample
+//
+void SsrFeedback::finishBlock() {                                               // Итоги блока
+  const bool on_valid = on_n_ >= kMinSamples;                                   // Включённое состояние оценимо
+  const bool off_valid = off_n_ >= kMinSamples;                                 // Выключенное состояние оценимо
+  const uint16_t on_pm = permille(on_cur_, on_n_);                              // Доля тока при включении
+  const uint16_t off_pm = permille(off_cur_, off_n_);                           // Доля тока при выключении
+  const bool none = on_valid && on_pm < kNoCurrentPermille;                     // Тока нет
+  const bool stuck = off_valid && off_pm > kStuckOnPermille;                    // Реле залипло
+  if (on_valid && !none && !stuck && on_pm > ref_) ref_ = on_pm;                // Опорная доля исправного нагревателя
+  const bool weak = on_valid && !none && ref_ && permille(on_pm, ref_) < kWeakPermille;  // Ток ниже обычного
+//
+  const uint16_t ref = ref_ ? ref_ : 1000;                                      // До первой опоры — без нормировки
+  uint32_t delivered = permille(on_cur_ + off_cur_, n_) * 1000UL / ref;         // Фактическая скважность
+  if (delivered > 1000) delivered = 1000;
+  const uint16_t commanded = permille(on_n_, n_);                               // Заданная скважность
+  uint32_t ratio = commanded ? delivered * 1000UL / commanded : 1000;           // Фактическая к заданной
+  if (ratio > kMaxRatio) ratio = kMaxRatio;
+  delivered_ = static_cast<uint16_t>(delivered);                                // Публикуем
+  ratio_ = static_cast<uint16_t>(ratio);
+  delivered_ms_ += delivered * (static_cast<uint32_t>(n_) * kSampleUs / 1000) / 1000;  // Эквивалент полной мощности, мс
+//
+  bad_stuck_ = confirm(bad_stuck_, stuck);                                      // Подтверждение признаков
+  bad_none_ = confirm(bad_none_, none);
+  bad_weak_ = confirm(bad_weak_, weak);
+  uint8_t f = 0;                                                                // Новые признаки
+  if (bad_stuck_ >= kConfirmBlocks) f |= kStuckOn;
+  if (bad_none_ >= kConfirmBlocks) f |= kNoCurrent;
+  if (bad_weak_ >= kConfirmBlocks) f |= kWeak;
+  flags_ = f;                                                                   // Публикуем
+  ++blocks_;                                                                    // Учитываем блок
+  n_ = 0; on_n_ = 0; on_cur_ = 0; off_n_ = 0; off_cur_ = 0;                     // Следующий блок
+}                                                                               // Завершение finishBlock
+//
+int SsrFeedback::deliveredPower(int commanded) const {                          // Команда × фактическая/заданная
+  if (!enabled() || blocks_ == 0) return commanded;                             // Итогов ещё нет — верим команде
+  const int p = static_cast<int>((static_cast<uint32_t>(commanded) * ratio_ + 500) / 1000);
+  return p > 255 ? 255 : p;
+}                                                                               // Завершение deliveredPower
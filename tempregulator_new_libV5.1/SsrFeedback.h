@@ -0,0 +1,77 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+class SsrOutput;                                                                // Выход, с командой которого сравниваем
+//
+// Контроль SSR по входу обратной связи SSR_FEEDBACK_PIN (оптрон или датчик
+// тока в цепи нагревателя: активный уровень — ток через нагрузку есть).
+// Вход опрашивается esp_timer раз в kSampleUs: за полупериод сети (10 или
+// 8.3 мс) снимается 8–10 отсчётов в разных фазах, поэтому провалы оптрона у
+// перехода через ноль входят в долю тока одинаково в каждом блоке. Каждый
+// отсчёт сравнивается с командой SsrOutput::level().
+//
+// Итоги подводятся блоками по kBlockSamples отсчётов:
+//  - доля тока при включённом выходе — опорная (запоминается наибольшая, с ней
+//    нормируется фактическая скважность — оптрон проводит не весь полупериод);
+//  - ток при выключенном выходе — реле залипло во включённом состоянии;
+//  - нет тока при включённом выходе — реле не включается или обрыв нагревателя
+//    (по одному входу эти случаи неразличимы);
+//  - ток заметно ниже опорного — нагреватель потребляет не полную мощность.
+// Признак выставляется после kConfirmBlocks плохих блоков подряд.
+class SsrFeedback {                                                             // Монитор обратной связи SSR
+public:                                                                         // Публичный интерфейс
+  using ReadFn = bool (*)(uint8_t pin);                                         // Чтение входа: true — ток есть
+//
+  static constexpr uint32_t kSampleUs = 1000;                                   // Период опроса входа, мкс
+  static constexpr uint16_t kBlockSamples = 2000;                               // Отсчётов в блоке (2 с)
+  static constexpr uint16_t kMinSamples = 200;                                  // Меньше отсчётов в состоянии — блок его не оценивает
+  static constexpr uint16_t kStuckOnPermille = 500;                             // Ток при выключенном выходе, ‰ — залипание
+  static constexpr uint16_t kNoCurrentPermille = 100;                           // Ток при включённом выходе ниже, ‰ — нет тока
+  static constexpr uint16_t kWeakPermille = 600;                                // Ниже этой доли опорного тока — неполная мощность, ‰
+  static constexpr uint8_t  kConfirmBlocks = 2;                                 // Плохих блоков подряд для признака
+//
+  enum Flag : uint8_t {                                                         // Признаки неисправности
+    kStuckOn = 0x01,                                                            // Ток есть, хотя выход выключен
+    kNoCurrent = 0x02,                                                          // Тока нет, хотя выход включён
+    kWeak = 0x04,                                                               // Ток заметно ниже обычного
+  };                                                                            // Конец перечисления Flag
+//
+  bool begin(uint8_t pin, bool active_low, const SsrOutput* out);               // Запуск опроса
+  void end();                                                                   // Остановка опроса
+  void setReadFn(ReadFn fn) { read_ = fn; }                                     // Подменить чтение входа (хост)
+  void sample(bool commanded, bool current);                                    // Один отсчёт (таймер; на хосте — вручную)
+//
+  bool     enabled() const { return out_ != nullptr; }                          // Монитор запущен
+  uint32_t blockCount() const { return blocks_; }                               // Завершённых блоков
+  uint8_t  flags() const { return flags_; }                                     // Текущие признаки Flag
+  uint16_t deliveredPermille() const { return delivered_; }                     // Фактическая скважность последнего блока, ‰
+  uint16_t ratioPermille() const { return ratio_; }                             // Фактическая/заданная мощность последнего блока, ‰
+  uint32_t deliveredMs() const { return delivered_ms_; }                        // Фактическое время полной мощности с запуска, мс
+  int      deliveredPower(int commanded) const;                                 // Мощность 0..255 с учётом фактического тока
+//
+private:                                                                        // Внутреннее состояние
+  static void timerCallback(void* arg);                                         // Колбэк периодического таймера
+  void finishBlock();                                                           // Итоги блока
+//
+  const SsrOutput* out_ = nullptr;                                              // Выход (nullptr — монитор выключен)
+  uint8_t  pin_ = 0;                                                            // Вход обратной связи
+  bool     active_low_ = true;                                                  // Ток — низкий уровень (оптрон на подтяжке)
+  ReadFn   read_ = nullptr;                                                     // Чтение входа
+  void*    timer_ = nullptr;                                                    // Дескриптор esp_timer (nullptr на хосте)
+//
+  uint16_t n_ = 0;                                                              // Отсчётов в блоке
+  uint16_t on_n_ = 0;                                                           // Отсчётов с включённым выходом
+  uint16_t on_cur_ = 0;                                                         // Из них с током
+  uint16_t off_n_ = 0;                                                          // Отсчётов с выключенным выходом
+  uint16_t off_cur_ = 0;                                                        // Из них с током
+  uint16_t ref_ = 0;                                                            // Опорная доля тока при включении, ‰ (0 — ещё нет)
+  uint8_t  bad_stuck_ = 0;                                                      // Плохих блоков подряд: залипание
+  uint8_t  bad_none_ = 0;                                                       // Плохих блоков подряд: нет тока
+  uint8_t  bad_weak_ = 0;                                                       // Плохих блоков подряд: слабый ток
+  volatile uint8_t  flags_ = 0;                                                 // Признаки Flag
+  volatile uint16_t delivered_ = 0;                                             // Фактическая скважность, ‰
+  volatile uint16_t ratio_ = 1000;                                              // Фактическая/заданная мощность, ‰
+  volatile uint32_t delivered_ms_ = 0;                                          // Накопленное время полной мощности, мс
+  volatile uint32_t blocks_ = 0;                                                // Завершённых блоков
+};                                                                              // Конец определения класса SsrFeedback
@@ -0,0 +1,111 @@
+#include "SsrOutput.h"                                                          // Объявление класса
+//
+#ifdef ARDUINO                                                                  // На целевой платформе — GPIO и esp_timer
+#include <Arduino.h>                                                            // digitalWrite
+#include "esp_timer.h"                                                          // Периодический таймер ESP-IDF
+#endif                                                                          // ARDUINO
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+#ifdef ARDUINO
+void arduinoWrite(uint8_t pin, bool on) {                                       // Вывод по умолчанию — GPIO
+  digitalWrite(pin, on ? HIGH : LOW);                                           // Один регистр, безопасно из таймера
+}                                                                               // Завершение arduinoWrite
+#endif                                                                          // ARDUINO
+//
+uint32_t slotFor(SsrOutput::Mode mode, uint8_t mains_hz) {                      // Длительность слота режима
+  if (mode == SsrOutput::Mode::Window) return SsrOutput::kWindowSlotUs;         // Доля окна ~1 с
+  if (mains_hz != 60) mains_hz = 50;                                            // Поддерживаются сети 50 и 60 Гц
+  return 1000000UL / (2UL * mains_hz);                                          // Полупериод сети
+}                                                                               // Завершение slotFor
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+bool SsrOutput::begin(uint8_t pin, Mode mode, uint8_t mains_hz) {               // Запуск
+  pin_ = pin;                                                                   // Вывод реле
+#ifdef ARDUINO
+  if (!write_) {                                                                // Если вывод не подменён
+    write_ = arduinoWrite;                                                      // Пишем в GPIO
+  }                                                                             // Конец выбора вывода
+#endif                                                                          // ARDUINO
+  write(false);                                                                 // Начинаем с выключенного выхода
+  return setMode(mode, mains_hz);                                               // Режим и таймер
+}                                                                               // Завершение begin
+//
+bool SsrOutput::setMode(Mode mode, uint8_t mains_hz) {                          // Смена режима
+  mode_ = mode;                                                                 // Запоминаем режим
+  slot_us_ = slotFor(mode, mains_hz);                                           // Длительность слота
+  slot_ = 0;                                                                    // Окно заново
+  latched_ = 0;
+  acc_ = 0;                                                                     // Сигма-дельта заново
+  return restartTimer();                                                        // Перезапуск таймера
+}                                                                               // Завершение setMode
+//
+bool SsrOutput::restartTimer() {                                                // (Пере)запуск таймера
+#ifdef ARDUINO
+  esp_timer_handle_t h = static_cast<esp_timer_handle_t>(timer_);               // Существующий таймер (если есть)
+  if (!h) {                                                                     // Таймер ещё не создан
+    const esp_timer_create_args_t args = { .callback = &SsrOutput::timerCallback,
+                                           .arg = this,
+                                           .dispatch_method = ESP_TIMER_TASK,
+                                           .name = "ssr_output" };              // Параметры таймера модуляции
+    if (esp_timer_create(&args, &h) != ESP_OK) {                                // Создаём таймер
+      return false;                                                             // Без таймера выход остаётся выключен
+    }                                                                           // Конец проверки создания
+    timer_ = h;                                                                 // Сохраняем дескриптор
+  } else {                                                                      // Таймер уже работает
+    esp_timer_stop(h);                                                          // Останавливаем перед сменой периода
+  }                                                                             // Конец проверки существования
+  if (esp_timer_start_periodic(h, slot_us_) != ESP_OK) {                        // Запускаем периодический вызов
+    return false;                                                               // Сообщаем об ошибке
+  }                                                                             // Конец проверки запуска
+#endif                                                                          // ARDUINO
+  return true;                                                                  // Таймер запущен
+}                                                                               // Завершение restartTimer
+//
+void SsrOutput::end() {                                                         // Остановка
+#ifdef ARDUINO
+  if (timer_) {                                                                 // Если таймер был создан
+    esp_timer_handle_t h = static_cast<esp_timer_handle_t>(timer_);             // Восстанавливаем тип дескриптора
+    esp_timer_stop(h);                                                          // Останавливаем
+    esp_timer_delete(h);                                                        // Удаляем
+  }                                                                             // Конец проверки таймера
+#endif                                                                          // ARDUINO
+  timer_ = nullptr;                                                             // Таймера больше нет
+  off();                                                                        // Выход выключен
+}                                                                               // Завершение end
+//
+void SsrOutput::off() {                                                         // Немедленное выключение
+  power_ = 0;                                                                   // Следующий слот тоже выключен
+  write(false);                                                                 // Не ждём слота
+}                                                                               // Завершение off
+//
+void SsrOutput::timerCallback(void* arg) {                                      // Вызывается esp_timer в своей задаче
+  static_cast<SsrOutput*>(arg)->tick();                                         // Один слот за тик
+}                                                                               // Завершение timerCallback
+//
+void SsrOutput::tick() {                                                        // Один слот
+  const uint8_t p = power_;                                                     // Снимок мощности
+  bool on;                                                                      // Уровень слота
+  if (mode_ == Mode::SigmaDelta) {                                              // Сигма-дельта
+    acc_ += p;                                                                  // Накопленная доля
+    on = acc_ >= kSlots;                                                        // Набрался целый слот
+    if (on) acc_ -= kSlots;                                                     // Переносим остаток
+  } else {                                                                      // Окно: Window или Burst
+    if (slot_ == 0 || p < latched_) latched_ = p;                               // Новое окно или снижение — сразу
+    on = slot_ < latched_;                                                      // Включение в начале окна
+    slot_ = (slot_ + 1 >= kSlots) ? 0 : slot_ + 1;                              // Следующий слот по кругу
+  }                                                                             // Конец выбора режима
+  ++total_slots_;                                                               // Учитываем слот
+  if (on) ++on_slots_;                                                          // И включённый слот
+  write(on);                                                                    // Выставляем уровень
+}                                                                               // Завершение tick
+//
+void SsrOutput::write(bool on) {                                                // Вывод уровня
+  if (on != level_) {                                                           // Фронт
+    level_ = on;                                                                // Новый уровень
+    ++edges_;                                                                   // Учитываем переключение
+    if (edge_) edge_(edge_arg_, on);                                            // Сообщаем подписчику (синхронизация АЦП)
+  }                                                                             // Конец проверки фронта
+  if (write_) write_(pin_, on);                                                 // Выставляем вывод каждый слот
+}                                                                               // Завершение write
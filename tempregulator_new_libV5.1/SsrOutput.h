@@ -0,0 +1,77 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+// Аппаратная модуляция выхода SSR. Выход переключает периодический esp_timer
+// (системный таймер SYSTIMER), а не цикл программы, поэтому скважность не
+// зависит от задержек UI и задачи регулятора. Время делится на слоты, и в окне
+// из kSlots = 255 слотов мощность 0..255 — это ровно число включённых слотов,
+// так что доля включения совпадает с заданной мощностью без округления.
+//
+// Режимы:
+//  - Window     — пропорционально времени: слот 1/255 окна ~1 с, включение
+//                 одним отрезком в начале окна;
+//  - Burst      — пакеты целых полупериодов: слот — полупериод сети, включение
+//                 одним пакетом в начале окна из 255 полупериодов;
+//  - SigmaDelta — сигма-дельта по полупериодам: включённые полупериоды
+//                 равномерно распределены (наименьшие пульсации и фликер).
+// В Window и Burst новая мощность берётся в начале окна; снижение применяется
+// сразу, чтобы отключение не ждало конца окна. Полупериодные слоты не
+// синхронизированы с переходом через ноль: реле с переключением в нуле само
+// выравнивает включение по полупериоду.
+//
+// На хосте таймера нет: tick() вызывается вручную, а запись в вывод подменяется
+// через setWriteFn() — счётчики слотов показывают фактическую скважность.
+class SsrOutput {                                                               // Выход SSR с аппаратной модуляцией
+public:                                                                         // Публичный интерфейс
+  enum class Mode : uint8_t {                                                   // Способ модуляции
+    Window = 0,                                                                 // Пропорционально времени
+    Burst = 1,                                                                  // Пакеты полупериодов
+    SigmaDelta = 2,                                                             // Сигма-дельта по полупериодам
+  };                                                                            // Конец перечисления Mode
+//
+  using WriteFn = void (*)(uint8_t pin, bool on);                               // Запись уровня в вывод
+  using EdgeFn = void (*)(void* arg, bool on);                                  // Уведомление о переключении выхода
+//
+  static constexpr uint16_t kSlots = 255;                                       // Слотов в окне (= полная мощность)
+  static constexpr uint32_t kWindowSlotUs = 3922;                               // Слот режима Window: окно 1.0001 с
+//
+  bool begin(uint8_t pin, Mode mode, uint8_t mains_hz);                         // Запуск таймера модуляции
+  void end();                                                                   // Остановка таймера, выход выключен
+  bool setMode(Mode mode, uint8_t mains_hz);                                    // Сменить режим или частоту сети
+  void setPower(uint8_t power) { power_ = power; }                              // Мощность 0..255 (из любой задачи)
+  void off();                                                                   // Немедленно выключить выход и обнулить мощность
+  void setWriteFn(WriteFn fn) { write_ = fn; }                                  // Подменить вывод (хост)
+  void setEdgeCallback(EdgeFn fn, void* arg) { edge_ = fn; edge_arg_ = arg; }   // Уведомлять о фронтах
+//
+  void tick();                                                                  // Один слот (колбэк таймера; на хосте — вручную)
+//
+  Mode     mode() const { return mode_; }                                       // Текущий режим
+  uint8_t  power() const { return power_; }                                     // Заданная мощность
+  bool     level() const { return level_; }                                     // Текущий уровень выхода
+  uint32_t slotUs() const { return slot_us_; }                                  // Длительность слота, мкс
+  uint32_t onSlots() const { return on_slots_; }                                // Включённых слотов с запуска
+  uint32_t totalSlots() const { return total_slots_; }                          // Всего слотов с запуска
+  uint32_t edgeCount() const { return edges_; }                                 // Переключений выхода с запуска
+//
+private:                                                                        // Внутреннее состояние
+  static void timerCallback(void* arg);                                         // Колбэк периодического таймера
+  bool restartTimer();                                                          // (Пере)запуск таймера с периодом слота
+  void write(bool on);                                                          // Выставить уровень и учесть фронт
+//
+  uint8_t  pin_ = 0;                                                            // Вывод SSR
+  Mode     mode_ = Mode::Window;                                                // Текущий режим
+  uint32_t slot_us_ = kWindowSlotUs;                                            // Длительность слота, мкс
+  volatile uint8_t power_ = 0;                                                  // Заданная мощность
+  uint8_t  latched_ = 0;                                                        // Мощность текущего окна (Window/Burst)
+  uint8_t  slot_ = 0;                                                           // Номер слота в окне
+  uint16_t acc_ = 0;                                                            // Аккумулятор сигма-дельты
+  volatile bool level_ = false;                                                 // Текущий уровень выхода
+  volatile uint32_t on_slots_ = 0;                                              // Счётчик включённых слотов
+  volatile uint32_t total_slots_ = 0;                                           // Счётчик всех слотов
+  volatile uint32_t edges_ = 0;                                                 // Счётчик переключений
+  WriteFn  write_ = nullptr;                                                    // Вывод уровня
+  EdgeFn   edge_ = nullptr;                                                     // Уведомление о фронтах
+  void*    edge_arg_ = nullptr;                                                 // Аргумент уведомления
+  void*    timer_ = nullptr;                                                    // Дескриптор esp_timer (nullptr на хосте)
+};                                                                              // Конец определения класса SsrOutput
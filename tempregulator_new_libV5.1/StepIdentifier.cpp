@@ -0,0 +1,226 @@
+#include "StepIdentifier.h"                                                     // Объявление класса
+//
+#include <math.h>                                                               // log, fabs, fmax
+//
+namespace {                                                                     // Внутренние помощники модуля
+//
+constexpr uint8_t kDelays[StepIdentifier::kDelayCount] = {                      // Сетка запаздываний, окна (до 160 с)
+    0, 1, 2, 3, 4, 5, 6, 8, 10, 13, 16, 20, 25, 32, 40, 50, 64, 80};
+constexpr double kSampleS = StepIdentifier::kSampleMs / 1000.0;                 // Окно, с
+constexpr double kP0A = 1.0;                                                    // Начальная ковариация МНК: a около 1 —
+constexpr double kP0B = 0.1;                                                    // шум до отклика не раскачивает оценки
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void StepIdentifier::start(uint32_t now_ms, Q16 limit, uint8_t power) {         // Запуск
+  for (Candidate& c : cand_) c = Candidate{1.0, 0.0, kP0A, 0.0, kP0B, 0.0};     // Начальная догадка: температура не меняется
+  power_ = power;
+  limit_raw_ = limit.raw();
+  win_t0_ = now_ms;
+  win_sum_ = 0;
+  win_n_ = 0;
+  y0_ = 0.0;
+  y_prev_ = 0.0;
+  samples_ = 0;
+  stable_ = 0;
+  ref_gain_ = 0.0;
+  ref_tau_ = 0.0;
+  baseline_ = false;                                                            // Первое окно — без нагрева
+  converged_ = false;
+  limit_hit_ = false;
+  running_ = true;
+}                                                                               // Завершение start
+//
+void StepIdentifier::stop() {                                                   // Остановка
+  running_ = false;                                                             // Модель, если была, сохраняется
+}                                                                               // Завершение stop
+//
+uint8_t StepIdentifier::tick(uint32_t now_ms, Q16 pv) {                         // Шаг ступеньки
+  if (!running_) return 0;                                                      // Выход выключен
+  if (baseline_ && pv.raw() >= limit_raw_) {                                    // Предел: дальше греть нельзя
+    const Model m = model();
+    running_ = false;
+    limit_hit_ = true;
+    converged_ = m.valid && stable_ >= kStableSamples &&
+                 elapsedMs() / 1000.0 >= m.dead_s + 0.4 * m.tau_s;
+    return 0;
+  }
+  win_sum_ += pv.raw();                                                         // Усреднение окна снижает шум в √n раз
+  ++win_n_;
+  if (now_ms - win_t0_ < kSampleMs) return baseline_ ? power_ : 0;
+  const double mean = static_cast<double>(win_sum_) / win_n_ / 65536.0;
+  win_t0_ = now_ms;
+  win_sum_ = 0;
+  win_n_ = 0;
+  if (!baseline_) {                                                             // Исходная температура, дальше — ступенька
+    y0_ = mean;
+    baseline_ = true;
+    return power_;
+  }
+  update(mean - y0_);
+  const Model m = model();
+  const double tol = kStablePermille / 1000.0;
+  if (m.valid && fabs(m.gain - ref_gain_) <= tol * ref_gain_ && fabs(m.tau_s - ref_tau_) <= tol * ref_tau_) {
+    if (stable_ < 255) ++stable_;
+  } else {                                                                      // Модель сдвинулась — новая точка отсчёта
+    ref_gain_ = m.gain;
+    ref_tau_ = m.tau_s;
+    stable_ = 0;
+  }
+  if (m.valid && stable_ >= kStableSamples && elapsedMs() / 1000.0 >= m.dead_s + 0.7 * m.tau_s) {
+    converged_ = true;
+    running_ = false;
+    return 0;
+  }
+  return power_;
+}                                                                               // Завершение tick
+//
+void StepIdentifier::update(double y) {                                         // Шаг рекурсивного МНК для всех запаздываний
+  ++samples_;
+  const double y1 = y_prev_;
+  for (uint8_t i = 0; i < kDelayCount; ++i) {
+    Candidate& c = cand_[i];
+    const double u = samples_ > kDelays[i] ? power_ : 0.0;                      // u[k−1−d]: ступенька дошла до модели
+    const double e = y - (c.a * y1 + c.b * u);                                  // Ошибка предсказания до обновления
+    const double pf1 = c.p11 * y1 + c.p12 * u;                                  // P·φ
+    const double pf2 = c.p12 * y1 + c.p22 * u;
+    const double den = 1.0 + y1 * pf1 + u * pf2;
+    const double g1 = pf1 / den;                                                // Коэффициент усиления МНК
+    const double g2 = pf2 / den;
+    c.a += g1 * e;
+    c.b += g2 * e;
+    c.p11 -= g1 * pf1;                                                          // P −= g·(P·φ)ᵀ
+    c.p12 -= g1 * pf2;
+    c.p22 -= g2 * pf2;
+    c.sse += e * e;
+  }
+  y_prev_ = y;
+}                                                                               // Завершение update
+//
+uint8_t StepIdentifier::best() const {                                          // Наименьшая ошибка предсказания
+  uint8_t b = 0;
+  for (uint8_t i = 1; i < kDelayCount; ++i) {
+    if (cand_[i].sse < cand_[b].sse) b = i;
+  }
+  return b;
+}                                                                               // Завершение best
+//
+StepIdentifier::Model StepIdentifier::model() const {                           // Модель лучшего запаздывания
+  Model m{0.0, 0.0, 0.0, false};
+  if (samples_ < 2) return m;
+  const uint8_t i = best();
+  const Candidate& c = cand_[i];
+  if (!(c.a > 0.0 && c.a < 1.0 && c.b > 0.0)) return m;                         // Не апериодическое звено — пока не модель
+  double d = kDelays[i];
+  if (i > 0 && i + 1 < kDelayCount) {                                           // Уточнение параболой по соседям
+    const double x1 = kDelays[i - 1], x3 = kDelays[i + 1];
+    const double f1 = cand_[i - 1].sse, f2 = c.sse, f3 = cand_[i + 1].sse;
+    const double den = (d - x1) * (f2 - f3) - (d - x3) * (f2 - f1);
+    if (den != 0.0) {
+      const double v = d - 0.5 * ((d - x1) * (d - x1) * (f2 - f3) - (d - x3) * (d - x3) * (f2 - f1)) / den;
+      if (v > x1 && v < x3) d = v;
+    }
+  }
+  m.tau_s = -kSampleS / log(c.a);
+  m.gain = c.b / (1.0 - c.a);
+  m.dead_s = fmax(0.0, (d - 0.5) * kSampleS);                                   // Окно усреднения запаздывает на половину
+  m.valid = true;
+  return m;
+}                                                                               // Завершение model
+//
+StepIdentifier::Gains StepIdentifier::gains(const Model& m, Tuning t) {         // IMC и лямбда-настройка
+  Gains g{0.0, 0.0, 0.0, false};
+  if (!m.valid || m.gain <= 0.0 || m.tau_s <= 0.0) return g;
+  const double k = m.gain, tau = m.tau_s, theta = m.dead_s;
+  double kc = 0.0, ti = 0.0, td = 0.0;                                          // Kc, Ti, Td
+  switch (t) {
+    case kImcPid:
+    case kImcPidSlow: {                                                         // IMC для K·e^(−θs)/(τs + 1), Паде первого порядка
+      const double lambda = t == kImcPid ? fmax(theta, tau / 10.0) : fmax(2.0 * theta, tau / 3.0);
+      kc = (tau + theta / 2.0) / (k * (lambda + theta / 2.0));
+      ti = tau + theta / 2.0;
+      td = tau * theta / (2.0 * tau + theta);
+      break;
+    }
+    case kLambdaPi:                                                             // Замкнутый контур не быстрее разомкнутого
+      kc = tau / (k * (tau + theta));
+      ti = tau;
+      break;
+    default: return g;
+  }
+  g.kp = kc;                                                                    // В параллельную форму
+  g.ki = kc / ti;
+  g.kd = kc * td;
+  g.valid = true;
+  return g;
+}                                                                               // Завершение gains
+//
+const char* StepIdentifier::tuningName(Tuning t) {                              // Название правила
+  switch (t) {
+    case kImcPid:     return "IMC PID быстрый";
+    case kImcPidSlow: return "IMC PID мягкий";
+    case kLambdaPi:   return "Лямбда PI, λ = τ";
+    default:          return "?";
+  }
+}                                                                               // Завершение tuningName
+//
+#ifdef TR_AUTOTUNE_SIM
+#include <stdio.h>                                                              // printf: и на устройстве, и на хосте
+//
+namespace {                                                                     // Модель печи для отладочной сборки
+//
+struct SimPlant {                                                               // Первый порядок с запаздыванием и шумом термопары
+  static constexpr uint32_t kDtMs = 100;                                        // Шаг регулятора
+  static constexpr uint32_t kMaxDelay = 1200;                                   // Наибольшее запаздывание, шагов
+  double   gain;                                                                // °C на единицу выхода
+  double   tau_s;                                                               // Постоянная времени, с
+  uint32_t delay;                                                               // Запаздывание, шагов
+  double   noise;                                                               // Размах шума, °C
+  double   temp = 25.0;                                                         // Температура печи
+  uint8_t  line[kMaxDelay] = {};                                                // Выход по пути к печи
+  uint32_t n = 0;                                                               // Номер шага
+  uint32_t seed = 12345;                                                        // Генератор шума
+//
+  Q16 step(uint8_t u) {                                                         // Шаг модели: выход → измерение
+    uint8_t late = u;
+    if (delay) {
+      late = line[n % delay];
+      line[n % delay] = u;
+    }
+    ++n;
+    temp += (gain * late - (temp - 25.0)) / tau_s * (kDtMs / 1000.0);
+    seed = seed * 1664525u + 1013904223u;
+    return Q16::fromDouble(temp + noise * ((seed >> 16) % 1001 / 1000.0 - 0.5));
+  }
+};                                                                              // Конец структуры SimPlant
+//
+void simulate(double gain, double tau_s, double dead_s, double noise, double limit_c) {  // Одна ступенька на одной печи
+  SimPlant p{gain, tau_s, static_cast<uint32_t>(dead_s * 1000 / SimPlant::kDtMs), noise};
+  StepIdentifier id;
+  id.start(0, Q16::fromDouble(limit_c), 128);
+  Q16 pv = p.step(0);
+  uint32_t now = 0;
+  for (; now < 4UL * 3600 * 1000 && id.running(); now += SimPlant::kDtMs) pv = p.step(id.tick(now, pv));
+  const StepIdentifier::Model m = id.model();
+  printf("[ID] K %.2f tau %.0f s theta %.0f s noise %.1f limit %.0f C: %s after %lu s%s, K %.3f tau %.1f s theta %.1f s\n",
+         gain, tau_s, dead_s, noise, limit_c, id.converged() ? "converged" : "FAILED",
+         static_cast<unsigned long>(now / 1000), id.limitReached() ? " (limit)" : "", m.gain, m.tau_s, m.dead_s);
+  for (uint8_t t = 0; t < StepIdentifier::kTuningCount; ++t) {                  // Коэффициенты по всем правилам
+    const auto tuning = static_cast<StepIdentifier::Tuning>(t);
+    const StepIdentifier::Gains g = StepIdentifier::gains(m, tuning);
+    printf("[ID]   %s: Kp %.3f Ki %.5f Kd %.2f%s\n", StepIdentifier::tuningName(tuning), g.kp, g.ki, g.kd,
+           g.valid ? "" : " (n/a)");
+  }
+}                                                                               // Завершение simulate
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+void runStepIdentSimulation() {                                                 // Ступенька 50 % на печах разной инерции
+  simulate(2.0, 600.0, 30.0, 0.0, 400.0);                                       // Чистое измерение
+  simulate(2.0, 600.0, 30.0, 0.5, 400.0);                                       // Шум термопары ±0.25 °C
+  simulate(2.0, 600.0, 30.0, 2.0, 400.0);                                       // Сильный шум ±1 °C
+  simulate(2.0, 600.0, 30.0, 0.5, 140.0);                                       // Предел раньше установления
+  simulate(2.0, 600.0, 30.0, 0.5, 80.0);                                        // Предел слишком близко
+  simulate(3.0, 1800.0, 90.0, 0.5, 600.0);                                      // Большая печь
+}                                                                               // Завершение runStepIdentSimulation
+#endif                                                                          // TR_AUTOTUNE_SIM
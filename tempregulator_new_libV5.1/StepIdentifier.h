@@ -0,0 +1,94 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Измерение в Q16, как у PID
+#include "RelayAutotune.h"                                                      // Общая структура коэффициентов Gains
+//
+// Идентификация печи по переходной характеристике: на выход подаётся
+// постоянная мощность, по отклику подбирается модель первого порядка с
+// запаздыванием K·e^(−θs)/(τs + 1), из неё по IMC/лямбда-правилам считаются
+// коэффициенты PID.
+//
+// Первое окно kSampleMs нагреватель выключен — это исходная температура.
+// Дальше измерения усредняются по окнам kSampleMs, и каждое окно обновляет
+// рекурсивным МНК банк дискретных моделей y[k] = a·y[k−1] + b·u[k−1−d], по
+// одной на каждое запаздывание d из сетки. Массив отсчётов не хранится: у
+// каждой модели только два параметра, матрица 2×2 и сумма квадратов ошибок
+// предсказания. Запаздывание — у модели с наименьшей ошибкой
+// (уточняется параболой по соседям), τ = −Ts/ln a, K = b/(1 − a).
+//
+// Идентификация заканчивается, когда K и τ лучшей модели не меняются
+// kStableSamples окон подряд и с начала ступеньки прошло θ + 0.7τ. Если
+// температура дошла до предела раньше, нагрев снимается, и модель принимается
+// при прошедших θ + 0.4τ.
+//
+// tick() вызывается в задаче регулятора; на границе окна — 18 обновлений
+// МНК в double (раз в 2 с). model() и gains() читаются из задачи UI.
+class StepIdentifier {                                                          // Идентификация по ступеньке мощности
+public:                                                                         // Публичный интерфейс
+  enum Tuning : uint8_t {                                                       // Правила расчёта PID по модели
+    kImcPid = 0,                                                                // IMC PID, λ = θ (не меньше τ/10)
+    kImcPidSlow,                                                                // IMC PID, λ = 2θ (не меньше τ/3)
+    kLambdaPi,                                                                  // Лямбда-настройка PI, λ = τ
+    kTuningCount                                                                // Число правил
+  };                                                                            // Конец перечисления Tuning
+//
+  struct Model {                                                                // Модель первого порядка с запаздыванием
+    double gain;                                                                // Усиление, °C на единицу выхода (0..255)
+    double tau_s;                                                               // Постоянная времени, с
+    double dead_s;                                                              // Запаздывание, с
+    bool   valid;                                                               // Модель физически осмысленна
+  };                                                                            // Конец структуры Model
+//
+  using Gains = RelayAutotune::Gains;                                           // Тот же результат, что у релейной настройки
+//
+  static constexpr uint32_t kSampleMs = 2000;                                   // Окно усреднения и шаг МНК
+  static constexpr uint8_t  kDelayCount = 18;                                   // Запаздываний в сетке
+  static constexpr uint8_t  kStableSamples = 15;                                // Окон без изменения модели для остановки
+  static constexpr uint16_t kStablePermille = 20;                               // Допуск «без изменения», ‰
+//
+  void start(uint32_t now_ms, Q16 limit, uint8_t power);                        // Запуск: limit — предел температуры, power — ступенька
+  void stop();                                                                  // Остановка без результата
+  uint8_t tick(uint32_t now_ms, Q16 pv);                                        // Шаг: мощность на выход
+//
+  bool     running() const { return running_; }                                 // Ступенька идёт
+  bool     converged() const { return converged_; }                             // Модель установилась
+  bool     limitReached() const { return limit_hit_; }                          // Остановлено по пределу температуры
+  uint32_t elapsedMs() const { return samples_ * kSampleMs; }                   // С начала ступеньки
+  Model    model() const;                                                       // Текущая лучшая модель
+//
+  static Gains gains(const Model& m, Tuning t);                                 // Коэффициенты по модели
+  static const char* tuningName(Tuning t);                                      // Название правила для экрана
+//
+private:                                                                        // Внутреннее состояние
+  struct Candidate {                                                            // Модель с одним запаздыванием
+    double a, b;                                                                // Параметры
+    double p11, p12, p22;                                                       // Ковариация МНК (симметричная)
+    double sse;                                                                 // Сумма квадратов ошибок предсказания
+  };                                                                            // Конец структуры Candidate
+//
+  void update(double y);                                                        // Шаг МНК по окну
+  uint8_t best() const;                                                         // Модель с наименьшей ошибкой
+//
+  Candidate cand_[kDelayCount] = {};                                            // Банк моделей
+  bool     running_ = false;                                                    // Ступенька идёт
+  bool     converged_ = false;                                                  // Результат готов
+  bool     limit_hit_ = false;                                                  // Достигнут предел температуры
+  bool     baseline_ = false;                                                   // Исходная температура измерена
+  uint8_t  power_ = 0;                                                          // Мощность ступеньки
+  int32_t  limit_raw_ = 0;                                                      // Предел температуры, Q16
+  uint32_t win_t0_ = 0;                                                         // Начало текущего окна
+  int64_t  win_sum_ = 0;                                                        // Сумма измерений окна, Q16
+  uint16_t win_n_ = 0;                                                          // Измерений в окне
+  double   y0_ = 0.0;                                                           // Исходная температура, °C
+  double   y_prev_ = 0.0;                                                       // Предыдущее окно, °C от исходной
+  uint32_t samples_ = 0;                                                        // Окон с начала ступеньки
+  uint8_t  stable_ = 0;                                                         // Окон подряд без изменения модели
+  double   ref_gain_ = 0.0;                                                     // Модель, с которой сравниваются окна
+  double   ref_tau_ = 0.0;
+};                                                                              // Конец определения класса StepIdentifier
+//
+#ifdef TR_AUTOTUNE_SIM                                                          // Отладочная сборка: моделирование на печи первого порядка
+void runStepIdentSimulation();                                                  // Точность модели и время ступеньки
+#endif                                                                          // TR_AUTOTUNE_SIM
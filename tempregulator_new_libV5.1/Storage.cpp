@@ -4,6 +4,7 @@
 #include <LittleFS.h>                                                              // Файловая система LittleFS на ESP32
 #include <stdlib.h>                                                                // Функции strtol/strtoul/strtod
 #include <string.h>                                                                // Функция strlen
+#include "EventTrace.h"                                                            // Участок записи конфигурации в трассу
 //
 namespace {                                                                        // Локальные константы и функции, не видимые за пределами файла
 constexpr const char* kConfigPath = "/config.ini";                               // Путь к файлу конфигурации в LittleFS
@@ -44,6 +45,15 @@ bool parseUInt16(const String& line, const char* key, uint16_t& out) {
   return true;                                                                    // Сообщаем об успешном парсинге
 }                                                                                 // Завершение parseUInt16
 //
+bool parseUInt8(const String& line, const char* key, uint8_t& out) {              // Парсинг 8-битного беззнакового целого
+  uint16_t v = 0;                                                                 // Промежуточное 16-битное значение
+  if (!parseUInt16(line, key, v)) {                                               // Используем общий парсер
+    return false;                                                                 // Ключ не совпал
+  }                                                                               // Конец проверки
+  out = static_cast<uint8_t>(v > 0xFF ? 0xFF : v);                                // Ограничиваем диапазоном uint8_t
+  return true;                                                                    // Успешный парсинг
+}                                                                                 // Завершение parseUInt8
+//
 bool parseFloat(const String& line, const char* key, float& out) {                 // Парсинг числа с плавающей точкой одинарной точности
   String value = readValue(line, key);                                            // Извлекаем значение по ключу
   if (value.length() == 0) {                                                      // Если ключ не найден
@@ -64,6 +74,25 @@ bool parseDouble(const String& line, const char* key, double& out) {
   return true;                                                                    // Успешное завершение
 }                                                                                 // Завершение parseDouble
 //
+bool parseGainPoint(const String& line, GainSchedule::Point* points) {            // Ключи точек таблицы PID: gs<N>_t/kp/ki/kd, N с 1
+  if (!line.startsWith("gs")) {                                                   // Быстрый отказ для остальных ключей
+    return false;                                                                 // Не точка таблицы
+  }                                                                               // Конец проверки префикса
+  char key[12];                                                                   // Буфер ключа
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) {                        // Перебираем точки
+    GainSchedule::Point& p = points[i];
+    snprintf(key, sizeof(key), "gs%u_t=", i + 1u);
+    if (parseFloat(line, key, p.temp_c)) return true;
+    snprintf(key, sizeof(key), "gs%u_kp=", i + 1u);
+    if (parseFloat(line, key, p.kp)) return true;
+    snprintf(key, sizeof(key), "gs%u_ki=", i + 1u);
+    if (parseFloat(line, key, p.ki)) return true;
+    snprintf(key, sizeof(key), "gs%u_kd=", i + 1u);
+    if (parseFloat(line, key, p.kd)) return true;
+  }                                                                               // Конец перебора
+  return false;                                                                   // Ключ не распознан
+}                                                                                 // Завершение parseGainPoint
+//
 }  // namespace                                                                    // Завершение анонимного пространства имён
 //
 namespace Storage {                                                               // Основное пространство имён модуля хранения
@@ -89,12 +118,36 @@ bool load(PersistentConfig& out) {
   tmp.pid_kp            = 2.0;                                                    // Начальные коэффициенты PID
   tmp.pid_ki            = 5.0;
   tmp.pid_kd            = 1.0;
+  tmp.tc_type           = 1;                                                      // Термопара типа K
+  tmp.emf_offset        = 0.0f;                                                   // Калибровки по ЭДС ещё нет
+  tmp.emf_slope         = 0.0f;
+  tmp.cjc_fixed         = 25.0f;                                                  // Холодный спай при комнатной температуре
+  tmp.tc_source         = 0;                                                      // Встроенный АЦП
+  tmp.wall_offset       = 0.0f;                                                   // Дополнительные каналы без калибровки
+  tmp.wall_slope        = 1.0f;
+  tmp.safety_offset     = 0.0f;
+  tmp.safety_slope      = 1.0f;
   tmp.touch_calibrated  = false;                                                  // Тач по умолчанию не калиброван
   tmp.touch_swap        = false;                                                  // Оси не меняем
   tmp.touch_tx_min      = 300;                                                    // Базовые границы тача по X
   tmp.touch_tx_max      = 3900;
   tmp.touch_ty_min      = 200;                                                    // Базовые границы тача по Y
   tmp.touch_ty_max      = 3900;
+  tmp.adc_mode          = 0;                                                      // По умолчанию — медианный фильтр
+  tmp.mains_hz          = 50;                                                     // Сеть 50 Гц
+  tmp.adc_ssr_sync      = false;                                                  // Без синхронизации с SSR
+  tmp.control_period_ms = 100;                                                    // Шаг регулятора 100 мс
+  tmp.ssr_mode          = 0;                                                      // Пропорционально времени, окно 1 с
+  tmp.ssr_feedback      = 0;                                                      // Обратная связь SSR не подключена
+  tmp.heater_w          = 0;                                                      // Мощность нагревателя не задана
+  tmp.pid_adapt         = false;                                                  // Коэффициенты в работе не меняются
+  tmp.shaper            = false;                                                  // Уставка выдержки без упреждения
+  tmp.shaper_k          = 0.0f;                                                   // Модель печи — только из профиля
+  tmp.shaper_tau        = 0.0f;
+  tmp.shaper_dead       = 0.0f;
+  for (GainSchedule::Point& p : tmp.pid_sched) {                                  // Таблица PID по температуре пуста
+    p = GainSchedule::Point{0.0f, 0.0f, 0.0f, 0.0f};
+  }                                                                               // Конец заполнения таблицы
 //
   while (f.available()) {                                                         // Читаем файл построчно до конца
     String line = f.readStringUntil('\n');                                       // Получаем строку до символа новой строки
@@ -118,6 +171,24 @@ bool load(PersistentConfig& out) {
       continue;
     } else if (parseDouble(line, "kd=", tmp.pid_kd)) {
       continue;
+    } else if (parseUInt8(line, "tc_type=", tmp.tc_type)) {
+      continue;
+    } else if (parseFloat(line, "emf_offset=", tmp.emf_offset)) {
+      continue;
+    } else if (parseFloat(line, "emf_slope=", tmp.emf_slope)) {
+      continue;
+    } else if (parseFloat(line, "cjc_fixed=", tmp.cjc_fixed)) {
+      continue;
+    } else if (parseUInt8(line, "tc_source=", tmp.tc_source)) {
+      continue;
+    } else if (parseFloat(line, "wall_offset=", tmp.wall_offset)) {
+      continue;
+    } else if (parseFloat(line, "wall_slope=", tmp.wall_slope)) {
+      continue;
+    } else if (parseFloat(line, "safety_offset=", tmp.safety_offset)) {
+      continue;
+    } else if (parseFloat(line, "safety_slope=", tmp.safety_slope)) {
+      continue;
     } else if (parseBool(line, "touch_calibrated=", tmp.touch_calibrated)) {
       continue;
     } else if (parseBool(line, "touch_swap=", tmp.touch_swap)) {
@@ -130,6 +201,32 @@ bool load(PersistentConfig& out) {
       continue;
     } else if (parseUInt16(line, "touch_ty_max=", tmp.touch_ty_max)) {
       continue;
+    } else if (parseUInt8(line, "adc_mode=", tmp.adc_mode)) {
+      continue;
+    } else if (parseUInt8(line, "mains_hz=", tmp.mains_hz)) {
+      continue;
+    } else if (parseBool(line, "adc_ssr_sync=", tmp.adc_ssr_sync)) {
+      continue;
+    } else if (parseUInt16(line, "control_period_ms=", tmp.control_period_ms)) {
+      continue;
+    } else if (parseUInt8(line, "ssr_mode=", tmp.ssr_mode)) {
+      continue;
+    } else if (parseUInt8(line, "ssr_feedback=", tmp.ssr_feedback)) {
+      continue;
+    } else if (parseUInt16(line, "heater_w=", tmp.heater_w)) {
+      continue;
+    } else if (parseBool(line, "pid_adapt=", tmp.pid_adapt)) {
+      continue;
+    } else if (parseBool(line, "shaper=", tmp.shaper)) {
+      continue;
+    } else if (parseFloat(line, "shaper_k=", tmp.shaper_k)) {
+      continue;
+    } else if (parseFloat(line, "shaper_tau=", tmp.shaper_tau)) {
+      continue;
+    } else if (parseFloat(line, "shaper_dead=", tmp.shaper_dead)) {
+      continue;
+    } else if (parseGainPoint(line, tmp.pid_sched)) {
+      continue;
     }
   }                                                                               // Конец чтения файла
 //
@@ -143,6 +240,7 @@ bool load(PersistentConfig& out) {
 }                                                                                 // Завершение функции load
 //
 bool save(const PersistentConfig& data) {                                         // Сохраняем структуру конфигурации в файл
+  TR_TRACE_SCOPE(kStorageSave, 0);                                                // Запись во флеш — участок трассы
   LittleFS.remove(kConfigPath);                                                   // Удаляем предыдущий файл, если он был
   File f = LittleFS.open(kConfigPath, FILE_WRITE);                                // Создаём новый файл для записи
   if (!f) {                                                                       // Если открыть на запись не удалось
@@ -157,12 +255,40 @@ bool save(const PersistentConfig& data) {
   f.printf("kp=%.6f\n", data.pid_kp);                                           // Коэффициент P
   f.printf("ki=%.6f\n", data.pid_ki);                                           // Коэффициент I
   f.printf("kd=%.6f\n", data.pid_kd);                                           // Коэффициент D
+  f.printf("tc_type=%u\n", static_cast<unsigned>(data.tc_type));               // Тип термопары
+  f.printf("emf_offset=%.3f\n", static_cast<double>(data.emf_offset));         // Смещение АЦП -> ЭДС, мкВ
+  f.printf("emf_slope=%.6f\n", static_cast<double>(data.emf_slope));           // Наклон АЦП -> ЭДС, мкВ/ед.
+  f.printf("cjc_fixed=%.2f\n", static_cast<double>(data.cjc_fixed));           // Холодный спай без датчика, °C
+  f.printf("tc_source=%u\n", static_cast<unsigned>(data.tc_source));           // Источник термопары
+  f.printf("wall_offset=%.5f\n", static_cast<double>(data.wall_offset));       // Канал стенки: смещение
+  f.printf("wall_slope=%.5f\n", static_cast<double>(data.wall_slope));         // Канал стенки: наклон
+  f.printf("safety_offset=%.5f\n", static_cast<double>(data.safety_offset));   // Защитный канал: смещение
+  f.printf("safety_slope=%.5f\n", static_cast<double>(data.safety_slope));     // Защитный канал: наклон
   f.printf("touch_calibrated=%d\n", data.touch_calibrated ? 1 : 0);             // Флаг калибровки тача
   f.printf("touch_swap=%d\n", data.touch_swap ? 1 : 0);                         // Флаг перестановки осей тача
   f.printf("touch_tx_min=%u\n", static_cast<unsigned>(data.touch_tx_min));     // Минимальное значение X
   f.printf("touch_tx_max=%u\n", static_cast<unsigned>(data.touch_tx_max));     // Максимальное значение X
   f.printf("touch_ty_min=%u\n", static_cast<unsigned>(data.touch_ty_min));     // Минимальное значение Y
   f.printf("touch_ty_max=%u\n", static_cast<unsigned>(data.touch_ty_max));     // Максимальное значение Y
+  f.printf("adc_mode=%u\n", static_cast<unsigned>(data.adc_mode));             // Режим выборки АЦП
+  f.printf("mains_hz=%u\n", static_cast<unsigned>(data.mains_hz));             // Частота сети
+  f.printf("adc_ssr_sync=%d\n", data.adc_ssr_sync ? 1 : 0);                     // Синхронизация окна АЦП с SSR
+  f.printf("control_period_ms=%u\n", static_cast<unsigned>(data.control_period_ms));  // Период шага регулятора
+  f.printf("ssr_mode=%u\n", static_cast<unsigned>(data.ssr_mode));             // Модуляция SSR
+  f.printf("ssr_feedback=%u\n", static_cast<unsigned>(data.ssr_feedback));     // Вход обратной связи SSR
+  f.printf("heater_w=%u\n", static_cast<unsigned>(data.heater_w));             // Мощность нагревателя
+  f.printf("pid_adapt=%d\n", data.pid_adapt ? 1 : 0);                          // Адаптивная подстройка PID
+  f.printf("shaper=%d\n", data.shaper ? 1 : 0);                                // Упреждение перед выдержкой
+  f.printf("shaper_k=%.3f\n", static_cast<double>(data.shaper_k));             // Модель печи вручную: K
+  f.printf("shaper_tau=%.1f\n", static_cast<double>(data.shaper_tau));         // Модель печи вручную: τ
+  f.printf("shaper_dead=%.1f\n", static_cast<double>(data.shaper_dead));       // Модель печи вручную: θ
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) {                        // Таблица PID по температуре
+    const GainSchedule::Point& p = data.pid_sched[i];
+    f.printf("gs%u_t=%.1f\n", i + 1u, static_cast<double>(p.temp_c));           // Температура точки
+    f.printf("gs%u_kp=%.3f\n", i + 1u, static_cast<double>(p.kp));              // Коэффициенты точки
+    f.printf("gs%u_ki=%.3f\n", i + 1u, static_cast<double>(p.ki));
+    f.printf("gs%u_kd=%.3f\n", i + 1u, static_cast<double>(p.kd));
+  }                                                                               // Конец таблицы
   f.close();                                                                      // Закрываем файл после записи
   return true;                                                                    // Возвращаем успех
 }                                                                                 // Завершение функции save
@@ -2,6 +2,8 @@
 //
 #include <stdint.h>                                        // Определения целочисленных типов фиксированной ширины
 //
+#include "GainSchedule.h"                                  // Точка таблицы коэффициентов PID по температуре
+//
 struct PersistentConfig {                                  // Структура, описывающая сохраняемую конфигурацию устройства
   bool     calibrated;                                     // Флаг калибровки термопары
   float    offset;                                         // Смещение для корректировки измерений
@@ -9,12 +11,34 @@ struct PersistentConfig {                                  // Структура
   double   pid_kp;                                         // PID: пропорциональная часть
   double   pid_ki;                                         // PID: интегральная часть
   double   pid_kd;                                         // PID: дифференциальная часть
+  uint8_t  tc_type;                                        // Тип термопары: 0 — линейно, 1 — K, 2 — J
+  float    emf_offset;                                     // АЦП -> ЭДС: смещение, мкВ
+  float    emf_slope;                                      // АЦП -> ЭДС: мкВ на единицу АЦП (0 — не откалибровано)
+  float    cjc_fixed;                                      // Температура холодного спая без датчика, °C
+  uint8_t  tc_source;                                      // Источник термопары: 0 — АЦП, 1 — MAX31855, 2 — MAX31856
+  float    wall_offset;                                    // Канал стенки камеры: смещение, °C
+  float    wall_slope;                                     // Канал стенки камеры: °C на единицу АЦП
+  float    safety_offset;                                  // Защитный канал: смещение, °C
+  float    safety_slope;                                   // Защитный канал: °C на единицу АЦП
   bool     touch_calibrated;                               // Флаг калибровки тачскрина
   bool     touch_swap;                                     // Флаг перестановки осей тача
   uint16_t touch_tx_min;                                   // Минимальное значение X тача
   uint16_t touch_tx_max;                                   // Максимальное значение X тача
   uint16_t touch_ty_min;                                   // Минимальное значение Y тача
   uint16_t touch_ty_max;                                   // Максимальное значение Y тача
+  uint8_t  adc_mode;                                       // Режим выборки АЦП (0 — медиана, 1 — интегрирование по периоду сети)
+  uint8_t  mains_hz;                                       // Частота сети для режима интегрирования, Гц (50/60)
+  bool     adc_ssr_sync;                                   // Отбрасывать окно АЦП, в которое попал фронт SSR
+  uint16_t control_period_ms;                              // Период шага регулятора, мс
+  uint8_t  ssr_mode;                                       // Модуляция SSR: 0 — окно, 1 — пакеты полупериодов, 2 — сигма-дельта
+  uint8_t  ssr_feedback;                                   // Вход обратной связи SSR: 0 — нет, 1 — активный низкий, 2 — активный высокий
+  uint16_t heater_w;                                       // Номинальная мощность нагревателя, Вт (0 — не задана)
+  bool     pid_adapt;                                      // Адаптивная подстройка PID в рабочем режиме
+  bool     shaper;                                         // Упреждающее снятие мощности перед выдержкой
+  float    shaper_k;                                       // Модель печи вручную: усиление, °C на единицу выхода (0 — из профиля)
+  float    shaper_tau;                                     // Модель печи вручную: постоянная времени, с
+  float    shaper_dead;                                    // Модель печи вручную: запаздывание, с
+  GainSchedule::Point pid_sched[GainSchedule::kMaxPoints]; // Коэффициенты PID по температуре (temp_c ≤ 0 — точка не используется)
 };                                                         // Завершение описания структуры
 //
 namespace Storage {                                        // Пространство имён с функциями работы с хранилищем
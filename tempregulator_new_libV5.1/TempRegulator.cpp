@@ -10,10 +10,13 @@
 #include "DisplayDriver.h"
 #include "EncoderInput.h"
 #include "TouchCalibration.h"
+#include "SpiBusArbiter.h"
 #include "HardwareConfig.h"
 #include "Storage.h"
 #include "LogoImageBuiltin.h"
 #include "WebInterface.h"                                                // Modified: обновляем WebSocket при изменениях
+#include "PhaseTimer.h"                                                  // Замер фаз цикла UI и шага регулятора
+#include "EventTrace.h"                                                  // Шаг регулятора на шкале трассы
 
 #include <LittleFS.h>
 #include "esp_timer.h"
@@ -202,20 +205,9 @@ static void encoder_modal_release() {
 static void lv_tick_task(void* arg){ lv_tick_inc(5); }
 
 /* ========= Consts ========= */
-static constexpr uint8_t  ADC_READ_SAMPLES        = 21;
-static constexpr uint16_t ADC_OUTLIER_THRESHOLD   = 50;
-static constexpr uint8_t  ADC_OUTLIER_ALARM_COUNT = 5;
-static constexpr uint32_t SSR_WINDOW_MS           = 1000;
-
-static constexpr uint16_t CAL_MAX_OUTLIERS   = 5;
-static constexpr uint16_t CAL_MIN_ADC_DIFF   = 120;
-static constexpr uint16_t CAL_STABLE_DELTA   = 8;
-static constexpr uint32_t CAL_STABLE_HOLD_MS = 2000;
-static constexpr uint32_t CAL_STEP_TIMEOUT_MS= 60000;
-
-static constexpr float    AT_MIN_TARGET_C = 40.0f;
-static constexpr float    AT_MAX_TARGET_C = 500.0f;
-static constexpr uint32_t AT_TIMEOUT_MS   = 10*60*1000;
+static constexpr uint32_t ADC_SAMPLE_PERIOD_US    = 2000;
+static_assert(SampleRateScheduler::kPeriodUs[SampleRateScheduler::kNominalLevel] == ADC_SAMPLE_PERIOD_US,
+              "nominal adaptive ADC rate must match the fixed sampling period");
 
 /* Header UI */
 static constexpr int HEADER_H = 28;
@@ -243,7 +235,8 @@ lv_obj_t* TempRegulator::msgbox(const char* text, const char* btn1) {
 
 void TempRegulator::clearAlarm() {
   alarm_active = false;
-  consecutive_outlier_cycles = 0;
+  safety.clearFaults();
+  WebInterface::instance().setRegulatorAlarm(false, String());
 }
 
 /* forward decl. */
@@ -284,6 +277,10 @@ static void _pid_ki_plus_cb(lv_event_t* ev);
 static void _pid_ki_minus_cb(lv_event_t* ev);
 static void _pid_kd_plus_cb(lv_event_t* ev);
 static void _pid_kd_minus_cb(lv_event_t* ev);
+static void _pid_set_next_cb(lv_event_t* ev);
+static void _pid_set_prev_cb(lv_event_t* ev);
+static void _pid_t_plus_cb(lv_event_t* ev);
+static void _pid_t_minus_cb(lv_event_t* ev);
 
 static void _tc_back_cb(lv_event_t* ev);
 static void _tc_reset_open_cb(lv_event_t* ev);
@@ -323,9 +320,17 @@ static void _work_back_cb(lv_event_t* ev);
 
 /* Автонастройка — без лямбд */
 static void _at_setup_next_cb(lv_event_t* ev);
+static void _at_method_cb(lv_event_t* ev);
 static void _at_confirm_no_cb(lv_event_t* ev);
 static void _at_confirm_yes_cb(lv_event_t* ev);
 static void _at_abort_cb(lv_event_t* ev);
+static void _at_rule_prev_cb(lv_event_t* ev);
+static void _at_rule_next_cb(lv_event_t* ev);
+static void _at_result_save_cb(lv_event_t* ev);
+static void _at_result_cancel_cb(lv_event_t* ev);
+
+/* Подстройка PID в работе */
+static void _adapt_save_cb(lv_event_t* ev);
 
 /* Ручной режим — колбэки */
 static void _manual_plus_cb(lv_event_t* ev);
@@ -357,7 +362,9 @@ float TempRegulator::getTargetC() const { return targetC; }
 void  TempRegulator::setTargetC(float c) {
   if (c < 40.0f)  c = 40.0f;
   if (c > 500.0f) c = 500.0f;
+  ControlScheduler::Lock lock;
   targetC = c;
+  targetQ = Q16::fromDouble(targetC);
   pid.setSetpoint(targetC);
 }
 void  TempRegulator::adjustTargetC(float delta) { setTargetC(targetC + delta); }
@@ -368,10 +375,6 @@ void TempRegulator::beep(uint16_t ms) {
   digitalWrite(BUZZER_PIN, HIGH);  // Возвращаемся в неактивное состояние
 }
 
-bool TempRegulator::isCalibTimedOut() const {
-  return (millis() - cal_t0) > CAL_STEP_TIMEOUT_MS;
-}
-
 /* Header maker */
 static lv_obj_t* make_header(lv_obj_t* parent, const char* t) {
   lv_obj_set_style_pad_all(parent, 0, 0);
@@ -447,13 +450,56 @@ static void _async_do_reset_pid(void* u)  { ((TempRegulator*)u)->do_reset_pid();
 static void _async_open_profiles(void* u){((TempRegulator*)u)->createProfiles();}
 /* ===== Инфо (глаз) ===== */
 void TempRegulator::openInfoDialog() {
-  char buf[192];
+  char health[160];
+  const uint8_t hf = tcHealth.flags();
+  if (!tcHealth.hasData()) {
+    snprintf(health, sizeof(health), "Датчик: нет данных%s", (hf & SensorHealth::kOpen) ? " (обрыв)" : "");
+  } else {
+    snprintf(health, sizeof(health),
+             "Датчик: %s\n  шум = %.2f (база %.2f)\n  выбросы = %.1f %%\n  дрейф = %+.2f\n  скачков = %u",
+             (hf & SensorHealth::kOpen) ? "обрыв" : (hf ? "внимание" : "норма"),
+             (double)tcHealth.noiseC(), (double)tcHealth.baselineNoiseC(),
+             (double)tcHealth.outlierPct(), (double)tcHealth.driftC(), (unsigned)tcHealth.stepCount());
+  }
+  char timing[192];
+  const ControlScheduler::Stats cs = control.stats();
+  snprintf(timing, sizeof(timing),
+           "Регулятор: шаг %lu мс\n  джиттер макс = %lu мкс\n  расчёт макс = %lu мкс\n  перегрузок = %lu\n"
+           "  джиттер: %lu/%lu/%lu/%lu/%lu/%lu/%lu/%lu",
+           (unsigned long)cs.period_ms, (unsigned long)cs.max_jitter_us, (unsigned long)cs.max_exec_us,
+           (unsigned long)cs.overruns,
+           (unsigned long)cs.jitter[0], (unsigned long)cs.jitter[1], (unsigned long)cs.jitter[2],
+           (unsigned long)cs.jitter[3], (unsigned long)cs.jitter[4], (unsigned long)cs.jitter[5],
+           (unsigned long)cs.jitter[6], (unsigned long)cs.jitter[7]);
+  char heater[160];
+  const uint32_t on_s = getHeaterOnSeconds();
+  int hn = snprintf(heater, sizeof(heater), "Нагреватель: %lu ч %02lu мин полной мощности",
+                    (unsigned long)(on_s / 3600), (unsigned long)(on_s / 60 % 60));
+  if (heater_w) hn += snprintf(heater + hn, sizeof(heater) - hn, ", %.2f кВт·ч", (double)getHeaterEnergyWh() / 1000.0);
+  if (ssrFeedback.enabled() && hn < (int)sizeof(heater)) {
+    const uint8_t sf = ssrFeedback.flags();
+    snprintf(heater + hn, sizeof(heater) - hn, "\n  SSR: %s, скважность %.1f %%",
+             (sf & SsrFeedback::kStuckOn) ? "залип" : (sf & SsrFeedback::kNoCurrent) ? "нет тока" :
+             (sf & SsrFeedback::kWeak) ? "слабый ток" : "норма",
+             ssrFeedback.deliveredPermille() / 10.0);
+  }
+  char phases[448] = "";
+#if TR_PHASE_TIMING
+  int pn = snprintf(phases, sizeof(phases), "\n\nФазы, мкс (ср/p99/макс):");
+  for (uint8_t i = 0; i < PhaseTimer::kCount && pn < (int)sizeof(phases); ++i) {
+    const auto ph = static_cast<PhaseTimer::Phase>(i);
+    const PhaseTimer::Summary sm = PhaseTimer::summary(ph);
+    pn += snprintf(phases + pn, sizeof(phases) - pn, "\n  %s %.0f/%.0f/%.0f", PhaseTimer::name(ph),
+                   (double)sm.avg_us, (double)sm.p99_us, (double)sm.max_us);
+  }
+#endif
+  char buf[1280];
   snprintf(buf, sizeof(buf),
-           "PID:\n  Kp = %.1f\n  Ki = %.1f\n  Kd = %.1f\n\n"
-           "Термопара:\n  kl = %.1f\n  kc = %.1f\n \n Калибровка: %s",
-           pid_kp, pid_ki, pid_kd,
+           "PID:\n  Kp = %.1f\n  Ki = %.1f\n  Kd = %.1f\n  Точек по температуре: %u\n\n"
+           "Термопара:\n  kl = %.1f\n  kc = %.1f\n \n Калибровка: %s\n\n%s\n\n%s\n\n%s%s",
+           pid_kp, pid_ki, pid_kd, static_cast<unsigned>(gainSchedule.count()),
            (double)slope, (double)offset,
-           isCalibrated ? "OK" : "нет");
+           isCalibrated ? "OK" : "нет", health, timing, heater, phases);
 
   lv_obj_t* m = lv_msgbox_create(NULL);
   lv_msgbox_add_text(m, buf);
@@ -928,6 +974,26 @@ static void _pid_kd_minus_cb(lv_event_t* ev){
   if (!s) return;
   s->adjustPidCoeffByIndex(2, -0.1);
 }
+static void _pid_set_next_cb(lv_event_t* ev){
+  auto s = (TempRegulator*)lv_event_get_user_data(ev);
+  if (!s) return;
+  s->selectPidEditPoint(1);
+}
+static void _pid_set_prev_cb(lv_event_t* ev){
+  auto s = (TempRegulator*)lv_event_get_user_data(ev);
+  if (!s) return;
+  s->selectPidEditPoint(-1);
+}
+static void _pid_t_plus_cb(lv_event_t* ev){
+  auto s = (TempRegulator*)lv_event_get_user_data(ev);
+  if (!s) return;
+  s->adjustPidCoeffByIndex(3, 10.0);
+}
+static void _pid_t_minus_cb(lv_event_t* ev){
+  auto s = (TempRegulator*)lv_event_get_user_data(ev);
+  if (!s) return;
+  s->adjustPidCoeffByIndex(3, -10.0);
+}
 
 void TempRegulator::createPidCoeffsMenu() {
   lv_obj_t* scr = lv_obj_create(NULL);
@@ -940,12 +1006,14 @@ void TempRegulator::createPidCoeffsMenu() {
   lv_obj_set_style_bg_opa(cont, LV_OPA_TRANSP, 0);
   lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
   lv_obj_set_style_pad_all(cont, 0, 0);
-  lv_obj_set_style_pad_gap(cont, 12, 0);
+  lv_obj_set_style_pad_gap(cont, 8, 0);
 
   lbl_pid_kp_val = lbl_pid_ki_val = lbl_pid_kd_val = nullptr;
+  lbl_pid_set_val = lbl_pid_t_val = nullptr;
+  pid_edit_point = -1;
 
   std::vector<lv_obj_t*> focus_items;
-  focus_items.reserve(10);
+  focus_items.reserve(14);
 
   auto make_row = [&](const char* name,
                       lv_event_cb_t plus_cb,
@@ -987,6 +1055,8 @@ void TempRegulator::createPidCoeffsMenu() {
     }
   };
 
+  make_row("Набор", _pid_set_next_cb, _pid_set_prev_cb, &lbl_pid_set_val);
+  make_row("T, °C", _pid_t_plus_cb, _pid_t_minus_cb, &lbl_pid_t_val);
   make_row("Kp", _pid_kp_plus_cb, _pid_kp_minus_cb, &lbl_pid_kp_val);
   make_row("Ki", _pid_ki_plus_cb, _pid_ki_minus_cb, &lbl_pid_ki_val);
   make_row("Kd", _pid_kd_plus_cb, _pid_kd_minus_cb, &lbl_pid_kd_val);
@@ -1142,19 +1212,33 @@ void TempRegulator::createThermoCoeffsMenu() {
 }
 
 void TempRegulator::refreshPidCoeffLabels() {
+  const bool point = pid_edit_point >= 0;
+  const GainSchedule::Point* p = point ? &pid_sched[pid_edit_point] : nullptr;
+  if (lbl_pid_set_val) {
+    char buf[24];
+    if (point) snprintf(buf, sizeof(buf), "T%d", pid_edit_point + 1);
+    else snprintf(buf, sizeof(buf), "общий");
+    lv_label_set_text(lbl_pid_set_val, buf);
+  }
+  if (lbl_pid_t_val) {
+    char buf[24];
+    if (point && p->temp_c > 0.0f) snprintf(buf, sizeof(buf), "%.0f", (double)p->temp_c);
+    else snprintf(buf, sizeof(buf), point ? "выкл" : "все");
+    lv_label_set_text(lbl_pid_t_val, buf);
+  }
   if (lbl_pid_kp_val) {
     char buf[24];
-    snprintf(buf, sizeof(buf), "%.1f", pid_kp);
+    snprintf(buf, sizeof(buf), "%.1f", point ? (double)p->kp : pid_kp);
     lv_label_set_text(lbl_pid_kp_val, buf);
   }
   if (lbl_pid_ki_val) {
     char buf[24];
-    snprintf(buf, sizeof(buf), "%.1f", pid_ki);
+    snprintf(buf, sizeof(buf), "%.1f", point ? (double)p->ki : pid_ki);
     lv_label_set_text(lbl_pid_ki_val, buf);
   }
   if (lbl_pid_kd_val) {
     char buf[24];
-    snprintf(buf, sizeof(buf), "%.1f", pid_kd);
+    snprintf(buf, sizeof(buf), "%.1f", point ? (double)p->kd : pid_kd);
     lv_label_set_text(lbl_pid_kd_val, buf);
   }
 }
@@ -1173,6 +1257,36 @@ void TempRegulator::refreshThermoCoeffLabels() {
 }
 
 void TempRegulator::adjustPidCoeffByIndex(int idx, double delta) {
+  if (pid_edit_point >= 0) {                // точка таблицы по температуре
+    GainSchedule::Point& p = pid_sched[pid_edit_point];
+    if (idx == 3) {
+      if (!(p.temp_c > 0.0f)) {
+        if (delta <= 0.0) return;
+        float hottest = 0.0f;               // новая точка — на 50 °C выше самой горячей
+        for (const GainSchedule::Point& q : pid_sched) hottest = q.temp_c > hottest ? q.temp_c : hottest;
+        p.temp_c = hottest > 0.0f ? hottest + 50.0f : 100.0f;
+        if (p.kp <= 0.0f && p.ki <= 0.0f && p.kd <= 0.0f) {   // без коэффициентов точка выключила бы регулятор
+          p.kp = static_cast<float>(pid_kp);
+          p.ki = static_cast<float>(pid_ki);
+          p.kd = static_cast<float>(pid_kd);
+        }
+      } else {
+        const float t = p.temp_c + static_cast<float>(delta);
+        p.temp_c = t > 0.0f ? t : 0.0f;
+      }
+    } else {
+      float* coeffs[] = {&p.kp, &p.ki, &p.kd};
+      if (idx < 0 || idx >= static_cast<int>(sizeof(coeffs) / sizeof(coeffs[0]))) {
+        return;
+      }
+      double value = std::round((*coeffs[idx] + delta) * 10.0) / 10.0;
+      *coeffs[idx] = static_cast<float>(value < 0.0 ? 0.0 : value);
+    }
+    refreshPidCoeffLabels();
+    saveNVS();
+    refreshGainSchedule();
+    return;
+  }
   double* coeffs[] = {&pid_kp, &pid_ki, &pid_kd};
   if (idx < 0 || idx >= static_cast<int>(sizeof(coeffs) / sizeof(coeffs[0]))) {
     return;
@@ -1183,11 +1297,18 @@ void TempRegulator::adjustPidCoeffByIndex(int idx, double delta) {
   *target = value;
   refreshPidCoeffLabels();
   saveNVS();
+  ControlScheduler::Lock lock;
   pid.setCoeffs(pid_kp, pid_ki, pid_kd);
 }
 
+void TempRegulator::selectPidEditPoint(int delta) {
+  const int n = GainSchedule::kMaxPoints + 1;   // общий набор и точки таблицы
+  pid_edit_point = static_cast<int8_t>((pid_edit_point + 1 + delta + n) % n - 1);
+  refreshPidCoeffLabels();
+}
+
 void TempRegulator::adjustThermoCoeffByIndex(int idx, float delta) {
-  float* coeffs[] = {&slope, &offset};
+  float* coeffs[] = {&slope, &offset};   // ручная подстройка относится к линейному режиму
   if (idx < 0 || idx >= static_cast<int>(sizeof(coeffs) / sizeof(coeffs[0]))) {
     return;
   }
@@ -1195,6 +1316,7 @@ void TempRegulator::adjustThermoCoeffByIndex(int idx, float delta) {
   double value = static_cast<double>(*target) + static_cast<double>(delta);
   value = std::round(value * 10.0) / 10.0;
   *target = static_cast<float>(value);
+  updateThermoFixed();
   refreshThermoCoeffLabels();
   saveNVS();
 }
@@ -1203,14 +1325,18 @@ void TempRegulator::resetPidCoeffsToDefaults() {
   pid_kp = 2.0;
   pid_ki = 5.0;
   pid_kd = 1.0;
+  resetGainSchedule();
   refreshPidCoeffLabels();
   saveNVS();
+  ControlScheduler::Lock lock;
   pid.setCoeffs(pid_kp, pid_ki, pid_kd);
 }
 
 void TempRegulator::resetThermoCoeffsToDefaults() {
   slope = 1.0f;
   offset = 0.0f;
+  resetEmfCalibration();
+  updateThermoFixed();
   refreshThermoCoeffLabels();
   saveNVS();
 }
@@ -1481,7 +1607,7 @@ static void _cal1_back_cb(lv_event_t* ev){
 }
 static void _cal1_ok_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
-  s->cst = CAL_STEP1_MEASURE; s->cal_t0 = millis();
+  s->calib.confirmAmbient(millis(), s->cal_temp1);
   s->createCalibS2();
 }
 
@@ -1504,15 +1630,12 @@ void TempRegulator::createCalibS2() {
 }
 static void _cal2_back_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
-  s->cst=CAL_STEP1_INPUT_AMBIENT;
+  s->calib.back(millis());
   s->createCalibS1();
 }
 static void _cal2_ok_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
-  if (s->stable){
-    s->cst = CAL_STEP2_MEASURE;
-    s->cal_t0 = millis();
-  } else {
+  if (!s->calib.confirmBoiling(millis())){
     s->onEnterReady();
     lv_async_call(_async_open_profiles, s);
   }
@@ -1540,6 +1663,12 @@ void TempRegulator::createAtSetup() {
   char b[48]; snprintf(b,sizeof(b),"Цель: %.0f °C", at_target);
   lv_label_set_text(lbl_at_cur,b); place_below_header(lbl_at_cur, 10);
 
+  lv_obj_t* method = lv_btn_create(scr_at_setup);
+  lv_obj_set_size(method, 220, 40); lv_obj_align(method, LV_ALIGN_CENTER, 0, 0);
+  lv_obj_add_event_cb(method, _at_method_cb, LV_EVENT_CLICKED, this);
+  lbl_at_method = lv_label_create(method); lv_obj_center(lbl_at_method);
+  lv_label_set_text(lbl_at_method, atSession.method() == AutotuneSession::kStep ? "Способ: ступенька" : "Способ: реле");
+
   lv_obj_t* back = make_btn_with_icon(scr_at_setup, LV_SYMBOL_LEFT, "Назад");
   lv_obj_set_size(back, 120, 40); lv_obj_align(back, LV_ALIGN_BOTTOM_LEFT, 8, -8);
   lv_obj_add_event_cb(back, _settings_back_cb, LV_EVENT_CLICKED, this);
@@ -1548,12 +1677,21 @@ void TempRegulator::createAtSetup() {
   lv_obj_set_size(next, 120, 40); lv_obj_align(next, LV_ALIGN_BOTTOM_RIGHT, -8, -8);
   lv_obj_add_event_cb(next, _at_setup_next_cb, LV_EVENT_CLICKED, this);
 
+  clear_encoder_group();
+  ui_group = lv_group_create();
+  for (lv_obj_t* obj : {method, back, next}) lv_group_add_obj(ui_group, obj);
+  set_encoder_group(ui_group);
+
   scr_load_smooth(scr_at_setup);
 }
 void TempRegulator::createAtConfirm() {
   scr_at_confirm = lv_obj_create(NULL);
   make_header(scr_at_confirm, "Подтверждение");
-  char b[96]; snprintf(b,sizeof(b),"Нагрев будет автоматическим.\nЦель: %.0f °C", at_target);
+  char b[96];
+  if (atSession.method() == AutotuneSession::kStep)
+    snprintf(b,sizeof(b),"Ступенька мощности %d %%.\nПредел: %.0f °C", AutotuneSession::kStepPower * 100 / 255, at_target);
+  else
+    snprintf(b,sizeof(b),"Нагрев будет автоматическим.\nЦель: %.0f °C", at_target);
   lv_obj_t* l=lv_label_create(scr_at_confirm); lv_label_set_text(l,b); place_below_header(l, 10);
 
   lv_obj_t* no = make_btn_with_icon(scr_at_confirm, LV_SYMBOL_LEFT, "Нет");
@@ -1571,6 +1709,14 @@ void TempRegulator::createAtRun() {
   make_header(scr_at_run, "Автонастройка...");
   lbl_at_cur  = lv_label_create(scr_at_run); lv_label_set_text(lbl_at_cur, "T: ---- °C"); place_below_header(lbl_at_cur, 6);
   lbl_at_time = lv_label_create(scr_at_run); lv_label_set_text(lbl_at_time,"t: 0 с");   lv_obj_align(lbl_at_time, LV_ALIGN_CENTER, 0,  16);
+  lbl_at_info = lv_label_create(scr_at_run); lv_label_set_text(lbl_at_info, atSession.method() == AutotuneSession::kStep ? "Исходная температура" : "Разогрев");
+  lv_obj_align(lbl_at_info, LV_ALIGN_CENTER, 0,  44);
+  if (activeProfileIndex >= 0 && activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount) &&
+      profiles[activeProfileIndex].hasModel()) {   // прежняя модель профиля — для сравнения
+    const auto& pr = profiles[activeProfileIndex];
+    char b[64]; snprintf(b, sizeof(b), "Было: K %.2f, τ %.0f с, θ %.0f с", pr.rKm_FO, pr.rTm_FO, pr.rLm_FO);
+    lv_obj_t* l = lv_label_create(scr_at_run); lv_label_set_text(l, b); lv_obj_align(l, LV_ALIGN_CENTER, 0, -12);
+  }
 
   lv_obj_t* abortb = make_btn_with_icon(scr_at_run, LV_SYMBOL_WARNING, "Аварийная остановка");
   lv_obj_set_size(abortb, 180, 40); lv_obj_align(abortb, LV_ALIGN_BOTTOM_MID, 0, -10);
@@ -1578,12 +1724,65 @@ void TempRegulator::createAtRun() {
 
   scr_load_smooth(scr_at_run);
 }
+void TempRegulator::createAtResult() {
+  lv_obj_t* scr = lv_obj_create(NULL);
+  make_header(scr, "Результат автонастройки");
+  char b[96];
+  if (atSession.method() == AutotuneSession::kStep) {
+    const StepIdentifier::Model m = atSession.step().model();
+    snprintf(b, sizeof(b), "K %.2f °C/ед., τ %.0f с, θ %.0f с", m.gain, m.tau_s, m.dead_s);
+  } else {
+    const RelayAutotune& relay = atSession.relay();
+    snprintf(b, sizeof(b), "Tu %.0f с, a %.1f °C, Ku %.2f",
+             relay.periodMs() / 1000.0, (double)relay.amplitudeC(), relay.ultimateGain());
+  }
+  lv_obj_t* info = lv_label_create(scr); lv_label_set_text(info, b); place_below_header(info, 6);
+
+  lv_obj_t* prev = make_icon_only_btn(scr, LV_SYMBOL_LEFT);
+  lv_obj_set_size(prev, 48, 36); lv_obj_align(prev, LV_ALIGN_TOP_LEFT, 8, HEADER_H + 32);
+  lv_obj_add_event_cb(prev, _at_rule_prev_cb, LV_EVENT_CLICKED, this);
+  lv_obj_t* next = make_icon_only_btn(scr, LV_SYMBOL_RIGHT);
+  lv_obj_set_size(next, 48, 36); lv_obj_align(next, LV_ALIGN_TOP_RIGHT, -8, HEADER_H + 32);
+  lv_obj_add_event_cb(next, _at_rule_next_cb, LV_EVENT_CLICKED, this);
+  lbl_at_rule  = lv_label_create(scr); lv_obj_align(lbl_at_rule, LV_ALIGN_TOP_MID, 0, HEADER_H + 40);
+  lbl_at_gains = lv_label_create(scr); lv_obj_align(lbl_at_gains, LV_ALIGN_CENTER, 0, 22);
+
+  lv_obj_t* no = make_btn_with_icon(scr, LV_SYMBOL_CLOSE, "Отмена");
+  lv_obj_set_size(no, 120, 40); lv_obj_align(no, LV_ALIGN_BOTTOM_LEFT, 8, -8);
+  lv_obj_add_event_cb(no, _at_result_cancel_cb, LV_EVENT_CLICKED, this);
+  lv_obj_t* yes = make_btn_with_icon(scr, LV_SYMBOL_SAVE, "Сохранить");
+  lv_obj_set_size(yes, 120, 40); lv_obj_align(yes, LV_ALIGN_BOTTOM_RIGHT, -8, -8);
+  lv_obj_add_event_cb(yes, _at_result_save_cb, LV_EVENT_CLICKED, this);
+
+  refreshAtResult();
+
+  clear_encoder_group();
+  ui_group = lv_group_create();
+  for (lv_obj_t* obj : {prev, next, no, yes}) lv_group_add_obj(ui_group, obj);
+  set_encoder_group(ui_group);
+
+  scr_load_smooth(scr);
+}
+void TempRegulator::refreshAtResult() {
+  if (lbl_at_rule) lv_label_set_text(lbl_at_rule, atSession.ruleName());
+  if (lbl_at_gains) {
+    const RelayAutotune::Gains g = atSession.gains();
+    char b[96];
+    if (g.valid) snprintf(b, sizeof(b), "Kp = %.2f\nKi = %.4f\nKd = %.1f", g.kp, g.ki, g.kd);
+    else snprintf(b, sizeof(b), "Правило неприменимо:\nпечь не была холодной");
+    lv_label_set_text(lbl_at_gains, b);
+  }
+}
 static void _at_setup_next_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
   if(!s->isCalibrated){ s->msgbox("Требуется калибровка"); return; }
-  if(s->at_target<AT_MIN_TARGET_C || s->at_target>AT_MAX_TARGET_C){ s->msgbox("Цель 40..500 °C"); return; }
+  if(!AutotuneSession::targetValid(s->at_target)){ s->msgbox("Цель 40..500 °C"); return; }
   s->createAtConfirm();
 }
+static void _at_method_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->selectAutotuneMethod();
+}
 static void _at_confirm_no_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
   s->createAtSetup();
@@ -1596,6 +1795,27 @@ static void _at_abort_cb(lv_event_t* ev){
   auto s=(TempRegulator*)lv_event_get_user_data(ev);
   s->atst=AT_ABORT;
 }
+static void _at_rule_prev_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->selectAutotuneRule(-1);
+}
+static void _at_rule_next_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->selectAutotuneRule(1);
+}
+static void _at_result_save_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->commitAutotune(true);
+}
+static void _at_result_cancel_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->commitAutotune(false);
+}
+static void _adapt_save_cb(lv_event_t* ev){
+  auto s=(TempRegulator*)lv_event_get_user_data(ev);
+  s->saveAdaptedGains();
+  _close_mbox_only_cb(ev);
+}
 
 /* ===== Вспомогательные для кнопки Стоп/Пуск ===== */
 static void set_btn_icon_text(lv_obj_t* btn, const char* sym, const char* text) {
@@ -1614,13 +1834,36 @@ void TempRegulator::updateHeatButtonsUI() {
 }
 
 void TempRegulator::startHeat() {
-  heating = true;
+  {
+    ControlScheduler::Lock lock;
+    if (!heating) pid.reset();   // интеграл и фильтр D не должны помнить время простоя
+    if (!heating && state == STATE_WORK && profileRunner.start(millis())) {
+      pid.setSetpointValue(profileRunner.setpoint());   // профиль — с первой ступени
+    }
+    if (!heating && state == STATE_WORK && pid_adapt && !(gain_sched_on && gainSchedule.active())) {
+      const TemperatureProfile* tuned = activeProfileIndex >= 0 && activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount) &&
+                                        profiles[activeProfileIndex].isAvailable() ? &profiles[activeProfileIndex] : nullptr;
+      const StepIdentifier::Model prior = tuned && tuned->hasModel()
+          ? StepIdentifier::Model{tuned->rKm_FO, tuned->rTm_FO, tuned->rLm_FO, true} : StepIdentifier::Model{};
+      pid.setCoeffs(work_kp, work_ki, work_kd);   // каждый пуск — с исходных коэффициентов
+      adaptive.start(millis(), work_kp, work_ki, work_kd, prior.valid ? &prior : nullptr, coldJunction.temperature());
+    }
+    if (!heating && state == STATE_WORK && shaper_on) shaper.start(millis());   // модель — с покоя, от пуска
+    heating = true;
+  }
   updateHeatButtonsUI();
 }
 void TempRegulator::stopHeat() {
-  heating = false;
-  ssr_power_0_255 = 0;
-  digitalWrite(SSR_CONTROL_PIN, LOW);
+  {
+    ControlScheduler::Lock lock;
+    heating = false;
+    ssr_power_0_255 = 0;
+    ssr.off();
+    profileRunner.stop();
+    atSession.stop();
+    adaptive.stop();
+    shaper.stop();
+  }
   updateHeatButtonsUI();
 }
 void TempRegulator::setHeating(bool on) {
@@ -1651,10 +1894,13 @@ void TempRegulator::createWork() {
   lv_obj_set_style_pad_bottom(list, 0, 0);
   lv_obj_clear_flag(list, LV_OBJ_FLAG_SCROLLABLE);
 
-  lbl_work_cur = lbl_work_sp = lbl_work_pow = nullptr;
+  lbl_work_cur = lbl_work_sp = lbl_work_pow = lbl_work_aux = nullptr;
   make_kv_row(list, "Температура",       "----", "°C", &lbl_work_cur);
   make_kv_row(list, "Заданная темп.",    "----", "°C", &lbl_work_sp);
   make_kv_row(list, "Мощность нагрева",  "----", "%",  &lbl_work_pow);
+  if (aux_channel[0] >= 0 || aux_channel[1] >= 0) {
+    make_kv_row(list, "Стенка / защита", "----", "°C", &lbl_work_aux);
+  }
 
   // ОДНА кнопка Стоп/Пуск + Назад
   btn_work_heat = make_btn_with_icon(scr_work, LV_SYMBOL_STOP, "Стоп", true);
@@ -1782,7 +2028,7 @@ static void _alarm_ok_cb(lv_event_t* ev){
   auto s = (TempRegulator*)lv_event_get_user_data(ev);
   _close_mbox_only_cb(ev);
   s->clearAlarm();
-  digitalWrite(SSR_CONTROL_PIN, LOW);
+  s->stopHeat();
   s->onEnterReady();
 }
 
@@ -1828,33 +2074,175 @@ static void _touchtest_bg_cb(lv_event_t* ev){
 
 /* Sensor / SSR */
 uint16_t TempRegulator::readAdcFiltered(uint8_t& out_outliers) {
-  std::vector<uint16_t> v; v.reserve(ADC_READ_SAMPLES);
-  for(uint8_t i=0;i<ADC_READ_SAMPLES;i++){ v.push_back((uint16_t)analogRead(THERMOCOUPLE_PIN)); delay(2); }
-  auto sv=v; std::nth_element(sv.begin(), sv.begin()+sv.size()/2, sv.end());
-  uint16_t med=sv[sv.size()/2]; uint32_t acc=0; uint16_t n=0; out_outliers=0;
-  for(auto s:v){ if(abs((int)s-(int)med)<=ADC_OUTLIER_THRESHOLD){acc+=s; n++;} else out_outliers++; }
-  if(n==0) return med; return (uint16_t)(acc/n);
+  return tcSampler.latest(out_outliers);
 }
 float TempRegulator::readTemperatureC() {
+  return readTemperatureQ().toFloat();
+}
+Q16 TempRegulator::readTemperatureQ() {
+  if (spiTc.enabled()) {                    // SPI-усилитель: неисправность оцениваем раз на новое чтение
+    const SpiThermocouple::Reading r = spiTc.latest();
+    tcHealth.setOpen(r.fault & SpiThermocouple::kFaultOpen);
+    raiseSafety(safety.spiReading(r.seq, r.fault & SpiThermocouple::kFaultOpen, r.fault != 0));
+    return spiTc.linearized(tc_type);
+  }
   uint8_t o=0; uint16_t adc=readAdcFiltered(o);
-  if (o > ADC_OUTLIER_ALARM_COUNT) {
-    consecutive_outlier_cycles++;
-    if (consecutive_outlier_cycles >= 3 && !alarm_active) {
-      alarm_active = true;
-      onEnterAlarm("Неисправность термопары");
+  const bool open = tcSampler.openCircuit();   // по сырому отсчёту, не дожидаясь окон
+  tcHealth.setOpen(open);
+  raiseSafety(safety.adcReading(open, tcSampler.windowCount(), o));   // выбросы — раз в полностью новое окно
+  if (tc_type == tc::Type::Linear || emf_slope_q == Q16()) {
+    return offset_q + mulInt<16>(slope_q, adc);   // только целочисленные операции
+  }
+  const Q16 cj = coldJunction.temperature();
+  if (cj != cj_temp_seen) { cj_temp_seen = cj; cj_emf = tc::emf(tc_type, cj); }  // меняется раз в секунду
+  const tc::EmfQ e = emf_offset_q + mulInt<8>(emf_slope_q, adc) + cj_emf;       // ЭДС горячего спая от 0 °C
+  return tc::temperature(tc_type, e);                                           // поиск в таблице NIST
+}
+void TempRegulator::updateThermoFixed() {
+  offset_q = Q16::fromDouble(offset);
+  slope_q  = Q24::fromDouble(slope);
+  emf_offset_q = tc::EmfQ::fromDouble(emf_offset);
+  emf_slope_q  = Q16::fromDouble(emf_slope);
+  coldJunction.setFixed(Q16::fromDouble(cjc_fixed));
+  for (int i = 0; i < 2; ++i) {
+    aux_offset_q[i] = Q16::fromDouble(aux_offset[i]);
+    aux_slope_q[i]  = Q24::fromDouble(aux_slope[i]);
+  }
+}
+void TempRegulator::pollAdcFrame() {
+  if (tcSampler.frameCount() == adc_frame_seen) return;   // новый кадр раз в круг опроса, работа O(каналов)
+  AdcSampler::Frame f;
+  if (!tcSampler.readFrame(f)) return;
+  adc_frame_seen = f.seq;
+  for (int i = 0; i < 2; ++i) {
+    const int8_t ch = aux_channel[i];
+    if (ch < 0 || ch >= f.count) continue;
+    aux_temp_c[i] = (aux_offset_q[i] + mulInt<16>(aux_slope_q[i], f.adc[ch])).toFloat();
+  }
+  if (aux_channel[1] >= 0) raiseSafety(safety.probe(aux_temp_c[1]));
+}
+void TempRegulator::resetEmfCalibration() {
+  emf_offset = 0.0f; emf_slope = 0.0f; cjc_fixed = 25.0f;
+}
+
+Q16 TempRegulator::estimateTemperatureQ() {
+  const Q16 measured = readTemperatureQ();
+  measuredQ = measured;   // подстройке PID — без фазового сдвига фильтра
+  if (estimator.update(millis(), measured, deliveredPower())) {   // мощность прошлого цикла — вход модели
+    const AdcSampler::ChannelStats st = spiTc.enabled() ? AdcSampler::ChannelStats{} : tcSampler.stats(0);
+    tcHealth.update(estimator.innovation(), st.samples, st.outlier_total);
+    updateSampleRate(false);
+  }
+  return estimator.temperature();
+}
+void TempRegulator::updateSampleRate(bool reset) {
+  if (reset) {
+    sampleRate.reset();
+  } else if (!sampleRate.update(millis(), estimator.rate(), Q16::fromDouble(targetC) - estimator.temperature())) {
+    return;
+  }
+  tcSampler.setMedianPeriod(sampleRate.periodUs());   // в режиме сетевого интегрирования период задан сетью
+}
+void TempRegulator::applyEstimatorTuning(const TemperatureProfile* profile) {
+  if (profile) estimator.configure(profile->rKq_KF, profile->rKr_KF, profile->rKb_KF);
+  else estimator.configure(TemperatureEstimator::kDefaultProcessNoise, TemperatureEstimator::kDefaultMeasureNoise,
+                           TemperatureEstimator::kDefaultPowerGain);
+  estimator.reset();
+  tcHealth.restart();
+  safety.restartRise();
+  updateSampleRate(true);
+}
+void TempRegulator::applyShaperModel(const TemperatureProfile* profile) {
+  const StepIdentifier::Model m = profile && profile->hasModel()
+      ? StepIdentifier::Model{profile->rKm_FO, profile->rTm_FO, profile->rLm_FO, true} : shaper_manual;
+  ControlScheduler::Lock lock;
+  shaper.configure(m);   // модели нет — формирователь не запустится
+}
+void TempRegulator::raiseSafety(SafetyMonitor::Alarm a) {
+  if (a != SafetyMonitor::Alarm::None) requestAlarm(SafetyMonitor::text(a), SafetyMonitor::stopsHeat(a));
+}
+void TempRegulator::checkRiseAlarms() {
+  raiseSafety(safety.rise(millis(), heating && !alarm_active && estimator.primed(), estimator.temperature(),
+                          estimator.rate(), ssr_power_0_255, targetC));
+}
+void TempRegulator::requestAlarm(const char* text, bool stop_heat) {
+  ControlScheduler::Lock lock;
+  if (alarm_active) return;
+  alarm_active = true;
+  if (stop_heat) {           // выход гасим сразу, окно и кнопки обновит update() в задаче UI
+    heating = false;
+    ssr_power_0_255 = 0;
+    ssr.off();
+    profileRunner.stop();
+    atSession.stop();
+    adaptive.stop();
+    shaper.stop();
+  }
+  pending_alarm = text;
+}
+void TempRegulator::checkSsrFeedback() {
+  raiseSafety(safety.ssrFeedback(ssrFeedback, heating));   // итоги раз в блок
+}
+int TempRegulator::deliveredPower() const {
+  return ssrFeedback.deliveredPower(ssr_power_0_255);
+}
+uint32_t TempRegulator::getHeaterOnSeconds() const {
+  if (ssrFeedback.enabled()) return ssrFeedback.deliveredMs() / 1000;   // по фактическому току
+  return static_cast<uint32_t>(static_cast<uint64_t>(ssr.onSlots()) * ssr.slotUs() / 1000000ULL);   // по команде
+}
+float TempRegulator::getHeaterEnergyWh() const {
+  if (!heater_w) return NAN;
+  return static_cast<float>(getHeaterOnSeconds()) * heater_w / 3600.0f;
+}
+
+/* ===== Control task ===== */
+void TempRegulator::controlTickThunk(void* self) {
+  static_cast<TempRegulator*>(self)->controlTick();
+}
+void TempRegulator::controlTick() {
+  TR_TRACE_SCOPE(kControl, state);
+  TR_PHASE_LAP(lap);
+  const uint32_t now = millis();
+  coldJunction.update(now);
+  spiTc.poll(now);
+  pollAdcFrame();
+  checkSsrFeedback();
+  TR_PHASE_NEXT(lap, kAcquire);   // опрос датчиков и АЦП
+  if (state == STATE_WORK || state == STATE_MANUAL) {
+    const Q16 pvq = estimateTemperatureQ();
+    lastTemperatureC = pvq.toFloat();
+    int power = 0;
+    switch (workLoop.step({now, pvq, targetQ, deliveredPower(), heating, state == STATE_WORK, gain_sched_on}, power)) {
+      case WorkLoop::Result::TimedOut:
+        requestAlarm("Профиль: температура не вошла в допуск выдержки", true);
+        break;
+      case WorkLoop::Result::Finished:
+        heating = false;   // последняя ступень пройдена
+        ssr.off();
+        adaptive.stop();
+        shaper.stop();
+        break;
+      case WorkLoop::Result::Power:
+        break;
     }
+    ssr_power_0_255 = heating ? power : 0;
+    if (heating) workLoop.adapt(now, measuredQ, deliveredPower());
+    checkRiseAlarms();
+  } else if (state == STATE_AUTOTUNE_PID && atSession.active()) {
+    const Q16 pvq = readTemperatureQ();   // по измерению: фильтр сдвинул бы фазу колебаний и исказил отклик
+    lastTemperatureC = pvq.toFloat();
+    ssr_power_0_255 = atSession.tick(now, pvq);
   } else {
-    consecutive_outlier_cycles = 0;
+    ssr_power_0_255 = 0;   // вне работы и хода автонастройки нагреватель выключен
   }
-  return offset + slope*(float)adc;
+  TR_PHASE_NEXT(lap, kControl);   // оценщик, задатчик, PID
+  ssrApply();
 }
 
 void TempRegulator::ssrApply() {
-  uint32_t now=millis();
-  if(now - ssr_window_start >= SSR_WINDOW_MS) { ssr_window_start = now; }
-  uint32_t on_time = (uint32_t)((ssr_power_0_255 * SSR_WINDOW_MS)/255);
-  bool on = ((now-ssr_window_start) < on_time);
-  digitalWrite(SSR_CONTROL_PIN, on ? HIGH : LOW);
+  TR_PHASE_SCOPE(kSsr);
+  const int p = ssr_power_0_255;
+  ssr.setPower(static_cast<uint8_t>(p < 0 ? 0 : (p > 255 ? 255 : p)));   // фронты выставляет таймер SsrOutput
 }
 
 /* ===== Persistent storage (LittleFS) ===== */
@@ -1866,12 +2254,34 @@ void TempRegulator::saveNVS() {
   cfg.pid_kp            = pid_kp;
   cfg.pid_ki            = pid_ki;
   cfg.pid_kd            = pid_kd;
+  cfg.tc_type           = static_cast<uint8_t>(tc_type);
+  cfg.emf_offset        = emf_offset;
+  cfg.emf_slope         = emf_slope;
+  cfg.cjc_fixed         = cjc_fixed;
+  cfg.tc_source         = tc_source;
+  cfg.wall_offset       = aux_offset[0];
+  cfg.wall_slope        = aux_slope[0];
+  cfg.safety_offset     = aux_offset[1];
+  cfg.safety_slope      = aux_slope[1];
   cfg.touch_calibrated  = g_touch_calibrated;
   cfg.touch_swap        = g_touch_swap_axes;
   cfg.touch_tx_min      = g_tx_min;
   cfg.touch_tx_max      = g_tx_max;
   cfg.touch_ty_min      = g_ty_min;
   cfg.touch_ty_max      = g_ty_max;
+  cfg.adc_mode          = adc_mode;
+  cfg.mains_hz          = mains_hz;
+  cfg.adc_ssr_sync      = adc_ssr_sync;
+  cfg.control_period_ms = control_period_ms;
+  cfg.ssr_mode          = ssr_mode;
+  cfg.ssr_feedback      = ssr_feedback;
+  cfg.heater_w          = heater_w;
+  cfg.pid_adapt         = pid_adapt;
+  cfg.shaper            = shaper_on;
+  cfg.shaper_k          = static_cast<float>(shaper_manual.gain);
+  cfg.shaper_tau        = static_cast<float>(shaper_manual.tau_s);
+  cfg.shaper_dead       = static_cast<float>(shaper_manual.dead_s);
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) cfg.pid_sched[i] = pid_sched[i];
 
   if (!Storage::save(cfg)) {
     Serial.println("[Storage] Failed to save config to LittleFS");
@@ -1887,7 +2297,22 @@ bool TempRegulator::loadNVS() {
     pid_kp             = 2.0;
     pid_ki             = 5.0;
     pid_kd             = 1.0;
+    resetGainSchedule();
+    tc_type            = tc::Type::K;
+    resetEmfCalibration();
+    updateThermoFixed();
     resetTouchCalibrationToDefaults();
+    adc_mode           = 0;
+    mains_hz           = 50;
+    adc_ssr_sync       = false;
+    control_period_ms  = ControlScheduler::kDefaultPeriodMs;
+    ssr_mode           = 0;
+    ssr_feedback       = 0;
+    heater_w           = 0;
+    pid_adapt          = false;
+    shaper_on          = false;
+    shaper_manual      = StepIdentifier::Model{};
+    applyAdcMode();
     return false;
   }
 
@@ -1897,6 +2322,18 @@ bool TempRegulator::loadNVS() {
   pid_kp             = cfg.pid_kp;
   pid_ki             = cfg.pid_ki;
   pid_kd             = cfg.pid_kd;
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) pid_sched[i] = cfg.pid_sched[i];
+  refreshGainSchedule();     // выключенные точки и отрицательные коэффициенты отсеет compile()
+  tc_type            = static_cast<tc::Type>(cfg.tc_type <= 2 ? cfg.tc_type : 1);
+  emf_offset         = cfg.emf_offset;
+  emf_slope          = cfg.emf_slope;
+  cjc_fixed          = cfg.cjc_fixed;
+  tc_source          = cfg.tc_source <= 2 ? cfg.tc_source : 0;
+  aux_offset[0]      = cfg.wall_offset;
+  aux_slope[0]       = cfg.wall_slope;
+  aux_offset[1]      = cfg.safety_offset;
+  aux_slope[1]       = cfg.safety_slope;
+  updateThermoFixed();
 
   g_touch_calibrated = cfg.touch_calibrated;
   g_touch_swap_axes  = cfg.touch_swap;
@@ -1905,9 +2342,28 @@ bool TempRegulator::loadNVS() {
   g_ty_min           = cfg.touch_ty_min;
   g_ty_max           = cfg.touch_ty_max;
 
+  adc_mode           = cfg.adc_mode;
+  mains_hz           = cfg.mains_hz;
+  adc_ssr_sync       = cfg.adc_ssr_sync;
+  applyAdcMode();
+  control_period_ms  = ControlScheduler::clampPeriod(cfg.control_period_ms);
+  ssr_mode           = cfg.ssr_mode <= 2 ? cfg.ssr_mode : 0;
+  ssr_feedback       = cfg.ssr_feedback <= 2 ? cfg.ssr_feedback : 0;
+  heater_w           = cfg.heater_w;
+  pid_adapt          = cfg.pid_adapt;
+  shaper_on          = cfg.shaper;
+  shaper_manual      = StepIdentifier::Model{cfg.shaper_k, cfg.shaper_tau, cfg.shaper_dead < 0.0f ? 0.0f : cfg.shaper_dead,
+                                             cfg.shaper_k > 0.0f && cfg.shaper_tau > 0.0f};
+
   return true;
 }
 
+void TempRegulator::applyAdcMode() {
+  const AdcSampler::Mode m = (adc_mode == 1) ? AdcSampler::Mode::MainsIntegrate : AdcSampler::Mode::Median;
+  tcSampler.setMode(m, mains_hz, adc_ssr_sync);
+  safety.skipWindows(tcSampler.windowCount());
+}
+
 /* ===== Калибровка термопары: логика ===== */
 void TempRegulator::updateCalibStableUI(bool st){
   if(!btn_ok) return;
@@ -1915,135 +2371,138 @@ void TempRegulator::updateCalibStableUI(bool st){
   lv_obj_set_style_bg_color(btn_ok,c,0);
 }
 void TempRegulator::saveCalibration(float off, float sl){
-  offset = off; slope = sl; isCalibrated = true; saveNVS();
+  offset = off; slope = sl; isCalibrated = true; updateThermoFixed(); saveNVS();
 }
 void TempRegulator::startCalibration(){
-  cst = CAL_STEP1_INPUT_AMBIENT; stable = false; stable_t0 = 0;
-  cal_t0 = millis();
+  calib.start(millis());
   createCalibS1();
 }
 void TempRegulator::tickCalibration(){
-  static uint16_t last_adc=0;
-
-  switch(cst){
-    case CAL_STEP1_INPUT_AMBIENT:
-      if (isCalibTimedOut()) { createCalibMsg("Тайм-аут шага 1"); cst=CAL_ERROR; }
-      break;
-
-    case CAL_STEP1_MEASURE: {
-      uint8_t o=0; uint16_t a=readAdcFiltered(o);
-      if(o>CAL_MAX_OUTLIERS){ createCalibMsg("Неисправность термопары"); cst=CAL_ERROR; break; }
-      cal_adc1 = a;
-      cal_temp2=100.0f;
-      stable=false; stable_t0=0; last_adc=a; cal_t0=millis();
-      cst=CAL_STEP2_WAIT_STABLE; createCalibS2();
-      break;
+  const CalibrationWizard::Step step = calib.step();
+  CalibrationWizard::Reading r{};
+  if (step == CalibrationWizard::Step::MeasureAmbient || step == CalibrationWizard::Step::WaitStable ||
+      step == CalibrationWizard::Step::MeasureBoiling) {
+    if (step == CalibrationWizard::Step::MeasureAmbient && !coldJunction.hasSensor()) {
+      cjc_fixed = cal_temp1; updateThermoFixed();   // без датчика холодный спай = окружающая среда
     }
+    r.adc = readAdcFiltered(r.outliers);
+    r.cj_c = coldJunction.temperature().toFloat();
+    r.cj_sensor = coldJunction.hasSensor();
+  } else if (step != CalibrationWizard::Step::InputAmbient) {
+    return;
+  }
 
-    case CAL_STEP2_WAIT_STABLE: {
-      uint8_t o=0; uint16_t a=readAdcFiltered(o);
-      if(lbl_cal_val){ char b[32]; snprintf(b,sizeof(b),"АЦП: %u",(unsigned)a); lv_label_set_text(lbl_cal_val,b); }
-      if(o>CAL_MAX_OUTLIERS){ createCalibMsg("Неисправность термопары"); cst=CAL_ERROR; break; }
-
-      if(abs((int)a-(int)last_adc)<=CAL_STABLE_DELTA){
-        if(!stable_t0) stable_t0=millis();
-        if(millis()-stable_t0>=CAL_STABLE_HOLD_MS){ stable=true; updateCalibStableUI(true); }
-      } else { stable=false; stable_t0=0; updateCalibStableUI(false); }
-      last_adc=a;
-
-      if(isCalibTimedOut()){ createCalibMsg("Тайм-аут шага 2"); cst=CAL_ERROR; }
+  switch (calib.tick(millis(), r, tc_type)) {
+    case CalibrationWizard::Event::AmbientMeasured:
+      createCalibS2();
       break;
-    }
-
-    case CAL_STEP2_MEASURE: {
-      uint8_t o=0; uint16_t a=readAdcFiltered(o);
-      if(o>CAL_MAX_OUTLIERS){ createCalibMsg("Неисправность термопары"); cst=CAL_ERROR; break; }
-      cal_adc2 = a;
-      cst=CALC_COEFFS;
-      /* fallthrough */
-    }
-
-    case CALC_COEFFS: {
-      if(cal_adc2<=cal_adc1 || (cal_adc2-cal_adc1)<CAL_MIN_ADC_DIFF){
-        createCalibMsg("Недостаточная разница АЦП"); cst=CAL_ERROR; break;
-      }
-      float sl=(cal_temp2-cal_temp1)/float(cal_adc2-cal_adc1);
-      float off=cal_temp1 - sl*float(cal_adc1);
-      saveCalibration(off,sl);
-      char m[96]; snprintf(m,sizeof(m),"Готово!\nКоэфф.=%.6f\nСмещение=%.2f",sl,off);
-      createCalibMsg(m); cst=CAL_DONE; beep(100);
+    case CalibrationWizard::Event::StableChanged:
+      updateCalibStableUI(calib.stable());
       break;
+    case CalibrationWizard::Event::Failed:
+      createCalibMsg(CalibrationWizard::errorText(calib.error()));
+      return;
+    case CalibrationWizard::Event::Finished: {
+      const tc::Calibration& c = calib.result();
+      if (tc_type != tc::Type::Linear) { emf_slope = c.emf_slope; emf_offset = c.emf_offset; }
+      saveCalibration(c.offset, c.slope);
+      char m[96]; snprintf(m,sizeof(m),"Готово!\nКоэфф.=%.6f\nСмещение=%.2f",c.slope,c.offset);
+      createCalibMsg(m); beep(100);
+      return;
     }
-
     default: break;
   }
+  if (calib.step() == CalibrationWizard::Step::WaitStable && lbl_cal_val) {
+    char b[32]; snprintf(b,sizeof(b),"АЦП: %u",(unsigned)calib.lastAdc()); lv_label_set_text(lbl_cal_val,b);
+  }
 }
 
 /* ===== Автонастройка ===== */
 void TempRegulator::startAutotune(){
-  atst=AT_RUNNING; at_t0=millis(); createAtRun();
-  peak_ts.clear(); peak_val.clear();
-  float pv = readTemperatureC(); was_above = (pv>at_target);
-  relay_on = true; ssr_power_0_255 = 255; ssr_window_start=millis();
+  atst=AT_RUNNING; createAtRun();
+  ControlScheduler::Lock lock;   // дальше выход ведёт задача регулятора
+  atSession.start(millis(), Q16::fromDouble(at_target), Q16::fromDouble(relay_hyst), readTemperatureQ());
 }
 void TempRegulator::finishAutotune(double kp,double ki,double kd){
-  relay_on = false;
   stopHeat();
   pid_kp=kp; pid_ki=ki; pid_kd=kd; saveNVS(); beep(120);
   msgbox("Автонастройка завершена");
   atst=AT_DONE;
 }
+void TempRegulator::selectAutotuneMethod(){
+  atSession.toggleMethod();
+  if (lbl_at_method) lv_label_set_text(lbl_at_method, atSession.method() == AutotuneSession::kStep ? "Способ: ступенька" : "Способ: реле");
+}
+void TempRegulator::selectAutotuneRule(int delta){
+  atSession.selectRule(delta);
+  refreshAtResult();
+}
+void TempRegulator::commitAutotune(bool save){
+  if (atst != AT_PREVIEW) return;
+  const RelayAutotune::Gains g = atSession.gains();
+  if (!save) { atst = AT_DONE; return; }
+  if (!g.valid) { msgbox("Выберите другое правило"); return; }
+  if (atSession.method() == AutotuneSession::kStep && activeProfileIndex >= 0 &&
+      activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount)) {   // модель — в выбранный профиль
+    const StepIdentifier::Model m = atSession.step().model();
+    profiles[activeProfileIndex].saveModelToNVS(m.gain, m.tau_s, m.dead_s);
+  }
+  finishAutotune(g.kp, g.ki, g.kd);
+}
 void TempRegulator::tickAutotune(){
   switch(atst){
     case AT_RUNNING: {
       uint32_t now=millis();
-      float t=readTemperatureC();
-      if(lbl_at_cur){ char b[32]; snprintf(b,sizeof(b),"T: %.1f °C",t); lv_label_set_text(lbl_at_cur,b); }
-      if(lbl_at_time){ char b[24]; snprintf(b,sizeof(b),"t: %lus",(unsigned)((now-at_t0)/1000)); lv_label_set_text(lbl_at_time,b); }
-
-      float pv = t;
-      if(relay_on && pv > (at_target + relay_hyst)) { relay_on=false; ssr_power_0_255=0; }
-      else if(!relay_on && pv < (at_target - relay_hyst)) { relay_on=true; ssr_power_0_255=255; }
-
-      bool above = pv>at_target;
-      if(above!=was_above){
-        peak_ts.push_back(now);
-        peak_val.push_back(pv);
-        was_above=above;
-      }
-
-      if(peak_ts.size()>=6){
-        double sum=0; int cnt=0;
-        for(size_t i=2;i<peak_ts.size();i++) { sum += (double)(peak_ts[i]-peak_ts[i-2]); cnt++; }
-        double Tu_ms = sum / (double)cnt;
-        double Tu = Tu_ms/1000.0;
-        double vmax=*std::max_element(peak_val.begin(), peak_val.end());
-        double vmin=*std::min_element(peak_val.begin(), peak_val.end());
-        double a = (vmax - vmin)/2.0; if(a<0.1) a=0.1;
-        double d = 1.0;
-        double Ku = (4.0*d) / (3.1415926535*a);
-        double Kp = 0.6 * Ku;
-        double Ti = 0.5 * Tu;
-        double Td = 0.125 * Tu;
-        double Ki = Kp / Ti;
-        double Kd = Kp * Td;
-        finishAutotune(Kp,Ki,Kd);
+      float t;
+      AutotuneSession::Outcome outcome;
+      uint8_t switches;
+      uint32_t period_ms;
+      float amp;
+      StepIdentifier::Model model;
+      {
+        ControlScheduler::Lock lock;
+        t = lastTemperatureC;
+        outcome = atSession.poll(now);
+        switches = atSession.relay().switches();
+        period_ms = atSession.relay().periodMs();
+        amp = atSession.relay().amplitudeC();
+        model = atSession.method() == AutotuneSession::kStep ? atSession.step().model() : StepIdentifier::Model{};
       }
+      if(lbl_at_cur){ char b[32]; snprintf(b,sizeof(b),"T: %.1f °C",t); lv_label_set_text(lbl_at_cur,b); }
+      if(lbl_at_time){ char b[24]; snprintf(b,sizeof(b),"t: %lus",(unsigned long)((now-atSession.startedMs())/1000)); lv_label_set_text(lbl_at_time,b); }
+      if(lbl_at_info){ char b[64];
+        if (atSession.method() == AutotuneSession::kStep) {
+          if (model.valid) snprintf(b,sizeof(b),"K %.2f, τ %.0f с, θ %.0f с",model.gain,model.tau_s,model.dead_s);
+          else snprintf(b,sizeof(b),"Ожидание отклика");
+        }
+        else if (period_ms) snprintf(b,sizeof(b),"Переключений %u, Tu %.0f с, a %.1f °C",(unsigned)switches,period_ms/1000.0,(double)amp);
+        else snprintf(b,sizeof(b),switches ? "Переключений %u" : "Разогрев",(unsigned)switches);
+        lv_label_set_text(lbl_at_info,b); }
 
-      if((now-at_t0)>AT_TIMEOUT_MS){
-        atst=AT_ERROR;
-        relay_on = false;
-        stopHeat();
-        msgbox("Тайм-аут автонастройки");
-      }
-      if(atst==AT_ABORT){
-        relay_on = false;
-        stopHeat();
-        atst=AT_IDLE;
-        onEnterSettings();
+      switch (outcome) {
+        case AutotuneSession::Outcome::LimitReached:
+        case AutotuneSession::Outcome::Stopped:
+          stopHeat();
+          atst=AT_ERROR;
+          msgbox(outcome == AutotuneSession::Outcome::LimitReached ? "Цель достигнута раньше, чем определилась модель"
+                                                                   : "Автонастройка прервана");
+          break;
+        case AutotuneSession::Outcome::Converged:
+          stopHeat();
+          beep(120);
+          atst=AT_PREVIEW;
+          createAtResult();
+          break;
+        case AutotuneSession::Outcome::TimedOut:
+          atst=AT_ERROR;
+          stopHeat();
+          msgbox("Тайм-аут автонастройки");
+          break;
+        default: break;
       }
       break;
     }
+    case AT_ABORT: { stopHeat(); onEnterSettings(); atst=AT_IDLE; break; }
     case AT_DONE:  { stopHeat(); onEnterSettings(); atst=AT_IDLE; break; }
     case AT_ERROR: { stopHeat(); onEnterSettings(); atst=AT_IDLE; break; }
     default: break;
@@ -2053,54 +2512,215 @@ void TempRegulator::tickAutotune(){
 /* ===== State enter ===== */
 void TempRegulator::onEnterReady(){
   clear_encoder_group();
+  {
+    ControlScheduler::Lock lock;
+    updateSampleRate(true);   // калибровка и автонастройка работают на номинальной частоте
+    state = STATE_READY;
+  }
   btn_work_heat = nullptr;
   btn_manual_heat = nullptr;
   lbl_work_cur = nullptr;
   lbl_work_sp = nullptr;
   lbl_work_pow = nullptr;
+  lbl_work_aux = nullptr;
   lbl_man_cur = nullptr;
   lbl_man_sp = nullptr;
-  state = STATE_READY;
   createMain();
 }
-void TempRegulator::onEnterSettings(){ state = STATE_SETTINGS; createSettings(); }
-void TempRegulator::onEnterWork(){
-  float desiredTarget = targetC;
-  pid.setCoeffs(pid_kp,pid_ki,pid_kd);
+void TempRegulator::onEnterSettings(){ setState(STATE_SETTINGS); createSettings(); }
+void TempRegulator::compileProfile(const TemperatureProfile& profile) {
+  ControlScheduler::Lock lock;
+  profileRunner.clear();
+  for (size_t i = 0; i < TemperatureProfile::MAX_ROWS; ++i) {
+    const TempProfileRow& row = profile.step(i);
+    const float band = row.rBand > 0.0f ? row.rBand : static_cast<float>(profile.rBand_GS);   // допуск ступени или общий
+    profileRunner.addSegment(row.rStartTemperature, row.rEndTemperature, row.rTime, band);   // пустые строки пропускаются
+  }
+  profileRunner.setMaxWaitMs(profile.rWait_GS > 0.0 ? static_cast<uint32_t>(profile.rWait_GS * 60000.0) : 0);
+}
 
-  if (activeProfileIndex >= 0 && activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount)) {
-    if (profiles[activeProfileIndex].isAvailable()) {
-      const auto& profile = profiles[activeProfileIndex];
-      if (profile.hasPidCoefficients()) {
-        pid.setCoeffs(profile.kp(), profile.ki(), profile.kd());
-      }
-      if (profile.stepCount() > 0) {
-        desiredTarget = profile.step(0).rEndTemperature;
-      }
+void TempRegulator::refreshGainSchedule() {
+  ControlScheduler::Lock lock;
+  gainSchedule.compile(pid_sched, GainSchedule::kMaxPoints);
+  if (gain_sched_on && !gainSchedule.active()) {
+    pid.setCoeffs(pid_kp, pid_ki, pid_kd);   // таблицу очистили — снова общий набор
+  }
+}
+
+void TempRegulator::resetGainSchedule() {
+  for (GainSchedule::Point& p : pid_sched) p = GainSchedule::Point{0.0f, 0.0f, 0.0f, 0.0f};
+  refreshGainSchedule();
+}
+
+bool TempRegulator::setGainSchedule(const GainSchedule::Point* points, uint8_t n) {
+  if (n > GainSchedule::kMaxPoints) return false;
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) {
+    GainSchedule::Point p = i < n ? points[i] : GainSchedule::Point{0.0f, 0.0f, 0.0f, 0.0f};
+    if (!(p.temp_c > 0.0f)) p = GainSchedule::Point{0.0f, 0.0f, 0.0f, 0.0f};
+    else if (!(p.kp >= 0.0f && p.ki >= 0.0f && p.kd >= 0.0f)) return false;   // отрицательные и NaN не принимаем
+    pid_sched[i] = p;
+  }
+  saveNVS();
+  refreshGainSchedule();
+  refreshPidCoeffLabels();
+  return true;
+}
+
+void TempRegulator::publishProfileProgress() {
+  bool running, paused;
+  uint8_t step;
+  uint32_t start_ms, step_ms;
+  {
+    ControlScheduler::Lock lock;
+    running  = profileRunner.running();
+    paused   = profileRunner.paused();
+    step     = profileRunner.segment();
+    start_ms = profileRunner.startMs();
+    step_ms  = millis() - profileRunner.segmentElapsedMs();   // начало ступени без учёта пауз
+    if (running || profileRunner.finished()) targetC = profileRunner.setpoint().toFloat();
+  }
+  if (running == profile_seen_running && paused == profile_seen_paused &&
+      (!running || step == profile_seen_step)) return;
+
+  WebInterface& web = WebInterface::instance();
+  if (running) {
+    if (!profile_seen_running) {
+      web.noteProfileStart(start_ms);
+      web.setProfileAlarm(false, String());
+    }
+    if (paused) web.noteProfileStepPause();
+    else web.noteProfileStep(step + 1, step_ms);
+  } else {
+    web.noteProfileStop();
+    web.noteProfileStepStop();
+    if (profileRunner.timedOut()) {
+      web.setProfileAlarm(true, "Температура не вошла в допуск выдержки");
+    } else if (profileRunner.finished()) {
+      updateHeatButtonsUI();
+      beep(300);
     }
   }
+  profile_seen_running = running;
+  profile_seen_paused = paused;
+  profile_seen_step = step;
+}
+
+void TempRegulator::publishAdaptiveProgress() {
+  bool running, alarm;
+  uint16_t retunes;
+  double kp, ki, kd;
+  StepIdentifier::Model m;
+  {
+    ControlScheduler::Lock lock;
+    running = adaptive.running();
+    retunes = adaptive.retunes();
+    kp = adaptive.kp(); ki = adaptive.ki(); kd = adaptive.kd();
+    m = adaptive.model();
+    alarm = alarm_active;
+  }
+  if (retunes != adapt_seen_retunes && retunes > 0) {   // журнал: по нему видно, куда ушли коэффициенты
+    Serial.printf("[ADAPT] #%u Kp %.4f Ki %.6f Kd %.3f, model K %.3f tau %.0f s\n",
+                  (unsigned)retunes, kp, ki, kd, m.gain, m.tau_s);
+  }
+  adapt_seen_retunes = retunes;
+  const bool ended = adapt_seen_running && !running;
+  adapt_seen_running = running;
+  if (!ended || retunes == 0 || alarm) return;
+
+  char buf[256];
+  const bool to_profile = work_pid_profile && activeProfileIndex >= 0 &&
+                          activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount);
+  const TemperatureProfile* target = to_profile ? &profiles[activeProfileIndex] : nullptr;
+  snprintf(buf, sizeof(buf),
+           "Подстройка PID: %u шагов\n  Kp %.3f -> %.3f\n  Ki %.5f -> %.5f\n  Kd %.2f -> %.2f\n\n%s%s%s",
+           (unsigned)retunes, work_kp, kp, work_ki, ki, work_kd, kd,
+           target ? "Сохранить в профиль «" : "Сохранить как общие коэффициенты?",
+           target ? target->name().c_str() : "", target ? "»?" : "");
+  lv_obj_t* m_box = lv_msgbox_create(NULL);
+  lv_msgbox_add_text(m_box, buf);
+  lv_obj_center(m_box);
+  lv_obj_t* yes = lv_msgbox_add_footer_button(m_box, "Сохранить");
+  lv_obj_add_event_cb(yes, _adapt_save_cb, LV_EVENT_CLICKED, this);
+  lv_obj_t* no = lv_msgbox_add_footer_button(m_box, "Нет");
+  lv_obj_add_event_cb(no, _close_mbox_only_cb, LV_EVENT_CLICKED, nullptr);
+  encoder_modal_take({yes, no});
+}
+
+void TempRegulator::saveAdaptedGains() {
+  double kp, ki, kd;
+  {
+    ControlScheduler::Lock lock;
+    kp = adaptive.kp(); ki = adaptive.ki(); kd = adaptive.kd();
+  }
+  if (work_pid_profile && activeProfileIndex >= 0 && activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount)) {
+    profiles[activeProfileIndex].savePidToNVS(kp, ki, kd);
+  } else {
+    pid_kp = kp; pid_ki = ki; pid_kd = kd;
+    saveNVS();
+    refreshPidCoeffLabels();
+  }
+  work_kp = kp; work_ki = ki; work_kd = kd;   // следующий пуск — уже с них
+}
+
+void TempRegulator::onEnterWork(){
+  {
+    ControlScheduler::Lock lock;   // регулятор видит вход в режим целиком, экран строится после
+    float desiredTarget = targetC;
+    state = STATE_WORK;
+    profileRunner.clear();   // без профиля — поддержание уставки
+    gain_sched_on = true;    // таблица PID по температуре, если она задана
+    pid.setCoeffs(pid_kp,pid_ki,pid_kd);
+    work_kp = pid_kp; work_ki = pid_ki; work_kd = pid_kd;
+    work_pid_profile = false;
+    const TemperatureProfile* tuned = nullptr;
+
+    if (activeProfileIndex >= 0 && activeProfileIndex < static_cast<int8_t>(kTemperatureProfileCount)) {
+      if (profiles[activeProfileIndex].isAvailable()) {
+        const auto& profile = profiles[activeProfileIndex];
+        if (profile.hasPidCoefficients()) {
+          gain_sched_on = false;   // свои коэффициенты профиля важнее таблицы
+          pid.setCoeffs(profile.kp(), profile.ki(), profile.kd());
+          work_kp = profile.kp(); work_ki = profile.ki(); work_kd = profile.kd();
+          work_pid_profile = true;
+        }
+        tuned = &profile;
+        compileProfile(profile);
+        if (profileRunner.segmentCount() > 0) {
+          desiredTarget = profileRunner.setpoint().toFloat();
+        }
+      }
+    }
 
-  setTargetC(desiredTarget);
-  ssr_window_start = millis();
-  ssr_power_0_255 = 0;
-  digitalWrite(SSR_CONTROL_PIN, LOW);
-  heating = false;          // нагрев запускается вручную кнопкой «Пуск»
+    pid.reset();
+    setTargetC(desiredTarget);
+    applyEstimatorTuning(tuned);
+    applyShaperModel(tuned);
+    ssr_power_0_255 = 0;
+    ssr.off();
+    heating = false;          // нагрев запускается вручную кнопкой «Пуск»
+  }
   createWork();
 }
 
 void TempRegulator::onEnterManual(){
-  state = STATE_MANUAL;
-  pid.setCoeffs(pid_kp,pid_ki,pid_kd);
-  setTargetC(targetC);
-  ssr_window_start = millis();
-  ssr_power_0_255 = 0;
-  digitalWrite(SSR_CONTROL_PIN, LOW);
-  heating = false;          // пользователю нужно включить нагрев вручную
+  {
+    ControlScheduler::Lock lock;   // регулятор видит вход в режим целиком, экран строится после
+    gain_sched_on = true;
+    state = STATE_MANUAL;
+    pid.setCoeffs(pid_kp,pid_ki,pid_kd);
+    pid.reset();
+    setTargetC(targetC);
+    applyEstimatorTuning(nullptr);
+    ssr_power_0_255 = 0;
+    ssr.off();
+    heating = false;          // пользователю нужно включить нагрев вручную
+  }
   createManual();
 }
 
-void TempRegulator::onEnterCalib(){ startCalibration(); }
-void TempRegulator::onEnterAutotune(){ atst=AT_SETUP_TARGET; createAtSetup(); }
+void TempRegulator::onEnterCalib(){ setState(STATE_CALIBRATE_SENSOR); startCalibration(); }
+void TempRegulator::onEnterAutotune(){ setState(STATE_AUTOTUNE_PID); atst=AT_SETUP_TARGET; createAtSetup(); }
+void TempRegulator::setState(State next){ ControlScheduler::Lock lock; state = next; }
 void TempRegulator::onEnterAlarm(const char* text){
   lv_obj_t* m = lv_msgbox_create(NULL);
   lv_msgbox_add_text(m, text);
@@ -2115,7 +2735,8 @@ void TempRegulator::onEnterTouchTest(){ createTouchTest(); state = STATE_TOUCH_T
 /* ===== Touch calib tick ===== */
 void TempRegulator::tickTouchCalib() {
   uint16_t rx, ry;
-  bool pressed = tft.getTouchRaw(&rx, &ry);
+  bool pressed;
+  { SpiBusLock lock(SpiBusArbiter::Client::Touch); pressed = tft.getTouchRaw(&rx, &ry); }
 
   switch (tcs) {
     case TCS_1:
@@ -2178,6 +2799,12 @@ void TempRegulator::begin() {
   digitalWrite(LED_R_PIN, HIGH); digitalWrite(LED_G_PIN, HIGH); digitalWrite(LED_B_PIN, HIGH);
 
   analogReadResolution(12);
+  if (TC_WALL_PIN >= 0)   aux_channel[0] = tcSampler.addChannel(TC_WALL_PIN);
+  if (TC_SAFETY_PIN >= 0) aux_channel[1] = tcSampler.addChannel(TC_SAFETY_PIN);
+  if (!tcSampler.begin(THERMOCOUPLE_PIN, ADC_SAMPLE_PERIOD_US)) {
+    Serial.println("[ADC] Failed to start background sampler");
+  }
+  coldJunction.begin(CJC_SENSOR_PIN);
 
   if (!Storage::begin()) {
     Serial.println("[Storage] Failed to mount LittleFS");
@@ -2187,50 +2814,69 @@ void TempRegulator::begin() {
     saveNVS();
   }
 
+  if (tc_source != 0) {
+    const auto chip = (tc_source == 2) ? SpiThermocouple::Chip::MAX31856 : SpiThermocouple::Chip::MAX31855;
+    if (!spiTc.begin(chip, PIN_TC_SPI_CS, tc_type, mains_hz)) {
+      Serial.println("[TC] SPI amplifier not configured, using ADC");
+    }
+  }
+
   ensureDefaultTemperatureProfiles();
   loadTemperatureProfiles();
 
   pid.setCoeffs(pid_kp, pid_ki, pid_kd);
+  ssr.setEdgeCallback([](void* self, bool) { static_cast<TempRegulator*>(self)->tcSampler.notifySsrEdge(); }, this);
+  if (!ssr.begin(SSR_CONTROL_PIN, static_cast<SsrOutput::Mode>(ssr_mode), mains_hz)) {
+    Serial.println("[SSR] Failed to start output timer");
+  }
+  if (ssr_feedback && !ssrFeedback.begin(SSR_FEEDBACK_PIN, ssr_feedback == 1, &ssr)) {
+    Serial.println("[SSR] Failed to start feedback monitor");
+  }
+
+  pid.setFixedDt(control_period_ms);
+  if (!control.begin(&TempRegulator::controlTickThunk, this, control_period_ms)) {
+    Serial.println("[Control] Failed to start control task");
+  }
 
   state = STATE_READY;                                                    // Modified: стартуем напрямую без заставки
   onEnterReady();                                                         // Modified: сразу создаём главный экран
 }
 
 void TempRegulator::update() {
+  TR_PHASE_LAP(lap);
   lv_timer_handler();
+  TR_PHASE_NEXT(lap, kLvgl);
+  if (const char* text = pending_alarm.exchange(nullptr)) {   // авария из задачи регулятора
+    updateHeatButtonsUI();
+    onEnterAlarm(text);
+    WebInterface::instance().setRegulatorAlarm(true, text);
+  }
 
   if (ev != EVENT_NONE) {
+    // Каждый onEnter* меняет состояние регулятора под своим захватом, а экран
+    // LVGL строит уже после освобождения: шаг регулятора не ждёт отрисовку.
     switch (state) {
       case STATE_INIT:
-        state = (ev == EVENT_INIT_OK) ? STATE_READY : STATE_ALARM;
-        if (state == STATE_READY) onEnterReady();
-        else onEnterAlarm("Ошибка инициализации");
+        if (ev == EVENT_INIT_OK) onEnterReady();
+        else { setState(STATE_ALARM); onEnterAlarm("Ошибка инициализации"); }
         break;
 
       case STATE_READY:
-        if (ev == EVENT_TO_SETTINGS)        { state = STATE_SETTINGS;        onEnterSettings(); }
-        else if (ev == EVENT_TO_PROFILES)   {                                 createProfiles(); }
-        else if (ev == EVENT_TO_PROFILE_WORK){ state = STATE_WORK;            onEnterWork();    }
-        else if (ev == EVENT_TO_MANUAL)     { state = STATE_MANUAL;           onEnterManual();  }
+        if (ev == EVENT_TO_SETTINGS)        { onEnterSettings(); }
+        else if (ev == EVENT_TO_PROFILES)   { createProfiles();  }
+        else if (ev == EVENT_TO_PROFILE_WORK){ onEnterWork();    }
+        else if (ev == EVENT_TO_MANUAL)     { onEnterManual();   }
         break;
 
       case STATE_SETTINGS:
-        if (ev == EVENT_TO_CALIB)   { state = STATE_CALIBRATE_SENSOR; onEnterCalib();    }
-        else if (ev == EVENT_TO_AUTOTUNE){ state = STATE_AUTOTUNE_PID;    onEnterAutotune(); }
+        if (ev == EVENT_TO_CALIB)   { onEnterCalib();    }
+        else if (ev == EVENT_TO_AUTOTUNE){ onEnterAutotune(); }
         break;
 
       case STATE_WORK:
-        if (ev == EVENT_STOP) {
-          stopHeat();
-          state = STATE_READY;
-          onEnterReady();
-        }
-        break;
-
       case STATE_MANUAL:
         if (ev == EVENT_STOP) {
-          stopHeat();
-          state = STATE_READY;
+          stopHeat();       // без heating шаг регулятора держит выход в нуле до READY
           onEnterReady();
         }
         break;
@@ -2245,50 +2891,45 @@ void TempRegulator::update() {
     }
     ev = EVENT_NONE;
   }
+  publishProfileProgress();
+  publishAdaptiveProgress();
+  TR_PHASE_NEXT(lap, kEvents);
 
   if (state == STATE_WORK) {
-    float pv = readTemperatureC();
-    lastTemperatureC = pv;                                                // Modified: сохраняем температуру для веба
-
-    if (heating) {
-      ssr_power_0_255 = pid.compute(pv);
-    } else {
-      ssr_power_0_255 = 0;
-      digitalWrite(SSR_CONTROL_PIN, LOW);
-    }
-    ssrApply();
+    const float pv = lastTemperatureC;                                    // измерение и PID — в задаче регулятора
 
     if (lbl_work_cur) { char b1[24]; snprintf(b1, sizeof(b1), "%.1f", pv);          lv_label_set_text(lbl_work_cur, b1); }
-    if (lbl_work_sp)  { char b2[24]; snprintf(b2, sizeof(b2), "%.1f", targetC);     lv_label_set_text(lbl_work_sp,  b2); }
+    if (lbl_work_sp)  { char b2[24];
+                        if (profile_seen_running) snprintf(b2, sizeof(b2), "%.1f %u/%u%s", targetC,
+                                                           (unsigned)profile_seen_step + 1, (unsigned)profileRunner.segmentCount(),
+                                                           profile_seen_paused ? " " LV_SYMBOL_PAUSE : "");
+                        else snprintf(b2, sizeof(b2), "%.1f", targetC);
+                        lv_label_set_text(lbl_work_sp, b2); }
     if (lbl_work_pow) { char b3[24]; snprintf(b3, sizeof(b3), "%.1f", (double)ssr_power_0_255 * 100.0 / 255.0);
                         lv_label_set_text(lbl_work_pow, b3); }
+    if (lbl_work_aux) { char w[8] = "--", p[8] = "--", b4[24];
+                        if (!isnan(aux_temp_c[0])) snprintf(w, sizeof(w), "%.0f", aux_temp_c[0]);
+                        if (!isnan(aux_temp_c[1])) snprintf(p, sizeof(p), "%.0f", aux_temp_c[1]);
+                        snprintf(b4, sizeof(b4), "%s / %s", w, p); lv_label_set_text(lbl_work_aux, b4); }
 
   } else if (state == STATE_CALIBRATE_SENSOR) {
     tickCalibration();
 
   } else if (state == STATE_AUTOTUNE_PID) {
     tickAutotune();
-    ssrApply();
 
   } else if (state == STATE_TOUCH_CALIBRATE) {
     tickTouchCalib();
 
   } else if (state == STATE_MANUAL) {
-    float pv = readTemperatureC();
-    lastTemperatureC = pv;                                                // Modified: сохраняем температуру для веба
-
-    if (heating) {
-      ssr_power_0_255 = pid.compute(pv);
-    } else {
-      ssr_power_0_255 = 0;
-      digitalWrite(SSR_CONTROL_PIN, LOW);
-    }
-    ssrApply();
+    const float pv = lastTemperatureC;
 
     if (lbl_man_cur) { char b1[24]; snprintf(b1, sizeof(b1), "%.1f", pv);          lv_label_set_text(lbl_man_cur, b1); }
     if (lbl_man_sp)  { char b2[24]; snprintf(b2, sizeof(b2), "%.1f", getTargetC()); lv_label_set_text(lbl_man_sp,  b2); }
   }
+  TR_PHASE_NEXT(lap, kScreen);
   WebInterface::instance().updateTelemetry(*this);                        // Modified: сообщаем веб-интерфейсу обновления
+  TR_PHASE_NEXT(lap, kTelemetry);
 }
 
 String TempRegulator::describeStateForWeb() const {                        // Modified: возвращаем строку состояния
@@ -2342,14 +2983,17 @@ void TempRegulator::do_reset_touch(){
 }
 void TempRegulator::do_reset_tc(){
   isCalibrated = false; offset = 0.0f; slope  = 1.0f;
+  resetEmfCalibration();
+  updateThermoFixed();
   saveNVS();
 
   onEnterSettings();
 }
 void TempRegulator::do_reset_pid(){
   pid_kp = 2.0; pid_ki = 5.0; pid_kd = 1.0;
+  resetGainSchedule();
   saveNVS();
-  if (state == STATE_WORK || state == STATE_MANUAL) pid.setCoeffs(pid_kp, pid_ki, pid_kd);
+  if (state == STATE_WORK || state == STATE_MANUAL) { ControlScheduler::Lock lock; pid.setCoeffs(pid_kp, pid_ki, pid_kd); }
 
   onEnterSettings();
 }
@@ -2366,7 +3010,10 @@ void TempRegulator::clearNVS() {
   }
 
   isCalibrated = false; offset = 0.0f; slope = 1.0f;
+  resetEmfCalibration();
+  updateThermoFixed();
   pid_kp = 2.0; pid_ki = 5.0; pid_kd = 1.0;
+  resetGainSchedule();
 
   resetTouchCalibrationToDefaults();
 
@@ -3,11 +3,33 @@
 #include <lvgl.h>                                                         // Основные определения LVGL (виджеты, события)
 //
 #include <array>                                                          // std::array для фиксированных наборов профилей
+#include <atomic>                                                         // Отложенная авария из задачи регулятора
+#include <math.h>                                                         // NAN для отсутствующих каналов
 #include <vector>                                                         // Используем std::vector для хранения списков значений
 //
+#include "AdaptivePid.h"                                                 // Подстройка PID под загрузку в работе
+#include "OvershootShaper.h"                                             // Упреждение перерегулирования перед выдержкой
+#include "AdcSampler.h"                                                  // Фоновая выборка АЦП термопары
+#include "AutotuneSession.h"                                             // Сеанс автонастройки PID (реле или ступенька)
+#include "CalibrationWizard.h"                                           // Мастер калибровки термопары по двум точкам
+#include "ColdJunction.h"                                                // Температура холодного спая
+#include "ControlScheduler.h"                                            // Фиксированный шаг контура регулирования
+#include "GainSchedule.h"                                                // Коэффициенты PID по температуре
 #include "PIDController.h"                                               // Класс PID-регулятора
+#include "ProfileRunner.h"                                               // Выполнение ступеней профиля
+#include "RelayAutotune.h"                                               // Релейная автонастройка PID
+#include "SafetyMonitor.h"                                               // Аварии датчика и нагревателя
+#include "SampleRateScheduler.h"                                         // Адаптивная частота выборки АЦП
+#include "SensorHealth.h"                                                // Статистика исправности термопары
+#include "SpiThermocouple.h"                                             // SPI-усилитель термопары на шине дисплея
+#include "SsrFeedback.h"                                                 // Контроль SSR по входу обратной связи
+#include "StepIdentifier.h"                                              // Модель печи по ступеньке мощности
+#include "SsrOutput.h"                                                   // Аппаратная модуляция выхода SSR
+#include "TemperatureEstimator.h"                                        // Фильтр Калмана: температура и скорость роста
 #include "TemperatureProfile.h"                                          // Температурные профили, загружаемые из NVS
+#include "ThermocoupleTables.h"                                          // Таблицы линеаризации NIST
 #include "TouchCalibration.h"                                            // Общие определения калибровки тачскрина
+#include "WorkLoop.h"                                                    // Шаг рабочего режима (общий с моделью печи)
 
 class WebInterface;                                                       // Modified: предварительное объявление веб-интерфейса
 
@@ -51,22 +73,12 @@ enum Event : uint8_t {                                                    // С
   EVENT_TO_MANUAL                                                         // Перейти в ручной режим
 };                                                                        // Конец перечисления Event
 //
-enum CalibState : uint8_t {                                               // Состояния мастера калибровки термопары
-  CAL_IDLE = 0,                                                           // Ожидание
-  CAL_STEP1_INPUT_AMBIENT,                                                // Пользователь вводит температуру окружающей среды
-  CAL_STEP1_MEASURE,                                                      // Считываем данные в первом шаге
-  CAL_STEP2_WAIT_STABLE,                                                  // Ожидаем стабилизацию второй точки
-  CAL_STEP2_MEASURE,                                                      // Измеряем вторую точку
-  CALC_COEFFS,                                                            // Расчёт коэффициентов
-  CAL_DONE,                                                               // Калибровка завершена успешно
-  CAL_ERROR                                                               // Ошибка калибровки
-};                                                                        // Конец перечисления CalibState
-//
 enum AtState : uint8_t {                                                  // Состояния автомата автонастройки PID
   AT_IDLE = 0,                                                            // Простой
   AT_SETUP_TARGET,                                                        // Выбор целевой температуры
   AT_CONFIRM,                                                             // Подтверждение запуска
   AT_RUNNING,                                                             // Выполнение алгоритма автонастройки
+  AT_PREVIEW,                                                             // Колебания установились: выбор правила до сохранения
   AT_DONE,                                                                // Завершение с успешными коэффициентами
   AT_ABORT,                                                               // Принудительное прерывание
   AT_ERROR                                                                // Ошибка автонастройки
@@ -95,7 +107,8 @@ public:                                                                   // П
   void createPidCoeffsMenu();                                             // Редактор коэффициентов PID
   void createThermoCoeffsMenu();                                          // Редактор коэффициентов термопары
   void createResetMenu();                                                 // Создать экран сбросов
-  void adjustPidCoeffByIndex(int idx, double delta);                      // Изменить коэффициент PID (UI)
+  void adjustPidCoeffByIndex(int idx, double delta);                      // Изменить коэффициент PID или температуру точки (3) (UI)
+  void selectPidEditPoint(int delta);                                     // Выбрать редактируемый набор: общий или точка таблицы (UI)
   void adjustThermoCoeffByIndex(int idx, float delta);                    // Изменить коэффициент термопары (UI)
   void resetPidCoeffsToDefaults();                                        // Сброс коэффициентов PID (UI)
   void resetThermoCoeffsToDefaults();                                     // Сброс коэффициентов термопары (UI)
@@ -106,6 +119,7 @@ public:                                                                   // П
   void createAtSetup();                                                   // Создать экран выбора цели автонастройки
   void createAtConfirm();                                                 // Создать экран подтверждения автонастройки
   void createAtRun();                                                     // Создать экран хода автонастройки
+  void createAtResult();                                                  // Экран результата: правило и коэффициенты до сохранения
   void createTouchCalib();                                                // Создать экран калибровки тача
   void createTouchTest();                                                 // Создать экран теста тача
   void createSplash();                                                    // Создать заставку при старте
@@ -114,7 +128,16 @@ public:                                                                   // П
   void onEnterManual();                                                   // Логика при входе в ручной режим
 //
   void handleProfileSelection(lv_obj_t* target);                          // Обработка нажатия на профиль
+  float getWallTemperatureC() const { return aux_temp_c[0]; }             // Температура стенки камеры (NAN — нет канала)
+  float getSafetyTemperatureC() const { return aux_temp_c[1]; }           // Температура защитного датчика (NAN — нет канала)
   float getLastTemperatureC() const { return lastTemperatureC; }          // Modified: последняя измеренная температура
+  uint16_t getAdcRateHz() const { return tcSampler.periodUs() ? 1000000UL / tcSampler.periodUs() : 0; } // Текущая частота выборки канала, Гц
+  const SensorHealth& getSensorHealth() const { return tcHealth; }        // Статистика исправности термопары
+  ControlScheduler::Stats getControlStats() const { return control.stats(); }  // Джиттер и время шага регулятора
+  const SsrFeedback& getSsrFeedback() const { return ssrFeedback; }       // Обратная связь SSR (enabled() — подключена)
+  uint32_t getHeaterOnSeconds() const;                                    // Время работы нагревателя на полной мощности, с
+  float getHeaterEnergyWh() const;                                        // Энергия нагревателя, Вт·ч (NAN — мощность не задана)
+  const AdaptivePid& getAdaptivePid() const { return adaptive; }          // Подстройка PID в работе (retunes() — шагов с пуска)
   int getActiveProfileIndex() const {                                      // Modified: индекс активного профиля (1..10)
     return (activeProfileIndex >= 0) ? (activeProfileIndex + 1) : 0;
   }
@@ -126,23 +149,20 @@ public:                                                                   // П
   lv_obj_t* lbl_work_cur = nullptr;                                       // Метка текущей температуры на рабочем экране
   lv_obj_t* lbl_work_sp = nullptr;                                        // Метка заданной температуры на рабочем экране
   lv_obj_t* lbl_work_pow = nullptr;                                       // Метка мощности нагрева на рабочем экране
+  lv_obj_t* lbl_work_aux = nullptr;                                       // Метка температур стенки и защитного датчика
 //
   lv_obj_t* lbl_cal_val = nullptr;                                        // Метка значения АЦП в процессе калибровки
   lv_obj_t* btn_ok = nullptr;                                             // Кнопка подтверждения в диалогах калибровки
   lv_obj_t* lbl_pid_kp_val = nullptr;                                     // Значение коэффициента Kp в UI
   lv_obj_t* lbl_pid_ki_val = nullptr;                                     // Значение коэффициента Ki в UI
   lv_obj_t* lbl_pid_kd_val = nullptr;                                     // Значение коэффициента Kd в UI
+  lv_obj_t* lbl_pid_set_val = nullptr;                                    // Редактируемый набор PID в UI
+  lv_obj_t* lbl_pid_t_val = nullptr;                                      // Температура точки таблицы PID в UI
   lv_obj_t* lbl_tc_kl_val = nullptr;                                      // Значение коэффициента Kl в UI
   lv_obj_t* lbl_tc_kc_val = nullptr;                                      // Значение коэффициента Kc в UI
 //
-  CalibState cst = CAL_IDLE;                                              // Текущее состояние мастера калибровки
-  float     cal_temp1 = 25.0f;                                            // Первая эталонная температура
-  float     cal_temp2 = 100.0f;                                           // Вторая эталонная температура
-  uint32_t  cal_t0 = 0;                                                   // Таймстамп начала шага калибровки
-  uint32_t  stable_t0 = 0;                                                // Таймстамп начала стабильного интервала
-  bool      stable = false;                                               // Флаг устойчивости показаний
-  uint16_t  cal_adc1 = 0;                                                 // Значение АЦП в первой точке
-  uint16_t  cal_adc2 = 0;                                                 // Значение АЦП во второй точке
+  CalibrationWizard calib;                                                // Шаги мастера калибровки термопары
+  float     cal_temp1 = 25.0f;                                            // Температура окружающей среды, вводимая на первом шаге
 //
   bool hasAlarm() const { return alarm_active; }                          // Проверка активной аварии
   void clearAlarm();                                                      // Сброс аварийного состояния
@@ -163,6 +183,7 @@ public:                                                                   // П
   void onEnterWork();                                                     // При переходе в рабочий режим
   void onEnterCalib();                                                    // При запуске калибровки
   void onEnterAutotune();                                                 // При запуске автонастройки
+  void setState(State next);                                              // Смена состояния под захватом регулятора
   void onEnterAlarm(const char* text);                                    // При появлении аварии
   void onEnterTouchCalib();                                               // При запуске калибровки тача
   void onEnterTouchTest();                                                // При запуске теста тача
@@ -174,23 +195,81 @@ public:                                                                   // П
   void  adjustTargetC(float delta);                                       // Изменить уставку на указанную величину
 //
   void startAutotune();                                                   // Запустить процедуру автонастройки PID
+  void selectAutotuneMethod();                                            // Переключить способ на экране настройки
+  void selectAutotuneRule(int delta);                                     // Сменить правило на экране результата
+  void commitAutotune(bool save);                                         // Сохранить коэффициенты выбранного правила или отказаться
+  void saveAdaptedGains();                                                // Перенести подстроенные коэффициенты в профиль или общие
 //
 private:                                                                  // Приватные поля и методы
   State state = STATE_INIT;                                               // Текущее состояние автомата
 //
   float   slope = 1.0f;                                                   // Коэффициент преобразования измерений
   float   offset = 0.0f;                                                  // Смещение измерений
-  uint8_t consecutive_outlier_cycles = 0;                                 // Количество подряд обнаруженных выбросов датчика
+  Q16     offset_q;                                                       // То же в фиксированной точке (горячий путь без soft-float)
+  Q24     slope_q = Q24(1);                                               // Наклон в фиксированной точке
+  tc::Type tc_type = tc::Type::K;                                         // Тип термопары (Linear — прежнее линейное преобразование)
+  float   emf_offset = 0.0f;                                              // АЦП -> ЭДС термопары: смещение, мкВ
+  float   emf_slope = 0.0f;                                               // АЦП -> ЭДС термопары: мкВ на единицу АЦП (0 — нет калибровки по ЭДС)
+  float   cjc_fixed = 25.0f;                                              // Температура холодного спая без датчика, °C
+  tc::EmfQ emf_offset_q;                                                  // emf_offset в фиксированной точке
+  Q16     emf_slope_q;                                                    // emf_slope в фиксированной точке
+  Q16     cj_temp_seen = Q16::min();                                      // Температура холодного спая, для которой посчитана cj_emf
+  tc::EmfQ cj_emf;                                                        // ЭДС холодного спая относительно 0 °C
+  ColdJunction coldJunction;                                              // Датчик холодного спая
+  SpiThermocouple spiTc;                                                  // SPI-усилитель термопары (вместо АЦП, если выбран)
+  uint8_t tc_source = 0;                                                  // Источник основной термопары: 0 — АЦП, 1 — MAX31855, 2 — MAX31856
+  AdcSampler tcSampler;                                                   // Фоновый сборщик отсчётов термопары
+  uint32_t   adc_frame_seen = 0;                                          // Номер последнего обработанного кадра сканера
+  int8_t     aux_channel[2] = {-1, -1};                                   // Каналы сканера: стенка камеры, защитный датчик
+  float      aux_offset[2] = {0.0f, 0.0f};                                // Калибровка дополнительных каналов: смещение
+  float      aux_slope[2] = {1.0f, 1.0f};                                 // Калибровка дополнительных каналов: наклон
+  Q16        aux_offset_q[2];                                             // То же в фиксированной точке
+  Q24        aux_slope_q[2] = {Q24(1), Q24(1)};                           // То же в фиксированной точке
+  float      aux_temp_c[2] = {NAN, NAN};                                  // Последние температуры дополнительных каналов (NAN — нет канала)
   bool    alarm_active = false;                                           // Признак активной аварии
+  SafetyMonitor safety;                                                   // Обрыв, выбросы, рост, SSR и защитный датчик
 //
   PIDController pid;                                                      // Встроенный PID-регулятор
   double pid_kp = 2.0;                                                    // Текущий коэффициент P
   double pid_ki = 5.0;                                                    // Текущий коэффициент I
   double pid_kd = 1.0;                                                    // Текущий коэффициент D
+  GainSchedule::Point pid_sched[GainSchedule::kMaxPoints] = {};           // Таблица PID по температуре (config.ini)
+  GainSchedule gainSchedule;                                              // Та же таблица, собранная для задачи регулятора
+  bool   gain_sched_on = false;                                           // Таблица действует в текущем режиме (профиль без своих PID)
+  int8_t pid_edit_point = -1;                                             // Редактируемый набор в меню: -1 — общий, иначе точка таблицы
+  AdaptivePid adaptive;                                                   // Подстройка коэффициентов под загрузку в работе
+  bool   pid_adapt = false;                                               // Подстройка включена (config.ini)
+  double work_kp = 0.0, work_ki = 0.0, work_kd = 0.0;                     // Коэффициенты, с которых начата работа
+  bool   work_pid_profile = false;                                        // Они взяты из профиля (иначе — общие)
+  bool   adapt_seen_running = false;                                      // Ход подстройки, уже показанный в UI
+  uint16_t adapt_seen_retunes = 0;                                        // Подстройки, уже записанные в журнал
+  Q16    measuredQ;                                                       // Последнее измерение до оценщика (вход подстройки)
+  OvershootShaper shaper;                                                 // Снятие мощности до выдержки по модели печи
+  bool   shaper_on = false;                                               // Формирование включено (config.ini)
+  StepIdentifier::Model shaper_manual{};                                  // Модель печи из config.ini (valid — задана)
+  Q16    targetQ;                                                         // Уставка поддержания в Q16 (цель формирования)
+  TemperatureEstimator estimator;                                         // Оценка температуры и скорости роста для PID и аварий
+  SampleRateScheduler sampleRate;                                         // Частота выборки АЦП по скорости роста и ошибке
+  SensorHealth tcHealth;                                                  // Шум, выбросы, дрейф и скачки термопары
   float  targetC = 210.0f;                                                // Заданная температура по умолчанию
   int    ssr_power_0_255 = 0;                                             // Мощность нагрева в диапазоне 0-255
-  uint32_t ssr_window_start = 0;                                          // Время начала текущего окна ШИМ SSR
+  SsrOutput ssr;                                                          // Выход SSR, модулируемый таймером
+  uint8_t ssr_mode = 0;                                                   // Способ модуляции SSR (SsrOutput::Mode)
+  SsrFeedback ssrFeedback;                                                // Сравнение команды SSR с током нагрузки
+  uint8_t ssr_feedback = 0;                                               // Вход обратной связи: 0 — нет, 1 — активный низкий, 2 — активный высокий
+  uint16_t heater_w = 0;                                                  // Номинальная мощность нагревателя, Вт (0 — не задана)
+  uint8_t adc_mode = 0;                                                   // Режим выборки АЦП (AdcSampler::Mode)
+  uint8_t mains_hz = 50;                                                  // Частота сети для интегрирования, Гц
+  bool   adc_ssr_sync = false;                                            // Синхронизация окна АЦП с фронтами SSR
   float    lastTemperatureC = 0.0f;                                       // Modified: последняя измеренная температура
+  ControlScheduler control;                                               // Задача фиксированного шага регулятора
+  uint16_t control_period_ms = ControlScheduler::kDefaultPeriodMs;        // Период регулятора, мс (config.ini)
+  std::atomic<const char*> pending_alarm{nullptr};                        // Авария из задачи регулятора, ждёт показа в UI
+  ProfileRunner profileRunner;                                            // Ступени активного профиля и их уставка
+  WorkLoop workLoop{pid, gainSchedule, profileRunner, shaper, adaptive};  // Звенья рабочего режима в порядке задачи регулятора
+  bool     profile_seen_running = false;                                  // Ход профиля, уже показанный в UI и вебе
+  bool     profile_seen_paused = false;                                   // Пауза выдержки, уже показанная в UI и вебе
+  uint8_t  profile_seen_step = 0;                                         // Ступень, уже показанная в UI и вебе
 
   std::array<TemperatureProfile, kTemperatureProfileCount> profiles{};   // Профили, считанные из NVS
   lv_obj_t* profileButtons[kTemperatureProfileCount]{};                  // Кнопки профилей на экране списка
@@ -210,17 +289,17 @@ private:                                                                  // П
   SplashImageDescriptor splash_img_dsc{};                                  // Описание изображения заставки
   std::vector<uint8_t> splash_img_buf;                                     // Буфер пикселей заставки (RGB565)
 //
-  uint32_t at_t0 = 0;                                                     // Время начала автонастройки
-  bool     relay_on = false;                                              // Текущее состояние реле/SSR
   float    relay_hyst = 2.0f;                                             // Гистерезис для управления нагревом
-  std::vector<uint32_t> peak_ts;                                          // Таймстампы обнаруженных пиков температуры
-  std::vector<float>    peak_val;                                         // Значения температурных пиков
-  bool was_above = false;                                                 // Флаг, что температура была выше цели
+  AutotuneSession atSession;                                              // Способ, ход, исход и правило автонастройки
   lv_obj_t* scr_at_setup = nullptr;                                       // Экран настройки автонастройки
   lv_obj_t* scr_at_confirm = nullptr;                                     // Экран подтверждения
   lv_obj_t* scr_at_run = nullptr;                                         // Экран выполнения
   lv_obj_t* lbl_at_cur = nullptr;                                         // Метка текущей температуры при автонастройке
   lv_obj_t* lbl_at_time = nullptr;                                        // Метка времени при автонастройке
+  lv_obj_t* lbl_at_info = nullptr;                                        // Переключения, период и амплитуда колебаний
+  lv_obj_t* lbl_at_rule = nullptr;                                        // Правило на экране результата
+  lv_obj_t* lbl_at_gains = nullptr;                                       // Коэффициенты выбранного правила
+  lv_obj_t* lbl_at_method = nullptr;                                      // Способ на экране настройки
 //
   TouchCalStep tcs = TCS_IDLE;                                            // Этап калибровки тачскрина
   lv_obj_t* scr_tcal = nullptr;                                           // Экран калибровки тача
@@ -235,11 +314,33 @@ private:                                                                  // П
 //
   void saveNVS();                                                         // Сохранение конфигурации в хранилище
   bool loadNVS();                                                         // Загрузка конфигурации из хранилища
+  void applyAdcMode();                                                    // Применить режим выборки АЦП из настроек
 //
   uint16_t readAdcFiltered(uint8_t& out_outliers);                        // Чтение АЦП с фильтрацией выбросов
   float    readTemperatureC();                                            // Расчёт температуры в градусах Цельсия
+  Q16      readTemperatureQ();                                            // То же в фиксированной точке для PID
+  void     updateThermoFixed();                                           // Пересчитать offset_q/slope_q после изменения offset/slope
+  void     resetEmfCalibration();                                         // Забыть калибровку по ЭДС (вернуться к линейной)
+  void     pollAdcFrame();                                                // Обработать новый кадр сканера (доп. каналы, защита)
   void     beep(uint16_t ms = 50);                                        // Короткий звуковой сигнал
-  void     ssrApply();                                                    // Применение вычисленной мощности к SSR
+  void     ssrApply();                                                    // Передать вычисленную мощность модулятору SSR
+  Q16      estimateTemperatureQ();                                        // Измерение через оценщик (вызывать раз в цикл)
+  void     applyEstimatorTuning(const TemperatureProfile* profile);       // Настройка оценщика (nullptr — по умолчанию)
+  void     applyShaperModel(const TemperatureProfile* profile);           // Модель формирователя: профиля или из config.ini
+  void     checkRiseAlarms();                                             // Аварии по скорости роста при нагреве
+  void     raiseSafety(SafetyMonitor::Alarm a);                           // Авария по итогу проверки SafetyMonitor
+  void     updateSampleRate(bool reset);                                  // Подстроить частоту выборки (reset — номинальная)
+  void     controlTick();                                                 // Шаг задачи регулятора: сбор, оценка, PID, SSR
+  static void controlTickThunk(void* self);                               // Переходник для ControlScheduler
+  void     requestAlarm(const char* text, bool stop_heat);                // Авария из любой задачи; окно покажет update()
+  void     checkSsrFeedback();                                            // Аварии по обратной связи SSR
+  int      deliveredPower() const;                                        // Фактическая мощность 0..255 с учётом обратной связи
+  void     compileProfile(const TemperatureProfile& profile);             // Строки профиля в ProfileRunner
+  void     publishProfileProgress();                                      // Смена ступени и завершение профиля — в UI и веб
+  void     publishAdaptiveProgress();                                     // Журнал подстроек PID и предложение их сохранить
+  void     refreshGainSchedule();                                         // Пересобрать таблицу PID после изменения точек
+  void     resetGainSchedule();                                           // Очистить таблицу PID
+  bool     setGainSchedule(const GainSchedule::Point* points, uint8_t n); // Новая таблица PID (веб): проверка, запись, применение
 //
   static void cb_reset_touch(void* user);                                 // Обработчик кнопки сброса тача
   static void cb_reset_tc(void* user);                                    // Обработчик кнопки сброса термопары
@@ -248,11 +349,11 @@ private:                                                                  // П
   void startCalibration();                                                // Запуск процесса калибровки термопары
   void tickCalibration();                                                 // Один шаг логики калибровки
   void updateCalibStableUI(bool st);                                      // Обновление UI статуса стабильности
-  bool isCalibTimedOut() const;                                           // Проверка таймаута калибровки
   void saveCalibration(float off, float sl);                              // Сохранение вычисленных коэффициентов
 //
   void tickAutotune();                                                    // Шаг алгоритма автонастройки
   void finishAutotune(double kp, double ki, double kd);                   // Завершение автонастройки с сохранением коэффициентов
+  void refreshAtResult();                                                 // Обновить правило и коэффициенты на экране результата
 //
   void tickTouchCalib();                                                  // Обработка шага калибровки тача
   void tcal_next_target();                                                // Перейти к следующей точке
@@ -0,0 +1,59 @@
+#include "TemperatureEstimator.h"                                               // Объявление класса
+//
+void TemperatureEstimator::configure(double q, double r, double b) {            // Установившиеся коэффициенты Калмана
+  if (q <= 0.0) q = kDefaultProcessNoise;                                       // Нулевой шум модели заморозил бы коррекцию
+  if (r <= 0.0) r = kDefaultMeasureNoise;                                       // Нулевой шум измерения — чистый повтор входа
+  const double dt = kPeriodMs / 1000.0;                                         // Шаг модели, с
+  const double q00 = q * dt * dt * dt / 3.0;                                    // Дискретный шум: случайное блуждание скорости
+  const double q01 = q * dt * dt / 2.0;
+  const double q11 = q * dt;
+  double p00 = r, p01 = 0.0, p11 = q;                                           // Начальная ковариация
+  double k0 = 0.0, k1 = 0.0;                                                    // Коэффициенты усиления
+  for (int i = 0; i < 1000; ++i) {                                              // Итерации Риккати до сходимости
+    const double a00 = p00 + 2.0 * dt * p01 + dt * dt * p11 + q00;              // Прогноз ковариации F·P·Fᵀ + Q
+    const double a01 = p01 + dt * p11 + q01;
+    const double a11 = p11 + q11;
+    const double s = a00 + r;                                                   // Дисперсия невязки
+    const double n0 = a00 / s, n1 = a01 / s;                                    // Новые коэффициенты
+    p00 = (1.0 - n0) * a00;                                                     // Коррекция ковариации (I - K·H)·P
+    p01 = (1.0 - n0) * a01;
+    p11 = a11 - n1 * a01;
+    const bool done = (n0 - k0 < 1e-9 && k0 - n0 < 1e-9 && n1 - k1 < 1e-9 && k1 - n1 < 1e-9);
+    k0 = n0; k1 = n1;                                                           // Запоминаем
+    if (done) break;                                                            // Сошлось
+  }                                                                             // Конец итераций
+  k_t_ = Q16::fromDouble(k0);                                                   // В фиксированную точку
+  k_d_ = Q16::fromDouble(k1);
+  gain_per_unit_ = Q16::fromDouble(b / 255.0);                                  // Прирост на единицу мощности
+}                                                                               // Завершение configure
+//
+bool TemperatureEstimator::update(uint32_t now_ms, Q16 measured, int power_0_255) {  // Вызывается каждый цикл
+  if (!primed_) {                                                               // Первое измерение
+    t_ = measured;                                                              // Начинаем с показания
+    drift_ = Q16();                                                             // Скорость неизвестна
+    innov_ = Q16();                                                             // Невязки ещё нет
+    power_ = power_0_255;                                                       // Действующая мощность
+    last_ms_ = now_ms;                                                          // Отсчёт шагов
+    primed_ = true;                                                             // Готово
+    return true;                                                                // Оценка обновлена
+  }                                                                             // Конец инициализации
+  uint32_t steps = (now_ms - last_ms_) / kPeriodMs;                             // Целых шагов с прошлого раза
+  if (steps == 0) {                                                             // Шаг ещё не прошёл
+    power_ = power_0_255;                                                       // Запоминаем мощность на этот интервал
+    return false;                                                               // Оценка прежняя
+  }                                                                             // Конец проверки
+  last_ms_ += steps * kPeriodMs;                                                // Сохраняем дробный остаток
+  if (steps > kMaxCatchUpSteps) {                                               // Цикл надолго останавливался
+    primed_ = false;                                                            // Прогноз уже бесполезен
+    return update(now_ms, measured, power_0_255);                               // Начинаем с измерения
+  }                                                                             // Конец проверки разрыва
+  const Q16 rise = rate() * dt_;                                                // Прирост за шаг по модели
+  for (uint32_t i = 0; i < steps; ++i) {                                        // Прогноз на пропущенные шаги
+    t_ += rise;
+  }                                                                             // Конец прогноза
+  innov_ = measured - t_;                                                       // Невязка измерения
+  t_ += k_t_ * innov_;                                                          // Коррекция температуры
+  drift_ += k_d_ * innov_;                                                      // Коррекция скорости
+  power_ = power_0_255;                                                         // Мощность на следующий шаг
+  return true;                                                                  // Оценка обновлена
+}                                                                               // Завершение update
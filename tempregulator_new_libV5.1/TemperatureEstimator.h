@@ -0,0 +1,47 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "FixedPoint.h"                                                         // Q16
+//
+// Фильтр Калмана с двумя состояниями: температура T и скорость роста d, не
+// объяснённая нагревом (потери, дрейф). Модель шага: T += dt * (b*u + d), где
+// u — мощность SSR 0..255, b — прирост °C/с на полной мощности. Мощность даёт
+// прогноз без запаздывания, измерение корректирует его, поэтому температура и
+// скорость получаются без шума медианного окна и без его задержки.
+//
+// Матрицы постоянны (шаг kPeriodMs фиксирован), поэтому установившиеся
+// коэффициенты усиления считаются один раз в configure() решением уравнения
+// Риккати в double, а горячий путь update() выполняет только операции Q16.
+class TemperatureEstimator {                                                    // Оценщик температуры и скорости роста
+public:                                                                         // Публичный интерфейс
+  static constexpr uint32_t kPeriodMs = 100;                                    // Шаг модели, мс
+  static constexpr uint8_t  kMaxCatchUpSteps = 10;                              // Больший разрыв — начинаем заново
+//
+  static constexpr double kDefaultProcessNoise = 0.01;                          // q: спектральная плотность дрейфа, (°C/с)²/с
+  static constexpr double kDefaultMeasureNoise = 0.25;                          // r: дисперсия измерения, °C²
+  static constexpr double kDefaultPowerGain    = 0.0;                           // b: °C/с на полной мощности (0 — без модели нагрева)
+//
+  void configure(double q, double r, double b);                                 // Пересчёт коэффициентов (вне горячего пути)
+  void reset() { primed_ = false; }                                             // Начать с следующего измерения
+  bool update(uint32_t now_ms, Q16 measured, int power_0_255);                  // Шаги модели и коррекция; true — был шаг
+//
+  bool primed() const { return primed_; }                                       // Получено первое измерение
+  Q16  temperature() const { return t_; }                                       // Оценка температуры, °C
+  Q16  rate() const { return drift_ + mulInt<16>(gain_per_unit_, power_); }     // Оценка скорости роста, °C/с
+  Q16  innovation() const { return innov_; }                                    // Невязка последней коррекции (измерение − прогноз), °C
+  Q16  gainT() const { return k_t_; }                                           // Установившийся коэффициент по температуре
+  Q16  gainRate() const { return k_d_; }                                        // Установившийся коэффициент по скорости, 1/с
+//
+private:                                                                        // Внутреннее состояние
+  Q16      t_;                                                                  // Температура, °C
+  Q16      drift_;                                                              // Скорость, не объяснённая нагревом, °C/с
+  Q16      innov_;                                                              // Невязка последней коррекции, °C
+  Q16      k_t_ = Q16::fromRatio(1, 2);                                         // Усиление коррекции температуры
+  Q16      k_d_;                                                                // Усиление коррекции скорости, 1/с
+  Q16      dt_ = Q16::fromRatio(kPeriodMs, 1000);                               // Шаг модели, с
+  Q16      gain_per_unit_;                                                      // b/255: °C/с на единицу мощности
+  int32_t  power_ = 0;                                                          // Мощность, действовавшая на последнем шаге
+  uint32_t last_ms_ = 0;                                                        // Время последнего шага
+  bool     primed_ = false;                                                     // Состояние инициализировано
+};                                                                              // Конец определения класса TemperatureEstimator
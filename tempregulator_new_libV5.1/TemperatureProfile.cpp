@@ -1,5 +1,6 @@
 #include "TemperatureProfile.h"                                           // подключаем объявление класса профиля
 #include <Preferences.h>                                                  // используем NVS для сохранения профилей
+#include "EventTrace.h"                                                   // чтение NVS — участок трассы
 
 namespace {                                                               // внутренние вспомогательные структуры
 
@@ -31,6 +32,7 @@ void resetRowsInPrefs(Preferences& prefs) {                               // з
     prefs.putFloat((baseKey + "rStartTemp").c_str(), 0.0f);
     prefs.putFloat((baseKey + "rEndTemp").c_str(),   0.0f);
     prefs.putFloat((baseKey + "rTime").c_str(),      0.0f);
+    prefs.putFloat((baseKey + "rBand").c_str(),      0.0f);
   }
 }
 
@@ -51,6 +53,14 @@ void writeProfileDefaults(const DefaultProfileDefinition& def) {          // з
     prefs.putDouble("rKd_PWM", 0.0);
     prefs.putDouble("rKl_TC", 1.0);
     prefs.putDouble("rKc_TC", 0.0);
+    prefs.putDouble("rKq_KF", 0.01);
+    prefs.putDouble("rKr_KF", 0.25);
+    prefs.putDouble("rKb_KF", 0.0);
+    prefs.putDouble("rBand_GS", 0.0);
+    prefs.putDouble("rWait_GS", 0.0);
+    prefs.putDouble("rKm_FO", 0.0);
+    prefs.putDouble("rTm_FO", 0.0);
+    prefs.putDouble("rLm_FO", 0.0);
     resetRowsInPrefs(prefs);
   }
 
@@ -80,6 +90,7 @@ void TemperatureProfile::setDefaultName(const String& name) {
 }
 
 bool TemperatureProfile::loadFromNVS() {
+  TR_TRACE_SCOPE(kProfileLoad, 0);   // чтение NVS может задержать цикл UI
   Preferences prefs;
 
   if (sNVSnamespace.isEmpty()) {
@@ -112,6 +123,14 @@ bool TemperatureProfile::loadFromNVS() {
   rKd_PWM = prefs.getDouble("rKd_PWM", rKd_PWM);
   rKl_TC  = prefs.getDouble("rKl_TC",  rKl_TC);
   rKc_TC  = prefs.getDouble("rKc_TC",  rKc_TC);
+  rKq_KF  = prefs.getDouble("rKq_KF",  rKq_KF);
+  rKr_KF  = prefs.getDouble("rKr_KF",  rKr_KF);
+  rKb_KF  = prefs.getDouble("rKb_KF",  rKb_KF);
+  rBand_GS = prefs.getDouble("rBand_GS", 0.0);
+  rWait_GS = prefs.getDouble("rWait_GS", 0.0);
+  rKm_FO  = prefs.getDouble("rKm_FO",  0.0);
+  rTm_FO  = prefs.getDouble("rTm_FO",  0.0);
+  rLm_FO  = prefs.getDouble("rLm_FO",  0.0);
 
   showInMenu      = prefs.getBool("visible", false);
   availableForWeb = prefs.getBool("isAvlablForWeb", showInMenu);
@@ -121,6 +140,7 @@ bool TemperatureProfile::loadFromNVS() {
     rows[i].rStartTemperature = prefs.getFloat((baseKey + "rStartTemp").c_str(), 0.0f);
     rows[i].rEndTemperature   = prefs.getFloat((baseKey + "rEndTemp").c_str(),   0.0f);
     rows[i].rTime             = prefs.getFloat((baseKey + "rTime").c_str(),      0.0f);
+    rows[i].rBand             = prefs.getFloat((baseKey + "rBand").c_str(),      0.0f);
 
     if (rows[i].rTime > 0.0f || rows[i].rStartTemperature != 0.0f || rows[i].rEndTemperature != 0.0f) {
       ++usedRows;
@@ -170,6 +190,7 @@ bool TemperatureProfile::saveToNVS(const String& name,
     prefs.putFloat((baseKey + "rStartTemp").c_str(), row.rStartTemperature);
     prefs.putFloat((baseKey + "rEndTemp").c_str(),   row.rEndTemperature);
     prefs.putFloat((baseKey + "rTime").c_str(),      row.rTime);
+    prefs.putFloat((baseKey + "rBand").c_str(),      row.rBand);
   }
 
   prefs.end();
@@ -181,10 +202,51 @@ bool TemperatureProfile::saveToNVS(const String& name,
 
 bool TemperatureProfile::clearInNVS() {
   TempProfileRow zeroRows[MAX_ROWS]{};
+  saveModelToNVS(0.0, 0.0, 0.0);
   // Сохраняем «пустой» профиль и одновременно локально обновляемся через loadFromNVS()
   return saveToNVS("", zeroRows, 0, false);
 }
 
+bool TemperatureProfile::saveModelToNVS(double gain, double tau_s, double dead_s) {
+  if (sNVSnamespace.isEmpty()) {
+    return false;
+  }
+
+  Preferences prefs;
+  if (!prefs.begin(sNVSnamespace.c_str(), false)) {
+    return false;
+  }
+  prefs.putDouble("rKm_FO", gain);
+  prefs.putDouble("rTm_FO", tau_s);
+  prefs.putDouble("rLm_FO", dead_s);
+  prefs.end();
+
+  rKm_FO = gain;
+  rTm_FO = tau_s;
+  rLm_FO = dead_s;
+  return true;
+}
+
+bool TemperatureProfile::savePidToNVS(double kp, double ki, double kd) {
+  if (sNVSnamespace.isEmpty()) {
+    return false;
+  }
+
+  Preferences prefs;
+  if (!prefs.begin(sNVSnamespace.c_str(), false)) {
+    return false;
+  }
+  prefs.putDouble("rKp_PWM", kp);
+  prefs.putDouble("rKi_PWM", ki);
+  prefs.putDouble("rKd_PWM", kd);
+  prefs.end();
+
+  rKp_PWM = kp;
+  rKi_PWM = ki;
+  rKd_PWM = kd;
+  return true;
+}
+
 bool TemperatureProfile::exportToJson(JsonDocument& doc) const {
   JsonObject obj = doc.to<JsonObject>();
   obj.clear();
@@ -196,17 +258,27 @@ bool TemperatureProfile::exportToJson(JsonDocument& doc) const {
   obj["rKd_PWM"] = rKd_PWM;
   obj["rKl_TC"]  = rKl_TC;
   obj["rKc_TC"]  = rKc_TC;
+  obj["rKq_KF"]  = rKq_KF;
+  obj["rKr_KF"]  = rKr_KF;
+  obj["rKb_KF"]  = rKb_KF;
+  obj["rBand_GS"] = rBand_GS;
+  obj["rWait_GS"] = rWait_GS;
+  obj["rKm_FO"]  = rKm_FO;
+  obj["rTm_FO"]  = rTm_FO;
+  obj["rLm_FO"]  = rLm_FO;
 
   JsonArray dataArr = obj.createNestedArray("data");
   for (int i = 0; i < MAX_ROWS; ++i) {
     JsonObject row = dataArr.createNestedObject();
-    char key1[6], key2[6], key3[6];
+    char key1[6], key2[6], key3[6], key4[6];
     snprintf(key1, sizeof(key1), "%d_1", i + 1);
     snprintf(key2, sizeof(key2), "%d_2", i + 1);
     snprintf(key3, sizeof(key3), "%d_3", i + 1);
+    snprintf(key4, sizeof(key4), "%d_4", i + 1);
     row[key1] = rows[i].rStartTemperature;
     row[key2] = rows[i].rEndTemperature;
     row[key3] = rows[i].rTime;
+    row[key4] = rows[i].rBand;
   }
 
   return true;
@@ -7,7 +7,8 @@
 struct TempProfileRow {
   float rStartTemperature = 0.0f;  // начальная температура ступени, °C
   float rEndTemperature   = 0.0f;  // конечная   температура ступени, °C
-  float rTime             = 0.0f;  // длительность ступени, мин (или сек — по вашей логике)
+  float rTime             = 0.0f;  // длительность ступени, мин
+  float rBand             = 0.0f;  // допуск гарантированной выдержки, °C (0 — общий допуск профиля)
 };
 
 class TemperatureProfile {
@@ -37,11 +38,24 @@ public:
   // Очистить профиль в NVS (обнулить имя/видимость/строки)
   bool clearInNVS();
 
+  // Сохранить модель печи, найденную по ступеньке мощности (см. StepIdentifier)
+  bool saveModelToNVS(double gain, double tau_s, double dead_s);
+
+  // Сохранить коэффициенты PID профиля (подстройка в работе, см. AdaptivePid)
+  bool savePidToNVS(double kp, double ki, double kd);
+
   // --- Экспорт/утилиты ---
   bool exportToJson(JsonDocument& doc) const;  // сериализация профиля в JSON
   bool hasPidCoefficients() const;             // есть ли ненулевые PID
+  bool hasModel() const { return rTm_FO > 0.0; } // есть ли модель печи
   const TempProfileRow& step(size_t idx) const;// доступ к строке профиля
   void resetRows();                             // локально обнулить строки
+  bool isAvailable() const { return available; }          // профиль пригоден для запуска
+  const String& name() const { return sNameProfile; }     // отображаемое имя
+  size_t stepCount() const { return usedRows; }           // число непустых ступеней
+  double kp() const { return rKp_PWM; }                   // PID профиля
+  double ki() const { return rKi_PWM; }
+  double kd() const { return rKd_PWM; }
 
   // --- Публичные поля/состояние (чтобы регулятор мог быстро читать) ---
   String sNVSnamespace;   // имя пространства NVS, где хранится профиль
@@ -54,6 +68,20 @@ public:
   double rKl_TC  = 1.0;  // коэффициент наклона/градуировки
   double rKc_TC  = 0.0;  // смещение, °C
 
+  // Настройка оценщика температуры (фильтр Калмана, см. TemperatureEstimator)
+  double rKq_KF  = 0.01; // шум модели: дрейф скорости, (°C/с)²/с
+  double rKr_KF  = 0.25; // шум измерения: дисперсия, °C²
+  double rKb_KF  = 0.0;  // прирост на полной мощности, °C/с (0 — без модели нагрева)
+
+  // Гарантированная выдержка (см. ProfileRunner): часы ступени идут только в допуске
+  double rBand_GS = 0.0; // общий допуск ступеней, °C (0 — выключено)
+  double rWait_GS = 0.0; // наибольшее ожидание входа в допуск за ступень, мин (0 — без аварии)
+
+  // Модель печи K·e^(−θs)/(τs + 1) по ступеньке мощности (см. StepIdentifier)
+  double rKm_FO = 0.0;   // усиление, °C на единицу выхода 0..255
+  double rTm_FO = 0.0;   // постоянная времени τ, с (0 — модели нет)
+  double rLm_FO = 0.0;   // запаздывание θ, с
+
   bool  available       = false; // профиль пригоден для локального UI
   bool  availableForWeb = false; // отображать в веб-интерфейсе
   bool  showInMenu      = false; // отображать в локальном меню/списке
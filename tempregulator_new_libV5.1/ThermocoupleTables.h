@@ -0,0 +1,197 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stddef.h>                                                             // size_t
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+#include <array>                                                                // std::array для constexpr-таблиц
+//
+#include "FixedPoint.h"                                                         // Q16 и Fixed<8>
+//
+// Линеаризация термопар по NIST ITS-90. Таблицы ЭДС на равномерной сетке
+// температур строятся при компиляции из прямых полиномов NIST (включая
+// экспоненциальный член типа K), поэтому во время работы на один отсчёт
+// приходится двоичный поиск по таблице и одна линейная интерполяция — без
+// вычисления полиномов и без плавающей точки.
+namespace tc {                                                                  // Пространство имён термопар
+//
+enum class Type : uint8_t {                                                     // Тип датчика
+  Linear = 0,                                                                   // Прежнее линейное преобразование offset + slope*АЦП
+  K = 1,                                                                        // Хромель-алюмель
+  J = 2,                                                                        // Железо-константан
+};                                                                              // Конец перечисления Type
+//
+using EmfQ = Fixed<8>;                                                          // ЭДС в мкВ, Q23.8 (диапазон с запасом до ±8 В)
+//
+namespace detail {                                                              // Вычисления времени компиляции
+//
+constexpr double cexp(double x) {                                               // exp(x) для constexpr (std::exp не constexpr в C++17)
+  int halvings = 0;                                                             // Сколько раз делили аргумент пополам
+  while (x > 0.5 || x < -0.5) {                                                 // Сводим к |x| <= 0.5
+    x *= 0.5;                                                                   // Делим аргумент
+    ++halvings;                                                                 // Запоминаем
+  }                                                                             // Конец сведения
+  double term = 1.0, sum = 1.0;                                                 // Ряд Тейлора
+  for (int n = 1; n < 24; ++n) {                                                // 24 члена — точность double
+    term *= x / n;                                                              // Очередной член
+    sum += term;                                                                // Накопление
+  }                                                                             // Конец ряда
+  while (halvings-- > 0) {                                                      // exp(2x) = exp(x)^2
+    sum *= sum;                                                                 // Возводим в квадрат
+  }                                                                             // Конец восстановления
+  return sum;                                                                   // exp(x)
+}                                                                               // Конец cexp
+//
+template <size_t N>                                                             // Число коэффициентов
+constexpr double poly(const double (&c)[N], double t) {                         // Полином по схеме Горнера
+  double acc = 0.0;                                                             // Аккумулятор
+  for (size_t i = N; i-- > 0;) {                                                // От старшего коэффициента к младшему
+    acc = acc * t + c[i];                                                       // Шаг Горнера
+  }                                                                             // Конец цикла
+  return acc;                                                                   // Значение полинома
+}                                                                               // Конец poly
+//
+// Коэффициенты NIST ITS-90: E(мВ) = sum c_i * t^i, t в °C.
+constexpr double kTypeKNeg[] = {                                                // Тип K, -270…0 °C
+  0.0, 0.394501280250e-01, 0.236223735980e-04, -0.328589067840e-06,
+  -0.499048287770e-08, -0.675090591730e-10, -0.574103274280e-12,
+  -0.310888728940e-14, -0.104516093650e-16, -0.198892668780e-19,
+  -0.163226974860e-22 };
+constexpr double kTypeKPos[] = {                                                // Тип K, 0…1372 °C
+  -0.176004136860e-01, 0.389212049750e-01, 0.185587700320e-04,
+  -0.994575928740e-07, 0.318409457190e-09, -0.560728448890e-12,
+  0.560750590590e-15, -0.320207200030e-18, 0.971511471520e-22,
+  -0.121047212750e-25 };
+constexpr double kTypeKA0 = 0.118597600000e+00;                                 // Тип K: экспоненциальный член a0*exp(a1*(t-a2)^2)
+constexpr double kTypeKA1 = -0.118343200000e-03;
+constexpr double kTypeKA2 = 0.126968600000e+03;
+constexpr double kTypeJLow[] = {                                                // Тип J, -210…760 °C
+  0.0, 0.503811878150e-01, 0.304758369300e-04, -0.856810657200e-07,
+  0.132281952950e-09, -0.170529583370e-12, 0.209480906970e-15,
+  -0.125383953360e-18, 0.156317256970e-22 };
+constexpr double kTypeJHigh[] = {                                               // Тип J, 760…1200 °C
+  0.296456256810e+03, -0.149761277860e+01, 0.317871039240e-02,
+  -0.318476867010e-05, 0.157208190040e-08, -0.306913690560e-12 };
+//
+}  // namespace detail                                                          // Завершение detail
+//
+template <Type T> struct Spec;                                                  // Диапазон таблицы и прямая функция NIST для типа
+//
+template <> struct Spec<Type::K> {                                              // Тип K
+  static constexpr int kMinC  = -50;                                            // Нижняя граница таблицы, °C
+  static constexpr int kMaxC  = 1370;                                           // Верхняя граница таблицы, °C
+  static constexpr int kStepC = 10;                                             // Шаг сетки, °C (ошибка интерполяции < 0.05 °C)
+  static constexpr double emfUv(double t) {                                     // ЭДС NIST, мкВ
+    if (t < 0.0) return 1000.0 * detail::poly(detail::kTypeKNeg, t);            // Отрицательная ветвь
+    const double d = t - detail::kTypeKA2;                                      // Сдвиг экспоненциального члена
+    return 1000.0 * (detail::poly(detail::kTypeKPos, t) +
+                     detail::kTypeKA0 * detail::cexp(detail::kTypeKA1 * d * d)); // Положительная ветвь
+  }                                                                             // Конец emfUv
+};                                                                              // Конец Spec<K>
+//
+template <> struct Spec<Type::J> {                                              // Тип J
+  static constexpr int kMinC  = -50;                                            // Нижняя граница таблицы, °C
+  static constexpr int kMaxC  = 1200;                                           // Верхняя граница таблицы, °C
+  static constexpr int kStepC = 10;                                             // Шаг сетки, °C
+  static constexpr double emfUv(double t) {                                     // ЭДС NIST, мкВ
+    return 1000.0 * (t < 760.0 ? detail::poly(detail::kTypeJLow, t)
+                               : detail::poly(detail::kTypeJHigh, t));          // Две ветви полинома
+  }                                                                             // Конец emfUv
+};                                                                              // Конец Spec<J>
+//
+template <Type T>                                                               // Тип термопары
+class Table {                                                                   // Таблица ЭДС(T) на равномерной сетке
+  using S = Spec<T>;                                                            // Параметры типа
+//
+public:                                                                         // Публичный интерфейс
+  static constexpr size_t kSize = (S::kMaxC - S::kMinC) / S::kStepC + 1;        // Число узлов
+//
+  static constexpr int32_t emfAtNode(size_t i) { return kEmf[i]; }              // ЭДС узла, сырое Q8 мкВ
+  static constexpr int     tempAtNode(size_t i) { return S::kMinC + int(i) * S::kStepC; }  // Температура узла, °C
+//
+  static Q16 temperature(EmfQ e) {                                              // ЭДС -> температура (обратная интерполяция)
+    const int32_t v = e.raw();                                                  // Сырое значение, Q8 мкВ
+    size_t lo = 0, hi = kSize - 1;                                              // Ищем отрезок [lo, lo+1], содержащий v
+    while (hi - lo > 1) {                                                       // Двоичный поиск (~8 шагов)
+      const size_t mid = (lo + hi) / 2;                                         // Середина
+      if (kEmf[mid] <= v) lo = mid; else hi = mid;                              // Сужаем отрезок
+    }                                                                           // За пределами таблицы — экстраполяция крайним отрезком
+    const int64_t de = int64_t(kEmf[lo + 1]) - kEmf[lo];                        // Приращение ЭДС на отрезке (> 0)
+    const int64_t num = (int64_t(v) - kEmf[lo]) * (int64_t(S::kStepC) * 65536);  // Доля шага в Q16
+    return Q16::fromRaw(fixed_detail::sat32(int64_t(tempAtNode(lo)) * 65536 + num / de));  // Узел бывает ниже 0 °C: умножение, не сдвиг
+  }                                                                             // Конец temperature
+//
+  static EmfQ emf(Q16 t) {                                                      // Температура -> ЭДС (для холодного спая)
+    const int64_t rel = int64_t(t.raw()) - int64_t(S::kMinC) * 65536;           // Смещение от начала таблицы, Q16 (kMinC < 0)
+    const int64_t step = int64_t(S::kStepC) * 65536;                            // Шаг сетки, Q16
+    int64_t i = rel / step;                                                     // Номер отрезка
+    if (rel < 0) i = 0;                                                         // Ниже таблицы — первый отрезок
+    if (i > int64_t(kSize) - 2) i = kSize - 2;                                  // Выше таблицы — последний отрезок
+    const int64_t frac = rel - i * step;                                        // Положение внутри отрезка
+    const int64_t de = int64_t(kEmf[i + 1]) - kEmf[i];                          // Приращение ЭДС
+    return EmfQ::fromRaw(fixed_detail::sat32(kEmf[i] + de * frac / step));      // Линейная интерполяция
+  }                                                                             // Конец emf
+//
+private:                                                                        // Построение таблицы
+  static constexpr std::array<int32_t, kSize> build() {                         // Вычисляется компилятором
+    std::array<int32_t, kSize> out{};                                           // Результат
+    for (size_t i = 0; i < kSize; ++i) {                                        // Каждый узел сетки
+      const double uv = S::emfUv(tempAtNode(i));                                // ЭДС NIST, мкВ
+      out[i] = static_cast<int32_t>(uv * EmfQ::kOne + (uv >= 0 ? 0.5 : -0.5));  // В Q8 с округлением
+    }                                                                           // Конец цикла
+    return out;                                                                 // Готовая таблица
+  }                                                                             // Конец build
+//
+  static constexpr std::array<int32_t, kSize> kEmf = build();                   // Таблица во flash
+};                                                                              // Конец шаблона Table
+//
+// Сверка со справочными таблицами NIST (ЭДС в мкВ, округлённая до 1 мкВ).
+constexpr int32_t nodeUv(int32_t raw) { return (raw + (raw >= 0 ? 128 : -128)) / 256; }  // Q8 -> мкВ
+static_assert(nodeUv(Table<Type::K>::emfAtNode(0))  == -1889, "NIST K -50C");
+static_assert(nodeUv(Table<Type::K>::emfAtNode(5))  == 0,     "NIST K 0C");
+static_assert(nodeUv(Table<Type::K>::emfAtNode(15)) == 4096,  "NIST K 100C");
+static_assert(nodeUv(Table<Type::K>::emfAtNode(25)) == 8138,  "NIST K 200C");
+static_assert(nodeUv(Table<Type::K>::emfAtNode(55)) == 20644, "NIST K 500C");
+static_assert(nodeUv(Table<Type::K>::emfAtNode(105)) == 41276, "NIST K 1000C");
+static_assert(nodeUv(Table<Type::J>::emfAtNode(15)) == 5269,  "NIST J 100C");
+static_assert(nodeUv(Table<Type::J>::emfAtNode(55)) == 27393, "NIST J 500C");
+static_assert(nodeUv(Table<Type::J>::emfAtNode(105)) == 57953, "NIST J 1000C");
+//
+inline Q16 temperature(Type type, EmfQ e) {                                     // ЭДС горячего спая -> °C
+  switch (type) {                                                               // Выбор таблицы
+    case Type::J: return Table<Type::J>::temperature(e);                        // Тип J
+    default:      return Table<Type::K>::temperature(e);                        // Тип K
+  }                                                                             // Конец выбора
+}                                                                               // Конец temperature
+//
+inline EmfQ emf(Type type, Q16 t) {                                             // °C -> ЭДС относительно 0 °C
+  switch (type) {                                                               // Выбор таблицы
+    case Type::J: return Table<Type::J>::emf(t);                                // Тип J
+    default:      return Table<Type::K>::emf(t);                                // Тип K
+  }                                                                             // Конец выбора
+}                                                                               // Конец emf
+//
+struct Calibration {                                                            // Результат калибровки по двум точкам
+  float offset;                                                                 // Линейный режим: °C при АЦП = 0
+  float slope;                                                                  // Линейный режим: °C на единицу АЦП
+  float emf_offset;                                                             // Термопара: мкВ при АЦП = 0 (0 — не считалось)
+  float emf_slope;                                                              // Термопара: мкВ на единицу АЦП
+};                                                                              // Конец структуры Calibration
+//
+// Калибровка по двум точкам (adc1, t1) и (adc2, t2); cj1, cj2 — температура
+// холодного спая в момент каждого замера. Для термопары та же пара точек
+// пересчитывается в ЭДС: E(горячий) − E(холодный) линейна по АЦП. Проверку
+// разницы АЦП делает вызывающий — с ней связано сообщение на экране.
+inline Calibration calibrateTwoPoint(Type type, uint16_t adc1, float t1, float cj1,
+                                     uint16_t adc2, float t2, float cj2) {      // adc2 > adc1
+  Calibration c{};
+  c.slope = (t2 - t1) / float(adc2 - adc1);
+  c.offset = t1 - c.slope * float(adc1);
+  if (type != Type::Linear) {
+    const float e1 = (emf(type, Q16::fromDouble(t1)) - emf(type, Q16::fromDouble(cj1))).toFloat();
+    const float e2 = (emf(type, Q16::fromDouble(t2)) - emf(type, Q16::fromDouble(cj2))).toFloat();
+    c.emf_slope = (e2 - e1) / float(adc2 - adc1);
+    c.emf_offset = e1 - c.emf_slope * float(adc1);
+  }
+  return c;
+}                                                                               // Конец calibrateTwoPoint
+//
+}  // namespace tc                                                              // Завершение пространства имён tc
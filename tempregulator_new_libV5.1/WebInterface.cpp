@@ -7,6 +7,7 @@
 
 #include "TempRegulator.h"                                                 // Доступ к данным регулятора
 #include "TemperatureProfile.h"                                            // Работа с профилями
+#include "EventTrace.h"                                                    // Трассировка событий и снимок по HTTP
 
 // --------------------------------------------------------------------------------------
 // Singleton
@@ -45,6 +46,26 @@ void WebInterface::begin(TempRegulator* regulator) {
   server_.on("/NeedCalibration.jpg", HTTP_GET, [](AsyncWebServerRequest* request) {
     request->send(LittleFS, "/NeedCalibration.jpg", "image/jpeg");
   });
+#if TR_EVENT_TRACE
+  server_.on("/trace.bin", HTTP_GET, [](AsyncWebServerRequest* request) {   // Снимок трассы для tools/trace_to_chrome.py
+    const size_t cap = EventTrace::snapshotSize();
+    uint8_t* buf = static_cast<uint8_t*>(malloc(cap));
+    if (!buf) {
+      request->send(503, "text/plain", "No memory for trace snapshot");
+      return;
+    }
+    const size_t n = EventTrace::snapshot(buf, cap);
+    AsyncWebServerResponse* response = request->beginResponse(
+        "application/octet-stream", n, [buf, n](uint8_t* out, size_t maxLen, size_t index) -> size_t {
+          const size_t k = index + maxLen < n ? maxLen : n - index;
+          memcpy(out, buf + index, k);
+          return k;
+        });
+    request->onDisconnect([buf]() { free(buf); });   // снимок живёт до конца передачи
+    response->addHeader("Content-Disposition", "attachment; filename=trace.bin");
+    request->send(response);
+  });
+#endif
   server_.onNotFound([](AsyncWebServerRequest* request) {
     request->send(404, "text/plain", "Not found");
   });
@@ -59,8 +80,14 @@ void WebInterface::begin(TempRegulator* regulator) {
 }
 
 void WebInterface::loop() {
+  TR_PHASE_LAP(lap);
   socket_.loop();                      // Обслуживаем WebSocket
+  TR_PHASE_NEXT(lap, kSocket);
   broadcastTelemetry();                // Отправляем дифф телеметрии
+  TR_PHASE_NEXT(lap, kBroadcast);
+#if TR_PHASE_TIMING
+  broadcastPhases();                   // Сводка фаз — отдельным сообщением
+#endif
 }
 
 // --------------------------------------------------------------------------------------
@@ -68,6 +95,25 @@ void WebInterface::loop() {
 // --------------------------------------------------------------------------------------
 void WebInterface::updateTelemetry(const TempRegulator& regulator) {
   newActualTempC_ = regulator.getLastTemperatureC();
+  newWallTempC_   = regulator.getWallTemperatureC();
+  newSafetyTempC_ = regulator.getSafetyTemperatureC();
+  newAdcRateHz_   = regulator.getAdcRateHz();
+  const SensorHealth& health = regulator.getSensorHealth();
+  newTcNoiseC_      = health.noiseC();
+  newTcOutlierPct_  = health.outlierPct();
+  newTcDriftC_      = health.driftC();
+  newTcHealth_      = health.flags();
+  newCtlStats_      = regulator.getControlStats();
+  const SsrFeedback& fb = regulator.getSsrFeedback();
+  newSsrFbFlags_    = fb.enabled() ? fb.flags() : -1;
+  newSsrDutyPct_    = fb.deliveredPermille() / 10.0f;
+  newHeaterOnS_     = regulator.getHeaterOnSeconds();
+  newEnergyWh_      = regulator.getHeaterEnergyWh();
+  const AdaptivePid& ad = regulator.getAdaptivePid();
+  newAdaptRetunes_  = (ad.running() || ad.retunes()) ? ad.retunes() : -1;
+  newAdaptGains_[0] = ad.kp();
+  newAdaptGains_[1] = ad.ki();
+  newAdaptGains_[2] = ad.kd();
   newSeltemp_     = String(regulator.getTargetC(), 1);
   newActivprof_   = String(regulator.getActiveProfileIndex());
   newStateprofil_ = regulator.describeStateForWeb();
@@ -96,6 +142,20 @@ void WebInterface::noteProfileStop() {
   newTimestopprofil_ = "stop";
 }
 
+void WebInterface::noteProfileStep(uint8_t step, uint32_t ms) {
+  newNstupen_         = String(step);
+  newTimestartstupen_ = String(ms);
+  newTimestopstupen_  = "";
+}
+
+void WebInterface::noteProfileStepStop() {
+  newTimestopstupen_ = "stop";
+}
+
+void WebInterface::noteProfileStepPause() {
+  newTimestopstupen_ = "pause";
+}
+
 // --------------------------------------------------------------------------------------
 // WebSocket: обработчик событий
 // --------------------------------------------------------------------------------------
@@ -104,6 +164,7 @@ void WebInterface::handleWebSocketEvent(uint8_t client_num,
                                         uint8_t* payload,
                                         size_t length) {
   if (!self_) return;
+  TR_TRACE_SCOPE(kWsEvent, type);     // разбор и сохранение профиля — участок трассы
 
   switch (type) {
     case WStype_DISCONNECTED:
@@ -127,7 +188,7 @@ void WebInterface::handleWebSocketEvent(uint8_t client_num,
       }
 
       // JSON
-      DynamicJsonDocument doc(1024);
+      DynamicJsonDocument doc(2048);                                      // Профиль из 10 строк по 4 значения
       DeserializationError err = deserializeJson(doc, text);
       if (err) {
         Serial.printf("[WS] JSON parse error: %s\n", err.c_str());
@@ -151,6 +212,8 @@ void WebInterface::handleWebSocketEvent(uint8_t client_num,
         }
       } else if (event == "EmulSetting") {
         self_->processSettingsRequest(doc);
+      } else if (event == "PidSchedule") {
+        self_->processPidSchedule(doc);
       }
 
       self_->processDebugFlags(doc);
@@ -166,7 +229,7 @@ void WebInterface::handleWebSocketEvent(uint8_t client_num,
 // Формирование JSON профиля/настроек из NVS
 // --------------------------------------------------------------------------------------
 String WebInterface::ExportToJSON(const String& sNVSnamespace) {
-  DynamicJsonDocument doc(1024);
+  DynamicJsonDocument doc(2048);
 
   if (preferences.begin(sNVSnamespace.c_str(), true)) {
     doc["sNVSnamespace"]     = sNVSnamespace;
@@ -177,20 +240,30 @@ String WebInterface::ExportToJSON(const String& sNVSnamespace) {
     doc["rKd_PWM"]           = preferences.getDouble("rKd_PWM", 0.0);
     doc["rKl_TC"]            = preferences.getDouble("rKl_TC", 0.0);
     doc["rKc_TC"]            = preferences.getDouble("rKc_TC", 0.0);
+    doc["rKq_KF"]            = preferences.getDouble("rKq_KF", TemperatureEstimator::kDefaultProcessNoise);
+    doc["rKr_KF"]            = preferences.getDouble("rKr_KF", TemperatureEstimator::kDefaultMeasureNoise);
+    doc["rKb_KF"]            = preferences.getDouble("rKb_KF", TemperatureEstimator::kDefaultPowerGain);
+    doc["rBand_GS"]          = preferences.getDouble("rBand_GS", 0.0);
+    doc["rWait_GS"]          = preferences.getDouble("rWait_GS", 0.0);
+    doc["rKm_FO"]            = preferences.getDouble("rKm_FO", 0.0);
+    doc["rTm_FO"]            = preferences.getDouble("rTm_FO", 0.0);
+    doc["rLm_FO"]            = preferences.getDouble("rLm_FO", 0.0);
 
     JsonArray dataArr = doc.createNestedArray("data");
     for (int i = 0; i < 10; i++) {
       JsonObject row = dataArr.createNestedObject();
 
-      char key1[6], key2[6], key3[6];
+      char key1[6], key2[6], key3[6], key4[6];
       snprintf(key1, sizeof(key1), "%u_1", i + 1);
       snprintf(key2, sizeof(key2), "%u_2", i + 1);
       snprintf(key3, sizeof(key3), "%u_3", i + 1);
+      snprintf(key4, sizeof(key4), "%u_4", i + 1);
 
       const String baseKey = "row" + String(i) + "_";
       row[key1] = preferences.getFloat((baseKey + "rStartTemp").c_str(), 0.0f);
       row[key2] = preferences.getFloat((baseKey + "rEndTemp").c_str(),   0.0f);
       row[key3] = preferences.getFloat((baseKey + "rTime").c_str(),      0.0f);
+      row[key4] = preferences.getFloat((baseKey + "rBand").c_str(),      0.0f);
     }
 
     preferences.end();
@@ -237,7 +310,8 @@ void WebInterface::processInitDataToWeb() {
     }
   }
   const String DictEmulSeting = EmulSettingsToJSON("Settings");
-  DictProfSMS += "\"Settings\": " + DictEmulSeting + "}";
+  DictProfSMS += "\"Settings\": " + DictEmulSeting + ",";
+  DictProfSMS += "\"PidSchedule\": " + pidScheduleToJSON() + "}";
 
   Serial.println(DictProfSMS);
   socket_.broadcastTXT(DictProfSMS);
@@ -249,16 +323,21 @@ void WebInterface::processInitDataToWeb() {
 void WebInterface::SaveProfileDataToNVS(const String& sNVSnamespaceKey,
                                         const String& sProfileName,
                                         bool xIsAvailableForWeb,
-                                        TempProfileRow dataTempProfileRows[10]) {
+                                        TempProfileRow dataTempProfileRows[10],
+                                        double rBandGS,
+                                        double rWaitGS) {
   if (preferences.begin(sNVSnamespaceKey.c_str(), /*readOnly=*/false)) {
     preferences.putString("sNameProfile", sProfileName.c_str());
     preferences.putBool("isAvlablForWeb", xIsAvailableForWeb);
+    preferences.putDouble("rBand_GS", rBandGS);
+    preferences.putDouble("rWait_GS", rWaitGS);
 
     for (int i = 0; i < TemperatureProfile::MAX_ROWS; i++) {
       const String baseKey = "row" + String(i) + "_";
       preferences.putFloat((baseKey + "rStartTemp").c_str(), dataTempProfileRows[i].rStartTemperature);
       preferences.putFloat((baseKey + "rEndTemp").c_str(),   dataTempProfileRows[i].rEndTemperature);
       preferences.putFloat((baseKey + "rTime").c_str(),      dataTempProfileRows[i].rTime);
+      preferences.putFloat((baseKey + "rBand").c_str(),      dataTempProfileRows[i].rBand);
     }
 
     preferences.end();
@@ -276,6 +355,11 @@ void WebInterface::ClearProfileDataFromNVS(const String& sNVSnamespaceKey) {
     // Метаданные
     preferences.putString("sNameProfile", "");
     preferences.putBool("isAvlablForWeb", false);
+    preferences.putDouble("rBand_GS", 0.0);
+    preferences.putDouble("rWait_GS", 0.0);
+    preferences.putDouble("rKm_FO", 0.0);
+    preferences.putDouble("rTm_FO", 0.0);
+    preferences.putDouble("rLm_FO", 0.0);
 
     // Таблица значений профиля
     for (int i = 0; i < TemperatureProfile::MAX_ROWS; ++i) {
@@ -283,6 +367,7 @@ void WebInterface::ClearProfileDataFromNVS(const String& sNVSnamespaceKey) {
       preferences.putFloat((baseKey + "rStartTemp").c_str(), 0.0f);
       preferences.putFloat((baseKey + "rEndTemp").c_str(),   0.0f);
       preferences.putFloat((baseKey + "rTime").c_str(),      0.0f);
+      preferences.putFloat((baseKey + "rBand").c_str(),      0.0f);
     }
 
     preferences.end();
@@ -305,7 +390,7 @@ void WebInterface::ParseProfileDataFromWeb(uint8_t* payload, size_t length) {
   const String msg = String((const char*)payload).substring(0, length);
   if (msg.length() == 0) return;
 
-  DynamicJsonDocument doc(1024);
+  DynamicJsonDocument doc(2048);
   DeserializationError error = deserializeJson(doc, msg);
   if (error) {
     Serial.print(F("deserializeJson() failed: "));
@@ -319,18 +404,22 @@ void WebInterface::ParseProfileDataFromWeb(uint8_t* payload, size_t length) {
   const String sProfileName     = joTempProfileJSON["sNameProfile"].as<String>();
   const bool   xIsAvailableForWeb = joTempProfileJSON["isAvailableForWeb"].as<bool>();
   JsonArray jaTempProfileDataTable = joTempProfileJSON["data"];
+  const double rBandGS = joTempProfileJSON["rBand_GS"] | 0.0;           // Гарантированная выдержка
+  const double rWaitGS = joTempProfileJSON["rWait_GS"] | 0.0;
 
   for (size_t i = 0; i < jaTempProfileDataTable.size() && i < 10; i++) {
     JsonObject row = jaTempProfileDataTable[i];
 
-    char key1[6], key2[6], key3[6];
+    char key1[6], key2[6], key3[6], key4[6];
     snprintf(key1, sizeof(key1), "%u_1", i + 1);
     snprintf(key2, sizeof(key2), "%u_2", i + 1);
     snprintf(key3, sizeof(key3), "%u_3", i + 1);
+    snprintf(key4, sizeof(key4), "%u_4", i + 1);
 
     dataTempProfileRows[i].rStartTemperature = row[key1].as<float>();
     dataTempProfileRows[i].rEndTemperature   = row[key2].as<float>();
     dataTempProfileRows[i].rTime             = row[key3].as<float>();
+    dataTempProfileRows[i].rBand             = row[key4].as<float>();
   }
 
   // DEBUG
@@ -341,7 +430,7 @@ void WebInterface::ParseProfileDataFromWeb(uint8_t* payload, size_t length) {
     Serial.println(dataTempProfileRows[i].rTime);
   }
 
-  SaveProfileDataToNVS(sNVSnamespaceKey, sProfileName, xIsAvailableForWeb, dataTempProfileRows);
+  SaveProfileDataToNVS(sNVSnamespaceKey, sProfileName, xIsAvailableForWeb, dataTempProfileRows, rBandGS, rWaitGS);
 }
 
 // --------------------------------------------------------------------------------------
@@ -368,6 +457,48 @@ void WebInterface::processSettingsRequest(const JsonDocument& doc) {
   newActivprof_ = String(s.activProf);   // Чтобы фронт сразу увидел актуальный профиль
 }
 
+void WebInterface::processPidSchedule(const JsonDocument& doc) {
+  if (!regulator_) return;
+  JsonArrayConst arr = doc["points"].as<JsonArrayConst>();
+  if (!arr.isNull()) {                                                     // Без points — только запрос таблицы
+    GainSchedule::Point pts[GainSchedule::kMaxPoints] = {};
+    uint8_t n = 0;
+    for (JsonObjectConst o : arr) {
+      if (n >= GainSchedule::kMaxPoints) break;
+      pts[n].temp_c = o["t"]  | 0.0f;
+      pts[n].kp     = o["kp"] | 0.0f;
+      pts[n].ki     = o["ki"] | 0.0f;
+      pts[n].kd     = o["kd"] | 0.0f;
+      ++n;
+    }
+    if (!regulator_->setGainSchedule(pts, n)) {
+      Serial.println("[WS] PidSchedule rejected: negative coefficient");
+    }
+  }
+  const String msg = "{\"eventMessage\": \"PidSchedule\", \"PidSchedule\": " + pidScheduleToJSON() + "}";
+  socket_.broadcastTXT(msg);                                               // Все открытые страницы видят новую таблицу
+}
+
+String WebInterface::pidScheduleToJSON() const {
+  DynamicJsonDocument doc(512);
+  if (regulator_) {
+    doc["kp"] = regulator_->pid_kp;                                        // Общий набор — вне таблицы
+    doc["ki"] = regulator_->pid_ki;
+    doc["kd"] = regulator_->pid_kd;
+    JsonArray arr = doc.createNestedArray("points");
+    for (const GainSchedule::Point& p : regulator_->pid_sched) {
+      JsonObject o = arr.createNestedObject();
+      o["t"]  = p.temp_c;
+      o["kp"] = p.kp;
+      o["ki"] = p.ki;
+      o["kd"] = p.kd;
+    }
+  }
+  String jsonStr;
+  serializeJson(doc, jsonStr);
+  return jsonStr;
+}
+
 void WebInterface::processDebugFlags(const JsonDocument& doc) {
   if (doc.containsKey("profisAlarm"))         newProfisAlarm_        = doc["profisAlarm"].as<bool>();
   if (doc.containsKey("regisAlarm"))          newRegisAlarm_         = doc["regisAlarm"].as<bool>();
@@ -387,12 +518,37 @@ void WebInterface::broadcastTelemetry() {
   const String msg = buildDiffMessage();
   if (msg.isEmpty()) return;
 
+  TR_TRACE_SCOPE(kWsSend, msg.length());
   socket_.broadcastTXT(msg);
   Serial.printf("[WS] >> %s\n", msg.c_str());
 }
 
+#if TR_PHASE_TIMING
+void WebInterface::broadcastPhases() {
+  if (millis() - phasesSentMs_ < kPhasesPeriodMs) return;
+  phasesSentMs_ = millis();
+  if (socket_.connectedClients() == 0) return;
+
+  DynamicJsonDocument doc(1024);
+  JsonObject phases = doc.createNestedObject("phases");
+  for (uint8_t i = 0; i < PhaseTimer::kCount; ++i) {
+    const auto ph = static_cast<PhaseTimer::Phase>(i);
+    const PhaseTimer::Summary sm = PhaseTimer::summary(ph);
+    JsonArray row = phases.createNestedArray(PhaseTimer::name(ph));   // [замеров, мин, ср, макс, p99], мкс
+    row.add(sm.count);
+    row.add(sm.min_us);
+    row.add(sm.avg_us);
+    row.add(sm.max_us);
+    row.add(sm.p99_us);
+  }
+  String msg;
+  serializeJson(doc, msg);
+  socket_.broadcastTXT(msg);           // в Serial не печатаем: сводка идёт каждые 5 с
+}
+#endif
+
 String WebInterface::buildDiffMessage() {
-  DynamicJsonDocument diff(1024);
+  DynamicJsonDocument diff(1536);
   bool changed = false;
 
   if (profisAlarm_ != newProfisAlarm_) {
@@ -462,7 +618,82 @@ String WebInterface::buildDiffMessage() {
     changed = true;
   }
 
+  if (!isnan(newWallTempC_) && !(fabsf(wallTempC_ - newWallTempC_) <= 0.01f)) {
+    diff["walltemp"] = newWallTempC_;
+    wallTempC_ = newWallTempC_;
+    changed = true;
+  }
+
+  if (!isnan(newSafetyTempC_) && !(fabsf(safetyTempC_ - newSafetyTempC_) <= 0.01f)) {
+    diff["safetytemp"] = newSafetyTempC_;
+    safetyTempC_ = newSafetyTempC_;
+    changed = true;
+  }
+
+  if (adcRateHz_ != newAdcRateHz_) {
+    diff["adcrate"] = newAdcRateHz_;
+    adcRateHz_ = newAdcRateHz_;
+    changed = true;
+  }
+
+  if (tcHealth_ != newTcHealth_ || fabsf(tcNoiseC_ - newTcNoiseC_) > 0.01f ||
+      fabsf(tcOutlierPct_ - newTcOutlierPct_) > 0.1f || fabsf(tcDriftC_ - newTcDriftC_) > 0.05f) {
+    diff["tchealth"]   = newTcHealth_;
+    diff["tcnoise"]    = newTcNoiseC_;
+    diff["tcoutliers"] = newTcOutlierPct_;
+    diff["tcdrift"]    = newTcDriftC_;
+    tcHealth_     = newTcHealth_;
+    tcNoiseC_     = newTcNoiseC_;
+    tcOutlierPct_ = newTcOutlierPct_;
+    tcDriftC_     = newTcDriftC_;
+    changed = true;
+  }
+
+  if (newCtlStats_.steps != ctlStats_.steps && millis() - ctlSentMs_ >= 1000) {   // счётчики меняются каждый шаг — не чаще раза в секунду
+    JsonArray jitter = diff.createNestedArray("ctljitter");
+    JsonArray exec   = diff.createNestedArray("ctlexec");
+    for (uint8_t i = 0; i < ControlScheduler::kBins; ++i) {
+      jitter.add(newCtlStats_.jitter[i]);
+      exec.add(newCtlStats_.exec[i]);
+    }
+    JsonObject max = diff.createNestedObject("ctlmax");
+    max["period"]   = newCtlStats_.period_ms;
+    max["jitter"]   = newCtlStats_.max_jitter_us;
+    max["exec"]     = newCtlStats_.max_exec_us;
+    max["overruns"] = newCtlStats_.overruns;
+    ctlStats_ = newCtlStats_;
+    ctlSentMs_ = millis();
+    changed = true;
+  }
+
+  if (newSsrFbFlags_ >= 0 && (ssrFbFlags_ != newSsrFbFlags_ || fabsf(ssrDutyPct_ - newSsrDutyPct_) > 0.05f)) {
+    diff["ssrfb"]   = newSsrFbFlags_;
+    diff["ssrduty"] = newSsrDutyPct_;
+    ssrFbFlags_ = newSsrFbFlags_;
+    ssrDutyPct_ = newSsrDutyPct_;
+    changed = true;
+  }
+
+  if (heaterOnS_ != newHeaterOnS_) {
+    diff["heateron"] = newHeaterOnS_;
+    if (!isnan(newEnergyWh_)) diff["energy"] = newEnergyWh_;
+    heaterOnS_ = newHeaterOnS_;
+    energyWh_  = newEnergyWh_;
+    changed = true;
+  }
+
+  if (newAdaptRetunes_ >= 0 && adaptRetunes_ != newAdaptRetunes_) {   // коэффициенты меняются только на подстройке
+    diff["adapt"] = newAdaptRetunes_;
+    JsonArray g = diff.createNestedArray("adaptpid");
+    for (float v : newAdaptGains_) g.add(v);
+    adaptRetunes_ = newAdaptRetunes_;
+    changed = true;
+  }
+
   if (!changed) return String();
+  if (diff.containsKey("timestartprofil") || diff.containsKey("timestartstupen")) {
+    diff["uptime"] = millis();   // отметки старта — в millis() устройства, браузер пересчитывает их от своих часов
+  }
 
   String out;
   serializeJson(diff, out);
@@ -5,6 +5,9 @@
 #include <ESPAsyncWebServer.h>                                            // Modified: HTTP-сервер
 #include <WebSocketsServer.h>                                             // Modified: WebSocket сервер
 
+#include "ControlScheduler.h"                                             // Статистика шага регулятора
+#include "PhaseTimer.h"                                                   // Длительность фаз цикла
+
 class TempRegulator;                                                      // Modified: вперёд объявляем главный класс
 
 class WebInterface {                                                      // Modified: оболочка для работы с веб-интерфейсом
@@ -19,6 +22,9 @@ public:
   void setRegulatorAlarm(bool active, const String& message);             // Modified: сигнализация по регулятору
   void noteProfileStart(uint32_t ms);                                     // Modified: отметка старта профиля
   void noteProfileStop();                                                 // Modified: отметка остановки профиля
+  void noteProfileStep(uint8_t step, uint32_t ms);                        // Начало ступени: номер с 1 и millis() начала
+  void noteProfileStepStop();                                             // Ступени больше не выполняются
+  void noteProfileStepPause();                                            // Часы ступени стоят (вне допуска выдержки)
 
 private:
   WebInterface();                                                         // Modified: закрытый конструктор
@@ -33,9 +39,16 @@ private:
   void processDeleteRequest(const JsonDocument& doc);                     // Modified: удаляем профиль
   void processSettingsRequest(const JsonDocument& doc);                   // Modified: сохраняем настройки
   void processDebugFlags(const JsonDocument& doc);                        // Modified: обновляем отладочные флаги
+  void processPidSchedule(const JsonDocument& doc);                       // Таблица PID по температуре: запись и ответ всем клиентам
+  String pidScheduleToJSON() const;                                       // Таблица PID по температуре в JSON
 
   void broadcastTelemetry();                                              // Modified: собираем и отправляем телеметрию
   String buildDiffMessage();                                              // Modified: формируем JSON с изменениями
+#if TR_PHASE_TIMING
+  void broadcastPhases();                                                 // Сводка длительности фаз, раз в kPhasesPeriodMs
+  static constexpr uint32_t kPhasesPeriodMs = 5000;                       // Период отправки сводки фаз
+  uint32_t phasesSentMs_ = 0;                                             // Время последней отправки сводки фаз
+#endif
 
   TempRegulator* regulator_ = nullptr;                                    // Modified: ссылка на регулятор
   AsyncWebServer server_{80};                                             // Modified: HTTP-сервер для статики
@@ -67,6 +80,34 @@ private:
 
   float actualTempC_ = 0.0f;                                              // Modified: текущая измеренная температура
   float newActualTempC_ = 0.0f;                                           // Modified: новое измеренное значение
+  float wallTempC_ = NAN;                                                 // Температура стенки камеры (NAN — канала нет)
+  float newWallTempC_ = NAN;                                              // Новое значение стенки камеры
+  float safetyTempC_ = NAN;                                               // Температура защитного датчика
+  float newSafetyTempC_ = NAN;                                            // Новое значение защитного датчика
+  uint16_t adcRateHz_ = 0;                                                // Частота выборки АЦП термопары, Гц
+  uint16_t newAdcRateHz_ = 0;                                             // Новое значение частоты выборки
+  float tcNoiseC_ = 0.0f;                                                 // Шум невязки термопары, °C
+  float newTcNoiseC_ = 0.0f;                                              // Новое значение шума
+  float tcOutlierPct_ = 0.0f;                                             // Доля выбросов АЦП, %
+  float newTcOutlierPct_ = 0.0f;                                          // Новая доля выбросов
+  float tcDriftC_ = 0.0f;                                                 // Дрейф показаний от модели, °C
+  float newTcDriftC_ = 0.0f;                                              // Новое значение дрейфа
+  int   tcHealth_ = -1;                                                   // Признаки SensorHealth::Flag (-1 — ещё не отправлялись)
+  int   newTcHealth_ = 0;                                                 // Новые признаки
+  ControlScheduler::Stats ctlStats_;                                      // Статистика регулятора, отправленная последней
+  ControlScheduler::Stats newCtlStats_;                                   // Новый снимок статистики регулятора
+  uint32_t ctlSentMs_ = 0;                                                // Время последней отправки статистики регулятора
+  int   ssrFbFlags_ = -1;                                                 // Признаки SsrFeedback::Flag (-1 — ещё не отправлялись)
+  int   newSsrFbFlags_ = -1;                                              // Новые признаки (-1 — обратной связи нет)
+  float ssrDutyPct_ = -1.0f;                                              // Фактическая скважность SSR, %
+  float newSsrDutyPct_ = 0.0f;                                            // Новое значение скважности
+  uint32_t heaterOnS_ = 0;                                                // Время полной мощности нагревателя, с
+  uint32_t newHeaterOnS_ = 0;                                             // Новое значение
+  float energyWh_ = NAN;                                                  // Энергия нагревателя, Вт·ч
+  float newEnergyWh_ = NAN;                                               // Новое значение энергии
+  int   adaptRetunes_ = -1;                                               // Подстроек PID с пуска (-1 — подстройки нет)
+  int   newAdaptRetunes_ = -1;                                            // Новое значение
+  float newAdaptGains_[3] = {};                                           // Текущие Kp, Ki, Kd подстройки
 
   static WebInterface* self_;                                            // Modified: указатель на singleton
 };
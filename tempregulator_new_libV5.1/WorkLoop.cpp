@@ -0,0 +1,55 @@
+#include "WorkLoop.h"                                                           // Объявление структуры
+//
+namespace {                                                                     // Локальные для модуля сущности
+template <int F>
+bool closeTo(Fixed<F> a, Fixed<F> b) {                                          // |a − b| ≤ |b|/256
+  const int64_t d = int64_t(a.raw()) - b.raw();
+  const int64_t m = b.raw() < 0 ? -int64_t(b.raw()) : b.raw();
+  return (d < 0 ? -d : d) * WorkLoop::kGainStep <= m;
+}                                                                               // Завершение closeTo
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+WorkLoop::Result WorkLoop::step(const Input& in, int& power) {                  // Шаг рабочего режима
+  power = 0;
+  if (in.schedule && schedule.active()) {
+    Q16 kp, kd;
+    Q24 ki;
+    schedule.eval(in.pv, kp, ki, kd);
+    if (!closeTo(kp, pid.proportionalGain()) || !closeTo(ki, pid.integralGain()) ||
+        !closeTo(kd, pid.derivativeGain())) {                                   // Пересчёт множителей — только при заметной смене
+      pid.setGains(kp, ki, kd);                                                 // Смена Kp компенсируется интегралом — без скачка выхода
+    }
+  }
+  if (profile.running()) {
+    if (!profile.tick(in.now_ms, in.pv)) {                                      // Профиль остановился на этом шаге
+      return profile.timedOut() ? Result::TimedOut : Result::Finished;
+    }
+    pid.setSetpointValue(profile.setpoint());
+  }
+  if (!in.heating) return Result::Power;
+  if (in.work && shaper.running()) {
+    shaper.tick(in.now_ms, in.delivered, in.pv);
+    bool shaped = false;
+    if (profile.running()) {
+      const uint8_t i = profile.segment();
+      if (profile.isHold(i) || (profile.isRampUp(i) && profile.isHold(i + 1))) {  // Нагрев перед выдержкой и сама выдержка
+        pid.setSetpointValue(shaper.shape(profile.setpoint(), profile.segmentEnd(i), in.pv));
+        shaped = true;
+      }
+    } else if (profile.segmentCount() == 0) {
+      pid.setSetpointValue(shaper.shape(in.target, in.target, in.pv));          // Поддержание уставки — та же выдержка
+      shaped = true;
+    }
+    if (shaped && shaper.presetting()) pid.presetIntegral(shaper.integralPreset());  // Выдержка начинается с мощности удержания
+  }
+  power = pid.compute(in.pv);
+  return Result::Power;
+}                                                                               // Завершение step
+//
+void WorkLoop::adapt(uint32_t now_ms, Q16 measured, int delivered) {            // Подстройка по измерению без фильтра
+  if (!adaptive.tick(now_ms, measured, delivered)) return;
+  Q16 kp, kd;
+  Q24 ki;
+  adaptive.gains(kp, ki, kd);
+  pid.setGains(kp, ki, kd);                                                     // Шаг подстройки небольшой, скачок P компенсирует интеграл
+}                                                                               // Завершение adapt
@@ -0,0 +1,46 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+//
+#include "AdaptivePid.h"                                                        // Подстройка коэффициентов в работе
+#include "FixedPoint.h"                                                         // Q16
+#include "GainSchedule.h"                                                       // Коэффициенты по температуре
+#include "OvershootShaper.h"                                                    // Формирование уставки перед выдержкой
+#include "PIDController.h"                                                      // PID в Q16
+#include "ProfileRunner.h"                                                      // Ступени профиля
+//
+// Шаг рабочего режима без ввода-вывода: таблица коэффициентов, задатчик
+// профиля, формирователь уставки, PID и подстройка — в том порядке, в котором
+// их вызывает задача регулятора. Звенья принадлежат владельцу (их же читают
+// UI и веб), WorkLoop только связывает их, поэтому один и тот же код
+// выполняют TempRegulator::controlTick() на плате и модель печи на ПК
+// (PlantSimulator). Аварии, SSR и датчики остаются у владельца: step()
+// сообщает о конце профиля результатом, а мощность выдаёт вызывающий.
+struct WorkLoop {                                                               // Связка звеньев рабочего режима
+  enum class Result : uint8_t {                                                 // Итог шага
+    Power,                                                                      // Мощность посчитана (или нагрев выключен)
+    Finished,                                                                   // Последняя ступень профиля пройдена
+    TimedOut,                                                                   // Профиль остановлен: выдержка не дождалась допуска
+  };                                                                            // Конец перечисления Result
+//
+  struct Input {                                                                // Данные шага
+    uint32_t now_ms;                                                            // Время шага
+    Q16      pv;                                                                // Температура для PID (после оценщика)
+    Q16      target;                                                            // Уставка поддержания без профиля
+    int      delivered;                                                         // Мощность, выданная на прошлом шаге
+    bool     heating;                                                           // Нагрев включён
+    bool     work;                                                              // Рабочий режим (не ручной)
+    bool     schedule;                                                          // Таблица коэффициентов действует
+  };                                                                            // Конец структуры Input
+//
+  static constexpr int32_t kGainStep = 256;                                     // Таблица меняет PID, когда коэффициент ушёл больше чем на 1/256
+//
+  PIDController&   pid;                                                         // Звенья владельца
+  GainSchedule&    schedule;
+  ProfileRunner&   profile;
+  OvershootShaper& shaper;
+  AdaptivePid&     adaptive;
+//
+  Result step(const Input& in, int& power);                                     // Коэффициенты, уставка и выход PID (power = 0 без нагрева)
+  void   adapt(uint32_t now_ms, Q16 measured, int delivered);                   // Шаг подстройки по выданной мощности
+};                                                                              // Конец определения структуры WorkLoop
@@ -3,6 +3,10 @@
 
 #include "TempRegulator.h"      // Подключаем заголовок с классом регулятора температуры и всеми связанными объявленими
 #include "WebInterface.h"       // Modified: подключаем веб-интерфейс с WebSocket
+#include "PIDController.h"      // runPidBenchmark() при сборке с TR_PID_BENCHMARK
+#include "ControlBenchmark.h"   // runControlBenchmark() там же
+#include "PhaseTimer.h"        // Замер длительности прохода loop()
+#include "EventTrace.h"        // Снимок трассы событий по команде из Serial
 
 void setup() {                   // Функция setup() запускается один раз при старте микроконтроллера
   Serial.begin(115200);          // Инициализируем последовательный порт для отладки на скорости 115200 бод
@@ -10,11 +14,24 @@ void setup() {                   // Функция setup() запускаетс
   WiFi.softAP("TR-MUF-1", "12345678");  // Modified: создаём точку доступа с заданным именем и паролем
   regulator.begin();             // Выполняем начальную настройку регулятора: дисплея, датчиков, памяти и т.д.
   WebInterface::instance().begin(&regulator);  // Modified: запускаем HTTP и WebSocket серверы
+#ifdef TR_PID_BENCHMARK
+  runPidBenchmark();             // Отладка: такты CPU на compute() для double и фиксированной точки
+  runControlBenchmark();         // Отладка: такты CPU по звеньям шага регулятора
+  runFilterBenchmark();          // Отладка: такты CPU фильтра АЦП против прежнего vector + nth_element
+#endif
 }
 
 void loop() {                    // Главный цикл программы, выполняется непрерывно после setup()
-  regulator.update();            // Обновляем состояние регулятора: обработка интерфейса, измерений и управляющих сигналов
-  WebInterface::instance().loop();  // Modified: обслуживаем веб-интерфейс и отправку телеметрии
+  {
+    TR_PHASE_SCOPE(kLoop);       // Проход без паузы delay(1)
+    regulator.update();          // Обновляем состояние регулятора: обработка интерфейса, измерений и управляющих сигналов
+    WebInterface::instance().loop();  // Modified: обслуживаем веб-интерфейс и отправку телеметрии
+  }
+#if TR_EVENT_TRACE
+  if (Serial.available() && Serial.read() == 't') {
+    EventTrace::printHex(Serial);  // «t» в мониторе порта — снимок для tools/trace_to_chrome.py
+  }
+#endif
   delay(1);                      // Делаем короткую паузу (1 мс), чтобы разгрузить процессор и дать LVGL обработать события
 }
 
@@ -0,0 +1,57 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <math.h>                                                               // fabs
+#include <stdio.h>                                                              // printf
+//
+#include <type_traits>                                                          // Печать перечислений как чисел
+//
+// Проверки для модульных тестов на ПК (ctest). Каждый тест — отдельная
+// программа: функции test*() вызываются из main(), проваленная проверка
+// печатает файл, строку, выражение и значения и не прерывает прогон, а
+// test::finish() возвращает код выхода (0 — все проверки прошли).
+namespace test {                                                                // Счётчики и печать
+//
+inline int& failures() { static int n = 0; return n; }                          // Проваленных проверок
+inline int& checks() { static int n = 0; return n; }                            // Всего проверок
+//
+template <typename T> double printable(const T& v) {                            // Значение для печати
+  if constexpr (std::is_enum<T>::value) return static_cast<double>(static_cast<long long>(v));
+  else return static_cast<double>(v);
+}                                                                               // Завершение printable
+//
+inline bool check(bool ok, const char* expr, const char* file, int line) {      // Истинность выражения
+  ++checks();
+  if (!ok) {
+    ++failures();
+    printf("%s:%d: FAILED: %s\n", file, line, expr);
+  }
+  return ok;
+}                                                                               // Завершение check
+//
+template <typename A, typename B>
+bool checkEq(const A& a, const B& b, const char* ea, const char* eb, const char* file, int line) {  // Равенство
+  ++checks();
+  if (a == b) return true;
+  ++failures();
+  printf("%s:%d: FAILED: %s == %s (%.9g vs %.9g)\n", file, line, ea, eb, printable(a), printable(b));
+  return false;
+}                                                                               // Завершение checkEq
+//
+inline bool checkNear(double a, double b, double tol, const char* ea, const char* eb, const char* file, int line) {
+  ++checks();
+  if (fabs(a - b) <= tol) return true;
+  ++failures();
+  printf("%s:%d: FAILED: |%s - %s| <= %g (%.9g vs %.9g)\n", file, line, ea, eb, tol, a, b);
+  return false;
+}                                                                               // Завершение checkNear
+//
+inline int finish(const char* name) {                                           // Итог программы: код выхода
+  printf("%s: %d checks, %d failed\n", name, checks(), failures());
+  return failures() ? 1 : 0;
+}                                                                               // Завершение finish
+//
+}  // namespace test                                                            // Завершение пространства имён test
+//
+#define CHECK(cond) ::test::check(static_cast<bool>(cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) ::test::checkEq((a), (b), #a, #b, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tol) ::test::checkNear((a), (b), (tol), #a, #b, __FILE__, __LINE__)
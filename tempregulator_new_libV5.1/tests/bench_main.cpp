@@ -0,0 +1,12 @@
+// Замеры стоимости горячего пути на ПК (цель bench, в ctest не входит).
+// Числа годятся для сравнения вариантов между собой, но не заменяют замер
+// на ESP32-C6 с тем же флагом TR_PID_BENCHMARK.
+#include "../ControlBenchmark.h"                                                // runControlBenchmark
+#include "../PIDController.h"                                                   // runPidBenchmark
+//
+int main() {                                                                    // Все замеры подряд
+  runPidBenchmark();                                                            // compute(): double и Q16
+  runControlBenchmark();                                                        // Звенья горячего пути
+  runFilterBenchmark();                                                         // Фильтр АЦП
+  return 0;
+}                                                                               // Завершение main
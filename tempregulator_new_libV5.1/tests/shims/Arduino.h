@@ -0,0 +1,75 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <math.h>                                                               // NAN, fabs — как в ядре Arduino
+#include <stdint.h>                                                             // Целочисленные типы фиксированной ширины
+#include <stdio.h>                                                              // snprintf
+#include <stdlib.h>                                                             // strtol, strtod
+#include <string.h>                                                             // strlen, strcmp
+//
+#include <string>                                                               // Хранилище String
+//
+// Замена ядра Arduino для сборки модулей прошивки на ПК (tests/, CMake).
+// Время виртуальное: millis() и micros() стоят на месте, пока тест не
+// сдвинет их hostSetMillis()/hostAdvanceMillis(), — так проверяются тайм-ауты
+// без ожидания. String — подмножество WString поверх std::string: ровно то,
+// чем пользуются Storage и TemperatureProfile. Макрос ARDUINO не
+// определяется: модули с ветками #ifdef ARDUINO собираются по хостовой ветке.
+uint32_t millis();                                                              // Виртуальные миллисекунды
+uint32_t micros();                                                              // Виртуальные микросекунды
+void     delay(uint32_t ms);                                                    // Сдвигает виртуальное время
+void     hostSetMillis(uint32_t ms);                                            // Тест: установить время
+void     hostAdvanceMillis(uint32_t ms);                                        // Тест: сдвинуть время
+//
+class String {                                                                  // Строка Arduino (подмножество)
+public:                                                                         // Публичный интерфейс
+  String() = default;                                                           // Пустая строка
+  String(const char* s) : s_(s ? s : "") {}                                     // Из C-строки
+  String(const std::string& s) : s_(s) {}                                      // Из std::string
+  explicit String(char c) : s_(1, c) {}                                         // Один символ
+  explicit String(int v) : s_(std::to_string(v)) {}                             // Десятичное число
+  explicit String(unsigned v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+  explicit String(double v, unsigned decimals = 2);                             // Число с плавающей точкой
+//
+  const char* c_str() const { return s_.c_str(); }                              // C-строка
+  size_t length() const { return s_.size(); }                                   // Длина в байтах
+  bool isEmpty() const { return s_.empty(); }                                   // Пустая ли строка
+  char operator[](size_t i) const { return i < s_.size() ? s_[i] : '\0'; }      // Символ (за концом — NUL)
+//
+  bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool endsWith(const String& p) const {                                        // Совпадение конца
+    return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }                                                                             // Конец endsWith
+  int indexOf(char c, size_t from = 0) const {                                  // Позиция символа (−1 — нет)
+    const size_t i = s_.find(c, from);
+    return i == std::string::npos ? -1 : static_cast<int>(i);
+  }                                                                             // Конец indexOf
+  String substring(size_t from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+  String substring(size_t from, size_t to) const {                              // [from, to)
+    if (to > s_.size()) to = s_.size();
+    return from < to ? String(s_.substr(from, to - from)) : String();
+  }                                                                             // Конец substring
+  void trim();                                                                  // Убрать пробельные символы по краям
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }                // Как WString: мусор — 0
+  float toFloat() const { return static_cast<float>(strtod(s_.c_str(), nullptr)); }
+  double toDouble() const { return strtod(s_.c_str(), nullptr); }
+//
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }             // Дописать строку
+  String& operator+=(const char* o) { s_ += o ? o : ""; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return s_ < o.s_; }                   // Для std::map в заменах
+//
+  const std::string& str() const { return s_; }                                 // Только для замен хоста
+//
+private:                                                                        // Внутреннее состояние
+  std::string s_;                                                               // Содержимое
+};                                                                              // Конец определения класса String
+//
+inline String operator+(String a, const String& b) { return a += b; }           // Конкатенация, как в WString
+inline String operator+(String a, const char* b) { return a += b; }
+inline String operator+(const char* a, const String& b) { return String(a) += b; }
@@ -0,0 +1,183 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <deque>                                                                // Узлы документа (адреса не меняются)
+#include <string>                                                               // Ключи и строковые значения
+#include <type_traits>                                                          // Выбор ветки as<T>()
+#include <utility>                                                              // pair
+#include <vector>                                                               // Члены объекта и элементы массива
+//
+#include <Arduino.h>                                                            // String
+//
+// Подмножество ArduinoJson 7 для сборки модулей на ПК: документ-дерево с
+// объектами, массивами, числами, строками и булевыми значениями. Запись —
+// obj["ключ"] = значение, createNestedArray()/createNestedObject(); чтение в
+// тестах — doc["ключ"][i].as<T>(). Сериализации нет: модулям ядра она не
+// нужна, а тесты сравнивают значения, а не текст.
+struct JsonNode {                                                               // Узел дерева
+  enum Type : uint8_t { kNull, kBool, kNumber, kString, kObject, kArray };      // Тип значения
+  Type type = kNull;                                                            // Текущий тип
+  bool b = false;                                                               // kBool
+  double num = 0.0;                                                             // kNumber
+  std::string str;                                                              // kString
+  std::vector<std::pair<std::string, JsonNode*>> members;                       // kObject
+  std::vector<JsonNode*> items;                                                 // kArray
+//
+  void reset(Type t) {                                                          // Новое пустое значение типа t
+    type = t; b = false; num = 0.0; str.clear(); members.clear(); items.clear();
+  }                                                                             // Конец reset
+  JsonNode* member(const std::string& key) const {                              // Член объекта или nullptr
+    if (type != kObject) return nullptr;
+    for (const auto& m : members) if (m.first == key) return m.second;
+    return nullptr;
+  }                                                                             // Конец member
+};                                                                              // Конец структуры JsonNode
+//
+class JsonDocument;                                                             // Владелец узлов
+class JsonArray;                                                                // Массив
+class JsonObject;                                                               // Объект
+//
+class JsonVariant {                                                             // Ссылка на значение (или на ещё не созданный член)
+public:                                                                         // Публичный интерфейс
+  JsonVariant() = default;                                                      // Пустая ссылка
+  JsonVariant(JsonDocument* doc, JsonNode* node, JsonNode* parent = nullptr, const std::string& key = std::string())
+      : doc_(doc), node_(node), parent_(parent), key_(key) {}                   // Член key объекта parent
+//
+  JsonVariant& operator=(bool v) { if (JsonNode* n = slot(JsonNode::kBool)) n->b = v; return *this; }
+  JsonVariant& operator=(double v) { if (JsonNode* n = slot(JsonNode::kNumber)) n->num = v; return *this; }
+  JsonVariant& operator=(float v) { return *this = static_cast<double>(v); }
+  JsonVariant& operator=(int v) { return *this = static_cast<double>(v); }
+  JsonVariant& operator=(long v) { return *this = static_cast<double>(v); }
+  JsonVariant& operator=(unsigned v) { return *this = static_cast<double>(v); }
+  JsonVariant& operator=(unsigned long v) { return *this = static_cast<double>(v); }
+  JsonVariant& operator=(const char* v) { if (JsonNode* n = slot(JsonNode::kString)) n->str = v ? v : ""; return *this; }
+  JsonVariant& operator=(const String& v) { return *this = v.c_str(); }
+//
+  bool isNull() const { return !node_ || node_->type == JsonNode::kNull; }      // Значения нет
+  size_t size() const {                                                         // Членов или элементов
+    if (!node_) return 0;
+    return node_->type == JsonNode::kArray ? node_->items.size() : node_->members.size();
+  }                                                                             // Конец size
+  JsonVariant operator[](const char* key) const {                               // Член объекта (только чтение)
+    return JsonVariant(doc_, node_ ? node_->member(key) : nullptr);
+  }                                                                             // Конец operator[]
+  JsonVariant operator[](int i) const {                                         // Элемент массива (только чтение)
+    if (!node_ || node_->type != JsonNode::kArray || i < 0 || static_cast<size_t>(i) >= node_->items.size()) return {};
+    return JsonVariant(doc_, node_->items[static_cast<size_t>(i)]);
+  }                                                                             // Конец operator[]
+//
+  template <typename T> T as() const {                                          // Значение как T
+    if constexpr (std::is_same<T, bool>::value) {
+      return node_ && node_->type == JsonNode::kBool ? node_->b : (node_ && node_->type == JsonNode::kNumber && node_->num != 0.0);
+    } else if constexpr (std::is_arithmetic<T>::value) {
+      if (!node_) return T();
+      if (node_->type == JsonNode::kBool) return static_cast<T>(node_->b);
+      return node_->type == JsonNode::kNumber ? static_cast<T>(node_->num) : T();
+    } else if constexpr (std::is_same<T, const char*>::value) {
+      return node_ && node_->type == JsonNode::kString ? node_->str.c_str() : nullptr;
+    } else {
+      static_assert(std::is_same<T, String>::value, "as<T>: bool, число, const char* или String");
+      return node_ && node_->type == JsonNode::kString ? String(node_->str) : String();
+    }
+  }                                                                             // Конец as
+//
+protected:                                                                      // Для JsonObject и JsonArray
+  JsonNode* slot(JsonNode::Type t);                                             // Узел для записи значения типа t
+//
+  JsonDocument* doc_ = nullptr;                                                 // Документ
+  JsonNode*     node_ = nullptr;                                                // Узел (nullptr — ещё не создан)
+  JsonNode*     parent_ = nullptr;                                              // Объект, в котором создать член
+  std::string   key_;                                                           // Ключ создаваемого члена
+};                                                                              // Конец определения класса JsonVariant
+//
+class JsonObject {                                                              // Объект документа
+public:                                                                         // Публичный интерфейс
+  JsonObject() = default;                                                       // Пустая ссылка
+  JsonObject(JsonDocument* doc, JsonNode* node) : doc_(doc), node_(node) {}     // Узел типа kObject
+//
+  JsonVariant operator[](const char* key) const {                               // Член (создаётся при записи)
+    return JsonVariant(doc_, node_ ? node_->member(key) : nullptr, node_, key);
+  }                                                                             // Конец operator[]
+  void clear() { if (node_) node_->reset(JsonNode::kObject); }                  // Удалить все члены
+  size_t size() const { return node_ ? node_->members.size() : 0; }             // Членов
+  JsonArray createNestedArray(const char* key);                                 // Новый массив в члене key
+  JsonObject createNestedObject(const char* key);                               // Новый объект в члене key
+//
+private:                                                                        // Внутреннее состояние
+  JsonDocument* doc_ = nullptr;                                                 // Документ
+  JsonNode*     node_ = nullptr;                                                // Узел объекта
+};                                                                              // Конец определения класса JsonObject
+//
+class JsonArray {                                                               // Массив документа
+public:                                                                         // Публичный интерфейс
+  JsonArray() = default;                                                        // Пустая ссылка
+  JsonArray(JsonDocument* doc, JsonNode* node) : doc_(doc), node_(node) {}      // Узел типа kArray
+//
+  JsonObject createNestedObject();                                              // Новый объект в конце
+  JsonVariant add();                                                            // Новый элемент в конце
+  size_t size() const { return node_ ? node_->items.size() : 0; }               // Элементов
+  JsonVariant operator[](int i) const { return JsonVariant(doc_, node_)[i]; }   // Элемент (только чтение)
+//
+private:                                                                        // Внутреннее состояние
+  JsonDocument* doc_ = nullptr;                                                 // Документ
+  JsonNode*     node_ = nullptr;                                                // Узел массива
+};                                                                              // Конец определения класса JsonArray
+//
+class JsonDocument {                                                            // Документ: владеет всеми узлами
+public:                                                                         // Публичный интерфейс
+  JsonDocument() : root_(alloc()) {}                                            // Пустой документ
+  JsonDocument(const JsonDocument&) = delete;                                   // Узлы не копируются
+  JsonDocument& operator=(const JsonDocument&) = delete;
+//
+  template <typename T> T to() {                                                // Корень — новый объект или массив
+    static_assert(std::is_same<T, JsonObject>::value || std::is_same<T, JsonArray>::value, "to<JsonObject|JsonArray>");
+    root_->reset(std::is_same<T, JsonObject>::value ? JsonNode::kObject : JsonNode::kArray);
+    return T(this, root_);
+  }                                                                             // Конец to
+  void clear() { root_->reset(JsonNode::kNull); }                               // Пустой документ
+  JsonVariant operator[](const char* key) const { return JsonVariant(nullptr, root_)[key]; }  // Член корня (чтение)
+  JsonVariant root() const { return JsonVariant(nullptr, root_); }              // Корень (чтение)
+//
+  JsonNode* alloc() { nodes_.emplace_back(); return &nodes_.back(); }           // Новый узел
+//
+private:                                                                        // Внутреннее состояние
+  std::deque<JsonNode> nodes_;                                                  // Узлы (deque не двигает элементы)
+  JsonNode* root_;                                                              // Корень
+};                                                                              // Конец определения класса JsonDocument
+//
+inline JsonNode* JsonVariant::slot(JsonNode::Type t) {                          // Узел для записи
+  if (!node_ && parent_ && doc_) {                                              // Члена ещё нет — создаём
+    node_ = doc_->alloc();
+    parent_->members.emplace_back(key_, node_);
+  }
+  if (node_) node_->reset(t);
+  return node_;
+}                                                                               // Конец slot
+//
+inline JsonArray JsonObject::createNestedArray(const char* key) {               // Массив в члене key
+  JsonVariant v = (*this)[key];
+  v = 0;                                                                        // Создаём член
+  JsonNode* n = node_->member(key);
+  n->reset(JsonNode::kArray);
+  return JsonArray(doc_, n);
+}                                                                               // Конец createNestedArray
+//
+inline JsonObject JsonObject::createNestedObject(const char* key) {             // Объект в члене key
+  JsonVariant v = (*this)[key];
+  v = 0;
+  JsonNode* n = node_->member(key);
+  n->reset(JsonNode::kObject);
+  return JsonObject(doc_, n);
+}                                                                               // Конец createNestedObject
+//
+inline JsonObject JsonArray::createNestedObject() {                             // Объект в конце массива
+  JsonNode* n = doc_->alloc();
+  n->reset(JsonNode::kObject);
+  node_->items.push_back(n);
+  return JsonObject(doc_, n);
+}                                                                               // Конец createNestedObject
+//
+inline JsonVariant JsonArray::add() {                                           // Элемент в конце массива
+  JsonNode* n = doc_->alloc();
+  node_->items.push_back(n);
+  return JsonVariant(doc_, n);
+}                                                                               // Конец add
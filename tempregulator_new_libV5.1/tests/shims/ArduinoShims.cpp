@@ -0,0 +1,213 @@
+#include <Arduino.h>                                                            // Объявления замен
+#include <LittleFS.h>
+#include <Preferences.h>
+//
+#include <ctype.h>                                                              // isspace
+#include <errno.h>                                                              // EEXIST
+#include <sys/stat.h>                                                           // mkdir, stat
+//
+#include <map>                                                                  // Пространства и ключи NVS
+//
+// --------------------------------------------------------------------------------------
+// Время и String
+// --------------------------------------------------------------------------------------
+namespace {                                                                     // Состояние замен
+uint64_t g_now_us = 0;                                                          // Виртуальное время
+//
+struct NvsValue {                                                               // Значение ключа NVS
+  char type;                                                                    // 'b', 'i', 'u', 'f', 'd', 's'
+  std::string data;                                                             // Байты значения
+};                                                                              // Конец структуры NvsValue
+//
+std::map<std::string, std::map<std::string, NvsValue>>& nvs() {                 // Вся NVS процесса
+  static std::map<std::string, std::map<std::string, NvsValue>> store;
+  return store;
+}                                                                               // Завершение nvs
+//
+template <typename T> std::string bytesOf(T v) {                                // Значение → байты
+  return std::string(reinterpret_cast<const char*>(&v), sizeof(v));
+}                                                                               // Завершение bytesOf
+//
+template <typename T> T fromBytes(const std::string* s, T def) {                // Байты → значение
+  if (!s || s->size() != sizeof(T)) return def;
+  T v;
+  memcpy(&v, s->data(), sizeof(T));
+  return v;
+}                                                                               // Завершение fromBytes
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+uint32_t millis() { return static_cast<uint32_t>(g_now_us / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(g_now_us); }
+void delay(uint32_t ms) { g_now_us += uint64_t(ms) * 1000; }
+void hostSetMillis(uint32_t ms) { g_now_us = uint64_t(ms) * 1000; }
+void hostAdvanceMillis(uint32_t ms) { g_now_us += uint64_t(ms) * 1000; }
+//
+String::String(double v, unsigned decimals) {                                   // Как dtostrf в WString
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(decimals), v);
+  s_ = buf;
+}                                                                               // Завершение String(double)
+//
+void String::trim() {                                                           // Пробельные символы по краям
+  size_t b = 0, e = s_.size();
+  while (b < e && isspace(static_cast<unsigned char>(s_[b]))) ++b;
+  while (e > b && isspace(static_cast<unsigned char>(s_[e - 1]))) --e;
+  s_ = s_.substr(b, e - b);
+}                                                                               // Завершение trim
+//
+// --------------------------------------------------------------------------------------
+// Preferences
+// --------------------------------------------------------------------------------------
+bool Preferences::begin(const char* name, bool read_only, const char*) {        // Открыть пространство
+  if (open_ || !name || !*name || strlen(name) > 15) return false;              // Имя NVS — до 15 символов
+  if (read_only && !nvs().count(name)) return false;                            // Пространства ещё нет
+  nvs()[name];
+  ns_ = name;
+  open_ = true;
+  read_only_ = read_only;
+  return true;
+}                                                                               // Завершение begin
+//
+void Preferences::end() { open_ = false; }
+//
+bool Preferences::clear() {                                                     // Все ключи пространства
+  if (!open_ || read_only_) return false;
+  nvs()[ns_].clear();
+  return true;
+}                                                                               // Завершение clear
+//
+bool Preferences::remove(const char* key) {                                     // Один ключ
+  if (!open_ || read_only_) return false;
+  return nvs()[ns_].erase(key) > 0;
+}                                                                               // Завершение remove
+//
+bool Preferences::isKey(const char* key) const {                                // Есть ли ключ
+  return open_ && nvs()[ns_].count(key) > 0;
+}                                                                               // Завершение isKey
+//
+size_t Preferences::put(const char* key, char type, const std::string& v, size_t size) {  // Общая запись
+  if (!open_ || read_only_ || !key || strlen(key) > 15) return 0;               // Ключ NVS — до 15 символов
+  nvs()[ns_][key] = NvsValue{type, v};
+  return size;
+}                                                                               // Завершение put
+//
+const std::string* Preferences::get(const char* key, char type) const {         // Общее чтение
+  if (!open_) return nullptr;
+  const auto& space = nvs()[ns_];
+  const auto it = space.find(key);
+  return it != space.end() && it->second.type == type ? &it->second.data : nullptr;
+}                                                                               // Завершение get
+//
+size_t Preferences::putBool(const char* key, bool v) { return put(key, 'b', bytesOf<uint8_t>(v), 1); }
+size_t Preferences::putInt(const char* key, int32_t v) { return put(key, 'i', bytesOf(v), 4); }
+size_t Preferences::putUInt(const char* key, uint32_t v) { return put(key, 'u', bytesOf(v), 4); }
+size_t Preferences::putFloat(const char* key, float v) { return put(key, 'f', bytesOf(v), 4); }
+size_t Preferences::putDouble(const char* key, double v) { return put(key, 'd', bytesOf(v), 8); }
+size_t Preferences::putString(const char* key, const char* v) {
+  const std::string s = v ? v : "";
+  return put(key, 's', s, s.size());
+}
+//
+bool Preferences::getBool(const char* key, bool def) const { return fromBytes<uint8_t>(get(key, 'b'), def) != 0; }
+int32_t Preferences::getInt(const char* key, int32_t def) const { return fromBytes(get(key, 'i'), def); }
+uint32_t Preferences::getUInt(const char* key, uint32_t def) const { return fromBytes(get(key, 'u'), def); }
+float Preferences::getFloat(const char* key, float def) const { return fromBytes(get(key, 'f'), def); }
+double Preferences::getDouble(const char* key, double def) const { return fromBytes(get(key, 'd'), def); }
+String Preferences::getString(const char* key, const String& def) const {
+  const std::string* s = get(key, 's');
+  return s ? String(*s) : def;
+}
+//
+void Preferences::hostErase() { nvs().clear(); }
+size_t Preferences::hostNamespaceCount() { return nvs().size(); }
+//
+// --------------------------------------------------------------------------------------
+// File и LittleFS
+// --------------------------------------------------------------------------------------
+File::File(FILE* f) : f_(f ? std::shared_ptr<FILE*>(new FILE*(f), [](FILE** p) {
+                        if (*p) fclose(*p);
+                        delete p;
+                      }) : nullptr) {}
+//
+int File::available() {                                                         // Байт до конца
+  FILE* f = handle();
+  if (!f) return 0;
+  const long pos = ftell(f);
+  fseek(f, 0, SEEK_END);
+  const long end = ftell(f);
+  fseek(f, pos, SEEK_SET);
+  return static_cast<int>(end - pos);
+}                                                                               // Завершение available
+//
+int File::read() {                                                              // Один байт
+  FILE* f = handle();
+  const int c = f ? fgetc(f) : EOF;
+  return c == EOF ? -1 : c;
+}                                                                               // Завершение read
+//
+size_t File::read(uint8_t* buf, size_t len) { FILE* f = handle(); return f ? fread(buf, 1, len, f) : 0; }
+size_t File::write(const uint8_t* buf, size_t len) { FILE* f = handle(); return f ? fwrite(buf, 1, len, f) : 0; }
+size_t File::print(const char* s) { return write(reinterpret_cast<const uint8_t*>(s), strlen(s)); }
+size_t File::println(const char* s) { return print(s) + print("\n"); }
+//
+size_t File::printf(const char* fmt, ...) {                                     // Форматированный вывод
+  FILE* f = handle();
+  if (!f) return 0;
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vfprintf(f, fmt, ap);
+  va_end(ap);
+  return n < 0 ? 0 : static_cast<size_t>(n);
+}                                                                               // Завершение printf
+//
+String File::readStringUntil(char end) {                                        // До разделителя
+  std::string s;
+  for (int c = read(); c >= 0 && c != end; c = read()) s += static_cast<char>(c);
+  return String(s);
+}                                                                               // Завершение readStringUntil
+//
+size_t File::size() {                                                           // Размер файла
+  FILE* f = handle();
+  if (!f) return 0;
+  const long pos = ftell(f);
+  fseek(f, 0, SEEK_END);
+  const long end = ftell(f);
+  fseek(f, pos, SEEK_SET);
+  return static_cast<size_t>(end);
+}                                                                               // Завершение size
+//
+void File::close() {                                                            // У всех копий
+  if (f_ && *f_) {
+    fclose(*f_);
+    *f_ = nullptr;
+  }
+  f_.reset();
+}                                                                               // Завершение close
+//
+LittleFSFS LittleFS;                                                            // Раздел по умолчанию
+//
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {               // Смонтировать
+  if (fail_) return false;
+  if (mkdir(root_.c_str(), 0755) != 0 && errno != EEXIST) return false;
+  mounted_ = true;
+  return true;
+}                                                                               // Завершение begin
+//
+std::string LittleFSFS::path(const char* p) const {                             // Путь на хосте
+  return root_ + (p && *p == '/' ? "" : "/") + (p ? p : "");
+}                                                                               // Завершение path
+//
+File LittleFSFS::open(const char* p, const char* mode) {                        // Открыть файл
+  if (!mounted_) return File();
+  const char* m = !strcmp(mode, FILE_WRITE) ? "wb" : (!strcmp(mode, FILE_APPEND) ? "ab" : "rb");
+  return File(fopen(path(p).c_str(), m));
+}                                                                               // Завершение open
+//
+bool LittleFSFS::exists(const char* p) {                                        // Есть ли файл
+  struct stat st;
+  return mounted_ && stat(path(p).c_str(), &st) == 0;
+}                                                                               // Завершение exists
+//
+bool LittleFSFS::remove(const char* p) {                                        // Удалить файл
+  return mounted_ && ::remove(path(p).c_str()) == 0;
+}                                                                               // Завершение remove
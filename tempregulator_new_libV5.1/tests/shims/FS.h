@@ -0,0 +1,42 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <stdarg.h>                                                             // va_list для printf
+#include <stdio.h>                                                              // FILE
+//
+#include <memory>                                                               // shared_ptr на открытый файл
+//
+#include <Arduino.h>                                                            // String
+//
+#define FILE_READ "r"                                                           // Режимы открытия, как в FS ESP32
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+//
+// Файл LittleFS на ПК — обычный файл в каталоге, который подставлен вместо
+// раздела (см. LittleFS.h). Копии File делят один дескриптор, как в ESP32.
+class File {                                                                    // Открытый файл
+public:                                                                         // Публичный интерфейс
+  File() = default;                                                             // Неоткрытый файл
+  explicit File(FILE* f);                                                       // Владеет дескриптором
+//
+  explicit operator bool() const { return f_ != nullptr; }                      // Открыт ли файл
+  int    available();                                                           // Байт до конца файла
+  int    read();                                                                // Байт или −1
+  size_t read(uint8_t* buf, size_t len);                                        // Блок
+  size_t write(const uint8_t* buf, size_t len);                                 // Блок
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t print(const char* s);                                                  // Строка без перевода
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t println(const char* s = "");                                           // Строка с переводом
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));    // Форматированный вывод
+  String readStringUntil(char end);                                             // До разделителя (он отбрасывается)
+  size_t size();                                                                // Размер файла
+  void   close();                                                               // Закрыть (у всех копий)
+//
+private:                                                                        // Внутреннее состояние
+  std::shared_ptr<FILE*> f_;                                                    // Общий дескриптор копий
+  FILE* handle() const { return f_ ? *f_ : nullptr; }                           // Дескриптор или nullptr
+};                                                                              // Конец определения класса File
+//
+namespace fs {                                                                  // Пространство имён FS ESP32
+using ::File;                                                                   // fs::File — тот же тип
+}  // namespace fs                                                              // Завершение пространства имён fs
@@ -0,0 +1,35 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <string>                                                               // Корневой каталог
+//
+#include "FS.h"                                                                 // File
+//
+// Раздел LittleFS на ПК — каталог файловой системы хоста. Путь файла
+// прошивки ("/config.ini") отсчитывается от корня, заданного hostSetRoot();
+// по умолчанию — ./littlefs в рабочем каталоге. begin() создаёт корень, если
+// его нет, hostFail(true) имитирует раздел, который не монтируется.
+class LittleFSFS {                                                              // Файловая система раздела
+public:                                                                         // Публичный интерфейс
+  bool begin(bool format_on_fail = false, const char* base = "/littlefs", uint8_t max_files = 10,
+             const char* label = "spiffs");                                     // Смонтировать
+  void end() { mounted_ = false; }                                              // Отмонтировать
+  File open(const char* path, const char* mode = FILE_READ);                    // Открыть файл
+  File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+  bool exists(const char* path);                                                // Есть ли файл
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);                                                // Удалить файл
+  bool remove(const String& path) { return remove(path.c_str()); }
+//
+  void hostSetRoot(const std::string& dir) { root_ = dir; }                     // Тест: каталог раздела
+  void hostFail(bool fail) { fail_ = fail; }                                    // Тест: раздел не монтируется
+  const std::string& hostRoot() const { return root_; }                         // Тест: каталог раздела
+//
+private:                                                                        // Внутреннее состояние
+  std::string path(const char* p) const;                                        // Путь на хосте
+//
+  std::string root_ = "littlefs";                                               // Каталог раздела
+  bool mounted_ = false;                                                        // begin() прошёл
+  bool fail_ = false;                                                           // Имитация сбоя монтирования
+};                                                                              // Конец определения класса LittleFSFS
+//
+extern LittleFSFS LittleFS;                                                     // Единственный раздел, как в ESP32
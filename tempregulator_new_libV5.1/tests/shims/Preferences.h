@@ -0,0 +1,43 @@
+#pragma once                                                                    // Предотвращает повторное включение заголовка
+//
+#include <Arduino.h>                                                            // String
+//
+// NVS в памяти процесса вместо библиотеки Preferences ESP32. Пространства
+// живут между экземплярами (как разделы NVS между begin()/end()) до вызова
+// hostErase(). Значения хранят тип: чтение ключа другим get*() возвращает
+// значение по умолчанию, как у настоящей NVS. begin() только для чтения
+// несуществующего пространства завершается неудачей — так же, как на плате.
+class Preferences {                                                             // Пространство ключей NVS
+public:                                                                         // Публичный интерфейс
+  bool begin(const char* name, bool read_only = false, const char* partition = nullptr);  // Открыть пространство
+  void end();                                                                   // Закрыть
+  bool clear();                                                                 // Удалить все ключи пространства
+  bool remove(const char* key);                                                 // Удалить ключ
+  bool isKey(const char* key) const;                                            // Есть ли ключ
+//
+  size_t putBool(const char* key, bool v);                                      // Запись: байт записанного значения
+  size_t putInt(const char* key, int32_t v);
+  size_t putUInt(const char* key, uint32_t v);
+  size_t putFloat(const char* key, float v);
+  size_t putDouble(const char* key, double v);
+  size_t putString(const char* key, const char* v);
+  size_t putString(const char* key, const String& v) { return putString(key, v.c_str()); }
+//
+  bool     getBool(const char* key, bool def = false) const;                    // Чтение: def, если ключа нет или тип другой
+  int32_t  getInt(const char* key, int32_t def = 0) const;
+  uint32_t getUInt(const char* key, uint32_t def = 0) const;
+  float    getFloat(const char* key, float def = NAN) const;
+  double   getDouble(const char* key, double def = NAN) const;
+  String   getString(const char* key, const String& def = String()) const;
+//
+  static void hostErase();                                                      // Тест: стереть всю NVS
+  static size_t hostNamespaceCount();                                           // Тест: число пространств
+//
+private:                                                                        // Внутреннее состояние
+  size_t put(const char* key, char type, const std::string& v, size_t size);    // Общая запись
+  const std::string* get(const char* key, char type) const;                     // Общее чтение
+//
+  std::string ns_;                                                              // Имя открытого пространства
+  bool open_ = false;                                                           // begin() прошёл
+  bool read_only_ = false;                                                      // Только чтение
+};                                                                              // Конец определения класса Preferences
@@ -0,0 +1,182 @@
+// AdaptivePid: на печи, сильно отличающейся от модели профиля, коэффициенты
+// не выходят из [исходный / kMaxRatio, исходный · kMaxRatio] и за подстройку
+// меняются не больше чем на kMaxStep исходного; на выдержке без возбуждения
+// модель и коэффициенты не уплывают от шума термопары.
+#include <math.h>                                                               // fabs
+//
+#include "../AdaptivePid.h"                                                     // Проверяемый модуль
+#include "../PIDController.h"                                                   // Замкнутый контур с регулятором прошивки
+#include "../TemperatureEstimator.h"                                            // PID — по оценке, как в WorkLoop
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Модель и проверки
+//
+constexpr uint32_t kDtMs = 100;                                                 // Период регулятора прошивки
+constexpr uint32_t kRampMs = 92UL * 60 * 1000;                                  // Нагрев 3 °C/мин до 300 °C
+const StepIdentifier::Model kPrior{2.0, 600.0, 30.0, true};                     // Модель профиля: пустая печь
+//
+class Plant {                                                                   // K·e^(−θs)/(τs + 1) от выхода 0..255, цех 25 °C
+public:                                                                         // Публичный интерфейс
+  Plant(double gain, double tau_s, double dead_s, double noise)
+      : gain_(gain), a_(kDtMs / 1000.0 / tau_s), noise_(noise), delay_n_(static_cast<int>(dead_s * 1000.0 / kDtMs)) {}
+  Q16 step(int u) {                                                             // Шаг kDtMs: выход → измерение с шумом
+    hist_[head_ % kHist] = static_cast<uint8_t>(u);
+    const int ud = head_ >= delay_n_ ? hist_[(head_ - delay_n_) % kHist] : 0;
+    ++head_;
+    y_ += (25.0 + gain_ * ud - y_) * a_;
+    seed_ = seed_ * 1664525u + 1013904223u;
+    return Q16::fromDouble(y_ + noise_ * ((seed_ >> 16) % 1001 / 1000.0 - 0.5));
+  }                                                                             // Конец step
+//
+private:                                                                        // Внутреннее состояние
+  static constexpr int kHist = 1024;                                            // Запаздывание до 102 с
+  double gain_, a_, noise_;
+  double y_ = 25.0;
+  int delay_n_;
+  int head_ = 0;
+  uint32_t seed_ = 12345;
+  uint8_t hist_[kHist] = {};
+};                                                                              // Конец определения класса Plant
+//
+struct Loop {                                                                   // PID по оценке, подстройка по измерению
+  Loop(double gain, double tau_s, double dead_s, double noise) : plant(gain, tau_s, dead_s, noise) {
+    est.configure(TemperatureEstimator::kDefaultProcessNoise, TemperatureEstimator::kDefaultMeasureNoise,
+                  TemperatureEstimator::kDefaultPowerGain);
+    base = StepIdentifier::gains(kPrior, StepIdentifier::kImcPid);
+    pid.setCoeffs(base.kp, base.ki, base.kd);
+    pid.setFixedDt(kDtMs);
+    ad.start(0, base.kp, base.ki, base.kd, &kPrior, Q16(25));
+    pv = plant.step(0);
+  }
+  bool step() {                                                                 // Шаг kDtMs: true — подстройка
+    pid.setSetpoint(now < kRampMs ? 25.0 + 275.0 * now / kRampMs : 300.0);
+    est.update(now, pv, u_);
+    const int u = pid.compute(est.temperature());
+    const bool changed = ad.tick(now, pv, u);                                   // Как WorkLoop::adapt()
+    if (changed) {
+      Q16 kp, kd;
+      Q24 ki;
+      ad.gains(kp, ki, kd);
+      pid.setGains(kp, ki, kd);
+    }
+    pv = plant.step(u);
+    u_ = u;
+    now += kDtMs;
+    return changed;
+  }                                                                             // Конец step
+  double tauPerGain() const {                                                   // Теплоёмкость модели, τ/K
+    const StepIdentifier::Model m = ad.model();
+    return m.tau_s / m.gain;
+  }                                                                             // Конец tauPerGain
+//
+  Plant plant;
+  PIDController pid;
+  AdaptivePid ad;
+  TemperatureEstimator est;
+  StepIdentifier::Gains base;
+  Q16 pv;
+  uint32_t now = 0;
+  int u_ = 0;                                                                   // Мощность прошлого шага
+};                                                                              // Конец структуры Loop
+//
+struct Bounds {                                                                 // Что видно по всем подстройкам
+  double lo[3] = {1e9, 1e9, 1e9};                                               // Наименьшее отношение к исходному
+  double hi[3] = {0.0, 0.0, 0.0};                                               // Наибольшее
+  double step = 0.0;                                                            // Наибольший шаг, доля исходного
+};                                                                              // Конец структуры Bounds
+//
+Bounds runMismatched(double gain, double tau_s, double dead_s) {                // Нагрев и 6 ч выдержки
+  Loop loop(gain, tau_s, dead_s, 0.5);
+  const double base[3] = {loop.base.kp, loop.base.ki, loop.base.kd};
+  Bounds b;
+  double prev[3] = {base[0], base[1], base[2]};
+  while (loop.now < kRampMs + 6UL * 3600 * 1000) {
+    if (!loop.step()) continue;
+    const double cur[3] = {loop.ad.kp(), loop.ad.ki(), loop.ad.kd()};
+    for (int i = 0; i < 3; ++i) {
+      const double r = cur[i] / base[i];
+      if (r < b.lo[i]) b.lo[i] = r;
+      if (r > b.hi[i]) b.hi[i] = r;
+      const double s = fabs(cur[i] - prev[i]) / base[i];
+      if (s > b.step) b.step = s;
+      prev[i] = cur[i];
+    }
+  }
+  printf("K %.1f tau %.0f s: Kp x%.3f..%.3f Ki x%.3f..%.3f Kd x%.3f..%.3f, step %.4f, %u retunes\n",
+         gain, tau_s, b.lo[0], b.hi[0], b.lo[1], b.hi[1], b.lo[2], b.hi[2], b.step,
+         static_cast<unsigned>(loop.ad.retunes()));
+  CHECK(loop.ad.retunes() > 20);
+  for (int i = 0; i < 3; ++i) {
+    CHECK(b.lo[i] >= 1.0 / AdaptivePid::kMaxRatio - 1e-9);
+    CHECK(b.hi[i] <= AdaptivePid::kMaxRatio + 1e-9);
+  }
+  CHECK(b.step <= AdaptivePid::kMaxStep + 1e-9);
+  return b;
+}                                                                               // Завершение runMismatched
+//
+void testHeavyLoad() {                                                          // Впятеро тяжелее: τ 6000 с, K вдвое меньше
+  const Bounds b = runMismatched(1.0, 6000.0, 30.0);
+  CHECK_NEAR(b.lo[1], 1.0 / AdaptivePid::kMaxRatio, 1e-6);                      // Ki упёрся в предел
+  CHECK(b.hi[0] > 1.15);                                                        // Kp пошёл вверх
+  CHECK_NEAR(b.step, AdaptivePid::kMaxStep, 1e-6);                              // Шаг упирался в предел скорости
+}                                                                               // Завершение testHeavyLoad
+//
+void testLightLoad() {                                                          // Вчетверо легче
+  const Bounds b = runMismatched(4.0, 150.0, 30.0);
+  CHECK_NEAR(b.lo[0], 1.0 / AdaptivePid::kMaxRatio, 1e-6);                      // Kp и Kd — у нижнего предела
+  CHECK_NEAR(b.lo[2], 1.0 / AdaptivePid::kMaxRatio, 1e-6);
+  CHECK_NEAR(b.hi[1], AdaptivePid::kMaxRatio, 1e-6);                            // Ki — у верхнего
+  CHECK_NEAR(b.step, AdaptivePid::kMaxStep, 1e-6);
+}                                                                               // Завершение testLightLoad
+//
+struct Drift {                                                                  // Уход за выдержку
+  double model = 0.0;                                                           // Наибольший уход τ/K, доля
+  double gains = 0.0;                                                           // Наибольший уход коэффициента, доля
+  uint16_t retunes = 0;                                                         // Подстроек за выдержку
+};                                                                              // Конец структуры Drift
+//
+Drift runHold(double noise) {                                                   // Та же печь: 10 ч выдержки после установления
+  Loop loop(2.0, 600.0, 30.0, noise);
+  const uint32_t settled = kRampMs + 3600UL * 1000;
+  while (loop.now < settled) loop.step();
+  const double m0 = loop.tauPerGain();
+  const double g0[3] = {loop.ad.kp(), loop.ad.ki(), loop.ad.kd()};
+  const uint16_t r0 = loop.ad.retunes();
+  Drift d;
+  while (loop.now < settled + 10UL * 3600 * 1000) {
+    loop.step();
+    const double m = fabs(loop.tauPerGain() / m0 - 1.0);
+    if (m > d.model) d.model = m;
+    const double g[3] = {loop.ad.kp(), loop.ad.ki(), loop.ad.kd()};
+    for (int i = 0; i < 3; ++i) {
+      const double e = fabs(g[i] / g0[i] - 1.0);
+      if (e > d.gains) d.gains = e;
+    }
+  }
+  d.retunes = static_cast<uint16_t>(loop.ad.retunes() - r0);
+  printf("hold, noise %.1f C: tau/K drift %.4f, gains drift %.4f, %u retunes\n", noise, d.model, d.gains,
+         static_cast<unsigned>(d.retunes));
+  return d;
+}                                                                               // Завершение runHold
+//
+void testHoldNoDrift() {                                                        // Выдержка без возбуждения
+  const Drift clean = runHold(0.0);                                             // Ошибка в зоне нечувствительности: МНК стоит
+  CHECK_EQ(clean.retunes, 0);
+  CHECK_NEAR(clean.model, 0.0, 1e-9);
+  const Drift usual = runHold(0.5);                                             // Шум термопары ±0.25 °C: окна не возбуждены
+  CHECK_EQ(usual.retunes, 0);
+  CHECK(usual.model < 0.02);
+  CHECK_NEAR(usual.gains, 0.0, 1e-9);
+  const Drift noisy = runHold(2.0);                                             // ±1 °C: редкие окна проходят, подстройки — нет
+  CHECK(noisy.model < 0.25);
+  CHECK(noisy.gains < 0.01);
+}                                                                               // Завершение testHoldNoDrift
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testHeavyLoad();
+  testLightLoad();
+  testHoldNoDrift();
+  return test::finish("test_adaptive_pid");
+}                                                                               // Завершение main
@@ -0,0 +1,145 @@
+// AdcSampler на хосте: отсчёты из подменённого источника вместо analogRead,
+// таймер не запускается — тики подаёт sampleOnce().
+#include "../AdcSampler.h"                                                      // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Источник отсчётов и проверки
+//
+uint16_t g_level = 1000;                                                        // Уровень источника
+uint32_t g_reads = 0;                                                           // Прочитано отсчётов
+uint32_t g_spike_every = 0;                                                     // Каждый n-й отсчёт — выброс (0 — без выбросов)
+//
+uint16_t levelSource(uint8_t) {                                                 // Постоянный уровень с редкими выбросами
+  ++g_reads;
+  return g_spike_every && g_reads % g_spike_every == 0 ? 3000 : g_level;
+}                                                                               // Завершение levelSource
+//
+uint16_t pinSource(uint8_t pin) { return static_cast<uint16_t>(pin * 100); }    // Значение выдаёт номер входа
+//
+void reset(uint16_t level, uint32_t spike_every) {                              // Новый прогон источника
+  g_level = level;
+  g_reads = 0;
+  g_spike_every = spike_every;
+}                                                                               // Завершение reset
+//
+void testBeginFillsWindow() {                                                   // После begin() значение сразу валидно
+  AdcSampler none;
+  CHECK(!none.begin(1, 2000));                                                  // На хосте без источника нечего читать
+  CHECK(!none.ready());
+//
+  reset(1000, 0);
+  AdcSampler s;
+  s.setReadFunction(levelSource);
+  CHECK(s.begin(1, 2000));
+  CHECK(s.ready());
+  CHECK_EQ(g_reads, static_cast<uint32_t>(AdcSampler::kWindow));
+  CHECK_EQ(s.sampleCount(), static_cast<uint32_t>(AdcSampler::kWindow));
+  CHECK_EQ(s.windowCount(), 1u);
+  CHECK_EQ(s.periodUs(), 2000u);
+  uint8_t outliers = 99;
+  CHECK_EQ(s.latest(outliers), 1000);
+  CHECK_EQ(outliers, 0);
+  CHECK(!s.openCircuit());
+}                                                                               // Завершение testBeginFillsWindow
+//
+void testOutliersRejected() {                                                   // Выбросы не попадают в среднее
+  reset(1000, 7);
+  AdcSampler s;
+  s.setReadFunction(levelSource);
+  s.begin(1, 2000);
+  uint8_t outliers = 0;
+  CHECK_EQ(s.latest(outliers), 1000);
+  CHECK_EQ(outliers, 3);                                                        // 7-й, 14-й и 21-й отсчёты окна
+  for (size_t i = 0; i < 3 * AdcSampler::kWindow; ++i) s.sampleOnce();
+  const AdcSampler::ChannelStats st = s.stats(0);
+  CHECK_EQ(st.windows, 4u);
+  CHECK_EQ(st.samples, static_cast<uint32_t>(4 * AdcSampler::kWindow));
+  CHECK_EQ(st.outlier_total, 12u);
+  CHECK_EQ(st.max_outliers, 3);
+}                                                                               // Завершение testOutliersRejected
+//
+void testStepFollowed() {                                                       // Скачок уровня: медиана за пол-окна
+  reset(1000, 0);
+  AdcSampler s;
+  s.setReadFunction(levelSource);
+  s.begin(1, 2000);
+  g_level = 1200;
+  uint8_t outliers = 0;
+  for (size_t i = 0; i < AdcSampler::kWindow / 2; ++i) s.sampleOnce();
+  CHECK_EQ(s.latest(outliers), 1000);                                           // Новых отсчётов меньше половины
+  s.sampleOnce();
+  CHECK_EQ(s.latest(outliers), 1200);                                           // Медиана перешла, старые — выбросы
+  CHECK_EQ(outliers, static_cast<uint8_t>(AdcSampler::kWindow / 2));
+  for (size_t i = 0; i < AdcSampler::kWindow; ++i) s.sampleOnce();
+  CHECK_EQ(s.latest(outliers), 1200);
+  CHECK_EQ(outliers, 0);
+}                                                                               // Завершение testStepFollowed
+//
+void testChannelsAndFrames() {                                                  // Каналы по кругу, кадр после круга
+  AdcSampler s;
+  CHECK_EQ(s.addChannel(5), 1);
+  CHECK_EQ(s.addChannel(6), 2);
+  CHECK_EQ(s.addChannel(7), -1);                                                // Больше kMaxChannels нельзя
+  AdcSampler::Frame f;
+  CHECK(!s.readFrame(f));
+  s.setReadFunction(pinSource);
+  CHECK(s.begin(3, 3000));
+  CHECK_EQ(s.channelCount(), 3);
+  CHECK_EQ(s.channelPin(2), 6);
+  CHECK_EQ(s.frameCount(), static_cast<uint32_t>(AdcSampler::kWindow));         // Круг — три тика
+  CHECK(s.readFrame(f));
+  CHECK_EQ(f.seq, s.frameCount());
+  CHECK_EQ(f.count, 3);
+  CHECK_EQ(f.adc[0], 300);
+  CHECK_EQ(f.adc[1], 500);
+  CHECK_EQ(f.adc[2], 600);
+  for (int i = 0; i < 3; ++i) s.sampleOnce();                                   // Время хоста — по тикам после запуска
+  CHECK(s.readFrame(f));
+  const uint32_t t0 = f.t_us;
+  for (int i = 0; i < 3; ++i) s.sampleOnce();
+  CHECK(s.readFrame(f));
+  CHECK_EQ(f.t_us - t0, 3000u);                                                 // Круг — один период канала
+  CHECK_EQ(s.sampleCount(1), static_cast<uint32_t>(AdcSampler::kWindow + 2));
+  CHECK_EQ(s.sampleCount(3), 0u);                                               // Нет такого канала
+  uint8_t outliers = 0;
+  CHECK_EQ(s.latest(3, outliers), 0);
+  CHECK(!s.ready(3));
+}                                                                               // Завершение testChannelsAndFrames
+//
+void testOpenCircuit() {                                                        // Обрыв виден по первому отсчёту
+  reset(1000, 0);
+  AdcSampler s;
+  s.setReadFunction(levelSource);
+  s.begin(1, 2000);
+  g_level = 4095;
+  s.sampleOnce();
+  CHECK(s.openCircuit());
+  uint8_t outliers = 0;
+  CHECK_EQ(s.latest(outliers), 1000);                                           // Медиана ещё старая
+  g_level = 1000;
+  s.sampleOnce();
+  CHECK(!s.openCircuit());
+}                                                                               // Завершение testOpenCircuit
+//
+void testMedianPeriod() {                                                       // Смена частоты не сбрасывает окно
+  reset(1000, 0);
+  AdcSampler s;
+  s.setReadFunction(levelSource);
+  s.begin(1, 2000);
+  s.setMedianPeriod(10000);
+  CHECK_EQ(s.periodUs(), 10000u);
+  CHECK(s.ready());
+  CHECK_EQ(s.windowCount(), 1u);
+}                                                                               // Завершение testMedianPeriod
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testBeginFillsWindow();
+  testOutliersRejected();
+  testStepFollowed();
+  testChannelsAndFrames();
+  testOpenCircuit();
+  testMedianPeriod();
+  return test::finish("test_adc_sampler");
+}                                                                               // Завершение main
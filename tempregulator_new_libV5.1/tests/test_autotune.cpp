@@ -0,0 +1,239 @@
+// AutotuneSession: реле и ступенька мощности на печи первого порядка с
+// запаздыванием, исходы poll() и перебор правил. RelayAutotune: остановка по
+// сходимости раньше прежних 6 пересечений, устойчивость к шуму термопары и
+// Ku против точного предельного цикла реле на той же печи.
+#include <math.h>                                                               // exp, log, sqrt
+#include <string.h>                                                             // strcmp
+//
+#include "../AutotuneSession.h"                                                 // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Модель и проверки
+//
+using Outcome = AutotuneSession::Outcome;
+//
+class Plant {                                                                   // K·e^(−θs)/(τs + 1) от выхода 0..255
+public:                                                                         // Публичный интерфейс
+  Plant(double gain, double tau_s, double dead_s, double ambient_c, double dt_s = 1.0)
+      : gain_(gain), a_(dt_s / tau_s), ambient_(ambient_c), y_(ambient_c),
+        delay_n_(static_cast<int>(dead_s / dt_s + 0.5)) {}
+  double step(uint8_t u) {                                                      // Шаг dt_s
+    hist_[head_ % kHist] = u;
+    const uint8_t ud = head_ >= delay_n_ ? hist_[(head_ - delay_n_) % kHist] : 0;
+    ++head_;
+    y_ += (ambient_ + gain_ * ud - y_) * a_;
+    return y_;
+  }                                                                             // Конец step
+  double y() const { return y_; }                                               // Температура, °C
+  double measured(double noise) {                                               // С шумом термопары размахом noise
+    seed_ = seed_ * 1664525u + 1013904223u;
+    return y_ + noise * ((seed_ >> 16) % 1001 / 1000.0 - 0.5);
+  }                                                                             // Конец measured
+//
+private:                                                                        // Внутреннее состояние
+  static constexpr int kHist = 1024;                                            // Запаздывание до 1023 шагов
+  double gain_, a_, ambient_, y_;
+  int delay_n_;
+  int head_ = 0;
+  uint32_t seed_ = 12345;                                                       // Генератор шума
+  uint8_t hist_[kHist] = {};
+};                                                                              // Конец определения класса Plant
+//
+Outcome run(AutotuneSession& at, Plant& p, uint32_t& now, uint32_t limit_ms) {  // Тики по 1 с до исхода
+  Outcome o = at.poll(now);
+  while (o == Outcome::Running && now - at.startedMs() < limit_ms) {
+    now += 1000;
+    p.step(at.tick(now, Q16::fromDouble(p.y())));
+    o = at.poll(now);
+  }
+  return o;
+}                                                                               // Завершение run
+//
+void testStepConverges() {                                                      // Ступенька находит модель
+  Plant p(2.5, 600.0, 20.0, 20.0);
+  AutotuneSession at;
+  CHECK_EQ(at.poll(0), Outcome::Idle);
+  at.setMethod(AutotuneSession::kStep);
+  uint32_t now = 1000;
+  at.start(now, Q16::fromDouble(400.0), Q16::fromDouble(2.0), Q16::fromDouble(p.y()));
+  CHECK(at.active());
+  CHECK_EQ(run(at, p, now, AutotuneSession::kTimeoutMs), Outcome::Converged);
+  CHECK(!at.active());
+  CHECK_EQ(at.tick(now + 1000, Q16::fromDouble(p.y())), 0);                     // После сходимости выход снят
+  const StepIdentifier::Model m = at.step().model();
+  CHECK(m.valid);
+  CHECK_NEAR(m.gain, 2.5, 0.25);
+  CHECK_NEAR(m.tau_s, 600.0, 60.0);
+  CHECK_NEAR(m.dead_s, 20.0, 10.0);
+  const RelayAutotune::Gains g = at.gains();
+  CHECK(g.valid);
+  CHECK(g.kp > 0.0 && g.ki > 0.0);
+}                                                                               // Завершение testStepConverges
+//
+void testRelayConverges() {                                                     // Реле: период и размах установились
+  Plant p(2.5, 600.0, 20.0, 20.0);
+  AutotuneSession at;
+  uint32_t now = 0;
+  at.start(now, Q16::fromDouble(200.0), Q16::fromDouble(2.0), Q16::fromDouble(p.y()));
+  CHECK_EQ(run(at, p, now, AutotuneSession::kTimeoutMs), Outcome::Converged);
+  CHECK(at.relay().converged());
+  CHECK(at.relay().periodMs() > 40000);                                         // Не меньше двух запаздываний
+  CHECK(at.relay().amplitudeC() > 2.0f);                                        // Больше гистерезиса
+  CHECK(at.gains().valid);
+  CHECK_NEAR(at.startedMs(), 0.0, 0.0);
+}                                                                               // Завершение testRelayConverges
+//
+// Печь прошивочной модели: 2 °C на единицу выхода, τ 600 с, θ 30 с, шаг
+// регулятора 100 мс, реле 0/255 вокруг 200 °C.
+constexpr double   kK = 2.0, kTau = 600.0, kTheta = 30.0, kAmbient = 25.0;
+constexpr double   kSetpoint = 200.0;
+constexpr uint32_t kStepMs = 100;
+constexpr uint32_t kRelayLimitMs = 4UL * 3600 * 1000;
+constexpr double   kPi = 3.14159265358979323846;
+//
+uint32_t legacyStopMs(double noise) {                                           // Прежняя остановка: 6 пересечений уставки
+  Plant p(kK, kTau, kTheta, kAmbient, kStepMs / 1000.0);
+  bool on = true, above = false;
+  uint8_t crossings = 0;
+  uint32_t t = 0;
+  double pv = p.measured(noise);
+  for (uint32_t now = 0; now < kRelayLimitMs && crossings < 6; now += kStepMs) {
+    if (on && pv > kSetpoint + 2.0) on = false;
+    else if (!on && pv < kSetpoint - 2.0) on = true;
+    if ((pv > kSetpoint) != above) {
+      above = !above;
+      ++crossings;
+      t = now;
+    }
+    p.step(on ? 255 : 0);
+    pv = p.measured(noise);
+  }
+  return t;
+}                                                                               // Завершение legacyStopMs
+//
+uint32_t relayStopMs(RelayAutotune& at, double noise, double hyst) {            // Реле до сходимости, время остановки
+  Plant p(kK, kTau, kTheta, kAmbient, kStepMs / 1000.0);
+  at.start(0, Q16::fromDouble(kSetpoint), Q16::fromDouble(hyst), Q16::fromDouble(p.y()));
+  uint32_t t = 0;
+  for (uint32_t now = 0; now < kRelayLimitMs && at.running(); now += kStepMs) {
+    p.step(at.tick(now, Q16::fromDouble(p.measured(noise))) ? 255 : 0);
+    t = now;
+  }
+  return t;
+}                                                                               // Завершение relayStopMs
+//
+void testRelayStopsEarly() {                                                    // Сходимость раньше 6 пересечений
+  RelayAutotune at;
+  const uint32_t t_new = relayStopMs(at, 0.0, 2.0);
+  const uint32_t t_old = legacyStopMs(0.0);
+  printf("relay: 6 crossings %lu s, converged %lu s\n", static_cast<unsigned long>(t_old / 1000),
+         static_cast<unsigned long>(t_new / 1000));
+  CHECK(at.converged());
+  CHECK(t_new < t_old);
+}                                                                               // Завершение testRelayStopsEarly
+//
+void testRelayNoise() {                                                         // Дребезг у уставки не останавливает реле
+  RelayAutotune clean, noisy;
+  const uint32_t t_clean = relayStopMs(clean, 0.0, 2.0);
+  const uint32_t t_noisy = relayStopMs(noisy, 1.0, 2.0);                        // ±0.5 °C
+  printf("relay noise: converged %lu s (clean %lu s), legacy %lu s\n", static_cast<unsigned long>(t_noisy / 1000),
+         static_cast<unsigned long>(t_clean / 1000), static_cast<unsigned long>(legacyStopMs(1.0) / 1000));
+  CHECK(noisy.converged());
+  CHECK_EQ(noisy.switches(), clean.switches());                                 // Лишних переключений нет
+  CHECK_NEAR(t_noisy, t_clean, 0.05 * t_clean);
+  CHECK_NEAR(noisy.periodMs(), clean.periodMs(), 0.05 * clean.periodMs());
+  CHECK_NEAR(noisy.amplitudeC(), clean.amplitudeC(), 0.05 * clean.amplitudeC());
+}                                                                               // Завершение testRelayNoise
+//
+void testRelayUltimateGain() {                                                  // Ku по описывающей функции точного цикла
+  constexpr double kHyst = 6.0;                                                 // Широкий гистерезис: поправка заметна
+  const double e = exp(-kTheta / kTau);                                         // За запаздывание печь идёт дальше
+  const double y_hi = kAmbient + kK * 255, y_lo = kAmbient;                     // Куда тянут включённое и выключенное реле
+  const double y_max = y_hi - (y_hi - (kSetpoint + kHyst)) * e;
+  const double y_min = y_lo + (kSetpoint - kHyst - y_lo) * e;
+  const double t_on = kTheta + kTau * log((y_hi - y_min) / (y_hi - kSetpoint - kHyst));
+  const double t_off = kTheta + kTau * log((y_max - y_lo) / (kSetpoint - kHyst - y_lo));
+  const double a = (y_max - y_min) / 2.0;
+  const double ku = 4.0 * 127.5 / (kPi * sqrt(a * a - kHyst * kHyst));
+  RelayAutotune at;
+  relayStopMs(at, 0.0, kHyst);
+  printf("relay Ku %.3f (analytic %.3f, without hysteresis %.3f), Tu %.1f s (analytic %.1f s)\n",
+         at.ultimateGain(), ku, 4.0 * 127.5 / (kPi * a), at.periodMs() / 1000.0, t_on + t_off);
+  CHECK(at.converged());
+  CHECK_NEAR(at.amplitudeC(), a, 0.02 * a);
+  CHECK_NEAR(at.periodMs() / 1000.0, t_on + t_off, 0.02 * (t_on + t_off));
+  CHECK_NEAR(at.ultimateGain(), ku, 0.02 * ku);
+}                                                                               // Завершение testRelayUltimateGain
+//
+void testRuleCycling() {                                                        // Правила по кругу, в обе стороны
+  AutotuneSession at;
+  CHECK_EQ(at.rule(), 0);
+  at.selectRule(-1);
+  CHECK_EQ(at.rule(), RelayAutotune::kRuleCount - 1);
+  CHECK(!strcmp(at.ruleName(), RelayAutotune::ruleName(RelayAutotune::kZieglerNichols)));
+  at.selectRule(1);
+  CHECK_EQ(at.rule(), 0);
+  at.selectRule(RelayAutotune::kRuleCount + 1);
+  CHECK_EQ(at.rule(), 1);
+//
+  at.toggleMethod();
+  CHECK_EQ(at.method(), AutotuneSession::kStep);
+  at.start(0, Q16::fromDouble(100.0), Q16::fromDouble(2.0), Q16::fromDouble(20.0));
+  CHECK_EQ(at.rule(), 0);                                                       // Запуск сбрасывает правило
+  at.selectRule(-1);
+  CHECK_EQ(at.rule(), StepIdentifier::kTuningCount - 1);
+  CHECK(!strcmp(at.ruleName(), StepIdentifier::tuningName(StepIdentifier::kLambdaPi)));
+  at.stop();
+}                                                                               // Завершение testRuleCycling
+//
+void testStopAndLimit() {                                                       // Прерывание и предел температуры
+  Plant p(2.5, 600.0, 20.0, 20.0);
+  AutotuneSession at;
+  uint32_t now = 0;
+  at.start(now, Q16::fromDouble(200.0), Q16::fromDouble(2.0), Q16::fromDouble(p.y()));
+  for (int i = 0; i < 10; ++i) p.step(at.tick(now += 1000, Q16::fromDouble(p.y())));
+  CHECK_EQ(at.poll(now), Outcome::Running);
+  at.stop();
+  CHECK(!at.active());
+  CHECK_EQ(at.poll(now), Outcome::Stopped);
+//
+  Plant q(2.5, 600.0, 20.0, 20.0);
+  at.setMethod(AutotuneSession::kStep);
+  now = 0;
+  at.start(now, Q16::fromDouble(60.0), Q16::fromDouble(2.0), Q16::fromDouble(q.y()));  // Предел раньше θ + 0.4τ
+  CHECK_EQ(run(at, q, now, AutotuneSession::kTimeoutMs), Outcome::LimitReached);
+  CHECK(at.step().limitReached());
+}                                                                               // Завершение testStopAndLimit
+//
+void testTimeout() {                                                            // Печь не дотягивает до цели
+  Plant p(0.5, 600.0, 20.0, 20.0);                                              // Предел 147 °C
+  AutotuneSession at;
+  uint32_t now = 5000;
+  at.start(now, Q16::fromDouble(300.0), Q16::fromDouble(2.0), Q16::fromDouble(p.y()));
+  CHECK_EQ(run(at, p, now, AutotuneSession::kTimeoutMs + 2000), Outcome::TimedOut);
+  CHECK_EQ(now - at.startedMs(), AutotuneSession::kTimeoutMs + 1000);
+  CHECK(at.active());                                                           // Выход снимает вызывающий
+  at.stop();
+}                                                                               // Завершение testTimeout
+//
+void testTargetRange() {                                                        // Допустимая цель
+  CHECK(!AutotuneSession::targetValid(39.9f));
+  CHECK(AutotuneSession::targetValid(AutotuneSession::kMinTargetC));
+  CHECK(AutotuneSession::targetValid(AutotuneSession::kMaxTargetC));
+  CHECK(!AutotuneSession::targetValid(500.1f));
+}                                                                               // Завершение testTargetRange
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testStepConverges();
+  testRelayConverges();
+  testRelayStopsEarly();
+  testRelayNoise();
+  testRelayUltimateGain();
+  testRuleCycling();
+  testStopAndLimit();
+  testTimeout();
+  testTargetRange();
+  return test::finish("test_autotune");
+}                                                                               // Завершение main
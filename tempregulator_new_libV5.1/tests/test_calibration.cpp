@@ -0,0 +1,150 @@
+// CalibrationWizard: шаги, тайм-ауты, устойчивость отсчёта и итоговые
+// коэффициенты по модели АЦП термопары типа K.
+#include "../CalibrationWizard.h"                                               // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Модель и проверки
+//
+using Step = CalibrationWizard::Step;
+using Event = CalibrationWizard::Event;
+using Error = CalibrationWizard::Error;
+//
+constexpr double kUvPerCount = 10.0;                                            // Усилитель: мкВ на единицу АЦП
+constexpr double kUvOffset = -150.0;                                            // Смещение нуля, мкВ
+//
+uint16_t adcFor(double hot_c, double cj_c) {                                    // Отсчёт для температуры спаев
+  const double e = (tc::emf(tc::Type::K, Q16::fromDouble(hot_c)) - tc::emf(tc::Type::K, Q16::fromDouble(cj_c))).toDouble();
+  return static_cast<uint16_t>((e - kUvOffset) / kUvPerCount + 0.5);
+}                                                                               // Завершение adcFor
+//
+CalibrationWizard::Reading reading(uint16_t adc, float cj_c, bool sensor = true, uint8_t outliers = 0) {
+  return CalibrationWizard::Reading{adc, outliers, cj_c, sensor};
+}                                                                               // Завершение reading
+//
+void testHappyPath() {                                                          // Полный проход с датчиком спая
+  CalibrationWizard w;
+  CHECK_EQ(w.tick(0, reading(0, 0), tc::Type::K), Event::None);                 // До start() ничего не делает
+  w.start(1000);
+  CHECK_EQ(w.step(), Step::InputAmbient);
+  CHECK(!w.confirmBoiling(1000));                                               // Не с того шага
+  w.confirmAmbient(5000, 23.0f);
+  CHECK_EQ(w.step(), Step::MeasureAmbient);
+  const uint16_t a1 = adcFor(23.0, 24.0);
+  CHECK_EQ(w.tick(5100, reading(a1, 24.0f), tc::Type::K), Event::AmbientMeasured);
+  CHECK_EQ(w.step(), Step::WaitStable);
+//
+  const uint16_t a2 = adcFor(100.0, 24.5);
+  uint32_t t = 6000;
+  CHECK_EQ(w.tick(t, reading(a2, 24.5f), tc::Type::K), Event::None);           // Скачок — не устойчиво
+  CHECK(!w.confirmBoiling(t));
+  Event ev = Event::None;
+  for (t += 100; t < 6000 + 100 + CalibrationWizard::kStableHoldMs + 200 && ev == Event::None; t += 100) {
+    ev = w.tick(t, reading(static_cast<uint16_t>(a2 + (t / 100) % 3), 24.5f), tc::Type::K);  // Шум ±2 единицы
+  }
+  CHECK_EQ(ev, Event::StableChanged);
+  CHECK(w.stable());
+  CHECK(t - 6100 >= CalibrationWizard::kStableHoldMs);
+  CHECK(w.confirmBoiling(t));
+  CHECK_EQ(w.step(), Step::MeasureBoiling);
+  CHECK_EQ(w.tick(t + 100, reading(a2, 24.5f), tc::Type::K), Event::Finished);
+  CHECK_EQ(w.step(), Step::Done);
+  CHECK_EQ(w.error(), Error::None);
+//
+  const tc::Calibration& c = w.result();
+  CHECK_NEAR(c.emf_slope, kUvPerCount, 0.05);
+  CHECK_NEAR(c.emf_offset, kUvOffset, 15.0);
+  CHECK_NEAR(c.slope * a1 + c.offset, 23.0, 1e-3);                              // Линейная пара проходит через обе точки
+  CHECK_NEAR(c.slope * a2 + c.offset, 100.0, 1e-3);
+}                                                                               // Завершение testHappyPath
+//
+void testNoColdJunctionSensor() {                                               // Без датчика спай = окружающая среда
+  CalibrationWizard w;
+  w.start(0);
+  w.confirmAmbient(10, 21.0f);
+  const uint16_t a1 = adcFor(21.0, 21.0);
+  CHECK_EQ(w.tick(20, reading(a1, 99.0f, false), tc::Type::K), Event::AmbientMeasured);
+  const uint16_t a2 = adcFor(100.0, 21.0);
+  uint32_t t = 100;
+  for (; !w.stable() && t < 10000; t += 100) w.tick(t, reading(a2, 99.0f, false), tc::Type::K);
+  CHECK(w.confirmBoiling(t));
+  CHECK_EQ(w.tick(t, reading(a2, 99.0f, false), tc::Type::K), Event::Finished);
+  CHECK_NEAR(w.result().emf_slope, kUvPerCount, 0.05);                          // cj_c = 99 проигнорирован
+}                                                                               // Завершение testNoColdJunctionSensor
+//
+void testStabilityResets() {                                                    // Отсчёт ушёл — устойчивость снята
+  CalibrationWizard w;
+  w.start(0);
+  w.confirmAmbient(0, 25.0f);
+  w.tick(0, reading(100, 25.0f), tc::Type::Linear);
+  uint32_t t = 0;
+  for (; !w.stable(); t += 100) w.tick(t, reading(500, 25.0f), tc::Type::Linear);
+  CHECK_EQ(w.tick(t, reading(500 + CalibrationWizard::kStableDelta + 1, 25.0f), tc::Type::Linear), Event::StableChanged);
+  CHECK(!w.stable());
+  CHECK(!w.confirmBoiling(t));
+  CHECK_EQ(w.lastAdc(), 500 + CalibrationWizard::kStableDelta + 1);
+}                                                                               // Завершение testStabilityResets
+//
+void testTimeouts() {                                                           // Тайм-аут каждого шага
+  CalibrationWizard w;
+  w.start(0xFFFFF000u);                                                         // Через переполнение millis()
+  CHECK_EQ(w.tick(0xFFFFF000u + CalibrationWizard::kStepTimeoutMs, reading(0, 0), tc::Type::K), Event::None);
+  CHECK_EQ(w.tick(0xFFFFF001u + CalibrationWizard::kStepTimeoutMs, reading(0, 0), tc::Type::K), Event::Failed);
+  CHECK_EQ(w.error(), Error::AmbientTimeout);
+  CHECK_EQ(w.step(), Step::Error);
+  CHECK_EQ(w.tick(0, reading(0, 0), tc::Type::K), Event::None);                 // Ошибка — конечное состояние
+//
+  w.start(0);
+  w.confirmAmbient(0, 25.0f);
+  w.tick(0, reading(100, 25.0f), tc::Type::K);
+  Event ev = Event::None;
+  for (uint32_t t = 0; ev != Event::Failed && t < 2 * CalibrationWizard::kStepTimeoutMs; t += 1000) {
+    ev = w.tick(t, reading(static_cast<uint16_t>(100 + t / 20), 25.0f), tc::Type::K);  // Вода греется: не устоялось
+  }
+  CHECK_EQ(ev, Event::Failed);
+  CHECK_EQ(w.error(), Error::BoilingTimeout);
+  CHECK(CalibrationWizard::errorText(w.error())[0] != '\0');
+}                                                                               // Завершение testTimeouts
+//
+void testBack() {                                                               // «Назад» перезапускает тайм-аут
+  CalibrationWizard w;
+  w.start(0);
+  w.confirmAmbient(50000, 25.0f);
+  w.tick(50000, reading(100, 25.0f), tc::Type::K);
+  w.back(59000);
+  CHECK_EQ(w.step(), Step::InputAmbient);
+  CHECK_EQ(w.tick(59000 + CalibrationWizard::kStepTimeoutMs, reading(0, 0), tc::Type::K), Event::None);
+  w.confirmAmbient(70000, 22.0f);
+  CHECK_NEAR(w.ambientC(), 22.0, 0.0);
+  w.back(70000);                                                                // Не с того шага — без эффекта
+  CHECK_EQ(w.step(), Step::MeasureAmbient);
+}                                                                               // Завершение testBack
+//
+void testErrors() {                                                             // Выбросы и малая разница АЦП
+  CalibrationWizard w;
+  w.start(0);
+  w.confirmAmbient(0, 25.0f);
+  CHECK_EQ(w.tick(0, reading(100, 25.0f, true, CalibrationWizard::kMaxOutliers + 1), tc::Type::K), Event::Failed);
+  CHECK_EQ(w.error(), Error::SensorFault);
+//
+  w.start(0);
+  w.confirmAmbient(0, 25.0f);
+  CHECK_EQ(w.tick(0, reading(1000, 25.0f, true, CalibrationWizard::kMaxOutliers), tc::Type::K), Event::AmbientMeasured);
+  const uint16_t small = 1000 + CalibrationWizard::kMinAdcDiff - 1;
+  uint32_t t = 0;
+  for (; !w.stable(); t += 100) w.tick(t, reading(small, 25.0f), tc::Type::K);
+  CHECK(w.confirmBoiling(t));
+  CHECK_EQ(w.tick(t, reading(small, 25.0f), tc::Type::K), Event::Failed);
+  CHECK_EQ(w.error(), Error::SmallSpan);
+}                                                                               // Завершение testErrors
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testHappyPath();
+  testNoColdJunctionSensor();
+  testStabilityResets();
+  testTimeouts();
+  testBack();
+  testErrors();
+  return test::finish("test_calibration");
+}                                                                               // Завершение main
@@ -0,0 +1,84 @@
+// ControlScheduler: приведение периода, корзины гистограмм и статистика шага
+// по подменённым часам (на хосте tick() вызывается вручную).
+#include "../ControlScheduler.h"                                                // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Часы и проверки
+//
+uint32_t g_now_us = 0;                                                          // Подменённое время
+uint32_t g_exec_us = 0;                                                         // Сколько «длится» шаг
+int g_steps = 0;                                                                // Вызовов шага
+//
+uint32_t fakeClock() { return g_now_us; }
+void step(void*) { ++g_steps; g_now_us += g_exec_us; }
+//
+void testClampPeriod() {                                                        // Пределы и кратность 10 мс
+  CHECK_EQ(ControlScheduler::clampPeriod(0), 20u);
+  CHECK_EQ(ControlScheduler::clampPeriod(19), 20u);
+  CHECK_EQ(ControlScheduler::clampPeriod(24), 20u);
+  CHECK_EQ(ControlScheduler::clampPeriod(25), 30u);
+  CHECK_EQ(ControlScheduler::clampPeriod(100), 100u);
+  CHECK_EQ(ControlScheduler::clampPeriod(104), 100u);
+  CHECK_EQ(ControlScheduler::clampPeriod(155), 160u);
+  CHECK_EQ(ControlScheduler::clampPeriod(999), 1000u);
+  CHECK_EQ(ControlScheduler::clampPeriod(65535), 1000u);
+  for (uint32_t p = 0; p < 1200; ++p) {
+    CHECK_EQ(ControlScheduler::clampPeriod(p) % ControlScheduler::kPeriodStepMs, 0u);
+  }
+}                                                                               // Завершение testClampPeriod
+//
+void testBins() {                                                               // Граница корзины включительно
+  CHECK_EQ(ControlScheduler::binFor(0), 0);
+  CHECK_EQ(ControlScheduler::binFor(50), 0);
+  CHECK_EQ(ControlScheduler::binFor(51), 1);
+  CHECK_EQ(ControlScheduler::binFor(5000), 6);
+  CHECK_EQ(ControlScheduler::binFor(5001), ControlScheduler::kBins - 1);
+}                                                                               // Завершение testBins
+//
+void testStats() {                                                              // Джиттер, время шага, перегрузки
+  ControlScheduler s;
+  s.setClock(&fakeClock);
+  s.tick();                                                                     // До begin() шаг не задан
+  CHECK_EQ(g_steps, 0);
+  CHECK(s.begin(&step, nullptr, 103));
+  CHECK_EQ(s.periodMs(), 100u);
+//
+  g_exec_us = 300;
+  for (int i = 0; i < 10; ++i) {                                                // Ровно по периоду
+    g_now_us = uint32_t(i) * 100000;
+    s.tick();
+  }
+  ControlScheduler::Stats st = s.stats();
+  CHECK_EQ(st.steps, 10u);
+  CHECK_EQ(g_steps, 10);
+  CHECK_EQ(st.jitter[0], 9u);                                                   // Первый шаг без интервала
+  CHECK_EQ(st.exec[ControlScheduler::binFor(300)], 10u);
+  CHECK_EQ(st.max_exec_us, 300u);
+  CHECK_EQ(st.overruns, 0u);
+//
+  g_now_us = 10 * 100000 + 60000;                                               // Опоздание на 60 мс — больше полупериода
+  s.tick();
+  g_exec_us = 120000;                                                           // Шаг дольше периода
+  g_now_us = 12 * 100000;
+  s.tick();
+  st = s.stats();
+  CHECK_EQ(st.overruns, 2u);
+  CHECK_EQ(st.max_jitter_us, 60000u);
+//
+  s.setPeriod(55);
+  st = s.stats();
+  CHECK_EQ(st.period_ms, 60u);
+  s.resetStats();
+  st = s.stats();
+  CHECK_EQ(st.steps, 0u);
+  CHECK_EQ(st.period_ms, 60u);
+}                                                                               // Завершение testStats
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testClampPeriod();
+  testBins();
+  testStats();
+  return test::finish("test_control_scheduler");
+}                                                                               // Завершение main
@@ -0,0 +1,151 @@
+// TemperatureEstimator на модели печи первого порядка с гауссовым шумом
+// измерения: шум и запаздывание оценки температуры, оценка скорости роста,
+// отклик на ступеньку мощности и перезапуск после разрыва.
+#include <math.h>                                                               // sqrt, log, cos, exp
+//
+#include "../TemperatureEstimator.h"                                            // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Модель и проверки
+//
+constexpr double kGain = 2.5;                                                   // °C на единицу мощности в установившемся режиме
+constexpr double kTau = 3000.0;                                                 // Постоянная времени, с
+constexpr double kAmbient = 20.0;                                               // Окружающая среда, °C
+constexpr double kSigma = 0.5;                                                  // СКО шума измерения, °C (r = 0.25)
+constexpr double kFullRate = kGain * 255.0 / kTau;                              // b: °C/с на полной мощности у холодной печи
+constexpr double kDt = TemperatureEstimator::kPeriodMs / 1000.0;                // Шаг, с
+//
+class Noise {                                                                   // Воспроизводимый гауссов шум
+public:                                                                         // Публичный интерфейс
+  double next() {                                                               // N(0, 1), Бокс — Мюллер
+    const double u1 = (uniform() + 1.0) / 4294967297.0;
+    const double u2 = uniform() / 4294967296.0;
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+  }                                                                             // Конец next
+//
+private:                                                                        // Внутреннее состояние
+  double uniform() {                                                            // 0..2³²−1
+    state_ = state_ * 6364136223846793005ull + 1442695040888963407ull;
+    return static_cast<double>(state_ >> 32);
+  }                                                                             // Конец uniform
+  uint64_t state_ = 0x5EEDull;
+};                                                                              // Конец определения класса Noise
+//
+struct Stats {                                                                  // Ошибки относительно истинной температуры
+  double sum = 0.0, sum2 = 0.0;
+  int n = 0;
+  void add(double e) { sum += e; sum2 += e * e; ++n; }
+  double mean() const { return n ? sum / n : 0.0; }
+  double rms() const { return n ? sqrt(sum2 / n) : 0.0; }
+  double sd() const { const double m = mean(); return n ? sqrt(sum2 / n - m * m) : 0.0; }
+};                                                                              // Конец определения структуры Stats
+//
+struct Run {                                                                    // Итоги прогона на одном участке
+  Stats raw, est, rate;
+};                                                                              // Конец определения структуры Run
+//
+// Печь от kAmbient: power_at(t) задаёт мощность, ошибки копятся в окне
+// [from_s, to_s). Модель оценщика знает только b — потери на окружающую
+// среду ей неизвестны и уходят в оценку дрейфа.
+template <typename Power>
+Run simulate(TemperatureEstimator& est, Power power_at, double from_s, double to_s) {
+  Noise noise;
+  Run run;
+  double y = kAmbient;
+  for (uint32_t n = 0; n * kDt < to_s; ++n) {
+    const double t = n * kDt;
+    const uint32_t now = n * TemperatureEstimator::kPeriodMs;
+    const int u = power_at(t);
+    const double measured = y + kSigma * noise.next();
+    est.update(now, Q16::fromDouble(measured), u);
+    if (t >= from_s) {
+      const double slope = (kAmbient + kGain * u - y) / kTau;                   // Истинная скорость роста
+      run.raw.add(measured - y);
+      run.est.add(est.temperature().toDouble() - y);
+      run.rate.add(est.rate().toDouble() - slope);
+    }
+    y += kDt * (kAmbient + kGain * u - y) / kTau;                               // Мощность этого шага действует до следующего
+  }
+  return run;
+}                                                                               // Завершение simulate
+//
+TemperatureEstimator configured(double b) {                                     // Оценщик с шумами по умолчанию
+  TemperatureEstimator est;
+  est.configure(TemperatureEstimator::kDefaultProcessNoise, TemperatureEstimator::kDefaultMeasureNoise, b);
+  return est;
+}                                                                               // Завершение configured
+//
+void testRampNoiseAndLag() {                                                    // Разгон на полной мощности
+  TemperatureEstimator est = configured(kFullRate);
+  const Run r = simulate(est, [](double) { return 255; }, 60.0, 1200.0);
+  CHECK_NEAR(r.raw.rms(), kSigma, 0.02);                                        // Шум модели измерения как задан
+  CHECK(r.est.rms() < 0.4 * r.raw.rms());                                       // Оценка заметно тише показания
+  CHECK_NEAR(r.est.mean(), 0.0, 0.02);                                          // Без отставания: 0.21 °C/с × 0.1 с = 0.02 °C
+  CHECK_NEAR(r.rate.mean(), 0.0, 0.005);                                        // Скорость роста без смещения
+  CHECK(r.rate.sd() < 0.1);                                                     // Разность соседних показаний: √2·σ/dt ≈ 7 °C/с
+}                                                                               // Завершение testRampNoiseAndLag
+//
+void testHoldWithUnknownLosses() {                                              // Удержание: потери видны только как дрейф
+  TemperatureEstimator est = configured(kFullRate);
+  const Run r = simulate(est, [](double t) { return t < 900.0 ? 255 : 60; }, 1200.0, 3000.0);
+  CHECK(r.est.rms() < 0.4 * r.raw.rms());
+  CHECK_NEAR(r.est.mean(), 0.0, 0.02);
+  CHECK_NEAR(r.rate.mean(), 0.0, 0.005);                                        // Дрейф объяснил потери
+}                                                                               // Завершение testHoldWithUnknownLosses
+//
+void testPowerStepLeadsMeasurement() {                                          // Мощность меняет скорость сразу, а не через невязку
+  TemperatureEstimator with_model = configured(kFullRate);
+  TemperatureEstimator without_model = configured(0.0);
+  const auto step = [](double t) { return t < 600.0 ? 0 : 255; };
+  simulate(with_model, step, 0.0, 600.0 + kDt);
+  simulate(without_model, step, 0.0, 600.0 + kDt);
+  const double jump = with_model.rate().toDouble() - without_model.rate().toDouble();
+  CHECK_NEAR(jump, kFullRate, 0.005);                                           // Первый же шаг после включения
+  const Run lagging = simulate(without_model, step, 600.0, 630.0);
+  const Run leading = simulate(with_model, step, 600.0, 630.0);
+  CHECK(leading.est.mean() > -0.05);
+  CHECK(lagging.est.mean() < leading.est.mean());                               // Без модели оценка отстаёт на разгоне
+}                                                                               // Завершение testPowerStepLeadsMeasurement
+//
+void testStepsAndGaps() {                                                       // Шаги по времени и перезапуск
+  TemperatureEstimator est = configured(kFullRate);
+  CHECK(!est.primed());
+  CHECK(est.update(1000, Q16(100), 0));                                // Первое измерение принимается как есть
+  CHECK(est.primed());
+  CHECK_NEAR(est.temperature().toDouble(), 100.0, 0.0);
+  CHECK(!est.update(1000 + TemperatureEstimator::kPeriodMs - 1, Q16(200), 0));  // Шаг ещё не прошёл
+  CHECK_NEAR(est.temperature().toDouble(), 100.0, 0.0);
+  CHECK(est.update(1000 + TemperatureEstimator::kPeriodMs, Q16(101), 0));
+  CHECK_NEAR(est.innovation().toDouble(), 1.0, 1e-4);
+  CHECK(est.temperature().toDouble() > 100.0 && est.temperature().toDouble() < 101.0);
+  const uint32_t gap = 1100 + (TemperatureEstimator::kMaxCatchUpSteps + 1) * TemperatureEstimator::kPeriodMs;
+  CHECK(est.update(gap, Q16(300), 0));                                 // Долгий разрыв — начинаем с измерения
+  CHECK_NEAR(est.temperature().toDouble(), 300.0, 0.0);
+  CHECK_NEAR(est.rate().toDouble(), 0.0, 0.0);
+  est.reset();
+  CHECK(!est.primed());
+}                                                                               // Завершение testStepsAndGaps
+//
+void testConfigureDefaults() {                                                  // Неположительные шумы заменяются
+  TemperatureEstimator a = configured(0.0);
+  TemperatureEstimator b;
+  b.configure(0.0, -1.0, 0.0);
+  CHECK_EQ(a.gainT().raw(), b.gainT().raw());
+  CHECK_EQ(a.gainRate().raw(), b.gainRate().raw());
+  CHECK(a.gainT().toDouble() > 0.0 && a.gainT().toDouble() < 1.0);
+  CHECK(a.gainRate().toDouble() > 0.0);
+  TemperatureEstimator quiet;
+  quiet.configure(TemperatureEstimator::kDefaultProcessNoise, 4.0, 0.0);        // Шумнее датчик — меньше доверия измерению
+  CHECK(quiet.gainT().raw() < a.gainT().raw());
+}                                                                               // Завершение testConfigureDefaults
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testRampNoiseAndLag();
+  testHoldWithUnknownLosses();
+  testPowerStepLeadsMeasurement();
+  testStepsAndGaps();
+  testConfigureDefaults();
+  return test::finish("test_estimator");
+}                                                                               // Завершение main
@@ -0,0 +1,78 @@
+// EventTrace: формат снимка, порядок записей по времени и затирание старых.
+#include <string.h>                                                             // memcmp
+//
+#include <vector>                                                               // Буфер снимка
+//
+#include "../EventTrace.h"                                                      // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Разбор снимка и проверки
+//
+uint32_t get32(const uint8_t* p) {                                              // Little-endian
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}                                                                               // Завершение get32
+//
+struct Snapshot {                                                               // Разобранный снимок
+  uint32_t written = 0, dropped = 0, count = 0, now_us = 0;
+  std::vector<uint32_t> ts;                                                     // Метки записей
+  std::vector<uint8_t> ids;                                                     // События записей
+};                                                                              // Конец структуры Snapshot
+//
+Snapshot take() {                                                               // Снимок и разбор
+  std::vector<uint8_t> buf(EventTrace::snapshotSize());
+  CHECK_EQ(EventTrace::snapshot(buf.data(), buf.size() - 1), 0u);               // Мал буфер — снимка нет
+  const size_t n = EventTrace::snapshot(buf.data(), buf.size());
+  Snapshot s;
+  CHECK(n >= 24);
+  CHECK(!memcmp(buf.data(), "TRC1", 4));
+  CHECK_EQ(buf[4] | (buf[5] << 8), EventTrace::kRecordSize);
+  CHECK_EQ(buf[6] | (buf[7] << 8), EventTrace::kCount);
+  s.written = get32(&buf[8]);
+  s.dropped = get32(&buf[12]);
+  s.count = get32(&buf[16]);
+  s.now_us = get32(&buf[20]);
+  size_t pos = 24;
+  for (int i = 0; i < EventTrace::kCount; ++i) pos += strlen(reinterpret_cast<const char*>(&buf[pos])) + 1;
+  CHECK_EQ(n, pos + static_cast<size_t>(s.count) * EventTrace::kRecordSize);
+  for (uint32_t i = 0; i < s.count; ++i, pos += EventTrace::kRecordSize) {
+    s.ts.push_back(get32(&buf[pos]));
+    s.ids.push_back(buf[pos + 4]);
+  }
+  return s;
+}                                                                               // Завершение take
+//
+void testOrderAndFormat() {                                                     // Записи по времени, метки не позже снимка
+  for (int i = 0; i < 10; ++i) {
+    TR_TRACE_SCOPE(kControl, i);
+    TR_TRACE_COUNTER(kEncoder, i);
+  }
+  const Snapshot s = take();
+  CHECK_EQ(s.written, 30u);
+  CHECK_EQ(s.count, 30u);
+  CHECK_EQ(s.dropped, 0u);
+  for (uint32_t i = 0; i < s.count; ++i) {
+    CHECK(s.now_us - s.ts[i] < 1000000u);                                       // Возраст не «отрицательный»
+    if (i > 0) CHECK(s.now_us - s.ts[i - 1] >= s.now_us - s.ts[i]);
+  }
+  CHECK_EQ(s.ids[0], EventTrace::kControl);
+  CHECK_EQ(s.ids[1], EventTrace::kEncoder);
+  CHECK(!strcmp(EventTrace::name(EventTrace::kWsSend), "ws_send"));
+  CHECK(!strcmp(EventTrace::name(EventTrace::kCount), "?"));
+}                                                                               // Завершение testOrderAndFormat
+//
+void testWrap() {                                                               // Кольцо хранит последние kCapacity
+  const uint32_t before = take().written;
+  for (int i = 0; i < 2 * EventTrace::kCapacity; ++i) TR_TRACE_INSTANT(kTouch, i);
+  const Snapshot s = take();
+  CHECK_EQ(s.written, before + 2u * EventTrace::kCapacity);
+  CHECK_EQ(s.count, static_cast<uint32_t>(EventTrace::kCapacity));
+  for (uint8_t id : s.ids) CHECK_EQ(id, EventTrace::kTouch);
+}                                                                               // Завершение testWrap
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testOrderAndFormat();
+  testWrap();
+  return test::finish("test_event_trace");
+}                                                                               // Завершение main
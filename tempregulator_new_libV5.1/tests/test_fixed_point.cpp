@@ -0,0 +1,80 @@
+// Fixed<N>: округление, насыщение, перевод форматов и совпадение горячего
+// пути в Q16 с эталоном на double (PID и перевод АЦП в температуру).
+#include "../FixedPoint.h"                                                      // Проверяемый модуль
+#include "../PIDController.h"                                                   // PIDControllerT<double> и <Q16>
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+constexpr double kQ16Step = 1.0 / 65536;                                        // Единица младшего разряда Q16
+//
+void testConversions() {                                                        // Из double, из дроби, в целое
+  CHECK_EQ(Q16(3).raw(), 3 * 65536);
+  CHECK_EQ(Q16::fromDouble(1.5).raw(), 98304);
+  CHECK_EQ(Q16::fromDouble(-1.5).raw(), -98304);
+  CHECK_EQ(Q16::fromDouble(kQ16Step * 0.6).raw(), 1);                          // К ближайшему, а не вниз
+  CHECK_EQ(Q16::fromDouble(-kQ16Step * 0.6).raw(), -1);
+  CHECK_NEAR(Q16::fromRatio(1, 3).toDouble(), 1.0 / 3, kQ16Step);
+  CHECK_EQ(Q16::fromDouble(2.75).toInt(), 2);
+  CHECK_EQ(Q16::fromDouble(-2.25).toInt(), -3);                                 // Целая часть — вниз
+  CHECK_EQ(Q16::fromDouble(2.5).roundToInt(), 3);
+  CHECK_EQ(Q16::fromDouble(1e6).raw(), INT32_MAX);                              // Вне диапазона — насыщение
+  CHECK_EQ(Q24::fromDouble(-200.0).raw(), INT32_MIN);
+}                                                                               // Завершение testConversions
+//
+void testSaturation() {                                                         // Арифметика без переполнения
+  const Q16 big = Q16(30000);
+  CHECK_EQ((big + big).raw(), INT32_MAX);
+  CHECK_EQ((-big - big).raw(), INT32_MIN);
+  CHECK_EQ((big * Q16(2)).raw(), INT32_MAX);
+  CHECK_EQ((-Q16::min()).raw(), INT32_MAX);
+  CHECK_EQ((Q16(1) / Q16()).raw(), INT32_MAX);                                  // Деление на ноль — к пределу
+  CHECK_EQ((Q16(-1) / Q16()).raw(), INT32_MIN);
+  CHECK_NEAR((Q16::fromDouble(7.25) * Q16::fromDouble(-0.5)).toDouble(), -3.625, 0.0);
+  CHECK_NEAR((Q16(10) / Q16(4)).toDouble(), 2.5, 0.0);
+}                                                                               // Завершение testSaturation
+//
+void testMulInt() {                                                             // Наклон Q24 × отсчёт АЦП
+  const Q24 slope = Q24::fromDouble(0.2446);                                    // °C на единицу АЦП
+  const Q16 offset = Q16::fromDouble(-12.5);
+  double worst = 0.0;
+  for (int32_t adc = 0; adc <= 4095; ++adc) {
+    const double ref = -12.5 + 0.2446 * adc;
+    const double err = fabs((offset + mulInt<16>(slope, adc)).toDouble() - ref);
+    if (err > worst) worst = err;
+  }
+  CHECK(worst < 1e-3);                                                          // Ошибка Q24 наклона на 4095 — доли мК
+  CHECK_EQ(mulInt<24>(Q16(3), 2).raw(), 6 << 24);                               // В более точный формат
+  CHECK_EQ(mulInt<16>(Q24::fromDouble(100.0), 1000).raw(), INT32_MAX);          // С насыщением
+}                                                                               // Завершение testMulInt
+//
+void testPidMatchesDouble() {                                                   // Одинаковые входы — одинаковый выход
+  PIDControllerDouble ref;
+  PIDController q;
+  ref.setCoeffs(2.0, 0.05, 1.0);                                                // Интеграл за прогон ~25: без насыщения
+  q.setCoeffs(2.0, 0.05, 1.0);
+  ref.setSetpoint(210.0);
+  q.setSetpoint(210.0);
+  ref.setOutputLimits(-1000, 1000);                                             // Без насыщения: сравниваем саму арифметику
+  q.setOutputLimits(-1000, 1000);
+  int worst = 0;
+  for (int i = 0; i < 2000; ++i) {
+    const double pv = 200.0 + 15.0 * ((i * 37) % 101) / 100.0;                  // Пила с шагом 0.15 °C
+    const int a = ref.compute(pv, 100);
+    const int b = q.compute(Q16::fromDouble(pv), 100);
+    const int d = a > b ? a - b : b - a;
+    if (d > worst) worst = d;
+  }
+  CHECK(worst <= 1);                                                            // Расходятся не больше чем на единицу выхода
+  CHECK_NEAR(q.integralTerm().toDouble(), ref.integralTerm(), 1e-3);
+}                                                                               // Завершение testPidMatchesDouble
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testConversions();
+  testSaturation();
+  testMulInt();
+  testPidMatchesDouble();
+  return test::finish("test_fixed_point");
+}                                                                               // Завершение main
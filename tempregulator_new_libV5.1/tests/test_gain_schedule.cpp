@@ -0,0 +1,155 @@
+// GainSchedule: интерполяция против расчёта на double в серединах и внутри
+// интервалов, крайние наборы за концами таблицы, сортировка и отбрасывание
+// точек в compile(); WorkLoop не трогает PID, пока таблица сдвинула
+// коэффициенты меньше чем на 1/256.
+#include "../GainSchedule.h"                                                    // Проверяемый модуль
+#include "../WorkLoop.h"                                                        // Гистерезис смены коэффициентов
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+constexpr double kTolQ16 = 1e-3;                                                // Kp, Kd: доля интервала в Q16, 2^-16 от размаха Kd 40 ≈ 6e-4
+constexpr double kTolQ24 = 2e-7;                                                // Ki: несколько младших разрядов Q24
+//
+struct Gains {                                                                  // Итог eval() в double
+  double kp, ki, kd;
+};                                                                              // Конец структуры Gains
+//
+Gains eval(const GainSchedule& gs, double pv) {                                 // eval() для температуры pv
+  Q16 kp, kd;
+  Q24 ki;
+  gs.eval(Q16::fromDouble(pv), kp, ki, kd);
+  return Gains{kp.toDouble(), ki.toDouble(), kd.toDouble()};
+}                                                                               // Завершение eval
+//
+Gains reference(const GainSchedule::Point* p, uint8_t n, double pv) {           // То же в double, точки по возрастанию
+  if (pv <= p[0].temp_c) return Gains{p[0].kp, p[0].ki, p[0].kd};
+  for (uint8_t i = 0; i + 1 < n; ++i) {
+    if (pv < p[i + 1].temp_c) {
+      const double w = (pv - p[i].temp_c) / (p[i + 1].temp_c - p[i].temp_c);
+      return Gains{p[i].kp + (p[i + 1].kp - p[i].kp) * w, p[i].ki + (p[i + 1].ki - p[i].ki) * w,
+                   p[i].kd + (p[i + 1].kd - p[i].kd) * w};
+    }
+  }
+  return Gains{p[n - 1].kp, p[n - 1].ki, p[n - 1].kd};
+}                                                                               // Завершение reference
+//
+void checkGains(const Gains& g, const Gains& ref) {                             // Совпадение с точностью типа
+  CHECK_NEAR(g.kp, ref.kp, kTolQ16);
+  CHECK_NEAR(g.ki, ref.ki, kTolQ24);
+  CHECK_NEAR(g.kd, ref.kd, kTolQ16);
+}                                                                               // Завершение checkGains
+//
+const GainSchedule::Point kTable[] = {                                          // Печь: к 300 °C жёстче, к 500 мягче
+  {100.0f, 1.0f, 0.0001f, 10.0f},
+  {300.0f, 3.0f, 0.0003f, 50.0f},
+  {500.0f, 2.0f, 0.0005f, 20.0f},
+};
+//
+void testInterpolation() {                                                      // Середины, произвольные точки и концы
+  GainSchedule gs;
+  gs.compile(kTable, 3);
+  CHECK(gs.active());
+  CHECK_EQ(gs.count(), 3);
+  checkGains(eval(gs, 200.0), Gains{2.0, 0.0002, 30.0});                        // Середины интервалов
+  checkGains(eval(gs, 400.0), Gains{2.5, 0.0004, 35.0});
+  for (double pv = 20.0; pv <= 620.0; pv += 7.3) checkGains(eval(gs, pv), reference(kTable, 3, pv));
+  checkGains(eval(gs, 300.0), Gains{3.0, 0.0003, 50.0});                        // Ровно в узле
+  checkGains(eval(gs, 99.99), Gains{1.0, 0.0001, 10.0});                        // Ниже таблицы — первый набор
+  checkGains(eval(gs, -40.0), Gains{1.0, 0.0001, 10.0});
+  checkGains(eval(gs, 500.01), Gains{2.0, 0.0005, 20.0});                       // Выше — последний
+  checkGains(eval(gs, 1200.0), Gains{2.0, 0.0005, 20.0});
+//
+  GainSchedule one;                                                             // Одна точка — везде её набор
+  one.compile(kTable + 1, 1);
+  checkGains(eval(one, 20.0), Gains{3.0, 0.0003, 50.0});
+  checkGains(eval(one, 900.0), Gains{3.0, 0.0003, 50.0});
+}                                                                               // Завершение testInterpolation
+//
+void testCompile() {                                                            // Сортировка, повторы и выключенные точки
+  const GainSchedule::Point shuffled[] = {
+    {500.0f, 2.0f, 0.0005f, 20.0f},
+    {100.0f, 1.0f, 0.0001f, 10.0f},
+    {300.0f, 3.0f, 0.0003f, 50.0f},
+    {100.0f, 9.0f, 0.0009f, 90.0f},                                             // Та же температура — отбрасывается
+  };
+  GainSchedule gs;
+  gs.compile(shuffled, 4);
+  CHECK_EQ(gs.count(), 3);
+  for (double pv = 20.0; pv <= 620.0; pv += 11.1) checkGains(eval(gs, pv), reference(kTable, 3, pv));
+//
+  const GainSchedule::Point off[] = {                                           // Температура ≤ 0 — точка не используется
+    {0.0f, 9.0f, 0.0009f, 90.0f},
+    {300.0f, 3.0f, 0.0003f, 50.0f},
+    {-5.0f, 9.0f, 0.0009f, 90.0f},
+    {100.0f, 1.0f, 0.0001f, 10.0f},
+  };
+  gs.compile(off, 4);
+  CHECK_EQ(gs.count(), 2);
+  checkGains(eval(gs, 200.0), Gains{2.0, 0.0002, 30.0});
+//
+  const GainSchedule::Point many[] = {                                          // Больше kMaxPoints — лишние не читаются
+    {100.0f, 1.0f, 0.0001f, 10.0f}, {200.0f, 2.0f, 0.0002f, 20.0f}, {300.0f, 3.0f, 0.0003f, 30.0f},
+    {400.0f, 4.0f, 0.0004f, 40.0f}, {50.0f, 9.0f, 0.0009f, 90.0f},
+  };
+  gs.compile(many, 5);
+  CHECK_EQ(gs.count(), GainSchedule::kMaxPoints);
+  checkGains(eval(gs, 60.0), Gains{1.0, 0.0001, 10.0});
+  const GainSchedule::Point neg[] = {{200.0f, -1.0f, -0.001f, -5.0f}};          // Отрицательные коэффициенты — ноль
+  gs.compile(neg, 1);
+  checkGains(eval(gs, 200.0), Gains{0.0, 0.0, 0.0});
+  gs.compile(neg, 0);
+  CHECK(!gs.active());
+}                                                                               // Завершение testCompile
+//
+void testWorkLoopHysteresis() {                                                 // Мелкие сдвиги таблицы не пересчитывают PID
+  PIDController pid;
+  GainSchedule schedule;
+  ProfileRunner profile;
+  OvershootShaper shaper;
+  AdaptivePid adaptive;
+  WorkLoop loop{pid, schedule, profile, shaper, adaptive};
+  const GainSchedule::Point table[] = {{100.0f, 2.0f, 0.0001f, 20.0f}, {500.0f, 4.0f, 0.0002f, 40.0f}};
+  schedule.compile(table, 2);
+  pid.setFixedDt(100);
+  uint32_t updates = 0;
+  bool held = true;                                                             // Без смены — таблица в пределах 1/256
+  bool jumped = true;                                                           // Со сменой — ровно значение таблицы
+  for (int i = 0; i <= 1000; ++i) {                                             // 100 → 200 °C по 0.1 °C
+    const Q16 pv = Q16::fromDouble(100.0 + 0.1 * i);
+    const Q16 kp0 = pid.proportionalGain();
+    const Q24 ki0 = pid.integralGain();
+    const Q16 kd0 = pid.derivativeGain();
+    int out = 0;
+    CHECK_EQ(loop.step({uint32_t(i) * 100, pv, Q16(150), 0, true, true, true}, out), WorkLoop::Result::Power);
+    Q16 kp, kd;
+    Q24 ki;
+    schedule.eval(pv, kp, ki, kd);
+    if (pid.proportionalGain() == kp0 && pid.integralGain() == ki0 && pid.derivativeGain() == kd0) {
+      held = held && (kp - kp0).raw() * WorkLoop::kGainStep <= kp0.raw() &&
+             (ki - ki0).raw() * WorkLoop::kGainStep <= ki0.raw() &&
+             (kd - kd0).raw() * WorkLoop::kGainStep <= kd0.raw();
+    } else {
+      ++updates;
+      jumped = jumped && pid.proportionalGain() == kp && pid.integralGain() == ki && pid.derivativeGain() == kd;
+    }
+  }
+  printf("schedule: %u PID updates over 1001 steps\n", static_cast<unsigned>(updates));
+  CHECK(held);
+  CHECK(jumped);
+  CHECK(updates > 1 && updates < 100);                                          // Kp 2 → 2.5: около ln(1.25)·256 ≈ 57
+  int out = 0;
+  const Q16 kp_before = pid.proportionalGain();
+  loop.step({200000, Q16::fromDouble(200.0), Q16(150), 0, true, true, false}, out);  // Таблица выключена — PID не трогаем
+  loop.step({200100, Q16::fromDouble(450.0), Q16(150), 0, true, true, false}, out);
+  CHECK(pid.proportionalGain() == kp_before);
+}                                                                               // Завершение testWorkLoopHysteresis
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testInterpolation();
+  testCompile();
+  testWorkLoopHysteresis();
+  return test::finish("test_gain_schedule");
+}                                                                               // Завершение main
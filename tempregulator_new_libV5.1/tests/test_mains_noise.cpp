@@ -0,0 +1,132 @@
+// Синтетическая сетевая наводка на входе АЦП: режим MainsIntegrate против
+// медианы с шагом 2 мс, выбросы и синхронизация окна с фронтами SSR.
+#include <math.h>                                                               // sin
+//
+#include "../AdcSampler.h"                                                      // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Источник с наводкой и проверки
+//
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLevel = 2000.0;                                               // Полезный сигнал, единиц АЦП
+//
+struct Hum {                                                                    // Параметры наводки
+  double hz = 50.0;                                                             // Частота сети
+  double amp = 300.0;                                                           // Основная гармоника, единиц АЦП
+  double phase = 0.0;                                                           // Фаза в момент первого отсчёта
+  uint32_t period_us = 1000;                                                    // Шаг выборки источника
+  uint32_t n = 0;                                                               // Номер отсчёта
+  uint32_t spike_at = UINT32_MAX;                                               // Номер отсчёта-выброса
+} g_hum;
+//
+uint16_t humSource(uint8_t) {                                                   // Сигнал + 1-я и 3-я гармоники сети
+  const double t = g_hum.n * (g_hum.period_us * 1e-6);
+  const double w = 2.0 * kPi * g_hum.hz;
+  double v = kLevel + g_hum.amp * sin(w * t + g_hum.phase) + 0.3 * g_hum.amp * sin(3.0 * w * t + 2.0 * g_hum.phase);
+  if (g_hum.n == g_hum.spike_at) v = 4000.0;
+  ++g_hum.n;
+  return static_cast<uint16_t>(v + 0.5);
+}                                                                               // Завершение humSource
+//
+double worstError(AdcSampler::Mode mode, double hz, double phase, uint32_t median_period_us) {  // Наибольшее отклонение от kLevel
+  g_hum = Hum{};
+  g_hum.hz = hz;
+  g_hum.phase = phase;
+  AdcSampler s;
+  s.setReadFunction(humSource);
+  s.setMode(mode, static_cast<uint8_t>(hz), false);
+  g_hum.period_us = mode == AdcSampler::Mode::Median ? median_period_us : s.periodUs();
+  s.begin(0, median_period_us);
+  double worst = 0.0;
+  for (int i = 0; i < 400; ++i) {
+    s.sampleOnce();
+    uint8_t outliers = 0;
+    const uint16_t v = s.latest(outliers);
+    if (!s.ready()) continue;
+    if (fabs(v - kLevel) > worst) worst = fabs(v - kLevel);
+  }
+  return worst;
+}                                                                               // Завершение worstError
+//
+void testHumRejected() {                                                        // Целый период сети — наводка в ноль
+  double mains50 = 0.0, mains60 = 0.0, median = 0.0;
+  for (int k = 0; k < 16; ++k) {                                                // Фаза сети относительно выборки
+    const double ph = 2.0 * kPi * k / 16;
+    mains50 = fmax(mains50, worstError(AdcSampler::Mode::MainsIntegrate, 50.0, ph, 2000));
+    mains60 = fmax(mains60, worstError(AdcSampler::Mode::MainsIntegrate, 60.0, ph, 2000));
+    median = fmax(median, worstError(AdcSampler::Mode::Median, 50.0, ph, 2000));
+  }
+  printf("hum 300 counts: median 2 ms %.1f, mains 50 Hz %.1f, mains 60 Hz %.1f counts\n", median, mains50, mains60);
+  CHECK(mains50 <= 1.0);                                                        // Остаток — округление среднего
+  CHECK(mains60 <= 2.0);                                                        // 20 × 833 мкс короче периода на 7 мкс
+  CHECK(median > 10.0 * mains60);                                               // Медиана с шагом 2 мс наводку пропускает
+}                                                                               // Завершение testHumRejected
+//
+void testPeriodFromMains() {                                                    // Период выборки задаёт сеть
+  AdcSampler s;
+  s.setMode(AdcSampler::Mode::MainsIntegrate, 50, false);
+  CHECK_EQ(s.periodUs(), 1000u);
+  s.setMode(AdcSampler::Mode::MainsIntegrate, 60, false);
+  CHECK_EQ(s.periodUs(), 833u);
+  s.setMode(AdcSampler::Mode::MainsIntegrate, 55, false);                       // Нестандартная частота — 50 Гц
+  CHECK_EQ(s.periodUs(), 1000u);
+  CHECK(s.mode() == AdcSampler::Mode::MainsIntegrate);
+}                                                                               // Завершение testPeriodFromMains
+//
+void testSpikeReplaced() {                                                      // Выброс заменяется средним прошлого периода
+  g_hum = Hum{};
+  g_hum.spike_at = 60;
+  AdcSampler s;
+  s.setReadFunction(humSource);
+  s.setMode(AdcSampler::Mode::MainsIntegrate, 50, false);
+  s.begin(0, 2000);
+  uint8_t outliers = 0;
+  uint8_t seen = 0;
+  double worst = 0.0;
+  for (int i = 0; i < 100; ++i) {
+    s.sampleOnce();
+    const uint16_t v = s.latest(outliers);
+    if (outliers > seen) seen = outliers;
+    if (fabs(v - kLevel) > worst) worst = fabs(v - kLevel);
+  }
+  CHECK_EQ(seen, 1);
+  CHECK_EQ(outliers, 0);                                                        // Выброс ушёл из окна
+  CHECK(worst <= 20.0);                                                         // Без замены было бы +100
+  CHECK_EQ(s.stats(0).max_outliers, 1);
+}                                                                               // Завершение testSpikeReplaced
+//
+void checkSsrEdge(bool sync) {                                                  // Фронт SSR посреди периода
+  g_hum = Hum{};
+  g_hum.amp = 0.0;
+  AdcSampler s;
+  s.setReadFunction(humSource);
+  s.setMode(AdcSampler::Mode::MainsIntegrate, 50, sync);
+  s.begin(0, 2000);
+  const uint32_t w0 = s.windowCount();
+  while (s.windowCount() == w0) s.sampleOnce();                                 // Начало периода
+  const uint32_t windows = s.windowCount();
+  const size_t half = AdcSampler::kMainsSamples / 2;
+  for (size_t i = 0; i < half; ++i) s.sampleOnce();
+  s.notifySsrEdge();
+  for (size_t i = 0; i < half; ++i) s.sampleOnce();
+  CHECK_EQ(s.windowCount() - windows, sync ? 0u : 1u);                          // С синхронизацией период начат с фронта
+  for (size_t i = half; i < AdcSampler::kMainsSamples; ++i) s.sampleOnce();
+  CHECK_EQ(s.windowCount() - windows, 1u);
+  uint8_t outliers = 0;
+  CHECK_EQ(s.latest(outliers), static_cast<uint16_t>(kLevel));
+}                                                                               // Завершение checkSsrEdge
+//
+void testSsrEdgeRestartsWindow() {                                              // С синхронизацией период заново, без — как шёл
+  checkSsrEdge(true);
+  checkSsrEdge(false);
+}                                                                               // Завершение testSsrEdgeRestartsWindow
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testHumRejected();
+  testPeriodFromMains();
+  testSpikeReplaced();
+  testSsrEdgeRestartsWindow();
+  return test::finish("test_mains_noise");
+}                                                                               // Завершение main
@@ -0,0 +1,90 @@
+// SlidingMedianFilter против прямого расчёта по окну (копия, nth_element,
+// проход по окну) на случайных отсчётах с выбросами и повторами.
+#include <stdlib.h>                                                             // abs
+//
+#include <algorithm>                                                            // nth_element, is_sorted
+#include <random>                                                               // mt19937
+#include <vector>                                                               // Эталонное окно
+//
+#include "../MedianFilter.h"                                                    // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Эталон и проверки
+//
+constexpr size_t   kWindow = 21;                                                // Как у AdcSampler
+constexpr uint32_t kThreshold = 50;
+//
+uint16_t reference(const std::vector<uint16_t>& win, uint16_t& med, uint8_t& outliers) {  // Прежний расчёт
+  std::vector<uint16_t> sv = win;
+  std::nth_element(sv.begin(), sv.begin() + sv.size() / 2, sv.end());
+  med = sv[sv.size() / 2];
+  uint32_t acc = 0;
+  uint16_t n = 0;
+  outliers = 0;
+  for (uint16_t s : win) {
+    if (abs(int(s) - int(med)) <= int(kThreshold)) { acc += s; ++n; } else { ++outliers; }
+  }
+  return static_cast<uint16_t>(acc / n);                                        // Медиана всегда в допуске
+}                                                                               // Завершение reference
+//
+void testAgainstReference(uint32_t seed, int spread, int repeat_every) {        // Случайный поток
+  std::mt19937 rng(seed);
+  SlidingMedianFilter<kWindow, kThreshold> f;
+  std::vector<uint16_t> win;
+  int mismatches = 0;
+  uint16_t last = 2000;
+  for (int i = 0; i < 20000; ++i) {
+    uint16_t s = static_cast<uint16_t>(2000 + int(rng() % (2 * spread + 1)) - spread);
+    if (rng() % 29 == 0) s = static_cast<uint16_t>(rng() % 4096);               // Выброс
+    if (repeat_every && i % repeat_every == 0) s = last;                        // Повтор значения
+    last = s;
+    f.push(s);
+    win.push_back(s);
+    if (win.size() > kWindow) win.erase(win.begin());
+    uint16_t med = 0;
+    uint8_t ref_o = 0, o = 0;
+    const uint16_t ref = reference(win, med, ref_o);
+    const uint16_t got = f.filtered(o);
+    if (f.median() != med || got != ref || o != ref_o) ++mismatches;
+  }
+  CHECK_EQ(mismatches, 0);
+  CHECK(f.full());
+}                                                                               // Завершение testAgainstReference
+//
+void testGrowthAndWrap() {                                                      // Рост окна, wrapped() и reset()
+  SlidingMedianFilter<5, 10> f;
+  uint8_t o = 0;
+  CHECK_EQ(f.filtered(o), 0);
+  CHECK_EQ(o, 0);
+  const uint16_t in[] = {30, 10, 20, 10, 500};
+  for (size_t i = 0; i < 5; ++i) {
+    f.push(in[i]);
+    CHECK_EQ(f.size(), i + 1);
+    CHECK_EQ(f.wrapped(), i == 4);
+  }
+  CHECK_EQ(f.median(), 20);
+  CHECK_EQ(f.filtered(o), 17);                                                  // (30 + 10 + 20 + 10) / 4
+  CHECK_EQ(o, 1);
+  f.push(500);                                                                  // Вытесняет 30 — новое правее
+  CHECK_EQ(f.median(), 20);                                                     // 10 10 20 500 500
+  f.push(500);                                                                  // Вытесняет 10
+  CHECK_EQ(f.median(), 500);                                                    // 10 20 500 500 500
+  f.push(0);                                                                    // Вытесняет 20 — новое левее
+  CHECK_EQ(f.median(), 500);                                                    // 0 10 500 500 500
+  CHECK_EQ(f.filtered(o), 500);
+  CHECK_EQ(o, 2);
+  f.reset();
+  CHECK_EQ(f.size(), 0u);
+  f.push(7);
+  CHECK_EQ(f.median(), 7);
+}                                                                               // Завершение testGrowthAndWrap
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testAgainstReference(1, 30, 0);
+  testAgainstReference(2, 3, 5);                                                // Узкий разброс: много равных значений
+  testAgainstReference(3, 200, 0);                                              // Разброс больше допуска
+  testGrowthAndWrap();
+  return test::finish("test_median_filter");
+}                                                                               // Завершение main
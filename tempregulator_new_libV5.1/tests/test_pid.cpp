@@ -0,0 +1,171 @@
+// PIDController: Q16 против эталона на double на медленной печи (малый Ki,
+// шаг 100 мс) с пределами выброса и выхода в полосу, симметрия интеграла,
+// смена уставки без броска, антинасыщение на долгой рампе, безударная смена
+// коэффициентов и переход из ручного режима.
+#include "../PIDController.h"                                                   // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Модель и проверки
+//
+constexpr uint32_t kDtMs = 100;                                                 // Период регулятора прошивки
+//
+class Plant {                                                                   // K·e^(−θs)/(τs + 1) от выхода 0..255
+public:                                                                         // Публичный интерфейс
+  Plant(double gain, double tau_s, double dead_s, double ambient_c)
+      : gain_(gain), a_(kDtMs / 1000.0 / tau_s), ambient_(ambient_c), y_(ambient_c),
+        delay_n_(static_cast<int>(dead_s * 1000.0 / kDtMs)) {}
+  double step(int u) {                                                          // Шаг kDtMs
+    hist_[head_ % kHist] = u;
+    const int ud = head_ >= delay_n_ ? hist_[(head_ - delay_n_) % kHist] : 0;
+    ++head_;
+    y_ += (ambient_ + gain_ * ud - y_) * a_;
+    return y_;
+  }                                                                             // Конец step
+//
+private:                                                                        // Внутреннее состояние
+  static constexpr int kHist = 1024;                                            // Запаздывание до 102 с
+  double gain_, a_, ambient_, y_;
+  int delay_n_;
+  int head_ = 0;
+  int hist_[kHist] = {};
+};                                                                              // Конец определения класса Plant
+//
+struct Response {                                                               // Итог прогона
+  double overshoot;                                                             // Наибольший выброс над уставкой, °C
+  double settle_s;                                                              // Последний выход из полосы ±1 °C, с
+  double offset;                                                                // Средняя ошибка за последний час, °C
+};                                                                              // Конец структуры Response
+//
+template <typename T>
+Response run(double kp, double ki, double kd) {                                 // Ступенька 20 → 300 °C, 40 ч
+  constexpr double kSetpoint = 300.0;
+  constexpr uint32_t kSteps = 40u * 3600u * 1000u / kDtMs;
+  constexpr uint32_t kLastHour = 3600u * 1000u / kDtMs;
+  Plant plant(2.5, 3000.0, 60.0, 20.0);                                         // Модель из автонастройки печи
+  PIDControllerT<T> pid;
+  pid.setCoeffs(kp, ki, kd);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(kSetpoint);
+  Response r{0.0, 0.0, 0.0};
+  double y = 20.0;
+  for (uint32_t i = 0; i < kSteps; ++i) {
+    y = plant.step(pid.compute(NumericTraits<T>::fromDouble(y), kDtMs));
+    if (y - kSetpoint > r.overshoot) r.overshoot = y - kSetpoint;
+    if (fabs(y - kSetpoint) > 1.0) r.settle_s = (i + 1) * (kDtMs / 1000.0);
+    if (i >= kSteps - kLastHour) r.offset += (kSetpoint - y) / kLastHour;
+  }
+  return r;
+}                                                                               // Завершение run
+//
+void testSlowFurnace() {                                                        // Малый Ki: ki·dt ≈ 4e-5 на шаг
+  const Response ref = run<double>(2.507, 0.0004185, 35.02);
+  const Response q = run<Q16>(2.507, 0.0004185, 35.02);
+  printf("double: overshoot %.3f C, settle %.0f s, offset %.4f C\n", ref.overshoot, ref.settle_s, ref.offset);
+  printf("Q16:    overshoot %.3f C, settle %.0f s, offset %.4f C\n", q.overshoot, q.settle_s, q.offset);
+  CHECK(ref.settle_s > 0.0 && ref.settle_s < 12.0 * 3600.0);                    // Эталон входит в полосу
+  CHECK(q.overshoot < 0.5);                                                     // Коэффициенты автонастройки: без выброса
+  CHECK(q.settle_s < 8.0 * 3600.0);                                             // В полосе ±1 °C за 8 ч
+  CHECK_NEAR(q.offset, 0.0, 0.02);                                              // Без статической ошибки
+  CHECK_NEAR(q.overshoot, ref.overshoot, 0.1 + 0.05 * ref.overshoot);
+  CHECK_NEAR(q.settle_s, ref.settle_s, 0.05 * ref.settle_s);
+//
+  const Response ref_fast = run<double>(5.0, 0.01, 35.02);                      // Резкий Ki: выброс есть
+  const Response q_fast = run<Q16>(5.0, 0.01, 35.02);
+  printf("fast double: overshoot %.3f C, settle %.0f s; Q16: overshoot %.3f C, settle %.0f s\n",
+         ref_fast.overshoot, ref_fast.settle_s, q_fast.overshoot, q_fast.settle_s);
+  CHECK(q_fast.overshoot < 3.0);                                                // Выброс есть, но ограничен
+  CHECK(q_fast.settle_s < 3600.0);                                              // В полосе за час
+  CHECK_NEAR(q_fast.overshoot, ref_fast.overshoot, 0.05 * ref_fast.overshoot);
+  CHECK_NEAR(q_fast.settle_s, ref_fast.settle_s, 0.05 * ref_fast.settle_s);
+  CHECK_NEAR(q_fast.offset, 0.0, 0.02);
+}                                                                               // Завершение testSlowFurnace
+//
+void testIntegralSymmetry() {                                                   // +e и −e поровну — интеграл на месте
+  PIDController pid;
+  pid.setCoeffs(0.0, 0.0004185, 0.0);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(100.0);
+  pid.initialize(Q16(100), 100);                                                // Интеграл 100, вне насыщения
+  for (int i = 0; i < 20000; ++i) pid.compute(Q16::fromDouble(99.7), kDtMs);    // Ошибка +0.3
+  const double up = pid.integralTerm().toDouble();
+  CHECK_NEAR(up, 100.0 + 0.0004185 * 0.1 * 0.3 * 20000, 1e-3);
+  for (int i = 0; i < 20000; ++i) pid.compute(Q16::fromDouble(100.3), kDtMs);   // Ошибка −0.3
+  CHECK_NEAR(pid.integralTerm().toDouble(), 100.0, 2.0 / 65536);
+}                                                                               // Завершение testIntegralSymmetry
+//
+void testBumplessGains() {                                                      // Смена Kp не дёргает выход
+  PIDController pid;
+  pid.setCoeffs(2.0, 0.01, 0.0);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(200.0);
+  pid.initialize(Q16(190), 100);
+  const int before = pid.compute(Q16(190), kDtMs);
+  pid.setCoeffs(3.0, 0.01, 0.0);
+  const int after = pid.compute(Q16(190), kDtMs);
+  CHECK(after - before <= 1 && before - after <= 1);
+}                                                                               // Завершение testBumplessGains
+//
+void testSetpointStep() {                                                       // Уставка 200 → 250: ни броска D, ни сброса интеграла
+  PIDController pid;
+  pid.setCoeffs(2.507, 0.0004185, 35.02);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(200.0);
+  pid.initialize(Q16(200), 80);                                                 // Установившийся режим: выход 80
+  for (int i = 0; i < 100; ++i) pid.compute(Q16(200));
+  const double i_before = pid.integralTerm().toDouble();
+  const int before = pid.compute(Q16(200));
+  pid.setSetpoint(250.0);
+  const int after = pid.compute(Q16(200));
+  CHECK_NEAR(pid.derivativeTerm().toDouble(), 0.0, 1e-3);                       // Измерение не менялось — D нет
+  CHECK_NEAR(pid.integralTerm().toDouble(), i_before, 0.0004185 * 0.1 * 50 + 1e-3);  // Только шаг интегрирования
+  CHECK_NEAR(after - before, 2.507 * 50, 1.0);                                  // Скачок ровно на Kp·Δуставки
+}                                                                               // Завершение testSetpointStep
+//
+void testRampWindup() {                                                         // 10 ч на полной мощности: интеграл не растёт
+  PIDController pid;
+  pid.setCoeffs(2.507, 0.0004185, 35.02);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(300.0);
+  constexpr uint32_t kSteps = 10u * 3600u * 1000u / kDtMs;                      // Рампа 20 → 310 °C
+  double i_max = 0.0;
+  double pv_release = 0.0;                                                      // Где выход впервые ушёл с 255
+  for (uint32_t i = 0; i < kSteps; ++i) {
+    const double pv = 20.0 + 290.0 * i / kSteps;
+    const int out = pid.compute(Q16::fromDouble(pv));
+    if (pid.integralTerm().toDouble() > i_max) i_max = pid.integralTerm().toDouble();
+    if (out < 255 && pv_release == 0.0) pv_release = pv;
+  }
+  printf("ramp: integral max %.2f, output leaves 255 at %.2f C\n", i_max, pv_release);
+  CHECK(i_max <= 255.0 + 1e-3);                                                 // Не выше предела выхода
+  CHECK(pv_release > 0.0 && pv_release <= 300.5);                               // Мощность снимается не позже уставки
+}                                                                               // Завершение testRampWindup
+//
+void testManualToAuto() {                                                       // Ручной выход 120 продолжается в автомате
+  PIDController pid;
+  pid.setCoeffs(2.507, 0.0004185, 35.02);
+  pid.setFixedDt(kDtMs);
+  pid.setSetpoint(260.0);
+  pid.initialize(Q16(250), 120);
+  const int first = pid.compute(Q16(250));
+  CHECK(first >= 119 && first <= 121);                                          // Без скачка
+  CHECK_NEAR(pid.derivativeTerm().toDouble(), 0.0, 1e-3);                       // Производная с нуля
+  CHECK_NEAR(pid.integralTerm().toDouble(), 120.0 - 2.507 * 10, 0.01);          // Интеграл продолжает выход
+  int last = first;
+  for (int i = 0; i < 600; ++i) last = pid.compute(Q16(250));                   // Минута: только медленный I
+  CHECK(last - first >= 0 && last - first <= 2);
+  pid.initialize(Q16(250), 400);                                                // Выход вне диапазона — интеграл в пределах
+  CHECK(pid.integralTerm().toDouble() <= 255.0);
+  CHECK_EQ(pid.compute(Q16(250)), 255);
+}                                                                               // Завершение testManualToAuto
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testSlowFurnace();
+  testIntegralSymmetry();
+  testSetpointStep();
+  testRampWindup();
+  testBumplessGains();
+  testManualToAuto();
+  return test::finish("test_pid");
+}                                                                               // Завершение main
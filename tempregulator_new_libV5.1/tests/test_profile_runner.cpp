@@ -0,0 +1,119 @@
+// ProfileRunner: перенос остатка времени через границу ступени, уставка на
+// паузе, гистерезис полосы гарантированной выдержки, счёт ожидания по
+// ступеням и остановка по setMaxWaitMs().
+#include "../ProfileRunner.h"                                                   // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+Q16 c(double v) { return Q16::fromDouble(v); }                                  // Температура в Q16
+//
+void testCarryOver() {                                                          // Тик через границу ступени
+  ProfileRunner p;
+  CHECK(p.addSegment(100.0f, 200.0f, 1.0f));
+  CHECK(p.addSegment(200.0f, 200.0f, 1.0f));
+  CHECK(p.addSegment(200.0f, 320.0f, 1.0f));
+  CHECK_EQ(p.totalMs(), 180000u);
+  CHECK(p.start(1000));
+  CHECK(p.tick(31000, c(150.0)));
+  CHECK_NEAR(p.setpoint().toDouble(), 150.0, 0.01);
+  CHECK(p.tick(71000, c(200.0)));                                               // 40 с: 30 в первой ступени, 10 во второй
+  CHECK_EQ(p.segment(), 1);
+  CHECK_EQ(p.segmentElapsedMs(), 10000u);
+  CHECK_NEAR(p.setpoint().toDouble(), 200.0, 0.01);
+  CHECK(p.tick(136000, c(210.0)));                                              // Остаток 15 с — в третью
+  CHECK_EQ(p.segment(), 2);
+  CHECK_EQ(p.segmentElapsedMs(), 15000u);
+  CHECK_NEAR(p.setpoint().toDouble(), 230.0, 0.01);
+  CHECK(!p.tick(181000, c(320.0)));                                             // Ровно конец профиля
+  CHECK(!p.running());
+  CHECK(p.finished());
+  CHECK(!p.timedOut());
+  CHECK_NEAR(p.setpoint().toDouble(), 320.0, 0.01);
+//
+  CHECK(p.start(0));                                                            // Один тик через две ступени
+  CHECK(p.tick(150000, c(230.0)));
+  CHECK_EQ(p.segment(), 2);
+  CHECK_EQ(p.segmentElapsedMs(), 30000u);
+  CHECK_NEAR(p.setpoint().toDouble(), 260.0, 0.01);
+}                                                                               // Завершение testCarryOver
+//
+void testPauseFreezesSetpoint() {                                               // Садка отстала — рампа ждёт
+  ProfileRunner p;
+  CHECK(p.addSegment(100.0f, 200.0f, 10.0f, 5.0f));                             // 10 °C/мин
+  CHECK(p.start(0));
+  CHECK(p.tick(60000, c(100.0)));                                               // Отклонение от прежней уставки 0
+  CHECK(!p.paused());
+  CHECK_NEAR(p.setpoint().toDouble(), 110.0, 0.01);
+  CHECK(p.tick(120000, c(106.0)));                                              // 4 °C — в полосе
+  CHECK_NEAR(p.setpoint().toDouble(), 120.0, 0.01);
+  CHECK(p.tick(180000, c(110.0)));                                              // 10 °C — пауза
+  CHECK(p.paused());
+  CHECK_NEAR(p.setpoint().toDouble(), 120.0, 0.01);
+  CHECK(p.tick(240000, c(112.0)));
+  CHECK(p.paused());
+  CHECK_NEAR(p.setpoint().toDouble(), 120.0, 0.01);                             // Уставка стоит
+  CHECK_EQ(p.segmentElapsedMs(), 120000u);                                      // Часы ступени тоже
+  CHECK_EQ(p.segmentWaitMs(), 120000u);
+  CHECK(p.tick(300000, c(118.0)));                                              // Догнала: рампа идёт дальше с того же места
+  CHECK(!p.paused());
+  CHECK_EQ(p.segmentElapsedMs(), 180000u);
+  CHECK_NEAR(p.setpoint().toDouble(), 130.0, 0.01);
+}                                                                               // Завершение testPauseFreezesSetpoint
+//
+void testBandHysteresis() {                                                     // Вход по band, выход по band + band/8
+  ProfileRunner p;
+  CHECK(p.addSegment(200.0f, 200.0f, 60.0f, 5.0f));                             // Выход из полосы — 5.625 °C
+  CHECK(p.start(0));
+  uint32_t now = 0;
+  CHECK(p.tick(now += 1000, c(205.5)));                                         // Между band и band_out — идёт
+  CHECK(!p.paused());
+  CHECK(p.tick(now += 1000, c(194.5)));
+  CHECK(!p.paused());
+  CHECK(p.tick(now += 1000, c(205.7)));                                         // За band_out — пауза
+  CHECK(p.paused());
+  CHECK(p.tick(now += 1000, c(205.2)));                                         // Вернулась ниже band_out, но не в band
+  CHECK(p.paused());
+  CHECK(p.tick(now += 1000, c(194.8)));
+  CHECK(p.paused());
+  CHECK(p.tick(now += 1000, c(204.9)));                                         // В полосе — часы пошли
+  CHECK(!p.paused());
+  CHECK_EQ(p.segmentWaitMs(), 3000u);
+  CHECK_EQ(p.segmentElapsedMs(), 3000u);
+}                                                                               // Завершение testBandHysteresis
+//
+void testWaitPerSegment() {                                                     // Ожидание считается заново в каждой ступени
+  ProfileRunner p;
+  CHECK(p.addSegment(200.0f, 200.0f, 1.0f, 5.0f));
+  CHECK(p.addSegment(200.0f, 200.0f, 1.0f, 5.0f));
+  p.setMaxWaitMs(45000);
+  CHECK(p.start(0));
+  CHECK(p.tick(30000, c(190.0)));                                               // 30 с паузы в первой ступени
+  CHECK_EQ(p.segmentWaitMs(), 30000u);
+  CHECK(p.tick(100000, c(200.0)));                                              // Прошла первую, 10 с во второй
+  CHECK_EQ(p.segment(), 1);
+  CHECK_EQ(p.segmentWaitMs(), 0u);
+  CHECK(p.tick(130000, c(190.0)));                                              // 30 с — в сумме с первой было бы 60
+  CHECK(p.paused());
+  CHECK(p.running());
+  CHECK(!p.timedOut());
+  CHECK_EQ(p.segmentWaitMs(), 30000u);
+  CHECK(!p.tick(145000, c(190.0)));                                             // 45 с во второй — предел
+  CHECK(p.timedOut());
+  CHECK(!p.running());
+  CHECK(!p.finished());
+  CHECK(!p.paused());
+  CHECK(!p.tick(150000, c(200.0)));                                             // Остановлен
+  CHECK(p.start(200000));                                                       // Новый запуск снимает признак
+  CHECK(!p.timedOut());
+}                                                                               // Завершение testWaitPerSegment
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testCarryOver();
+  testPauseFreezesSetpoint();
+  testBandHysteresis();
+  testWaitPerSegment();
+  return test::finish("test_profile_runner");
+}                                                                               // Завершение main
@@ -0,0 +1,104 @@
+// SafetyMonitor: обрыв и плохие окна, таймеры роста (в том числе по шумной
+// оценке скорости у выпавшей термопары), итоги обратной связи SSR.
+#include <string.h>                                                             // strcmp
+//
+#include "../SafetyMonitor.h"                                                   // Проверяемый модуль
+#include "../SsrFeedback.h"                                                     // Источник итогов блоков
+#include "../SsrOutput.h"                                                       // Команда выхода для монитора SSR
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+using Alarm = SafetyMonitor::Alarm;
+//
+void testSensorFaults() {                                                       // Обрыв сразу, выбросы — три окна подряд
+  SafetyMonitor m;
+  CHECK_EQ(m.adcReading(true, 0, 0), Alarm::OpenCircuit);
+  CHECK_EQ(m.adcReading(false, 1, 9), Alarm::None);
+  CHECK_EQ(m.adcReading(false, 1, 9), Alarm::None);                             // То же окно не считается дважды
+  CHECK_EQ(m.adcReading(false, 2, 9), Alarm::None);
+  CHECK_EQ(m.adcReading(false, 3, 9), Alarm::SensorFault);
+  m.clearFaults();
+  CHECK_EQ(m.adcReading(false, 4, 9), Alarm::None);
+  CHECK_EQ(m.adcReading(false, 5, 0), Alarm::None);                             // Хорошее окно сбрасывает счёт
+  CHECK_EQ(m.adcReading(false, 6, 9), Alarm::None);
+//
+  CHECK_EQ(m.spiReading(1, false, true), Alarm::None);
+  CHECK_EQ(m.spiReading(1, false, true), Alarm::None);
+  CHECK_EQ(m.spiReading(2, true, true), Alarm::OpenCircuit);
+  CHECK_EQ(m.spiReading(3, false, false), Alarm::None);
+  CHECK(!SafetyMonitor::stopsHeat(Alarm::SensorFault));
+  CHECK(SafetyMonitor::stopsHeat(Alarm::OpenCircuit));
+  CHECK(!strcmp(SafetyMonitor::text(Alarm::OpenCircuit), "Обрыв термопары"));
+  CHECK_EQ(m.probe(SafetyMonitor::kProbeMaxC + 1.0f), Alarm::ProbeOverheat);
+  CHECK_EQ(m.probe(SafetyMonitor::kProbeMaxC), Alarm::None);
+}                                                                               // Завершение testSensorFaults
+//
+void testRiseFast() {                                                           // Скачок держится kRiseFastMs
+  SafetyMonitor m;
+  const Q16 pv = Q16(300), fast = Q16(25);
+  uint32_t now = 0;
+  for (; now < SafetyMonitor::kRiseFastMs; now += 100) CHECK_EQ(m.rise(now, true, pv, fast, 100, 400.0f), Alarm::None);
+  CHECK_EQ(m.rise(now, true, pv, fast, 100, 400.0f), Alarm::RiseFast);
+  CHECK_EQ(m.rise(now + 100, false, pv, fast, 100, 400.0f), Alarm::None);       // Нагрев снят — таймер заново
+  CHECK_EQ(m.rise(now + 200, true, pv, fast, 100, 400.0f), Alarm::None);
+}                                                                               // Завершение testRiseFast
+//
+void testStallWithNoisyRate() {                                                 // Спай вне печи: скорость шумит вокруг нуля
+  SafetyMonitor m;
+  Alarm a = Alarm::None;
+  uint32_t now = 0;
+  for (int i = 0; a == Alarm::None && i < 3000; ++i, now += 100) {
+    const Q16 rate = Q16::fromRatio(i % 2 ? 3 : -3, 100);                       // ±0.03 °C/с — чаще выше порога, чем ниже
+    a = m.rise(now, true, Q16(20), rate, 255, 600.0f);
+  }
+  CHECK_EQ(a, Alarm::RiseStall);
+  CHECK_NEAR(now, SafetyMonitor::kStallMs + 100, 200);
+}                                                                               // Завершение testStallWithNoisyRate
+//
+void testSlowRiseIsNotStall() {                                                 // Тяжёлая садка растёт медленно, но растёт
+  SafetyMonitor m;
+  for (uint32_t now = 0; now < 10 * SafetyMonitor::kStallMs; now += 100) {
+    const Q16 pv = Q16::fromDouble(200.0 + 0.03 * now / 1000.0);                // 0.03 °C/с на полной мощности
+    CHECK_EQ(m.rise(now, true, pv, Q16::fromRatio(3, 100), 255, 600.0f), Alarm::None);
+  }
+  SafetyMonitor near;                                                           // У цели полная мощность без роста — не авария
+  for (uint32_t now = 0; now < 2 * SafetyMonitor::kStallMs; now += 100) {
+    CHECK_EQ(near.rise(now, true, Q16(590), Q16(), 255, 600.0f), Alarm::None);
+  }
+}                                                                               // Завершение testSlowRiseIsNotStall
+//
+void testSsrFeedback() {                                                        // Итоги блоков: раз на блок, по приоритету
+  SsrOutput out;
+  SsrFeedback fb;
+  SafetyMonitor m;
+  CHECK_EQ(m.ssrFeedback(fb, true), Alarm::None);                               // Монитор не запущен
+  fb.begin(0, false, &out);
+  CHECK_EQ(fb.deliveredPower(128), 128);                                        // Итогов ещё нет — по команде
+  for (int b = 0; b < SsrFeedback::kConfirmBlocks; ++b) {
+    for (uint16_t i = 0; i < SsrFeedback::kBlockSamples; ++i) fb.sample(i % 2 == 0, true);  // Ток и при выключенном выходе
+  }
+  CHECK_EQ(m.ssrFeedback(fb, true), Alarm::SsrStuckOn);
+  CHECK_EQ(m.ssrFeedback(fb, true), Alarm::None);                               // Тот же блок второй раз не оценивается
+//
+  SsrFeedback none;
+  SafetyMonitor m2;
+  none.begin(0, false, &out);
+  for (int b = 0; b < SsrFeedback::kConfirmBlocks; ++b) {
+    for (uint16_t i = 0; i < SsrFeedback::kBlockSamples; ++i) none.sample(i % 2 == 0, false);
+  }
+  CHECK_EQ(m2.ssrFeedback(none, true), Alarm::SsrNoCurrent);
+  CHECK(SafetyMonitor::stopsHeat(Alarm::SsrNoCurrent));
+  CHECK(!SafetyMonitor::stopsHeat(Alarm::SsrWeak));
+}                                                                               // Завершение testSsrFeedback
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testSensorFaults();
+  testRiseFast();
+  testStallWithNoisyRate();
+  testSlowRiseIsNotStall();
+  testSsrFeedback();
+  return test::finish("test_safety_monitor");
+}                                                                               // Завершение main
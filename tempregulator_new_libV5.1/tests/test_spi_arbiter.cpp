@@ -0,0 +1,151 @@
+// SpiBusArbiter и SpiThermocouple на SpiMockDevice: чтение обеих микросхем,
+// отложенное чтение при занятой шине и расписание рядом с заливкой и тачем.
+#include "../SpiMockDevice.h"                                                   // Имитатор усилителя
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Часы, обмен и проверки
+//
+using Client = SpiBusArbiter::Client;
+using Chip = SpiThermocouple::Chip;
+//
+constexpr uint32_t kTransferUs = 10;                                            // Длительность обмена с усилителем
+uint32_t g_now_us = 0;                                                          // Время модели
+//
+uint32_t fakeClock() { return g_now_us; }                                       // Часы арбитра
+//
+bool timedTransfer(int8_t cs, uint8_t mode, uint32_t freq, uint8_t* buf, size_t len) {  // Обмен занимает kTransferUs
+  g_now_us += kTransferUs;
+  return SpiMockDevice::transfer(cs, mode, freq, buf, len);
+}                                                                               // Завершение timedTransfer
+//
+SpiBusArbiter& bus() { return SpiBusArbiter::instance(); }                      // Арбитр
+//
+void testMax31855() {                                                           // Кадр, период, неисправность
+  SpiMockDevice dev(Chip::MAX31855);
+  dev.set(250.25, 25.0625);
+  SpiThermocouple tc;
+  tc.setTransfer(timedTransfer);
+  CHECK(tc.begin(Chip::MAX31855, 5, tc::Type::K, 50));
+  CHECK_EQ(dev.transfers(), 0u);                                                // MAX31855 настраивать нечего
+  CHECK(tc.poll(1000));
+  SpiThermocouple::Reading r = tc.latest();
+  CHECK(r.valid);
+  CHECK_EQ(r.seq, 1u);
+  CHECK_NEAR(r.hot.toDouble(), 250.25, 0.0);
+  CHECK_NEAR(r.cold.toDouble(), 25.0625, 0.0);
+  CHECK_EQ(r.fault, 0);
+  CHECK(!tc.poll(1000 + SpiThermocouple::kConversionMs - 1));                   // Новый результат ещё не готов
+  CHECK(tc.poll(1000 + SpiThermocouple::kConversionMs));
+  CHECK_EQ(tc.latest().seq, 2u);
+  CHECK_NEAR(tc.linearized(tc::Type::Linear).toDouble(), 250.25, 0.0);
+//
+  dev.set(-10.5, 24.0, SpiThermocouple::kFaultOpen);
+  CHECK(tc.poll(2000));
+  CHECK_EQ(tc.latest().fault, SpiThermocouple::kFaultOpen);
+  CHECK_NEAR(tc.latest().hot.toDouble(), -10.5, 0.0);
+  CHECK_EQ(dev.transfers(), 3u);
+  CHECK_EQ(dev.busViolations(), 0u);
+  CHECK(bus().owner() == Client::None);
+}                                                                               // Завершение testMax31855
+//
+void testMax31856() {                                                           // Настройка CR0/CR1 и регистры результата
+  SpiMockDevice dev(Chip::MAX31856);
+  SpiThermocouple tc;
+  tc.setTransfer(timedTransfer);
+  CHECK(tc.begin(Chip::MAX31856, 6, tc::Type::K, 50));
+  CHECK_EQ(dev.cr0(), 0x91);                                                    // Автопреобразование, обрыв, 50 Гц
+  CHECK_EQ(dev.cr1(), 0x03);                                                    // Тип K
+  CHECK(tc.begin(Chip::MAX31856, 6, tc::Type::J, 60));
+  CHECK_EQ(dev.cr0(), 0x90);
+  CHECK_EQ(dev.cr1(), 0x02);
+  dev.set(1000.5, 30.25);
+  CHECK(tc.poll(0));
+  CHECK_NEAR(tc.latest().hot.toDouble(), 1000.5, 0.0);
+  CHECK_NEAR(tc.latest().cold.toDouble(), 30.25, 0.0);
+  CHECK_NEAR(tc.linearized(tc::Type::K).toDouble(), 1000.5, 0.0);               // Микросхема линеаризует сама
+  dev.set(20.0, 20.0, 0x01);
+  CHECK(tc.poll(SpiThermocouple::kConversionMs));
+  CHECK_EQ(tc.latest().fault, SpiThermocouple::kFaultOpen);
+  CHECK_EQ(dev.busViolations(), 0u);
+}                                                                               // Завершение testMax31856
+//
+void testBusyBusDefers() {                                                      // Шина у дисплея — чтение переносится
+  SpiMockDevice dev(Chip::MAX31855);
+  SpiThermocouple tc;
+  tc.setTransfer(timedTransfer);
+  tc.begin(Chip::MAX31855, 5, tc::Type::K, 50);
+  const SpiBusArbiter::Stats s0 = bus().stats();
+  bus().acquire(Client::Display);
+  CHECK(!tc.poll(0));
+  CHECK(!tc.poll(1));
+  CHECK_EQ(tc.deferrals(), 2u);
+  CHECK_EQ(dev.transfers(), 0u);                                                // Во время заливки на шину не выходили
+  CHECK(bus().owner() == Client::Display);
+  bus().release(Client::Sensor);                                                // Чужое освобождение не действует
+  CHECK(bus().owner() == Client::Display);
+  bus().release(Client::Display);
+  CHECK(tc.poll(2));                                                            // Первый свободный промежуток
+  CHECK_EQ(dev.transfers(), 1u);
+  const SpiBusArbiter::Stats s1 = bus().stats();
+  CHECK_EQ(s1.sensor_deferrals - s0.sensor_deferrals, 2u);
+  CHECK_EQ(s1.grants[static_cast<uint8_t>(Client::Display)] - s0.grants[static_cast<uint8_t>(Client::Display)], 1u);
+  CHECK_EQ(dev.busViolations(), 0u);
+}                                                                               // Завершение testBusyBusDefers
+//
+void testSchedule() {                                                           // 10 с: заливка 8 мс из 10, тач раз в 30 мс
+  SpiMockDevice dev(Chip::MAX31855);
+  dev.set(300.0, 25.0);
+  SpiThermocouple tc;
+  tc.setTransfer(timedTransfer);
+  tc.begin(Chip::MAX31855, 5, tc::Type::K, 50);
+  bus().setClock(fakeClock);
+  const SpiBusArbiter::Stats s0 = bus().stats();
+  uint32_t reads = 0, last_read_ms = 0, worst_gap_ms = 0;
+  for (uint32_t ms = 0; ms < 10000; ++ms) {
+    g_now_us = ms * 1000;
+    if (ms % 10 == 0) bus().acquire(Client::Display);                           // Начало заливки кадра
+    if (ms % 10 == 8) bus().release(Client::Display);
+    if (ms % 30 == 9) {                                                         // Чтение тача в промежутке
+      SpiBusLock lock(Client::Touch);
+      g_now_us += 50;
+    }
+    if (tc.poll(ms)) {                                                          // Задача регулятора, шаг 1 мс
+      if (reads > 0 && ms - last_read_ms > worst_gap_ms) worst_gap_ms = ms - last_read_ms;
+      last_read_ms = ms;
+      ++reads;
+    }
+  }
+  const SpiBusArbiter::Stats s1 = bus().stats();
+  bus().setClock(nullptr);
+  CHECK(reads >= 95);                                                           // Почти каждый период преобразования
+  CHECK(worst_gap_ms <= SpiThermocouple::kConversionMs + 10);                   // Перенос не дольше одной заливки
+  CHECK(tc.deferrals() > 0);                                                    // Заливка действительно мешала
+  CHECK_EQ(s1.max_wait_us, 0u);                                                 // Дисплей и тач ни разу не ждали датчик
+  CHECK(s1.max_sensor_hold_us <= kTransferUs);                                  // Датчик держит шину один обмен
+  CHECK_EQ(s1.grants[static_cast<uint8_t>(Client::Sensor)] - s0.grants[static_cast<uint8_t>(Client::Sensor)], reads);
+  CHECK_EQ(dev.busViolations(), 0u);
+}                                                                               // Завершение testSchedule
+//
+void testNoDevice() {                                                           // Нет обмена или выбора — драйвер выключен
+  SpiThermocouple tc;
+  CHECK(!tc.begin(Chip::MAX31855, 5, tc::Type::K, 50));                         // На хосте без TransferFn
+  CHECK(!tc.enabled());
+  CHECK(!tc.poll(0));
+  tc.setTransfer(timedTransfer);
+  CHECK(!tc.begin(Chip::MAX31855, -1, tc::Type::K, 50));
+  CHECK(tc.begin(Chip::MAX31855, 5, tc::Type::K, 50));
+  CHECK(!tc.poll(0));                                                           // SpiMockDevice не создан — ответа нет
+  CHECK(!tc.latest().valid);
+  CHECK(bus().owner() == Client::None);                                         // Шина освобождена и после сбоя
+}                                                                               // Завершение testNoDevice
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testMax31855();
+  testMax31856();
+  testBusyBusDefers();
+  testSchedule();
+  testNoDevice();
+  return test::finish("test_spi_arbiter");
+}                                                                               // Завершение main
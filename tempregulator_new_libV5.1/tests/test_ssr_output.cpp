@@ -0,0 +1,193 @@
+// SsrOutput: число включённых слотов в окне из 255 в режимах Window и Burst,
+// доля и длина включений сигма-дельты, снижение мощности посреди окна, счёт
+// фронтов и уведомление о них. Вывод подменён через setWriteFn().
+#include "../SsrOutput.h"                                                       // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Подменённый вывод и проверки
+//
+using Mode = SsrOutput::Mode;
+//
+struct Pin {                                                                    // Что видит вывод
+  uint32_t writes = 0;                                                          // Записей
+  uint32_t high = 0;                                                            // Из них включённых
+  bool     last = false;                                                        // Последний уровень
+  uint8_t  pin = 0;                                                             // Номер вывода
+};                                                                              // Конец структуры Pin
+Pin g_pin;
+//
+void writePin(uint8_t pin, bool on) {                                           // Подмена digitalWrite
+  ++g_pin.writes;
+  if (on) ++g_pin.high;
+  g_pin.last = on;
+  g_pin.pin = pin;
+}                                                                               // Завершение writePin
+//
+struct Edges {                                                                  // Что видит подписчик фронтов
+  uint32_t rises = 0;
+  uint32_t falls = 0;
+  bool     last = false;
+};                                                                              // Конец структуры Edges
+//
+void onEdge(void* arg, bool on) {                                               // Уведомление о фронте
+  Edges& e = *static_cast<Edges*>(arg);
+  if (on) ++e.rises;
+  else ++e.falls;
+  e.last = on;
+}                                                                               // Завершение onEdge
+//
+struct Window {                                                                 // Итог одного окна
+  uint32_t on = 0;                                                              // Включённых слотов
+  uint32_t first_off = SsrOutput::kSlots;                                       // Первый выключенный слот
+  uint32_t on_after = 0;                                                        // Включённых после первого выключенного
+};                                                                              // Конец структуры Window
+//
+Window runWindow(SsrOutput& ssr) {                                              // kSlots тиков подряд
+  Window w;
+  for (uint32_t i = 0; i < SsrOutput::kSlots; ++i) {
+    const uint32_t high0 = g_pin.high;
+    ssr.tick();
+    const bool on = g_pin.high != high0;
+    CHECK_EQ(on, ssr.level());                                                  // Вывод и уровень совпадают
+    if (on) ++w.on;
+    if (!on && w.first_off == SsrOutput::kSlots) w.first_off = i;
+    if (on && w.first_off != SsrOutput::kSlots) ++w.on_after;
+  }
+  return w;
+}                                                                               // Завершение runWindow
+//
+void testWindowSlots() {                                                        // Мощность = включённые слоты окна
+  const uint8_t powers[] = {0, 1, 37, 128, 200, 254, 255};
+  const Mode modes[] = {Mode::Window, Mode::Burst};
+  for (Mode mode : modes) {
+    SsrOutput ssr;
+    g_pin = Pin{};
+    ssr.setWriteFn(writePin);
+    CHECK(ssr.begin(7, mode, 50));
+    CHECK_EQ(ssr.slotUs(), mode == Mode::Window ? SsrOutput::kWindowSlotUs : 10000u);
+    uint32_t on_total = 0;
+    for (uint8_t p : powers) {
+      ssr.setPower(p);
+      const Window w = runWindow(ssr);
+      CHECK_EQ(w.on, p);                                                        // Ровно p слотов из 255
+      CHECK_EQ(w.first_off, p == 255 ? 255u : uint32_t(p));                     // Одним отрезком в начале окна
+      CHECK_EQ(w.on_after, 0u);
+      on_total += p;
+    }
+    CHECK_EQ(ssr.onSlots(), on_total);
+    CHECK_EQ(ssr.totalSlots(), SsrOutput::kSlots * sizeof(powers));
+    CHECK_EQ(g_pin.writes, ssr.totalSlots() + 1);                               // Каждый слот и выключение в begin()
+    CHECK_EQ(g_pin.pin, 7);
+  }
+  SsrOutput ssr;
+  ssr.setWriteFn(writePin);
+  CHECK(ssr.begin(7, Mode::Burst, 60));
+  CHECK_EQ(ssr.slotUs(), 8333u);                                                // Полупериод сети 60 Гц
+}                                                                               // Завершение testWindowSlots
+//
+void testSigmaDelta() {                                                         // Доля на длинном прогоне и длина включений
+  for (int p = 0; p <= 255; ++p) {
+    SsrOutput ssr;
+    g_pin = Pin{};
+    ssr.setWriteFn(writePin);
+    ssr.begin(0, Mode::SigmaDelta, 50);
+    ssr.setPower(static_cast<uint8_t>(p));
+    constexpr uint32_t kWindows = 40;
+    uint32_t run_on = 0, run_off = 0, max_on = 0, max_off = 0;
+    bool duty_ok = true;
+    for (uint32_t i = 1; i <= kWindows * SsrOutput::kSlots; ++i) {
+      ssr.tick();
+      if (ssr.level()) {
+        ++run_on;
+        run_off = 0;
+      } else {
+        ++run_off;
+        run_on = 0;
+      }
+      if (run_on > max_on) max_on = run_on;
+      if (run_off > max_off) max_off = run_off;
+      const int32_t err = int32_t(ssr.onSlots() * 255) - int32_t(i * p);      // Отставание от точной доли, в 1/255 слота
+      if (err > 0 || err <= -255) duty_ok = false;                              // В любой момент меньше слота
+    }
+    CHECK_EQ(g_pin.high, kWindows * p);                                         // Доля точная
+    CHECK(duty_ok);
+    const uint32_t off = 255 - p;                                               // Включения распределены равномерно
+    if (p > 0 && p < 255) {
+      CHECK(max_on <= (p + off - 1) / off);
+      CHECK(max_off <= (off + p - 1) / p);
+    }
+  }
+}                                                                               // Завершение testSigmaDelta
+//
+void testLowerMidWindow() {                                                     // Снижение — со следующего слота, рост — со следующего окна
+  SsrOutput ssr;
+  g_pin = Pin{};
+  ssr.setWriteFn(writePin);
+  ssr.begin(0, Mode::Window, 50);
+  ssr.setPower(200);
+  for (int i = 0; i < 50; ++i) ssr.tick();
+  CHECK(ssr.level());
+  ssr.setPower(20);                                                             // Слот 50 уже за новой мощностью
+  ssr.tick();
+  CHECK(!ssr.level());
+  for (int i = 51; i < 255; ++i) ssr.tick();
+  CHECK_EQ(ssr.onSlots(), 50u);
+  ssr.setPower(100);
+  CHECK_EQ(runWindow(ssr).on, 100u);
+  for (int i = 0; i < 150; ++i) ssr.tick();                                     // Рост посреди окна ждёт нового окна
+  ssr.setPower(255);
+  ssr.tick();
+  CHECK(!ssr.level());
+  for (int i = 151; i < 255; ++i) ssr.tick();
+  CHECK_EQ(runWindow(ssr).on, 255u);
+//
+  ssr.setMode(Mode::Burst, 50);                                                 // В Burst так же
+  ssr.setPower(255);
+  for (int i = 0; i < 10; ++i) ssr.tick();
+  ssr.setPower(0);
+  ssr.tick();
+  CHECK(!ssr.level());
+}                                                                               // Завершение testLowerMidWindow
+//
+void testEdges() {                                                              // Фронты: счётчик и уведомление
+  SsrOutput ssr;
+  Edges e;
+  g_pin = Pin{};
+  ssr.setWriteFn(writePin);
+  ssr.setEdgeCallback(onEdge, &e);
+  ssr.begin(0, Mode::Window, 50);
+  CHECK_EQ(ssr.edgeCount(), 0u);                                                // Выключенный выход не переключался
+  ssr.setPower(100);
+  for (int w = 0; w < 3; ++w) runWindow(ssr);
+  CHECK_EQ(ssr.edgeCount(), 6u);                                                // Включение и выключение на окно
+  CHECK_EQ(e.rises, 3u);
+  CHECK_EQ(e.falls, 3u);
+  CHECK(!e.last);
+  ssr.setPower(255);
+  for (int w = 0; w < 3; ++w) runWindow(ssr);
+  CHECK_EQ(ssr.edgeCount(), 7u);                                                // Полная мощность — одно включение
+  CHECK(e.last);
+  ssr.off();                                                                    // Выключение без ожидания слота
+  CHECK_EQ(ssr.edgeCount(), 8u);
+  CHECK(!e.last && !g_pin.last && !ssr.level());
+  CHECK_EQ(ssr.power(), 0);
+  ssr.tick();
+  CHECK_EQ(ssr.edgeCount(), 8u);
+//
+  ssr.setMode(Mode::SigmaDelta, 50);                                            // 64/255: включения по одному слоту
+  ssr.setPower(64);
+  const uint32_t e0 = ssr.edgeCount();
+  for (int w = 0; w < 2; ++w) runWindow(ssr);
+  CHECK_EQ(ssr.edgeCount() - e0, 2u * 128 - (ssr.level() ? 1 : 0));
+  CHECK_EQ(e.rises + e.falls, ssr.edgeCount());
+}                                                                               // Завершение testEdges
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testWindowSlots();
+  testSigmaDelta();
+  testLowerMidWindow();
+  testEdges();
+  return test::finish("test_ssr_output");
+}                                                                               // Завершение main
@@ -0,0 +1,157 @@
+// Storage: config.ini на разделе LittleFS (каталог во временной папке хоста).
+#include <stdio.h>                                                              // fopen, remove
+#include <stdlib.h>                                                             // mkdtemp
+//
+#include <string>                                                               // Пути
+//
+#include <LittleFS.h>                                                           // Замена раздела
+//
+#include "../Storage.h"                                                         // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Вспомогательные функции
+//
+PersistentConfig sample() {                                                     // Конфигурация с неумолчательными полями
+  PersistentConfig c{};
+  c.calibrated = true;
+  c.offset = -1.25f;
+  c.slope = 0.98765f;
+  c.pid_kp = 2.507;
+  c.pid_ki = 0.000419;
+  c.pid_kd = 35.02;
+  c.tc_type = 2;
+  c.emf_offset = -12.5f;
+  c.emf_slope = 10.123456f;
+  c.cjc_fixed = 22.5f;
+  c.tc_source = 1;
+  c.wall_offset = 0.5f;
+  c.wall_slope = 1.01f;
+  c.safety_offset = -0.5f;
+  c.safety_slope = 0.99f;
+  c.touch_calibrated = true;
+  c.touch_swap = true;
+  c.touch_tx_min = 310;
+  c.touch_tx_max = 3890;
+  c.touch_ty_min = 220;
+  c.touch_ty_max = 3870;
+  c.adc_mode = 1;
+  c.mains_hz = 60;
+  c.adc_ssr_sync = true;
+  c.control_period_ms = 250;
+  c.ssr_mode = 2;
+  c.ssr_feedback = 1;
+  c.heater_w = 3000;
+  c.pid_adapt = true;
+  c.shaper = true;
+  c.shaper_k = 2.5f;
+  c.shaper_tau = 3000.0f;
+  c.shaper_dead = 60.0f;
+  c.pid_sched[0] = GainSchedule::Point{100.0f, 3.0f, 0.5f, 40.0f};
+  c.pid_sched[2] = GainSchedule::Point{800.0f, 1.5f, 0.125f, 20.0f};
+  return c;
+}                                                                               // Завершение sample
+//
+std::string configPath() { return LittleFS.hostRoot() + "/config.ini"; }        // config.ini на хосте
+//
+void testRoundTrip() {                                                          // save() → load() без потерь
+  CHECK(Storage::begin());
+  const PersistentConfig in = sample();
+  CHECK(Storage::save(in));
+  PersistentConfig out{};
+  CHECK(Storage::load(out));
+  CHECK_EQ(out.calibrated, in.calibrated);
+  CHECK_NEAR(out.offset, in.offset, 1e-5);
+  CHECK_NEAR(out.slope, in.slope, 1e-5);
+  CHECK_NEAR(out.pid_kp, in.pid_kp, 1e-6);
+  CHECK_NEAR(out.pid_ki, in.pid_ki, 1e-6);
+  CHECK_NEAR(out.pid_kd, in.pid_kd, 1e-6);
+  CHECK_EQ(out.tc_type, in.tc_type);
+  CHECK_NEAR(out.emf_offset, in.emf_offset, 1e-3);
+  CHECK_NEAR(out.emf_slope, in.emf_slope, 1e-6);
+  CHECK_NEAR(out.cjc_fixed, in.cjc_fixed, 1e-2);
+  CHECK_EQ(out.tc_source, in.tc_source);
+  CHECK_NEAR(out.wall_slope, in.wall_slope, 1e-5);
+  CHECK_NEAR(out.safety_offset, in.safety_offset, 1e-5);
+  CHECK_EQ(out.touch_calibrated, in.touch_calibrated);
+  CHECK_EQ(out.touch_swap, in.touch_swap);
+  CHECK_EQ(out.touch_tx_min, in.touch_tx_min);
+  CHECK_EQ(out.touch_ty_max, in.touch_ty_max);
+  CHECK_EQ(out.adc_mode, in.adc_mode);
+  CHECK_EQ(out.mains_hz, in.mains_hz);
+  CHECK_EQ(out.adc_ssr_sync, in.adc_ssr_sync);
+  CHECK_EQ(out.control_period_ms, in.control_period_ms);
+  CHECK_EQ(out.ssr_mode, in.ssr_mode);
+  CHECK_EQ(out.ssr_feedback, in.ssr_feedback);
+  CHECK_EQ(out.heater_w, in.heater_w);
+  CHECK_EQ(out.pid_adapt, in.pid_adapt);
+  CHECK_EQ(out.shaper, in.shaper);
+  CHECK_NEAR(out.shaper_k, in.shaper_k, 1e-3);
+  CHECK_NEAR(out.shaper_tau, in.shaper_tau, 0.1);
+  CHECK_NEAR(out.shaper_dead, in.shaper_dead, 0.1);
+  for (uint8_t i = 0; i < GainSchedule::kMaxPoints; ++i) {
+    CHECK_NEAR(out.pid_sched[i].temp_c, in.pid_sched[i].temp_c, 0.1);
+    CHECK_NEAR(out.pid_sched[i].kp, in.pid_sched[i].kp, 1e-3);
+    CHECK_NEAR(out.pid_sched[i].ki, in.pid_sched[i].ki, 1e-3);
+    CHECK_NEAR(out.pid_sched[i].kd, in.pid_sched[i].kd, 1e-3);
+  }
+}                                                                               // Завершение testRoundTrip
+//
+void testMissingKeysKeepDefaults() {                                            // Старый файл без новых ключей
+  FILE* f = fopen(configPath().c_str(), "w");
+  CHECK(f != nullptr);
+  if (!f) return;
+  fputs("# old\nversion=1\ncalibrated=1\nkp=3.5\n\n", f);
+  fclose(f);
+  PersistentConfig out{};
+  CHECK(Storage::load(out));
+  CHECK(out.calibrated);
+  CHECK_NEAR(out.pid_kp, 3.5, 1e-9);
+  CHECK_NEAR(out.pid_ki, 5.0, 1e-9);                                            // Умолчание load()
+  CHECK_EQ(out.control_period_ms, 100);
+  CHECK_EQ(out.mains_hz, 50);
+  CHECK_NEAR(out.pid_sched[0].temp_c, 0.0, 0.0);                                // Таблица PID пуста
+}                                                                               // Завершение testMissingKeysKeepDefaults
+//
+void testVersionMismatch() {                                                    // Чужая версия — out не трогаем
+  FILE* f = fopen(configPath().c_str(), "w");
+  CHECK(f != nullptr);
+  if (!f) return;
+  fputs("version=2\nkp=9\n", f);
+  fclose(f);
+  PersistentConfig out = sample();
+  CHECK(!Storage::load(out));
+  CHECK_NEAR(out.pid_kp, 2.507, 1e-9);
+}                                                                               // Завершение testVersionMismatch
+//
+void testClear() {                                                              // Удаление файла
+  CHECK(Storage::save(sample()));
+  CHECK(Storage::clear());
+  PersistentConfig out{};
+  CHECK(!Storage::load(out));
+  CHECK(Storage::clear());                                                      // Файла нет — тоже успех
+}                                                                               // Завершение testClear
+//
+void testMountFailure() {                                                       // Раздел не монтируется
+  LittleFS.end();
+  LittleFS.hostFail(true);
+  CHECK(!Storage::begin());
+  CHECK(!Storage::save(sample()));
+  LittleFS.hostFail(false);
+  CHECK(Storage::begin());
+}                                                                               // Завершение testMountFailure
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  char dir[] = "/tmp/tr_storage_XXXXXX";
+  if (!mkdtemp(dir)) return 2;
+  LittleFS.hostSetRoot(dir);
+  testRoundTrip();
+  testMissingKeysKeepDefaults();
+  testVersionMismatch();
+  testClear();
+  testMountFailure();
+  Storage::clear();
+  ::remove(dir);
+  return test::finish("test_storage");
+}                                                                               // Завершение main
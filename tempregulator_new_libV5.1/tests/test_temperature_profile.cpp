@@ -0,0 +1,117 @@
+// TemperatureProfile: профиль в NVS (Preferences в памяти) и экспорт в JSON.
+#include <string.h>                                                             // strcmp
+//
+#include <ArduinoJson.h>                                                        // JsonDocument
+#include <Preferences.h>                                                        // hostErase
+//
+#include "../TemperatureProfile.h"                                              // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+void testMissingNamespace() {                                                   // Пространства нет — профиль недоступен
+  Preferences::hostErase();
+  TemperatureProfile p("UserTmpProf_3", "Без NVS");
+  p.rKp_PWM = 4.0;
+  CHECK(!p.loadFromNVS());
+  CHECK(!p.isAvailable());
+  CHECK_EQ(p.stepCount(), 0u);
+  CHECK_NEAR(p.kp(), 4.0, 0.0);                                                 // Поля объекта не обнулены
+  CHECK_EQ(Preferences::hostNamespaceCount(), 0u);                              // Чтение не создаёт пространство
+//
+  TemperatureProfile unnamed;
+  CHECK(!unnamed.loadFromNVS());
+  CHECK(!unnamed.saveToNVS("x", nullptr, 0, true));
+}                                                                               // Завершение testMissingNamespace
+//
+void testDefaults() {                                                           // Заготовки профилей
+  Preferences::hostErase();
+  ensureDefaultTemperatureProfiles();
+  CHECK_EQ(Preferences::hostNamespaceCount(), 10u);
+//
+  TemperatureProfile first("UserTmpProf_1");
+  CHECK(!first.loadFromNVS());                                                  // Имя есть, ступеней нет
+  CHECK(first.name().length() > 0);
+  CHECK(first.availableForWeb);
+  CHECK_NEAR(first.rKl_TC, 1.0, 0.0);
+  CHECK_NEAR(first.rKq_KF, 0.01, 1e-12);
+  CHECK(!first.hasModel());
+  CHECK(!first.hasPidCoefficients());
+//
+  TemperatureProfile second("UserTmpProf_2");
+  second.saveToNVS("Мой", nullptr, 0, false);
+  ensureDefaultTemperatureProfiles();                                           // Существующий профиль не перезаписывается
+  second.loadFromNVS();
+  CHECK(second.name() == "Мой");
+}                                                                               // Завершение testDefaults
+//
+void testSaveLoad() {                                                           // Строки, видимость, модель и PID
+  Preferences::hostErase();
+  TempProfileRow rows[3] = {
+      {20.0f, 300.0f, 60.0f, 0.0f},
+      {300.0f, 300.0f, 30.0f, 3.0f},
+      {300.0f, 1000.0f, 120.0f, 0.0f},
+  };
+  TemperatureProfile p("UserTmpProf_4");
+  CHECK(p.saveToNVS("Обжиг", rows, 3, true));
+  CHECK(p.isAvailable());
+  CHECK_EQ(p.stepCount(), 3u);
+  CHECK(p.showInMenu);
+  CHECK(p.availableForWeb);
+  CHECK_NEAR(p.step(1).rBand, 3.0, 0.0);
+  CHECK_NEAR(p.step(2).rEndTemperature, 1000.0, 0.0);
+  CHECK_NEAR(p.step(TemperatureProfile::MAX_ROWS).rTime, 0.0, 0.0);           // За концом — пустая строка
+//
+  CHECK(p.saveModelToNVS(2.5, 3000.0, 60.0));
+  CHECK(p.savePidToNVS(2.507, 0.000419, 35.02));
+//
+  TemperatureProfile q("UserTmpProf_4");                                        // Новый экземпляр читает то же
+  CHECK(q.loadFromNVS());
+  CHECK(q.name() == "Обжиг");
+  CHECK_EQ(q.stepCount(), 3u);
+  CHECK_NEAR(q.step(0).rStartTemperature, 20.0, 0.0);
+  CHECK(q.hasModel());
+  CHECK_NEAR(q.rKm_FO, 2.5, 0.0);
+  CHECK_NEAR(q.rTm_FO, 3000.0, 0.0);
+  CHECK_NEAR(q.rLm_FO, 60.0, 0.0);
+  CHECK(q.hasPidCoefficients());
+  CHECK_NEAR(q.ki(), 0.000419, 0.0);
+//
+  CHECK(q.saveToNVS("Скрыт", rows, 3, false));                                  // Ступени есть — в меню всё равно
+  CHECK(q.showInMenu);
+  CHECK(!q.availableForWeb);
+//
+  CHECK(!q.clearInNVS());
+  CHECK_EQ(q.stepCount(), 0u);
+  CHECK(!q.hasModel());
+}                                                                               // Завершение testSaveLoad
+//
+void testExportJson() {                                                         // Поля и таблица в JSON
+  Preferences::hostErase();
+  TempProfileRow rows[2] = {{20.0f, 500.0f, 90.0f, 0.0f}, {500.0f, 500.0f, 15.0f, 2.0f}};
+  TemperatureProfile p("UserTmpProf_5");
+  p.saveToNVS("Сушка", rows, 2, true);
+  p.savePidToNVS(3.0, 0.002, 40.0);
+//
+  JsonDocument doc;
+  CHECK(p.exportToJson(doc));
+  CHECK(!strcmp(doc["sNVSnamespace"].as<const char*>(), "UserTmpProf_5"));
+  CHECK(doc["sNameProfile"].as<String>() == "Сушка");
+  CHECK(doc["isAvailableForWeb"].as<bool>());
+  CHECK_NEAR(doc["rKp_PWM"].as<double>(), 3.0, 0.0);
+  CHECK_NEAR(doc["rKd_PWM"].as<double>(), 40.0, 0.0);
+  CHECK_EQ(doc["data"].size(), static_cast<size_t>(TemperatureProfile::MAX_ROWS));
+  CHECK_NEAR(doc["data"][0]["1_2"].as<float>(), 500.0, 0.0);
+  CHECK_NEAR(doc["data"][1]["2_4"].as<float>(), 2.0, 0.0);
+  CHECK_NEAR(doc["data"][9]["10_3"].as<float>(), 0.0, 0.0);
+}                                                                               // Завершение testExportJson
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testMissingNamespace();
+  testDefaults();
+  testSaveLoad();
+  testExportJson();
+  return test::finish("test_temperature_profile");
+}                                                                               // Завершение main
@@ -0,0 +1,59 @@
+// ThermocoupleTables: обратная интерполяция temperature() между узлами
+// сетки против прямых полиномов NIST ITS-90 и справочных значений, включая
+// участок ниже 0 °C, где узел отрицателен.
+#include <math.h>                                                               // fabs
+//
+#include "../ThermocoupleTables.h"                                              // Проверяемый модуль
+#include "TestCheck.h"                                                          // CHECK*
+//
+namespace {                                                                     // Проверки
+//
+template <tc::Type T>
+double worstInverseError(double from_c, double to_c, double step_c) {           // Наибольшая ошибка temperature() на отрезке
+  double worst = 0.0;
+  for (double t = from_c; t <= to_c; t += step_c) {
+    const tc::EmfQ e = tc::EmfQ::fromDouble(tc::Spec<T>::emfUv(t));
+    const double err = fabs(tc::temperature(T, e).toDouble() - t);
+    if (err > worst) worst = err;
+  }
+  return worst;
+}                                                                               // Завершение worstInverseError
+//
+void testInverseBetweenNodes() {                                                // Шаг 0.37 °C: почти всегда между узлами
+  CHECK(worstInverseError<tc::Type::K>(-49.9, 1369.9, 0.37) < 0.05);
+  CHECK(worstInverseError<tc::Type::J>(-49.9, 1199.9, 0.37) < 0.05);
+  CHECK(worstInverseError<tc::Type::K>(-49.9, -0.1, 0.13) < 0.05);               // Отрицательные узлы
+  CHECK(worstInverseError<tc::Type::J>(-49.9, -0.1, 0.13) < 0.05);
+}                                                                               // Завершение testInverseBetweenNodes
+//
+void testNistReference() {                                                      // Справочные таблицы NIST, мкВ → °C
+  struct Point { tc::Type type; double uv; double c; };
+  const Point pts[] = {
+      {tc::Type::K, -1156.0, -30.0}, {tc::Type::K, -392.0, -10.0}, {tc::Type::K, 1000.0, 25.0},
+      {tc::Type::K, 1489.0, 37.0}, {tc::Type::K, 12209.0, 300.0}, {tc::Type::K, 35313.0, 850.0},
+      {tc::Type::J, -1482.0, -30.0}, {tc::Type::J, 1277.0, 25.0}, {tc::Type::J, 13555.0, 250.0},
+      {tc::Type::J, 40068.0, 715.0},
+  };
+  for (const Point& p : pts) {
+    const double t = tc::temperature(p.type, tc::EmfQ::fromDouble(p.uv)).toDouble();
+    CHECK_NEAR(t, p.c, 0.06);                                                   // Таблица NIST округлена до 1 мкВ
+  }
+}                                                                               // Завершение testNistReference
+//
+void testEmfRoundTrip() {                                                       // emf() и temperature() взаимно обратны
+  for (double t = -48.5; t < 1300.0; t += 7.3) {
+    const tc::EmfQ e = tc::emf(tc::Type::K, Q16::fromDouble(t));
+    CHECK_NEAR(e.toDouble(), tc::Spec<tc::Type::K>::emfUv(t), 2.0);
+    CHECK_NEAR(tc::temperature(tc::Type::K, e).toDouble(), t, 0.01);
+  }
+  CHECK_NEAR(tc::emf(tc::Type::J, Q16::fromDouble(-20.0)).toDouble(), tc::Spec<tc::Type::J>::emfUv(-20.0), 1.0);
+}                                                                               // Завершение testEmfRoundTrip
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main() {                                                                    // Прогон проверок
+  testInverseBetweenNodes();
+  testNistReference();
+  testEmfRoundTrip();
+  return test::finish("test_thermocouple");
+}                                                                               // Завершение main
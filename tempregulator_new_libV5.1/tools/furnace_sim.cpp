@@ -0,0 +1,100 @@
+// Прогон профиля по модели печи на ПК (PlantSimulator) через тот же шаг
+// рабочего режима, что и на плате. Без аргументов — регрессионный набор на
+// 8-часовом профиле: каждый прогон сверяется со своими пределами
+// перерегулирования, IAE и установления (с неисправностью — с ожидаемой
+// аварией), код выхода 1, если хоть один предел нарушен; входит в ctest.
+// Иначе один прогон стандартного сценария с заменёнными параметрами
+// «ключ=значение» (fault: 1 — обрыв термопары, 2 — SSR залип, 3 — нет тока,
+// 4 — термопара вне печи). Каждый прогон — строка JSON (JSON Lines).
+// Сборка из каталога скетча:
+//
+//   cmake -S . -B build && cmake --build build -j
+//   ./build/furnace_sim name=fast kp=5 ki=0.0017 kd=35 shaper=1 dead_s=40
+//   ./build/furnace_sim seg=20:300:60 seg=300:300:30:3 noise_c=1 outlier_rate=0.01
+//   ./build/furnace_sim name=stuck fault=2 fault_s=9000
+//
+#include <stdio.h>                                                              // fprintf
+#include <stdlib.h>                                                             // strtod
+#include <string.h>                                                             // strchr, strcmp, strncmp
+//
+#include "../PlantSimulator.h"                                                  // Модель печи и прогон
+//
+namespace {                                                                     // Разбор аргументов
+//
+struct Key {                                                                    // Числовой параметр сценария
+  const char* name;                                                             // Ключ в командной строке
+  double*     value;                                                            // Куда записать
+};                                                                              // Конец структуры Key
+//
+bool parseSegment(const char* v, LoopScenario& sc) {                            // start:end:minutes[:band]
+  float f[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  const int n = sscanf(v, "%f:%f:%f:%f", &f[0], &f[1], &f[2], &f[3]);
+  if (n < 3 || sc.count >= ProfileRunner::kMaxSegments) return false;
+  sc.addSegment(f[0], f[1], f[2], f[3]);
+  return true;
+}                                                                               // Завершение parseSegment
+//
+}  // namespace                                                                 // Завершение анонимного пространства имён
+//
+int main(int argc, char** argv) {                                               // Набор или один прогон
+  if (argc < 2) return runPlantSimulation() ? 1 : 0;
+  LoopScenario sc = LoopScenario::standard();
+  LoopScenario::Segment* custom = nullptr;                                      // Первая seg= заменяет стандартный профиль
+  const char* name = "custom";
+  double shaper = sc.shaper, adapt = sc.adapt, ssr = sc.ssr_mode, feedback = sc.feedback, seed = sc.plant.seed;
+  double fault = 0.0;
+  const Key keys[] = {
+    {"kp", &sc.kp}, {"ki", &sc.ki}, {"kd", &sc.kd}, {"model_c", &sc.model_c}, {"max_wait_min", &sc.max_wait_min},
+    {"shaper", &shaper}, {"adapt", &adapt}, {"ssr", &ssr}, {"feedback", &feedback}, {"seed", &seed},
+    {"fault", &fault}, {"fault_s", &sc.plant.fault_s},
+    {"heater_w", &sc.plant.heater_w}, {"capacity_j", &sc.plant.capacity_j},
+    {"loss_w", &sc.plant.loss_w}, {"rad_w", &sc.plant.rad_w}, {"ambient_c", &sc.plant.ambient_c},
+    {"dead_s", &sc.plant.dead_s}, {"tc_tau_s", &sc.plant.tc_tau_s}, {"noise_c", &sc.plant.noise_c},
+    {"outlier_rate", &sc.plant.outlier_rate}, {"outlier_c", &sc.plant.outlier_c},
+  };
+  for (int i = 1; i < argc; ++i) {
+    const char* eq = strchr(argv[i], '=');
+    if (!eq) {
+      fprintf(stderr, "expected key=value: %s\n", argv[i]);
+      return 2;
+    }
+    const size_t len = static_cast<size_t>(eq - argv[i]);
+    const char* v = eq + 1;
+    if (len == 4 && !strncmp(argv[i], "name", 4)) {
+      name = v;
+      continue;
+    }
+    if (len == 3 && !strncmp(argv[i], "seg", 3)) {
+      if (!custom) {
+        sc.count = 0;
+        custom = sc.segments;
+      }
+      if (!parseSegment(v, sc)) {
+        fprintf(stderr, "bad segment (start:end:minutes[:band]): %s\n", v);
+        return 2;
+      }
+      continue;
+    }
+    bool known = false;
+    for (const Key& k : keys) {
+      if (strlen(k.name) == len && !strncmp(argv[i], k.name, len)) {
+        *k.value = strtod(v, nullptr);
+        known = true;
+      }
+    }
+    if (!known) {
+      fprintf(stderr, "unknown key: %.*s\n", static_cast<int>(len), argv[i]);
+      return 2;
+    }
+  }
+  sc.shaper = shaper != 0.0;
+  sc.adapt = adapt != 0.0;
+  sc.ssr_mode = static_cast<uint8_t>(ssr);
+  sc.feedback = feedback != 0.0;
+  sc.plant.fault = static_cast<PlantSimulator::Fault>(fault);
+  sc.plant.seed = static_cast<uint32_t>(seed);
+  LoopReport r;
+  runClosedLoop(sc, r);
+  printLoopReport(name, r);
+  return r.finished ? 0 : 1;
+}                                                                               // Завершение main
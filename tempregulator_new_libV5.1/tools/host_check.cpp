@@ -0,0 +1,28 @@
+// Проверка ядра регулятора на ПК, без Arduino и платы. Собирает замеры
+// стоимости (TR_PID_BENCHMARK) и отладочные моделирования (TR_AUTOTUNE_SIM)
+// тех же модулей, что идут в прошивку; время — PlatformClock.h. Arduino IDE
+// каталог tools/ не компилирует. Сборка из каталога скетча:
+//
+//   cmake -S . -B build && cmake --build build -j && ./build/host_check
+//
+#include "../AdaptivePid.h"                                                     // runAdaptiveSimulation
+#include "../ControlBenchmark.h"                                                // runControlBenchmark
+#include "../OvershootShaper.h"                                                 // runShaperSimulation
+#include "../PIDController.h"                                                   // runPidBenchmark
+#include "../RelayAutotune.h"                                                   // runAutotuneSimulation
+#include "../StepIdentifier.h"                                                  // runStepIdentSimulation
+//
+int main() {                                                                    // Замеры, затем моделирования
+#ifdef TR_PID_BENCHMARK
+  runPidBenchmark();                                                            // compute(): double и Q16
+  runControlBenchmark();                                                        // Звенья горячего пути
+  runFilterBenchmark();                                                         // Фильтр АЦП
+#endif                                                                          // TR_PID_BENCHMARK
+#ifdef TR_AUTOTUNE_SIM
+  runAutotuneSimulation();                                                      // Релейная настройка
+  runStepIdentSimulation();                                                     // Идентификация по ступеньке
+  runAdaptiveSimulation();                                                      // Адаптивная подстройка
+  runShaperSimulation();                                                        // Формирование уставки
+#endif                                                                          // TR_AUTOTUNE_SIM
+  return 0;
+}                                                                               // Завершение main
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Снимок трассы прибора (EventTrace) → JSON для chrome://tracing и Perfetto.
+
+Вход — либо файл /trace.bin, скачанный с прибора, либо лог монитора порта,
+в котором после команды «t» есть блок «[TRACE] begin … [TRACE] end» (берётся
+последний). Каждое событие прибора — своя дорожка, время — от первой записи.
+"""
+import argparse
+import json
+import re
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+# --------------------------------------------------------------------------------------
+# Формат снимка (см. EventTrace.h)
+# --------------------------------------------------------------------------------------
+
+MAGIC = b"TRC1"
+HEADER = struct.Struct("<4sHHIIII")
+RECORD = struct.Struct("<IBBh")
+WRAP = 1 << 32
+
+Record = Tuple[int, int, str, int]  # мкс от снимка (≤ 0), событие, вид, аргумент
+
+
+def extract_serial_dump(text: str) -> bytes:
+    """Последний блок «[TRACE] begin … [TRACE] end» из лога порта."""
+    blocks = re.findall(r"\[TRACE\] begin (\d+)\s*\n(.*?)\[TRACE\] end", text, re.S)
+    if not blocks:
+        raise ValueError("в логе нет блока [TRACE] begin … [TRACE] end")
+    size, body = blocks[-1]
+    data = bytes.fromhex("".join(re.findall(r"^[0-9a-fA-F]+$", body, re.M)))
+    if len(data) != int(size):
+        raise ValueError(f"блок обрезан: {len(data)} байт из {size}")
+    return data
+
+
+def parse_snapshot(data: bytes) -> Tuple[List[str], List[Record], Dict[str, int]]:
+    magic, rec_size, name_count, written, dropped, count, now_us = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError("не снимок EventTrace (нет сигнатуры TRC1)")
+    if rec_size != RECORD.size:
+        raise ValueError(f"неизвестный размер записи {rec_size}")
+    pos = HEADER.size
+    names = []
+    for _ in range(name_count):
+        end = data.index(b"\0", pos)
+        names.append(data[pos:end].decode("utf-8"))
+        pos = end + 1
+    records = []
+    for i in range(count):
+        ts, ev, kind, arg = RECORD.unpack_from(data, pos + i * rec_size)
+        # Метки — младшие 32 бита micros(): возраст относительно снимка не
+        # зависит от переполнения, пока кольцо короче 71 минуты. Время снимка
+        # прибор берёт после копирования, поэтому возраст не отрицательный.
+        age = (now_us - ts) % WRAP
+        records.append((-age, ev, chr(kind), arg))
+    info = {"written": written, "dropped": dropped, "count": count}
+    return names, records, info
+
+
+# --------------------------------------------------------------------------------------
+# Преобразование в Chrome trace
+# --------------------------------------------------------------------------------------
+
+def to_chrome(names: List[str], records: List[Record]) -> dict:
+    events = [{"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "TR-MUF-1"}}]
+    for i, name in enumerate(names):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": i, "args": {"name": name}})
+    if not records:
+        return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+    records = sorted(records, key=lambda r: r[0])  # прибор уже упорядочил; снимки прошлых версий — нет
+    t0 = records[0][0]
+    depth: Dict[int, int] = {}
+    for ts, ev, kind, arg in records:
+        name = names[ev] if ev < len(names) else f"event{ev}"
+        e = {"name": name, "ph": kind, "ts": ts - t0, "pid": 1, "tid": ev}
+        if kind == "B":
+            depth[ev] = depth.get(ev, 0) + 1
+            e["args"] = {"arg": arg}
+        elif kind == "E":
+            if depth.get(ev, 0) == 0:  # начало участка уже затёрто в кольце
+                continue
+            depth[ev] -= 1
+        elif kind == "C":
+            e["args"] = {name: arg}
+        elif kind == "i":
+            e["s"] = "t"
+            e["args"] = {"arg": arg}
+        else:
+            continue
+        events.append(e)
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description="Снимок EventTrace → Chrome/Perfetto JSON")
+    ap.add_argument("input", type=Path, help="trace.bin с прибора или лог монитора порта")
+    ap.add_argument("-o", "--output", type=Path, help="файл JSON (по умолчанию stdout)")
+    args = ap.parse_args()
+
+    raw = args.input.read_bytes()
+    try:
+        data = raw if raw.startswith(MAGIC) else extract_serial_dump(raw.decode("utf-8", "replace"))
+        names, records, info = parse_snapshot(data)
+    except (ValueError, struct.error) as exc:
+        print(f"{args.input}: {exc}", file=sys.stderr)
+        return 1
+
+    trace = to_chrome(names, records)
+    text = json.dumps(trace, ensure_ascii=False)
+    if args.output:
+        args.output.write_text(text, encoding="utf-8")
+    else:
+        print(text)
+    span = (max(r[0] for r in records) - min(r[0] for r in records)) / 1e6 if records else 0.0
+    print(f"записей {info['count']} (всего {info['written']}, потеряно {info['dropped']}), "
+          f"охват {span:.1f} с", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())